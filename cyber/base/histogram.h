@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_BASE_HISTOGRAM_H_
+#define CYBER_BASE_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstdint>
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+/**
+ * @class Histogram
+ * @brief Lock-free histogram of durations in nanoseconds with power of two
+ * microsecond buckets: bucket 0 counts values below 1us and bucket i values in
+ * [2^(i-1), 2^i) us, the last bucket being open ended. Counters are cumulative
+ * and only updated with relaxed atomics, so recording is cheap and readers may
+ * sample at any time, at the price of a slightly inconsistent snapshot.
+ */
+class Histogram {
+ public:
+  static const uint32_t kBucketNum = 32;
+
+  Histogram() = default;
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  void Record(uint64_t value_ns) {
+    buckets_[BucketIndex(value_ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value_ns, std::memory_order_relaxed);
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value_ns > max && !max_.compare_exchange_weak(
+                                 max, value_ns, std::memory_order_relaxed)) {
+    }
+  }
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+  uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+  uint64_t bucket(uint32_t index) const {
+    return index < kBucketNum ? buckets_[index].load(std::memory_order_relaxed)
+                              : 0;
+  }
+
+  /**
+   * @brief Upper bound in nanoseconds of the bucket holding the given
+   * percentile, or max() if that is smaller.
+   *
+   * @param percentile in [0, 100]
+   */
+  uint64_t Percentile(double percentile) const {
+    uint64_t total = count();
+    if (total == 0) {
+      return 0;
+    }
+    auto rank = static_cast<uint64_t>(static_cast<double>(total) *
+                                      percentile / 100.0);
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < kBucketNum; ++i) {
+      seen += bucket(i);
+      if (seen > rank || seen == total) {
+        uint64_t bound = BucketUpperBound(i);
+        return bound < max() ? bound : max();
+      }
+    }
+    return max();
+  }
+
+  static uint32_t BucketIndex(uint64_t value_ns) {
+    uint64_t us = value_ns / 1000;
+    if (us == 0) {
+      return 0;
+    }
+    auto index = static_cast<uint32_t>(64 - __builtin_clzll(us));
+    return index < kBucketNum ? index : kBucketNum - 1;
+  }
+
+  static uint64_t BucketUpperBound(uint32_t index) {
+    if (index + 1 >= kBucketNum) {
+      return UINT64_MAX;
+    }
+    return (1ULL << index) * 1000;
+  }
+
+ private:
+  std::atomic<uint64_t> buckets_[kBucketNum] = {};
+  std::atomic<uint64_t> count_ = {0};
+  std::atomic<uint64_t> sum_ = {0};
+  std::atomic<uint64_t> max_ = {0};
+};
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_BASE_HISTOGRAM_H_
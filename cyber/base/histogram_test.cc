@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/base/histogram.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace base {
+
+TEST(HistogramTest, bucket) {
+  EXPECT_EQ(0, Histogram::BucketIndex(0));
+  EXPECT_EQ(0, Histogram::BucketIndex(999));
+  EXPECT_EQ(1, Histogram::BucketIndex(1000));
+  EXPECT_EQ(2, Histogram::BucketIndex(2000));
+  EXPECT_EQ(2, Histogram::BucketIndex(3999));
+  EXPECT_EQ(10, Histogram::BucketIndex(1000 * 1000));
+  EXPECT_EQ(Histogram::kBucketNum - 1, Histogram::BucketIndex(UINT64_MAX));
+
+  EXPECT_EQ(1000, Histogram::BucketUpperBound(0));
+  EXPECT_EQ(4000, Histogram::BucketUpperBound(2));
+  EXPECT_EQ(UINT64_MAX, Histogram::BucketUpperBound(Histogram::kBucketNum));
+}
+
+TEST(HistogramTest, record) {
+  Histogram hist;
+  EXPECT_EQ(0, hist.count());
+  EXPECT_EQ(0, hist.Percentile(50));
+
+  for (uint64_t i = 1; i <= 100; ++i) {
+    hist.Record(i * 1000);
+  }
+  EXPECT_EQ(100, hist.count());
+  EXPECT_EQ(5050 * 1000, hist.sum());
+  EXPECT_EQ(100 * 1000, hist.max());
+  EXPECT_EQ(1, hist.bucket(1));
+  EXPECT_EQ(2, hist.bucket(2));
+  EXPECT_EQ(0, hist.bucket(Histogram::kBucketNum));
+
+  // 50us lies in [32us, 64us)
+  EXPECT_EQ(64 * 1000, hist.Percentile(50));
+  EXPECT_EQ(100 * 1000, hist.Percentile(99));
+  EXPECT_EQ(100 * 1000, hist.Percentile(100));
+}
+
+TEST(HistogramTest, concurrent_record) {
+  Histogram hist;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&hist, i]() {
+      for (int j = 0; j < 10000; ++j) {
+        hist.Record((i + 1) * 1000);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(40000, hist.count());
+  EXPECT_EQ(4000, hist.max());
+}
+
+}  // namespace base
+}  // namespace cyber
+}  // namespace apollo
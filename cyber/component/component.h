@@ -72,6 +72,16 @@ class Component : public ComponentBase {
                const std::shared_ptr<M2>& msg2,
                const std::shared_ptr<M3>& msg3);
 
+ protected:
+  /**
+   * @brief Pick how the messages of the channels are fused, from the
+   * constructor or Init(). Component configs have no field for it, and
+   * outside of reality mode the latest messages are always paired.
+   */
+  void SetFusionConfig(const data::FusionConfig& fusion_config) {
+    fusion_config_ = fusion_config;
+  }
+
  private:
   /**
    * @brief The process logical of yours.
@@ -87,6 +97,8 @@ class Component : public ComponentBase {
                     const std::shared_ptr<M1>& msg1,
                     const std::shared_ptr<M2>& msg2,
                     const std::shared_ptr<M3>& msg3) = 0;
+
+  data::FusionConfig fusion_config_;
 };
 
 template <>
@@ -118,9 +130,21 @@ class Component<M0, M1, NullType, NullType> : public ComponentBase {
   bool Process(const std::shared_ptr<M0>& msg0,
                const std::shared_ptr<M1>& msg1);
 
+ protected:
+  /**
+   * @brief Pick how the messages of the channels are fused, from the
+   * constructor or Init(). Component configs have no field for it, and
+   * outside of reality mode the latest messages are always paired.
+   */
+  void SetFusionConfig(const data::FusionConfig& fusion_config) {
+    fusion_config_ = fusion_config;
+  }
+
  private:
   virtual bool Proc(const std::shared_ptr<M0>& msg,
                     const std::shared_ptr<M1>& msg1) = 0;
+
+  data::FusionConfig fusion_config_;
 };
 
 template <typename M0, typename M1, typename M2>
@@ -132,10 +156,22 @@ class Component<M0, M1, M2, NullType> : public ComponentBase {
   bool Process(const std::shared_ptr<M0>& msg0, const std::shared_ptr<M1>& msg1,
                const std::shared_ptr<M2>& msg2);
 
+ protected:
+  /**
+   * @brief Pick how the messages of the channels are fused, from the
+   * constructor or Init(). Component configs have no field for it, and
+   * outside of reality mode the latest messages are always paired.
+   */
+  void SetFusionConfig(const data::FusionConfig& fusion_config) {
+    fusion_config_ = fusion_config;
+  }
+
  private:
   virtual bool Proc(const std::shared_ptr<M0>& msg,
                     const std::shared_ptr<M1>& msg1,
                     const std::shared_ptr<M2>& msg2) = 0;
+
+  data::FusionConfig fusion_config_;
 };
 
 template <typename M0>
@@ -309,7 +345,8 @@ bool Component<M0, M1, NullType, NullType>::Initialize(
   for (auto& reader : readers_) {
     config_list.emplace_back(reader->ChannelId(), reader->PendingQueueSize());
   }
-  auto dv = std::make_shared<data::DataVisitor<M0, M1>>(config_list);
+  auto dv = std::make_shared<data::DataVisitor<M0, M1>>(config_list,
+                                                        fusion_config_);
   croutine::RoutineFactory factory =
       croutine::CreateRoutineFactory<M0, M1>(func, dv);
   return sched->CreateTask(factory, node_->Name());
@@ -419,7 +456,8 @@ bool Component<M0, M1, M2, NullType>::Initialize(
   for (auto& reader : readers_) {
     config_list.emplace_back(reader->ChannelId(), reader->PendingQueueSize());
   }
-  auto dv = std::make_shared<data::DataVisitor<M0, M1, M2>>(config_list);
+  auto dv = std::make_shared<data::DataVisitor<M0, M1, M2>>(
+      config_list, fusion_config_);
   croutine::RoutineFactory factory =
       croutine::CreateRoutineFactory<M0, M1, M2>(func, dv);
   return sched->CreateTask(factory, node_->Name());
@@ -542,7 +580,8 @@ bool Component<M0, M1, M2, M3>::Initialize(const ComponentConfig& config) {
   for (auto& reader : readers_) {
     config_list.emplace_back(reader->ChannelId(), reader->PendingQueueSize());
   }
-  auto dv = std::make_shared<data::DataVisitor<M0, M1, M2, M3>>(config_list);
+  auto dv = std::make_shared<data::DataVisitor<M0, M1, M2, M3>>(
+      config_list, fusion_config_);
   croutine::RoutineFactory factory =
       croutine::CreateRoutineFactory<M0, M1, M2, M3>(func, dv);
   return sched->CreateTask(factory, node_->Name());
@@ -16,11 +16,8 @@
 
 #include "cyber/croutine/croutine.h"
 
-#include <algorithm>
 #include <utility>
 
-#include "cyber/base/concurrent_object_pool.h"
-#include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
 #include "cyber/croutine/detail/routine_context.h"
 
@@ -32,9 +29,6 @@ thread_local CRoutine *CRoutine::current_routine_ = nullptr;
 thread_local char *CRoutine::main_stack_ = nullptr;
 
 namespace {
-std::shared_ptr<base::CCObjectPool<RoutineContext>> context_pool = nullptr;
-std::once_flag pool_init_flag;
-
 void CRoutineEntry(void *arg) {
   CRoutine *r = static_cast<CRoutine *>(arg);
   r->Run();
@@ -42,25 +36,13 @@ void CRoutineEntry(void *arg) {
 }
 }  // namespace
 
-CRoutine::CRoutine(const std::function<void()> &func) : func_(func) {
-  std::call_once(pool_init_flag, [&]() {
-    uint32_t routine_num = common::GlobalData::Instance()->ComponentNums();
-    auto &global_conf = common::GlobalData::Instance()->Config();
-    if (global_conf.has_scheduler_conf() &&
-        global_conf.scheduler_conf().has_routine_num()) {
-      routine_num =
-          std::max(routine_num, global_conf.scheduler_conf().routine_num());
-    }
-    context_pool.reset(new base::CCObjectPool<RoutineContext>(routine_num));
-  });
-
-  context_ = context_pool->GetObject();
-  if (context_ == nullptr) {
-    AWARN << "Maximum routine context number exceeded! Please check "
-             "[routine_num] in config file.";
-    context_.reset(new RoutineContext());
+CRoutine::CRoutine(const std::function<void()> &func, size_t stack_size)
+    : func_(func), context_(std::make_shared<RoutineContext>(stack_size)) {
+  if (!context_->Valid()) {
+    // never resumed, the scheduler drops it
+    state_ = RoutineState::FINISHED;
+    return;
   }
-
   MakeContext(CRoutineEntry, this, context_.get());
   state_ = RoutineState::READY;
   updated_.test_and_set(std::memory_order_release);
@@ -25,6 +25,7 @@
 #include <set>
 #include <string>
 
+#include "cyber/base/histogram.h"
 #include "cyber/common/log.h"
 #include "cyber/croutine/detail/routine_context.h"
 
@@ -39,7 +40,7 @@ enum class RoutineState { READY, FINISHED, SLEEP, IO_WAIT, DATA_WAIT };
 
 class CRoutine {
  public:
-  explicit CRoutine(const RoutineFunc &func);
+  explicit CRoutine(const RoutineFunc &func, size_t stack_size = STACK_SIZE);
   virtual ~CRoutine();
 
   // static interfaces
@@ -88,6 +89,22 @@ class CRoutine {
 
   std::chrono::steady_clock::time_point wake_time() const;
 
+  // Steady clock time in nanoseconds at which the routine became runnable,
+  // kept from the first wake-up until the next resume. 0 if unknown.
+  void MarkReady(uint64_t ready_time_ns);
+  uint64_t TakeReadyTime();
+
+  // False if the stack could not be allocated, the routine cannot run.
+  bool Valid() const { return context_->Valid(); }
+
+  // Size of the stack and the part of it touched so far, in bytes.
+  size_t stack_size() const { return context_->stack.size; }
+  size_t stack_high_water() const { return context_->StackHighWater(); }
+
+  // Wake-to-run latency and run time of every resume.
+  base::Histogram &wait_latency() { return wait_latency_; }
+  base::Histogram &run_time() { return run_time_; }
+
   void set_group_name(const std::string &group_name) {
     group_name_ = group_name;
   }
@@ -118,6 +135,10 @@ class CRoutine {
 
   std::string group_name_;
 
+  std::atomic<uint64_t> ready_time_ = {0};
+  base::Histogram wait_latency_;
+  base::Histogram run_time_;
+
   static thread_local CRoutine *current_routine_;
   static thread_local char *main_stack_;
 };
@@ -178,6 +199,9 @@ inline RoutineState CRoutine::UpdateState() {
   if (state_ == RoutineState::SLEEP &&
       std::chrono::steady_clock::now() > wake_time_) {
     state_ = RoutineState::READY;
+    MarkReady(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  wake_time_.time_since_epoch())
+                  .count());
     return state_;
   }
 
@@ -203,9 +227,22 @@ inline void CRoutine::Release() {
 }
 
 inline void CRoutine::SetUpdateFlag() {
+  MarkReady(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
   updated_.clear(std::memory_order_release);
 }
 
+inline void CRoutine::MarkReady(uint64_t ready_time_ns) {
+  uint64_t expected = 0;
+  ready_time_.compare_exchange_strong(expected, ready_time_ns,
+                                      std::memory_order_relaxed);
+}
+
+inline uint64_t CRoutine::TakeReadyTime() {
+  return ready_time_.exchange(0, std::memory_order_relaxed);
+}
+
 }  // namespace croutine
 }  // namespace cyber
 }  // namespace apollo
@@ -49,6 +49,26 @@ TEST(Croutine, croutinetest) {
   EXPECT_EQ(cr->Resume(), RoutineState::FINISHED);
 }
 
+TEST(Croutine, stack) {
+  std::shared_ptr<CRoutine> cr =
+      std::make_shared<CRoutine>(function, 64 * 1024);
+  EXPECT_EQ(64 * 1024, cr->stack_size());
+  size_t high_water = cr->stack_high_water();
+  EXPECT_GT(high_water, 0);
+  cr->Resume();
+  EXPECT_EQ(cr->state(), RoutineState::IO_WAIT);
+  EXPECT_GE(cr->stack_high_water(), high_water);
+  EXPECT_LE(cr->stack_high_water(), cr->stack_size());
+}
+
+TEST(Croutine, no_stack) {
+  // more than the address space, the stack cannot be mapped
+  std::shared_ptr<CRoutine> cr =
+      std::make_shared<CRoutine>(function, size_t(1) << 60);
+  EXPECT_FALSE(cr->Valid());
+  EXPECT_EQ(cr->state(), RoutineState::FINISHED);
+}
+
 }  // namespace croutine
 }  // namespace cyber
 }  // namespace apollo
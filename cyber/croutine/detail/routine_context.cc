@@ -20,6 +20,13 @@ namespace apollo {
 namespace cyber {
 namespace croutine {
 
+RoutineContext::RoutineContext(size_t size) {
+  // the stack is left empty if it cannot be mapped, see Valid()
+  StackPool::Instance()->Allocate(size, &stack);
+}
+
+RoutineContext::~RoutineContext() { StackPool::Instance()->Release(stack); }
+
 //  The stack layout looks as follows:
 //
 //              +------------------+
@@ -38,12 +45,13 @@ namespace croutine {
 // ctx->sp  =>  |        RBP       |
 //              +------------------+
 void MakeContext(const func &f1, const void *arg, RoutineContext *ctx) {
-  ctx->sp = ctx->stack + STACK_SIZE - 2 * sizeof(void *) - REGISTERS_SIZE;
+  char *top = ctx->stack.base + ctx->stack.size;
+  ctx->sp = top - 2 * sizeof(void *) - REGISTERS_SIZE;
   std::memset(ctx->sp, 0, REGISTERS_SIZE);
 #ifdef __aarch64__
-  char *sp = ctx->stack + STACK_SIZE - sizeof(void *);
+  char *sp = top - sizeof(void *);
 #else
-  char *sp = ctx->stack + STACK_SIZE - 2 * sizeof(void *);
+  char *sp = top - 2 * sizeof(void *);
 #endif
   *reinterpret_cast<void **>(sp) = reinterpret_cast<void *>(f1);
   sp -= sizeof(void *);
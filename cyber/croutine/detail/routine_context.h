@@ -22,6 +22,7 @@
 #include <iostream>
 
 #include "cyber/common/log.h"
+#include "cyber/croutine/detail/stack_pool.h"
 
 extern "C" {
 extern void ctx_swap(void**, void**) asm("ctx_swap");
@@ -31,7 +32,10 @@ namespace apollo {
 namespace cyber {
 namespace croutine {
 
+// default stack size of a croutine
 constexpr size_t STACK_SIZE = 2 * 1024 * 1024;
+// smallest configurable one, enough for logging from a croutine
+constexpr size_t MIN_STACK_SIZE = 64 * 1024;
 #if defined __aarch64__
 constexpr size_t REGISTERS_SIZE = 160;
 #else
@@ -40,13 +44,22 @@ constexpr size_t REGISTERS_SIZE = 56;
 
 typedef void (*func)(void*);
 struct RoutineContext {
-  char stack[STACK_SIZE];
+  explicit RoutineContext(size_t size = STACK_SIZE);
+  ~RoutineContext();
+
+  // false if the stack could not be allocated
+  bool Valid() const { return stack.base != nullptr; }
+
+  // bytes of the stack used so far, at page granularity
+  size_t StackHighWater() const { return StackPool::HighWater(stack); }
+
+  RoutineStack stack;
   char* sp = nullptr;
-#if defined __aarch64__
-} __attribute__((aligned(16)));
-#else
+
+ private:
+  RoutineContext(const RoutineContext&) = delete;
+  RoutineContext& operator=(const RoutineContext&) = delete;
 };
-#endif
 
 void MakeContext(const func& f1, const void* arg, RoutineContext* ctx);
 
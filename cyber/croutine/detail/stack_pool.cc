@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/croutine/detail/stack_pool.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+const size_t StackPool::kMaxFreeStacks = 64;
+
+StackPool::StackPool() {}
+
+size_t StackPool::PageSize() {
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+}
+
+bool StackPool::Allocate(size_t size, RoutineStack* stack) {
+  const size_t page_size = PageSize();
+  size = std::max((size + page_size - 1) / page_size * page_size, page_size);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& stacks = free_stacks_[size];
+    if (!stacks.empty()) {
+      *stack = stacks.back();
+      stacks.pop_back();
+      return true;
+    }
+  }
+
+  void* addr = mmap(nullptr, size + page_size, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (addr == MAP_FAILED) {
+    AERROR << "map croutine stack failed, size: " << size
+           << ", errno: " << errno;
+    return false;
+  }
+  if (mprotect(addr, page_size, PROT_NONE) != 0) {
+    AERROR << "protect croutine stack guard page failed, errno: " << errno;
+    munmap(addr, size + page_size);
+    return false;
+  }
+  stack->base = static_cast<char*>(addr) + page_size;
+  stack->size = size;
+  return true;
+}
+
+void StackPool::Release(const RoutineStack& stack) {
+  if (stack.base == nullptr) {
+    return;
+  }
+  // drop the touched pages, the next routine starts from zeroed ones
+  if (madvise(stack.base, stack.size, MADV_DONTNEED) != 0) {
+    AWARN << "madvise croutine stack failed, errno: " << errno;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& stacks = free_stacks_[stack.size];
+    if (stacks.size() < kMaxFreeStacks) {
+      stacks.push_back(stack);
+      return;
+    }
+  }
+  Unmap(stack);
+}
+
+size_t StackPool::FreeStackNum() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t num = 0;
+  for (const auto& item : free_stacks_) {
+    num += item.second.size();
+  }
+  return num;
+}
+
+void StackPool::Unmap(const RoutineStack& stack) {
+  const size_t page_size = PageSize();
+  munmap(stack.base - page_size, stack.size + page_size);
+}
+
+size_t StackPool::HighWater(const RoutineStack& stack) {
+  const size_t page_size = PageSize();
+  size_t page_num = stack.size / page_size;
+  std::vector<unsigned char> resident(page_num);
+  if (page_num == 0 || mincore(stack.base, stack.size, resident.data()) != 0) {
+    return 0;
+  }
+  // the stack grows down, so the lowest resident page marks the deepest use
+  for (size_t i = 0; i < page_num; ++i) {
+    if (resident[i] & 1) {
+      return (page_num - i) * page_size;
+    }
+  }
+  return 0;
+}
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_CROUTINE_DETAIL_STACK_POOL_H_
+#define CYBER_CROUTINE_DETAIL_STACK_POOL_H_
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+// Usable stack memory is [base, base + size), the guard page lies right
+// below base, where an overflowing stack runs into it.
+struct RoutineStack {
+  char* base = nullptr;
+  size_t size = 0;
+};
+
+/**
+ * @class StackPool
+ * @brief Hands out croutine stacks mapped with a guard page and recycles the
+ * released ones by size.
+ *
+ * Stacks are mapped without reserving swap and their pages are returned to
+ * the kernel on release, so a stack only costs the memory its routine
+ * actually touched.
+ */
+class StackPool {
+ public:
+  /**
+   * @brief Get a stack of at least size bytes, rounded up to whole pages.
+   *
+   * @return false if the stack cannot be mapped
+   */
+  bool Allocate(size_t size, RoutineStack* stack);
+  void Release(const RoutineStack& stack);
+
+  /**
+   * @brief Bytes of the stack touched so far, counted from its top, at page
+   * granularity.
+   */
+  static size_t HighWater(const RoutineStack& stack);
+
+  size_t FreeStackNum();
+
+ private:
+  static size_t PageSize();
+  void Unmap(const RoutineStack& stack);
+
+  std::mutex mutex_;
+  std::unordered_map<size_t, std::vector<RoutineStack>> free_stacks_;
+
+  // released stacks kept per size, the others are unmapped
+  static const size_t kMaxFreeStacks;
+
+  DECLARE_SINGLETON(StackPool)
+};
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_CROUTINE_DETAIL_STACK_POOL_H_
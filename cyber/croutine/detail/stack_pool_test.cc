@@ -0,0 +1,73 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/croutine/detail/stack_pool.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace croutine {
+
+const size_t kPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+TEST(StackPoolTest, AllocateAndRecycle) {
+  auto pool = StackPool::Instance();
+  RoutineStack stack;
+  ASSERT_TRUE(pool->Allocate(10 * kPageSize - 1, &stack));
+  EXPECT_NE(nullptr, stack.base);
+  EXPECT_EQ(10 * kPageSize, stack.size);
+  EXPECT_EQ(0, StackPool::HighWater(stack));
+
+  // touch the top three pages, as a routine using them would
+  std::memset(stack.base + stack.size - 3 * kPageSize, 1, 3 * kPageSize);
+  EXPECT_EQ(3 * kPageSize, StackPool::HighWater(stack));
+
+  size_t free_num = pool->FreeStackNum();
+  char* base = stack.base;
+  pool->Release(stack);
+  EXPECT_EQ(free_num + 1, pool->FreeStackNum());
+
+  // a stack of the same size comes back from the pool, with its pages
+  // dropped
+  RoutineStack recycled;
+  ASSERT_TRUE(pool->Allocate(10 * kPageSize, &recycled));
+  EXPECT_EQ(base, recycled.base);
+  EXPECT_EQ(free_num, pool->FreeStackNum());
+  EXPECT_EQ(0, StackPool::HighWater(recycled));
+  EXPECT_EQ(0, recycled.base[recycled.size - 1]);
+  pool->Release(recycled);
+
+  RoutineStack other;
+  ASSERT_TRUE(pool->Allocate(4 * kPageSize, &other));
+  EXPECT_NE(base, other.base);
+  pool->Release(other);
+}
+
+TEST(StackPoolDeathTest, GuardPage) {
+  RoutineStack stack;
+  ASSERT_TRUE(StackPool::Instance()->Allocate(4 * kPageSize, &stack));
+  stack.base[0] = 1;
+  EXPECT_DEATH(*(stack.base - 1) = 1, "");
+  StackPool::Instance()->Release(stack);
+}
+
+}  // namespace croutine
+}  // namespace cyber
+}  // namespace apollo
@@ -17,8 +17,11 @@
 #ifndef CYBER_CROUTINE_ROUTINE_FACTORY_H_
 #define CYBER_CROUTINE_ROUTINE_FACTORY_H_
 
+#include <chrono>
+#include <limits>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
@@ -47,6 +50,19 @@ class RoutineFactory {
   std::shared_ptr<data::DataVisitorBase> data_visitor_ = nullptr;
 };
 
+/**
+ * @brief When a batched routine hands its messages over.
+ *
+ * A batch is delivered once it holds max_batch_size messages, or once
+ * max_latency_us passed since its first message was fetched. With the
+ * default max_latency_us of 0, every wake-up delivers what is buffered.
+ */
+struct BatchPolicy {
+  // 0 for no limit besides the pending queue size of the reader
+  uint32_t max_batch_size = 0;
+  uint64_t max_latency_us = 0;
+};
+
 template <typename M0, typename F>
 RoutineFactory CreateRoutineFactory(
     F&& f, const std::shared_ptr<data::DataVisitor<M0>>& dv) {
@@ -69,6 +85,56 @@ RoutineFactory CreateRoutineFactory(
   return factory;
 }
 
+/**
+ * @brief Calls f with all the messages buffered since its last call, so a
+ * high rate channel costs one switch to the routine per batch instead of one
+ * per message. f takes a const std::vector<std::shared_ptr<M0>>&.
+ *
+ * While a batch is not full and younger than the latency, the routine
+ * sleeps until the latency is reached and then takes whatever arrived
+ * meanwhile.
+ */
+template <typename M0, typename F>
+RoutineFactory CreateBatchRoutineFactory(
+    F&& f, const std::shared_ptr<data::DataVisitor<M0>>& dv,
+    const BatchPolicy& policy) {
+  RoutineFactory factory;
+  factory.SetDataVisitor(dv);
+  uint64_t max_size = policy.max_batch_size > 0
+                          ? policy.max_batch_size
+                          : std::numeric_limits<uint64_t>::max();
+  auto max_latency = std::chrono::microseconds(policy.max_latency_us);
+  factory.create_routine = [=]() {
+    return [=]() {
+      std::vector<std::shared_ptr<M0>> msgs;
+      std::chrono::steady_clock::time_point deadline;
+      for (;;) {
+        CRoutine::GetCurrentRoutine()->set_state(RoutineState::DATA_WAIT);
+        bool first = msgs.empty();
+        if (!dv->TryFetchBatch(max_size - msgs.size(), &msgs)) {
+          if (msgs.empty()) {
+            CRoutine::Yield();
+            continue;
+          }
+        } else if (first) {
+          deadline = std::chrono::steady_clock::now() + max_latency;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (msgs.size() < max_size && now < deadline) {
+          CRoutine::GetCurrentRoutine()->Sleep(
+              std::chrono::duration_cast<Duration>(deadline - now) +
+              Duration(1));
+          continue;
+        }
+        f(msgs);
+        msgs.clear();
+        CRoutine::Yield(RoutineState::READY);
+      }
+    };
+  };
+  return factory;
+}
+
 template <typename M0, typename M1, typename F>
 RoutineFactory CreateRoutineFactory(
     F&& f, const std::shared_ptr<data::DataVisitor<M0, M1>>& dv) {
@@ -17,15 +17,29 @@
 #ifndef CYBER_DATA_CACHE_BUFFER_H_
 #define CYBER_DATA_CACHE_BUFFER_H_
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <vector>
+#include <utility>
+
+#include "cyber/base/macros.h"
 
 namespace apollo {
 namespace cyber {
 namespace data {
 
+/**
+ * @brief Ring buffer between the dispatcher, which fills it, and the readers
+ * of a channel.
+ *
+ * Writers are serialized by Mutex(). Readers do not take it: they copy
+ * elements with Read(), which only locks the slot being copied. Every slot
+ * is tagged with the position it holds, so a reader which fell behind
+ * notices when its slot has been overwritten instead of reading a newer
+ * element.
+ */
 template <typename T>
 class CacheBuffer {
  public:
@@ -35,30 +49,40 @@ class CacheBuffer {
 
   explicit CacheBuffer(uint64_t size) {
     capacity_ = size + 1;
-    buffer_.resize(capacity_);
+    slots_.reset(new Slot[capacity_]);
   }
 
   CacheBuffer(const CacheBuffer& rhs) {
     std::lock_guard<std::mutex> lg(rhs.mutex_);
-    head_ = rhs.head_;
-    tail_ = rhs.tail_;
-    buffer_ = rhs.buffer_;
+    head_.store(rhs.head_.load());
+    tail_.store(rhs.tail_.load());
     capacity_ = rhs.capacity_;
+    slots_.reset(new Slot[capacity_]);
+    for (uint64_t i = 0; i < capacity_; ++i) {
+      slots_[i].pos = rhs.slots_[i].pos;
+      slots_[i].value = rhs.slots_[i].value;
+    }
     fusion_callback_ = rhs.fusion_callback_;
   }
 
-  T& operator[](const uint64_t& pos) { return buffer_[GetIndex(pos)]; }
-  const T& at(const uint64_t& pos) const { return buffer_[GetIndex(pos)]; }
+  // Unsynchronized element access, for the writer side or under Mutex().
+  T& operator[](const uint64_t& pos) { return slots_[GetIndex(pos)].value; }
+  const T& at(const uint64_t& pos) const {
+    return slots_[GetIndex(pos)].value;
+  }
 
-  uint64_t Head() const { return head_ + 1; }
-  uint64_t Tail() const { return tail_; }
-  uint64_t Size() const { return tail_ - head_; }
+  uint64_t Head() const { return head_.load(std::memory_order_acquire) + 1; }
+  uint64_t Tail() const { return tail_.load(std::memory_order_acquire); }
+  uint64_t Size() const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+  }
 
-  const T& Front() const { return buffer_[GetIndex(head_ + 1)]; }
-  const T& Back() const { return buffer_[GetIndex(tail_)]; }
+  const T& Front() const { return at(Head()); }
+  const T& Back() const { return at(Tail()); }
 
-  bool Empty() const { return tail_ == 0; }
-  bool Full() const { return capacity_ - 1 == tail_ - head_; }
+  bool Empty() const { return Tail() == 0; }
+  bool Full() const { return capacity_ - 1 == Size(); }
   uint64_t Capacity() const { return capacity_; }
 
   void SetFusionCallback(const FusionCallback& callback) {
@@ -68,28 +92,74 @@ class CacheBuffer {
   void Fill(const T& value) {
     if (fusion_callback_) {
       fusion_callback_(value);
-    } else {
-      if (Full()) {
-        buffer_[GetIndex(head_)] = value;
-        ++head_;
-        ++tail_;
-      } else {
-        buffer_[GetIndex(tail_ + 1)] = value;
-        ++tail_;
-      }
+      return;
+    }
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    // the slot of head is the spare one, no reader is meant to read it
+    Store(tail + 1, value);
+    if (tail - head == capacity_ - 1) {
+      head_.store(head + 1, std::memory_order_release);
+    }
+    tail_.store(tail + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Copy the element at pos, safe against a concurrent Fill.
+   *
+   * @return false if pos has not been filled yet or was overwritten
+   */
+  bool Read(uint64_t pos, T* value) const {
+    const Slot& slot = slots_[GetIndex(pos)];
+    SlotLock lock(&slot);
+    if (slot.pos != pos) {
+      return false;
     }
+    *value = slot.value;
+    return true;
   }
 
   std::mutex& Mutex() { return mutex_; }
 
  private:
+  struct Slot {
+    mutable std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    // position of the element held, none before the first Fill
+    uint64_t pos = UINT64_MAX;
+    T value;
+  };
+
+  class SlotLock {
+   public:
+    explicit SlotLock(const Slot* slot) : slot_(slot) {
+      while (slot_->lock.test_and_set(std::memory_order_acquire)) {
+        cpu_relax();
+      }
+    }
+    ~SlotLock() { slot_->lock.clear(std::memory_order_release); }
+
+   private:
+    const Slot* slot_;
+  };
+
   CacheBuffer& operator=(const CacheBuffer& other) = delete;
   uint64_t GetIndex(const uint64_t& pos) const { return pos % capacity_; }
 
-  uint64_t head_ = 0;
-  uint64_t tail_ = 0;
+  // Put value at pos and hand back the element it replaces, so that it is
+  // released outside of the slot lock.
+  T Store(uint64_t pos, const T& value) {
+    Slot& slot = slots_[GetIndex(pos)];
+    T copy = value;
+    SlotLock lock(&slot);
+    std::swap(slot.value, copy);
+    slot.pos = pos;
+    return copy;
+  }
+
+  std::atomic<uint64_t> head_ = {0};
+  std::atomic<uint64_t> tail_ = {0};
   uint64_t capacity_ = 0;
-  std::vector<T> buffer_;
+  std::unique_ptr<Slot[]> slots_;
   mutable std::mutex mutex_;
   FusionCallback fusion_callback_;
 };
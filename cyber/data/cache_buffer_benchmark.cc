@@ -0,0 +1,155 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares reading channel buffers through the buffer mutex, as readers did
+// before, with the slot-locked reads, and the dispatcher fan-out with a
+// mutex-guarded buffer map.
+//
+// bazel run //cyber/data:cache_buffer_benchmark
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/util.h"
+#include "cyber/data/data_dispatcher.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+using Buffer = CacheBuffer<std::shared_ptr<int>>;
+
+// Fills the buffer as the dispatcher does, until stopped.
+class Writer {
+ public:
+  explicit Writer(Buffer* buffer) {
+    thread_ = std::thread([this, buffer]() {
+      auto msg = std::make_shared<int>(0);
+      while (!stop_.load()) {
+        std::lock_guard<std::mutex> lock(buffer->Mutex());
+        buffer->Fill(msg);
+      }
+    });
+  }
+  ~Writer() {
+    stop_.store(true);
+    thread_.join();
+  }
+
+ private:
+  std::atomic<bool> stop_ = {false};
+  std::thread thread_;
+};
+
+std::shared_ptr<Buffer> shared_buffer;
+std::unique_ptr<Writer> writer;
+
+void SetUp(const benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_buffer.reset(new Buffer(64));
+    writer.reset(new Writer(shared_buffer.get()));
+  }
+}
+
+void TearDown(const benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    writer.reset();
+    shared_buffer.reset();
+  }
+}
+
+// The latest message read under the buffer mutex, like Latest() did.
+void BM_LatestLocked(benchmark::State& state) {
+  std::shared_ptr<int> msg;
+  for (auto _ : state) {
+    std::lock_guard<std::mutex> lock(shared_buffer->Mutex());
+    if (!shared_buffer->Empty()) {
+      msg = shared_buffer->Back();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LatestLocked)
+    ->ThreadRange(1, 8)
+    ->Setup(SetUp)
+    ->Teardown(TearDown);
+
+// The same with slot-locked reads, as ChannelBuffer::Latest() does now.
+void BM_Latest(benchmark::State& state) {
+  std::shared_ptr<int> msg;
+  for (auto _ : state) {
+    uint64_t tail = shared_buffer->Tail();
+    while (tail > 0 && !shared_buffer->Read(tail, &msg)) {
+      tail = shared_buffer->Tail();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Latest)->ThreadRange(1, 8)->Setup(SetUp)->Teardown(TearDown);
+
+// Fan-out of one message to the readers of a channel through a map guarded
+// by a mutex, against the dispatcher.
+void BM_DispatchLocked(benchmark::State& state) {
+  std::mutex mutex;
+  std::unordered_map<uint64_t, std::vector<std::weak_ptr<Buffer>>> map;
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  for (int i = 0; i < state.range(0); ++i) {
+    buffers.emplace_back(new Buffer(10));
+    map[1].emplace_back(buffers.back());
+  }
+  auto msg = std::make_shared<int>(0);
+  for (auto _ : state) {
+    std::lock_guard<std::mutex> map_lock(mutex);
+    for (auto& buffer_wptr : map[1]) {
+      if (auto buffer = buffer_wptr.lock()) {
+        std::lock_guard<std::mutex> lock(buffer->Mutex());
+        buffer->Fill(msg);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DispatchLocked)->Arg(1)->Arg(4)->Arg(16);
+
+void BM_Dispatch(benchmark::State& state) {
+  auto channel_id =
+      common::Hash("/benchmark/" + std::to_string(state.range(0)));
+  auto dispatcher = DataDispatcher<int>::Instance();
+  std::vector<ChannelBuffer<int>> buffers;
+  for (int i = 0; i < state.range(0); ++i) {
+    buffers.emplace_back(channel_id, new Buffer(10));
+    dispatcher->AddBuffer(buffers.back());
+  }
+  auto msg = std::make_shared<int>(0);
+  for (auto _ : state) {
+    dispatcher->Dispatch(channel_id, msg);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Dispatch)->Arg(1)->Arg(4)->Arg(16);
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
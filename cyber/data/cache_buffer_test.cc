@@ -16,6 +16,7 @@
 
 #include "cyber/data/cache_buffer.h"
 
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <utility>
@@ -52,6 +53,44 @@ TEST(CacheBufferTest, cache_buffer_test) {
   EXPECT_TRUE(buffer1.Full());
 }
 
+TEST(CacheBufferTest, read) {
+  CacheBuffer<int> buffer(2);
+  int value = 0;
+  EXPECT_FALSE(buffer.Read(1, &value));
+  buffer.Fill(1);
+  EXPECT_TRUE(buffer.Read(1, &value));
+  EXPECT_EQ(1, value);
+  EXPECT_FALSE(buffer.Read(2, &value));
+
+  buffer.Fill(2);
+  buffer.Fill(3);
+  buffer.Fill(4);
+  // position 1 has been overwritten by 4 which shares its slot
+  EXPECT_FALSE(buffer.Read(1, &value));
+  EXPECT_TRUE(buffer.Read(4, &value));
+  EXPECT_EQ(4, value);
+}
+
+TEST(CacheBufferTest, concurrent_read) {
+  CacheBuffer<std::shared_ptr<uint64_t>> buffer(4);
+  const uint64_t kFillNum = 100000;
+  std::thread writer([&buffer, kFillNum]() {
+    for (uint64_t i = 1; i <= kFillNum; ++i) {
+      std::lock_guard<std::mutex> lock(buffer.Mutex());
+      buffer.Fill(std::make_shared<uint64_t>(i));
+    }
+  });
+  std::shared_ptr<uint64_t> value;
+  while (buffer.Tail() < kFillNum) {
+    uint64_t tail = buffer.Tail();
+    // an element read back is always the one filled at its position
+    if (tail > 0 && buffer.Read(tail, &value)) {
+      EXPECT_EQ(tail, *value);
+    }
+  }
+  writer.join();
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
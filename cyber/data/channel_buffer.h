@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "cyber/common/global_data.h"
@@ -45,6 +46,16 @@ class ChannelBuffer {
 
   bool FetchMulti(uint64_t fetch_size, std::vector<std::shared_ptr<T>>* vec);
 
+  /**
+   * @brief Append up to fetch_size messages to vec, starting at the position
+   * *index and moving it past the last one fetched. An index of 0 starts at
+   * the oldest message of the buffer.
+   *
+   * @return true if any message was appended
+   */
+  bool FetchMulti(uint64_t* index, uint64_t fetch_size,
+                  std::vector<std::shared_ptr<T>>* vec);
+
   uint64_t channel_id() const { return channel_id_; }
   std::shared_ptr<BufferType> Buffer() const { return buffer_; }
 
@@ -56,54 +67,96 @@ class ChannelBuffer {
 template <typename T>
 bool ChannelBuffer<T>::Fetch(uint64_t* index,
                              std::shared_ptr<T>& m) {  // NOLINT
-  std::lock_guard<std::mutex> lock(buffer_->Mutex());
-  if (buffer_->Empty()) {
+  uint64_t tail = buffer_->Tail();
+  if (tail == 0) {
     return false;
   }
 
   if (*index == 0) {
-    *index = buffer_->Tail();
-  } else if (*index == buffer_->Tail() + 1) {
+    *index = tail;
+  } else if (*index == tail + 1) {
     return false;
-  } else if (*index < buffer_->Head()) {
-    auto interval = buffer_->Tail() - *index;
+  }
+  // fall back to the latest element once the writer has overtaken the reader,
+  // which may also happen between the checks and the copy
+  while (*index < buffer_->Head() || !buffer_->Read(*index, &m)) {
+    tail = buffer_->Tail();
+    auto interval = tail - *index;
     AWARN << "channel[" << GlobalData::GetChannelById(channel_id_) << "] "
           << "read buffer overflow, drop_message[" << interval << "] pre_index["
-          << *index << "] current_index[" << buffer_->Tail() << "] ";
-    *index = buffer_->Tail();
+          << *index << "] current_index[" << tail << "] ";
+    *index = tail;
   }
-  m = buffer_->at(*index);
   return true;
 }
 
 template <typename T>
 bool ChannelBuffer<T>::Latest(std::shared_ptr<T>& m) {  // NOLINT
-  std::lock_guard<std::mutex> lock(buffer_->Mutex());
-  if (buffer_->Empty()) {
-    return false;
+  while (true) {
+    uint64_t tail = buffer_->Tail();
+    if (tail == 0) {
+      return false;
+    }
+    if (buffer_->Read(tail, &m)) {
+      return true;
+    }
   }
-
-  m = buffer_->Back();
-  return true;
 }
 
 template <typename T>
 bool ChannelBuffer<T>::FetchMulti(uint64_t fetch_size,
                                   std::vector<std::shared_ptr<T>>* vec) {
-  std::lock_guard<std::mutex> lock(buffer_->Mutex());
-  if (buffer_->Empty()) {
+  uint64_t tail = buffer_->Tail();
+  if (tail == 0) {
     return false;
   }
 
-  auto num = std::min(buffer_->Size(), fetch_size);
+  auto num = std::min({tail, buffer_->Capacity() - 1, fetch_size});
   vec->reserve(num);
-  for (auto index = buffer_->Tail() - num + 1; index <= buffer_->Tail();
-       ++index) {
-    vec->emplace_back(buffer_->at(index));
+  std::shared_ptr<T> m;
+  for (auto index = tail - num + 1; index <= tail; ++index) {
+    // skip the oldest ones if the writer overwrote them meanwhile
+    if (buffer_->Read(index, &m)) {
+      vec->emplace_back(std::move(m));
+    }
   }
   return true;
 }
 
+template <typename T>
+bool ChannelBuffer<T>::FetchMulti(uint64_t* index, uint64_t fetch_size,
+                                  std::vector<std::shared_ptr<T>>* vec) {
+  uint64_t tail = buffer_->Tail();
+  if (tail == 0 || *index == tail + 1) {
+    return false;
+  }
+
+  if (*index == 0) {
+    *index = buffer_->Head();
+  }
+  uint64_t num = 0;
+  std::shared_ptr<T> m;
+  for (; num < fetch_size && *index <= tail; ++*index) {
+    auto head = buffer_->Head();
+    if (*index < head) {
+      AWARN << "channel[" << GlobalData::GetChannelById(channel_id_) << "] "
+            << "read buffer overflow, drop_message[" << head - *index
+            << "] pre_index[" << *index << "] current_index[" << head
+            << "] ";
+      *index = head;
+      if (*index > tail) {
+        break;
+      }
+    }
+    // the writer may overwrite the element between the check and the copy
+    if (buffer_->Read(*index, &m)) {
+      vec->emplace_back(std::move(m));
+      ++num;
+    }
+  }
+  return num > 0;
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
@@ -17,6 +17,8 @@
 #include "cyber/data/channel_buffer.h"
 
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include "gtest/gtest.h"
 
@@ -97,6 +99,62 @@ TEST(ChannelBufferTest, FetchMulti) {
   EXPECT_EQ(2, *vector[1]);
 }
 
+TEST(ChannelBufferTest, FetchMultiFromIndex) {
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(4);
+  auto buffer = std::make_shared<ChannelBuffer<int>>(channel0, cache_buffer);
+  std::vector<std::shared_ptr<int>> vector;
+  uint64_t index = 0;
+  EXPECT_FALSE(buffer->FetchMulti(&index, 8, &vector));
+  for (int i = 1; i <= 3; ++i) {
+    buffer->Buffer()->Fill(std::make_shared<int>(i));
+  }
+  // starts at the oldest message, appends and stops at fetch_size
+  EXPECT_TRUE(buffer->FetchMulti(&index, 2, &vector));
+  ASSERT_EQ(2, vector.size());
+  EXPECT_EQ(1, *vector[0]);
+  EXPECT_EQ(2, *vector[1]);
+  EXPECT_TRUE(buffer->FetchMulti(&index, 2, &vector));
+  ASSERT_EQ(3, vector.size());
+  EXPECT_EQ(3, *vector[2]);
+  EXPECT_FALSE(buffer->FetchMulti(&index, 2, &vector));
+
+  // the overwritten ones are skipped
+  vector.clear();
+  for (int i = 4; i <= 9; ++i) {
+    buffer->Buffer()->Fill(std::make_shared<int>(i));
+  }
+  EXPECT_TRUE(buffer->FetchMulti(&index, 8, &vector));
+  ASSERT_EQ(4, vector.size());
+  EXPECT_EQ(6, *vector[0]);
+  EXPECT_EQ(9, *vector[3]);
+  EXPECT_FALSE(buffer->FetchMulti(&index, 8, &vector));
+}
+
+TEST(ChannelBufferTest, ConcurrentFetch) {
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(8);
+  auto buffer = std::make_shared<ChannelBuffer<int>>(channel0, cache_buffer);
+  const int kFillNum = 10000;
+  std::thread writer([&buffer, kFillNum]() {
+    for (int i = 1; i <= kFillNum; ++i) {
+      std::lock_guard<std::mutex> lock(buffer->Buffer()->Mutex());
+      buffer->Buffer()->Fill(std::make_shared<int>(i));
+    }
+  });
+  // messages may be dropped when the reader falls behind, but never reorder
+  std::shared_ptr<int> msg;
+  uint64_t index = 0;
+  int last = 0;
+  while (last < kFillNum) {
+    if (buffer->Fetch(&index, msg)) {
+      EXPECT_EQ(index, static_cast<uint64_t>(*msg));
+      EXPECT_LT(last, *msg);
+      last = *msg;
+      ++index;
+    }
+  }
+  writer.join();
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 #include "cyber/common/log.h"
@@ -46,9 +47,17 @@ class DataDispatcher {
   bool Dispatch(const uint64_t channel_id, const std::shared_ptr<T>& msg);
 
  private:
+  // The buffers of one channel, read-copy-update style: Dispatch takes a
+  // snapshot of the current vector, AddBuffer publishes an extended copy.
+  // A replaced vector is freed once the last Dispatch using it is done.
+  struct ChannelBuffers {
+    std::shared_ptr<const BufferVector> current;
+  };
+
   DataNotifier* notifier_ = DataNotifier::Instance();
   std::mutex buffers_map_mutex_;
-  AtomicHashMap<uint64_t, BufferVector> buffers_map_;
+  // an entry is never replaced once set, so readers may keep the pointer
+  AtomicHashMap<uint64_t, std::shared_ptr<ChannelBuffers>> buffers_map_;
 
   DECLARE_SINGLETON(DataDispatcher)
 };
@@ -59,24 +68,41 @@ inline DataDispatcher<T>::DataDispatcher() {}
 template <typename T>
 void DataDispatcher<T>::AddBuffer(const ChannelBuffer<T>& channel_buffer) {
   std::lock_guard<std::mutex> lock(buffers_map_mutex_);
-  auto buffer = channel_buffer.Buffer();
-  BufferVector* buffers = nullptr;
-  if (buffers_map_.Get(channel_buffer.channel_id(), &buffers)) {
-    buffers->emplace_back(buffer);
+  std::shared_ptr<ChannelBuffers>* entry = nullptr;
+  std::shared_ptr<ChannelBuffers> buffers;
+  if (buffers_map_.Get(channel_buffer.channel_id(), &entry)) {
+    buffers = *entry;
   } else {
-    BufferVector new_buffers = {buffer};
-    buffers_map_.Set(channel_buffer.channel_id(), new_buffers);
+    buffers = std::make_shared<ChannelBuffers>();
+  }
+
+  auto new_buffers = std::make_shared<BufferVector>();
+  if (auto current = std::atomic_load(&buffers->current)) {
+    // drop the buffers of readers which are gone on the way
+    for (const auto& buffer_wptr : *current) {
+      if (!buffer_wptr.expired()) {
+        new_buffers->emplace_back(buffer_wptr);
+      }
+    }
+  }
+  new_buffers->emplace_back(channel_buffer.Buffer());
+  std::shared_ptr<const BufferVector> published = std::move(new_buffers);
+  std::atomic_store(&buffers->current, published);
+
+  if (entry == nullptr) {
+    buffers_map_.Set(channel_buffer.channel_id(), buffers);
   }
 }
 
 template <typename T>
 bool DataDispatcher<T>::Dispatch(const uint64_t channel_id,
                                  const std::shared_ptr<T>& msg) {
-  BufferVector* buffers = nullptr;
+  std::shared_ptr<ChannelBuffers>* entry = nullptr;
   if (apollo::cyber::IsShutdown()) {
     return false;
   }
-  if (buffers_map_.Get(channel_id, &buffers)) {
+  if (buffers_map_.Get(channel_id, &entry)) {
+    auto buffers = std::atomic_load(&(*entry)->current);
     for (auto& buffer_wptr : *buffers) {
       if (auto buffer = buffer_wptr.lock()) {
         std::lock_guard<std::mutex> lock(buffer->Mutex());
@@ -16,7 +16,9 @@
 
 #include "cyber/data/data_dispatcher.h"
 
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <vector>
 #include "gtest/gtest.h"
 
@@ -57,6 +59,37 @@ TEST(DataDispatcher, Dispatch) {
   EXPECT_TRUE(dispatcher->Dispatch(channel0, msg));
 }
 
+TEST(DataDispatcher, AddBufferWhileDispatching) {
+  auto channel2 = common::Hash("/channel2");
+  auto dispatcher = DataDispatcher<int>::Instance();
+  auto notifier = std::make_shared<Notifier>();
+  DataNotifier::Instance()->AddNotifier(channel2, notifier);
+  auto cache_buffer = new CacheBuffer<std::shared_ptr<int>>(10);
+  auto buffer = ChannelBuffer<int>(channel2, cache_buffer);
+  dispatcher->AddBuffer(buffer);
+
+  // readers come and go while messages are dispatched, the vectors of
+  // buffers they replace are freed on the way
+  std::atomic<bool> done = {false};
+  std::thread reader_thread([channel2, &done] {
+    for (int i = 0; i < 1000; ++i) {
+      auto reader_buffer = ChannelBuffer<int>(
+          channel2, new CacheBuffer<std::shared_ptr<int>>(1));
+      DataDispatcher<int>::Instance()->AddBuffer(reader_buffer);
+    }
+    done = true;
+  });
+  auto msg = std::make_shared<int>(1);
+  uint64_t dispatch_num = 0;
+  while (!done) {
+    EXPECT_TRUE(dispatcher->Dispatch(channel2, msg));
+    ++dispatch_num;
+  }
+  reader_thread.join();
+  EXPECT_TRUE(dispatcher->Dispatch(channel2, msg));
+  EXPECT_EQ(dispatch_num + 1, cache_buffer->Tail());
+}
+
 }  // namespace data
 }  // namespace cyber
 }  // namespace apollo
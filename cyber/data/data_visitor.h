@@ -27,6 +27,7 @@
 #include "cyber/data/data_dispatcher.h"
 #include "cyber/data/data_visitor_base.h"
 #include "cyber/data/fusion/all_latest.h"
+#include "cyber/data/fusion/approximate_time.h"
 #include "cyber/data/fusion/data_fusion.h"
 
 namespace apollo {
@@ -40,6 +41,20 @@ struct VisitorConfig {
   uint32_t queue_size;
 };
 
+enum class FusionPolicy {
+  // the primary message with the latest message of each other channel
+  ALL_LATEST,
+  // the primary message with the closest message in time of each other
+  // channel, see fusion::ApproximateTime
+  APPROXIMATE_TIME,
+};
+
+struct FusionConfig {
+  FusionPolicy policy = FusionPolicy::ALL_LATEST;
+  // how far apart in time APPROXIMATE_TIME fuses messages
+  uint64_t time_tolerance_ns = 0;
+};
+
 template <typename T>
 using BufferType = CacheBuffer<std::shared_ptr<T>>;
 
@@ -47,7 +62,8 @@ template <typename M0, typename M1 = NullType, typename M2 = NullType,
           typename M3 = NullType>
 class DataVisitor : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(const std::vector<VisitorConfig>& configs,
+                       const FusionConfig& fusion_config = FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -61,8 +77,18 @@ class DataVisitor : public DataVisitorBase {
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
     DataDispatcher<M3>::Instance()->AddBuffer(buffer_m3_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
-        buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    if (fusion_config.policy == FusionPolicy::APPROXIMATE_TIME) {
+      data_fusion_ = new fusion::ApproximateTime<M0, M1, M2, M3>(
+          buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_,
+          fusion_config.time_tolerance_ns);
+      // waiting primary messages may be fused when the others arrive
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m2_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m3_.channel_id(), notifier_);
+    } else {
+      data_fusion_ = new fusion::AllLatest<M0, M1, M2, M3>(
+          buffer_m0_, buffer_m1_, buffer_m2_, buffer_m3_);
+    }
   }
 
   ~DataVisitor() {
@@ -92,7 +118,8 @@ class DataVisitor : public DataVisitorBase {
 template <typename M0, typename M1, typename M2>
 class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(const std::vector<VisitorConfig>& configs,
+                       const FusionConfig& fusion_config = FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -103,8 +130,16 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     DataDispatcher<M2>::Instance()->AddBuffer(buffer_m2_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ =
-        new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_, buffer_m2_);
+    if (fusion_config.policy == FusionPolicy::APPROXIMATE_TIME) {
+      data_fusion_ = new fusion::ApproximateTime<M0, M1, M2>(
+          buffer_m0_, buffer_m1_, buffer_m2_, fusion_config.time_tolerance_ns);
+      // waiting primary messages may be fused when the others arrive
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+      data_notifier_->AddNotifier(buffer_m2_.channel_id(), notifier_);
+    } else {
+      data_fusion_ = new fusion::AllLatest<M0, M1, M2>(buffer_m0_, buffer_m1_,
+                                                       buffer_m2_);
+    }
   }
 
   ~DataVisitor() {
@@ -133,7 +168,8 @@ class DataVisitor<M0, M1, M2, NullType> : public DataVisitorBase {
 template <typename M0, typename M1>
 class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
  public:
-  explicit DataVisitor(const std::vector<VisitorConfig>& configs)
+  explicit DataVisitor(const std::vector<VisitorConfig>& configs,
+                       const FusionConfig& fusion_config = FusionConfig())
       : buffer_m0_(configs[0].channel_id,
                    new BufferType<M0>(configs[0].queue_size)),
         buffer_m1_(configs[1].channel_id,
@@ -141,7 +177,14 @@ class DataVisitor<M0, M1, NullType, NullType> : public DataVisitorBase {
     DataDispatcher<M0>::Instance()->AddBuffer(buffer_m0_);
     DataDispatcher<M1>::Instance()->AddBuffer(buffer_m1_);
     data_notifier_->AddNotifier(buffer_m0_.channel_id(), notifier_);
-    data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
+    if (fusion_config.policy == FusionPolicy::APPROXIMATE_TIME) {
+      data_fusion_ = new fusion::ApproximateTime<M0, M1>(
+          buffer_m0_, buffer_m1_, fusion_config.time_tolerance_ns);
+      // waiting primary messages may be fused when the others arrive
+      data_notifier_->AddNotifier(buffer_m1_.channel_id(), notifier_);
+    } else {
+      data_fusion_ = new fusion::AllLatest<M0, M1>(buffer_m0_, buffer_m1_);
+    }
   }
 
   ~DataVisitor() {
@@ -188,6 +231,15 @@ class DataVisitor<M0, NullType, NullType, NullType> : public DataVisitorBase {
     return false;
   }
 
+  /**
+   * @brief Append up to max_size of the messages not fetched yet to msgs.
+   * A visitor uses either TryFetch or TryFetchBatch.
+   */
+  bool TryFetchBatch(uint64_t max_size,
+                     std::vector<std::shared_ptr<M0>>* msgs) {
+    return buffer_.FetchMulti(&next_msg_index_, max_size, msgs);
+  }
+
  private:
   ChannelBuffer<M0> buffer_;
 };
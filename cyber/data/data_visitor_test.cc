@@ -71,6 +71,20 @@ TEST(DataVisitorTest, one_channel) {
   EXPECT_FALSE(dv->TryFetch(msg));
 }
 
+TEST(DataVisitorTest, one_channel_batch) {
+  auto channel0 = str_hash("/channel_batch");
+  auto dv = std::make_shared<DataVisitor<RawMessage>>(channel0, 10);
+
+  std::vector<std::shared_ptr<RawMessage>> msgs;
+  EXPECT_FALSE(dv->TryFetchBatch(4, &msgs));
+  DispatchMessage(channel0, 6);
+  EXPECT_TRUE(dv->TryFetchBatch(4, &msgs));
+  EXPECT_EQ(4, msgs.size());
+  EXPECT_TRUE(dv->TryFetchBatch(4, &msgs));
+  EXPECT_EQ(6, msgs.size());
+  EXPECT_FALSE(dv->TryFetchBatch(4, &msgs));
+}
+
 TEST(DataVisitorTest, two_channel) {
   auto dv =
       std::make_shared<DataVisitor<RawMessage, RawMessage>>(InitConfigs(2));
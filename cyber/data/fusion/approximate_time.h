@@ -0,0 +1,478 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
+#define CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/log.h"
+#include "cyber/common/types.h"
+#include "cyber/data/cache_buffer.h"
+#include "cyber/data/channel_buffer.h"
+#include "cyber/data/fusion/data_fusion.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+namespace fusion {
+
+/**
+ * @brief Timestamp in nanoseconds ApproximateTime aligns messages by, read
+ * from header().timestamp_sec(). Specialize it for messages which carry
+ * their time elsewhere.
+ */
+template <typename T, typename = void>
+struct MessageTime {
+  static bool Get(const T&, uint64_t*) { return false; }
+};
+
+template <typename T>
+struct MessageTime<
+    T, decltype(void(std::declval<const T&>().header().timestamp_sec()))> {
+  static bool Get(const T& msg, uint64_t* timestamp_ns) {
+    *timestamp_ns = static_cast<uint64_t>(msg.header().timestamp_sec() * 1e9);
+    return true;
+  }
+};
+
+enum class MatchResult {
+  // the closest message is within tolerance
+  MATCHED,
+  // the closest message is out of tolerance
+  MISSED,
+  // no message at or after the timestamp yet, a closer one may still come
+  PENDING,
+};
+
+/**
+ * @brief Finds the message of a channel closest in time to the messages of
+ * the primary channel, which come in time order.
+ *
+ * The closest message is known once the channel has one at or after the
+ * timestamp, until then the match is pending. The messages of the channel
+ * are in time order in its ring too, so the search resumes at the position
+ * of the last match, and stops at the first message not older than the
+ * timestamp.
+ */
+template <typename T>
+class TimeMatcher {
+ public:
+  explicit TimeMatcher(const ChannelBuffer<T>& buffer) : buffer_(buffer) {}
+
+  MatchResult Match(uint64_t timestamp_ns, uint64_t tolerance_ns,
+                    std::shared_ptr<T>* m) {
+    auto cache = buffer_.Buffer();
+    uint64_t tail = cache->Tail();
+    if (tail == 0) {
+      return MatchResult::PENDING;
+    }
+
+    std::shared_ptr<T> msg;
+    std::shared_ptr<T> best;
+    uint64_t best_pos = 0;
+    uint64_t best_diff = UINT64_MAX;
+    bool settled = false;
+    for (uint64_t pos = std::max(cursor_, cache->Head()); pos <= tail; ++pos) {
+      // skip the ones overwritten meanwhile
+      if (!cache->Read(pos, &msg)) {
+        continue;
+      }
+      uint64_t msg_time = 0;
+      if (!MessageTime<T>::Get(*msg, &msg_time)) {
+        AERROR_EVERY(100) << "channel["
+                          << GlobalData::GetChannelById(buffer_.channel_id())
+                          << "] has no message time to align on.";
+        return MatchResult::MISSED;
+      }
+      uint64_t diff = msg_time > timestamp_ns ? msg_time - timestamp_ns
+                                              : timestamp_ns - msg_time;
+      if (diff <= best_diff) {
+        best_diff = diff;
+        best_pos = pos;
+        best = std::move(msg);
+      }
+      if (msg_time >= timestamp_ns) {
+        settled = true;
+        break;
+      }
+    }
+    if (best == nullptr) {
+      return MatchResult::PENDING;
+    }
+    // older messages are even farther from the next timestamps
+    cursor_ = best_pos;
+    if (!settled) {
+      return MatchResult::PENDING;
+    }
+    if (best_diff > tolerance_ns) {
+      return MatchResult::MISSED;
+    }
+    *m = std::move(best);
+    return MatchResult::MATCHED;
+  }
+
+ private:
+  ChannelBuffer<T> buffer_;
+  uint64_t cursor_ = 0;
+};
+
+/**
+ * @brief Primary messages waiting for the other channels, oldest first, in
+ * a fixed ring. When it is full the oldest one is dropped.
+ */
+template <typename T>
+class PendingQueue {
+ public:
+  explicit PendingQueue(uint64_t size)
+      : slots_(std::max<uint64_t>(size, 1)) {}
+
+  // Returns false if the oldest message was dropped to make room.
+  bool Push(const std::shared_ptr<T>& msg, uint64_t timestamp_ns) {
+    bool dropped = false;
+    if (size_ == slots_.size()) {
+      Pop();
+      dropped = true;
+    }
+    Slot& slot = slots_[(head_ + size_) % slots_.size()];
+    slot.msg = msg;
+    slot.timestamp_ns = timestamp_ns;
+    ++size_;
+    return !dropped;
+  }
+
+  bool Front(std::shared_ptr<T>* msg, uint64_t* timestamp_ns) const {
+    if (size_ == 0) {
+      return false;
+    }
+    *msg = slots_[head_].msg;
+    *timestamp_ns = slots_[head_].timestamp_ns;
+    return true;
+  }
+
+  void Pop() {
+    slots_[head_].msg.reset();
+    head_ = (head_ + 1) % slots_.size();
+    --size_;
+  }
+
+ private:
+  struct Slot {
+    std::shared_ptr<T> msg;
+    uint64_t timestamp_ns = 0;
+  };
+
+  std::vector<Slot> slots_;
+  uint64_t head_ = 0;
+  uint64_t size_ = 0;
+};
+
+/**
+ * @brief Ring of fused tuples, stored in place so that a fusion does not
+ * allocate.
+ */
+template <typename T>
+class FusionBuffer {
+ public:
+  explicit FusionBuffer(uint64_t size) : buffer_(size) {}
+
+  void Fill(const T& value) {
+    std::lock_guard<std::mutex> lg(buffer_.Mutex());
+    buffer_.Fill(value);
+  }
+
+  bool Fetch(uint64_t* index, T* value) {
+    uint64_t tail = buffer_.Tail();
+    if (tail == 0) {
+      return false;
+    }
+    if (*index == 0) {
+      *index = tail;
+    } else if (*index == tail + 1) {
+      return false;
+    }
+    // fall back to the latest tuple once the fusion has overtaken the reader
+    while (*index < buffer_.Head() || !buffer_.Read(*index, value)) {
+      *index = buffer_.Tail();
+    }
+    return true;
+  }
+
+ private:
+  CacheBuffer<T> buffer_;
+};
+
+/**
+ * @class ApproximateTime
+ * @brief Fuses every message of the primary channel M0 with the message of
+ * each other channel closest to it in time, if all of them are within
+ * tolerance_ns. Otherwise the primary message is skipped.
+ *
+ * A primary message waits until every other channel has a message at or
+ * after its time, since a closer one may still come until then. Waiting
+ * messages are fused when a primary message arrives or when Fusion() is
+ * called, so the reader should be notified of the messages of the other
+ * channels too, as DataVisitor does. At most as many primary messages as the
+ * primary channel buffers wait, the oldest ones are dropped beyond that.
+ * Messages are aligned by MessageTime.
+ */
+template <typename M0, typename M1 = NullType, typename M2 = NullType,
+          typename M3 = NullType>
+class ApproximateTime : public DataFusion<M0, M1, M2, M3> {
+  using FusionDataType = std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>,
+                                    std::shared_ptr<M2>, std::shared_ptr<M3>>;
+
+ public:
+  ApproximateTime(const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<M1>& buffer_1,
+                  const ChannelBuffer<M2>& buffer_2,
+                  const ChannelBuffer<M3>& buffer_3, uint64_t tolerance_ns)
+      : buffer_m0_(buffer_0),
+        matcher_m1_(buffer_1),
+        matcher_m2_(buffer_2),
+        matcher_m3_(buffer_3),
+        tolerance_ns_(tolerance_ns),
+        pending_(buffer_0.Buffer()->Capacity() - uint64_t(1)),
+        buffer_fusion_(buffer_0.Buffer()->Capacity() - uint64_t(1)) {
+    buffer_m0_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M0>& m0) { AddPrimary(m0); });
+  }
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,
+              std::shared_ptr<M2>& m2, std::shared_ptr<M3>& m3) override {
+    FuseReady();
+    FusionDataType fusion_data;
+    if (!buffer_fusion_.Fetch(index, &fusion_data)) {
+      return false;
+    }
+    std::tie(m0, m1, m2, m3) = std::move(fusion_data);
+    return true;
+  }
+
+ private:
+  void AddPrimary(const std::shared_ptr<M0>& m0) {
+    uint64_t timestamp = 0;
+    if (!MessageTime<M0>::Get(*m0, &timestamp)) {
+      AERROR_EVERY(100) << "primary message has no time to align on.";
+      return;
+    }
+    std::lock_guard<std::mutex> lg(pending_mutex_);
+    if (!pending_.Push(m0, timestamp)) {
+      AWARN_EVERY(100) << "drop a primary message which waited too long.";
+    }
+    FuseReadyLocked();
+  }
+
+  void FuseReady() {
+    std::lock_guard<std::mutex> lg(pending_mutex_);
+    FuseReadyLocked();
+  }
+
+  void FuseReadyLocked() {
+    std::shared_ptr<M0> m0;
+    uint64_t timestamp = 0;
+    while (pending_.Front(&m0, &timestamp)) {
+      std::shared_ptr<M1> m1;
+      std::shared_ptr<M2> m2;
+      std::shared_ptr<M3> m3;
+      MatchResult result = matcher_m1_.Match(timestamp, tolerance_ns_, &m1);
+      if (result == MatchResult::MATCHED) {
+        result = matcher_m2_.Match(timestamp, tolerance_ns_, &m2);
+      }
+      if (result == MatchResult::MATCHED) {
+        result = matcher_m3_.Match(timestamp, tolerance_ns_, &m3);
+      }
+      if (result == MatchResult::PENDING) {
+        return;
+      }
+      pending_.Pop();
+      if (result == MatchResult::MATCHED) {
+        buffer_fusion_.Fill(FusionDataType(m0, m1, m2, m3));
+      }
+    }
+  }
+
+  ChannelBuffer<M0> buffer_m0_;
+  TimeMatcher<M1> matcher_m1_;
+  TimeMatcher<M2> matcher_m2_;
+  TimeMatcher<M3> matcher_m3_;
+  const uint64_t tolerance_ns_;
+  std::mutex pending_mutex_;
+  PendingQueue<M0> pending_;
+  FusionBuffer<FusionDataType> buffer_fusion_;
+};
+
+template <typename M0, typename M1, typename M2>
+class ApproximateTime<M0, M1, M2, NullType> : public DataFusion<M0, M1, M2> {
+  using FusionDataType =
+      std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>, std::shared_ptr<M2>>;
+
+ public:
+  ApproximateTime(const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<M1>& buffer_1,
+                  const ChannelBuffer<M2>& buffer_2, uint64_t tolerance_ns)
+      : buffer_m0_(buffer_0),
+        matcher_m1_(buffer_1),
+        matcher_m2_(buffer_2),
+        tolerance_ns_(tolerance_ns),
+        pending_(buffer_0.Buffer()->Capacity() - uint64_t(1)),
+        buffer_fusion_(buffer_0.Buffer()->Capacity() - uint64_t(1)) {
+    buffer_m0_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M0>& m0) { AddPrimary(m0); });
+  }
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0, std::shared_ptr<M1>& m1,
+              std::shared_ptr<M2>& m2) override {
+    FuseReady();
+    FusionDataType fusion_data;
+    if (!buffer_fusion_.Fetch(index, &fusion_data)) {
+      return false;
+    }
+    std::tie(m0, m1, m2) = std::move(fusion_data);
+    return true;
+  }
+
+ private:
+  void AddPrimary(const std::shared_ptr<M0>& m0) {
+    uint64_t timestamp = 0;
+    if (!MessageTime<M0>::Get(*m0, &timestamp)) {
+      AERROR_EVERY(100) << "primary message has no time to align on.";
+      return;
+    }
+    std::lock_guard<std::mutex> lg(pending_mutex_);
+    if (!pending_.Push(m0, timestamp)) {
+      AWARN_EVERY(100) << "drop a primary message which waited too long.";
+    }
+    FuseReadyLocked();
+  }
+
+  void FuseReady() {
+    std::lock_guard<std::mutex> lg(pending_mutex_);
+    FuseReadyLocked();
+  }
+
+  void FuseReadyLocked() {
+    std::shared_ptr<M0> m0;
+    uint64_t timestamp = 0;
+    while (pending_.Front(&m0, &timestamp)) {
+      std::shared_ptr<M1> m1;
+      std::shared_ptr<M2> m2;
+      MatchResult result = matcher_m1_.Match(timestamp, tolerance_ns_, &m1);
+      if (result == MatchResult::MATCHED) {
+        result = matcher_m2_.Match(timestamp, tolerance_ns_, &m2);
+      }
+      if (result == MatchResult::PENDING) {
+        return;
+      }
+      pending_.Pop();
+      if (result == MatchResult::MATCHED) {
+        buffer_fusion_.Fill(FusionDataType(m0, m1, m2));
+      }
+    }
+  }
+
+  ChannelBuffer<M0> buffer_m0_;
+  TimeMatcher<M1> matcher_m1_;
+  TimeMatcher<M2> matcher_m2_;
+  const uint64_t tolerance_ns_;
+  std::mutex pending_mutex_;
+  PendingQueue<M0> pending_;
+  FusionBuffer<FusionDataType> buffer_fusion_;
+};
+
+template <typename M0, typename M1>
+class ApproximateTime<M0, M1, NullType, NullType> : public DataFusion<M0, M1> {
+  using FusionDataType = std::tuple<std::shared_ptr<M0>, std::shared_ptr<M1>>;
+
+ public:
+  ApproximateTime(const ChannelBuffer<M0>& buffer_0,
+                  const ChannelBuffer<M1>& buffer_1, uint64_t tolerance_ns)
+      : buffer_m0_(buffer_0),
+        matcher_m1_(buffer_1),
+        tolerance_ns_(tolerance_ns),
+        pending_(buffer_0.Buffer()->Capacity() - uint64_t(1)),
+        buffer_fusion_(buffer_0.Buffer()->Capacity() - uint64_t(1)) {
+    buffer_m0_.Buffer()->SetFusionCallback(
+        [this](const std::shared_ptr<M0>& m0) { AddPrimary(m0); });
+  }
+
+  bool Fusion(uint64_t* index, std::shared_ptr<M0>& m0,
+              std::shared_ptr<M1>& m1) override {
+    FuseReady();
+    FusionDataType fusion_data;
+    if (!buffer_fusion_.Fetch(index, &fusion_data)) {
+      return false;
+    }
+    std::tie(m0, m1) = std::move(fusion_data);
+    return true;
+  }
+
+ private:
+  void AddPrimary(const std::shared_ptr<M0>& m0) {
+    uint64_t timestamp = 0;
+    if (!MessageTime<M0>::Get(*m0, &timestamp)) {
+      AERROR_EVERY(100) << "primary message has no time to align on.";
+      return;
+    }
+    std::lock_guard<std::mutex> lg(pending_mutex_);
+    if (!pending_.Push(m0, timestamp)) {
+      AWARN_EVERY(100) << "drop a primary message which waited too long.";
+    }
+    FuseReadyLocked();
+  }
+
+  void FuseReady() {
+    std::lock_guard<std::mutex> lg(pending_mutex_);
+    FuseReadyLocked();
+  }
+
+  void FuseReadyLocked() {
+    std::shared_ptr<M0> m0;
+    uint64_t timestamp = 0;
+    while (pending_.Front(&m0, &timestamp)) {
+      std::shared_ptr<M1> m1;
+      MatchResult result = matcher_m1_.Match(timestamp, tolerance_ns_, &m1);
+      if (result == MatchResult::PENDING) {
+        return;
+      }
+      pending_.Pop();
+      if (result == MatchResult::MATCHED) {
+        buffer_fusion_.Fill(FusionDataType(m0, m1));
+      }
+    }
+  }
+
+  ChannelBuffer<M0> buffer_m0_;
+  TimeMatcher<M1> matcher_m1_;
+  const uint64_t tolerance_ns_;
+  std::mutex pending_mutex_;
+  PendingQueue<M0> pending_;
+  FusionBuffer<FusionDataType> buffer_fusion_;
+};
+
+}  // namespace fusion
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_DATA_FUSION_APPROXIMATE_TIME_H_
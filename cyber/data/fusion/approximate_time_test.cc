@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright 2019 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/data/fusion/approximate_time.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "cyber/message/raw_message.h"
+
+namespace apollo {
+namespace cyber {
+namespace data {
+
+using apollo::cyber::message::RawMessage;
+
+struct Header {
+  double timestamp_sec() const { return timestamp; }
+  double timestamp = 0.0;
+};
+
+struct StampedMessage {
+  StampedMessage(const std::string& name, double timestamp) : name(name) {
+    stamp.timestamp = timestamp;
+  }
+  const Header& header() const { return stamp; }
+  std::string name;
+  Header stamp;
+};
+
+using Buffer = CacheBuffer<std::shared_ptr<StampedMessage>>;
+
+void Fill(Buffer* cache, const std::string& name, double timestamp) {
+  cache->Fill(std::make_shared<StampedMessage>(name, timestamp));
+}
+
+TEST(ApproximateTimeTest, message_time) {
+  uint64_t timestamp = 0;
+  EXPECT_TRUE(
+      fusion::MessageTime<StampedMessage>::Get({"m", 1.5}, &timestamp));
+  EXPECT_EQ(1500000000, timestamp);
+  EXPECT_FALSE(fusion::MessageTime<RawMessage>::Get(RawMessage(), &timestamp));
+}
+
+TEST(ApproximateTimeTest, two_channels) {
+  auto cache0 = new Buffer(10);
+  auto cache1 = new Buffer(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  uint64_t index = 0;
+  // 30ms tolerance
+  fusion::ApproximateTime<StampedMessage, StampedMessage> fusion(
+      buffer0, buffer1, 30000000);
+
+  // nothing to pair with yet
+  Fill(cache0, "0-0", 1.0);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  // the closest in time, not the latest, and 0-0 is out of tolerance
+  Fill(cache1, "1-0", 1.05);
+  Fill(cache1, "1-1", 1.10);
+  Fill(cache1, "1-2", 1.15);
+  Fill(cache0, "0-1", 1.11);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_EQ("0-1", m0->name);
+  EXPECT_EQ("1-1", m1->name);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  // waits for a newer message of the channel, which may be closer
+  Fill(cache1, "1-3", 1.19);
+  Fill(cache0, "0-2", 1.20);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  Fill(cache1, "1-4", 1.201);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_EQ("0-2", m0->name);
+  EXPECT_EQ("1-4", m1->name);
+
+  // out of tolerance on both sides
+  Fill(cache0, "0-3", 1.30);
+  Fill(cache1, "1-5", 1.40);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+
+  // the closest message was older after all
+  Fill(cache1, "1-6", 1.50);
+  Fill(cache0, "0-4", 1.51);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  Fill(cache1, "1-7", 1.60);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  index++;
+  EXPECT_EQ("0-4", m0->name);
+  EXPECT_EQ("1-6", m1->name);
+}
+
+TEST(ApproximateTimeTest, three_channels) {
+  auto cache0 = new Buffer(10);
+  auto cache1 = new Buffer(10);
+  auto cache2 = new Buffer(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  ChannelBuffer<StampedMessage> buffer2(2, cache2);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  std::shared_ptr<StampedMessage> m2;
+  uint64_t index = 0;
+  fusion::ApproximateTime<StampedMessage, StampedMessage, StampedMessage>
+      fusion(buffer0, buffer1, buffer2, 10000000);
+
+  Fill(cache1, "1-0", 2.000);
+  Fill(cache2, "2-0", 1.980);
+  Fill(cache0, "0-0", 2.001);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+  // waits for every channel
+  Fill(cache2, "2-1", 2.005);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+  Fill(cache1, "1-1", 2.004);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2));
+  index++;
+  EXPECT_EQ("0-0", m0->name);
+  EXPECT_EQ("1-0", m1->name);
+  EXPECT_EQ("2-1", m2->name);
+
+  // the third channel is too far
+  Fill(cache1, "1-2", 2.050);
+  Fill(cache2, "2-2", 2.100);
+  Fill(cache0, "0-1", 2.050);
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1, m2));
+}
+
+TEST(ApproximateTimeTest, pending_overflow) {
+  auto cache0 = new Buffer(2);
+  auto cache1 = new Buffer(10);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  uint64_t index = 0;
+  fusion::ApproximateTime<StampedMessage, StampedMessage> fusion(
+      buffer0, buffer1, 100000000);
+
+  // as many primary messages as the channel buffers wait
+  Fill(cache0, "0-0", 1.0);
+  Fill(cache0, "0-1", 1.1);
+  Fill(cache0, "0-2", 1.2);
+  Fill(cache1, "1-0", 1.15);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  EXPECT_EQ("0-1", m0->name);
+  EXPECT_EQ("1-0", m1->name);
+  index++;
+  EXPECT_FALSE(fusion.Fusion(&index, m0, m1));
+  Fill(cache1, "1-1", 1.26);
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1));
+  EXPECT_EQ("0-2", m0->name);
+  EXPECT_EQ("1-0", m1->name);
+}
+
+TEST(ApproximateTimeTest, four_channels_overflow) {
+  auto cache0 = new Buffer(4);
+  auto cache1 = new Buffer(4);
+  auto cache2 = new Buffer(4);
+  auto cache3 = new Buffer(4);
+  ChannelBuffer<StampedMessage> buffer0(0, cache0);
+  ChannelBuffer<StampedMessage> buffer1(1, cache1);
+  ChannelBuffer<StampedMessage> buffer2(2, cache2);
+  ChannelBuffer<StampedMessage> buffer3(3, cache3);
+  std::shared_ptr<StampedMessage> m0;
+  std::shared_ptr<StampedMessage> m1;
+  std::shared_ptr<StampedMessage> m2;
+  std::shared_ptr<StampedMessage> m3;
+  uint64_t index = 0;
+  fusion::ApproximateTime<StampedMessage, StampedMessage, StampedMessage,
+                          StampedMessage>
+      fusion(buffer0, buffer1, buffer2, buffer3, 5000000);
+
+  for (int i = 0; i < 20; ++i) {
+    double timestamp = 3.0 + i * 0.1;
+    std::string seq = std::to_string(i);
+    Fill(cache1, "1-" + seq, timestamp);
+    Fill(cache2, "2-" + seq, timestamp + 0.001);
+    Fill(cache3, "3-" + seq, timestamp + 0.002);
+    Fill(cache0, "0-" + seq, timestamp);
+  }
+  // a new reader starts at the latest fusion
+  EXPECT_TRUE(fusion.Fusion(&index, m0, m1, m2, m3));
+  EXPECT_EQ("0-19", m0->name);
+  EXPECT_EQ("1-19", m1->name);
+  EXPECT_EQ("2-19", m2->name);
+  EXPECT_EQ("3-19", m3->name);
+}
+
+}  // namespace data
+}  // namespace cyber
+}  // namespace apollo
@@ -17,11 +17,14 @@
 #include "cyber/logger/async_logger.h"
 
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <thread>
 #include <unordered_map>
 
 #include "cyber/base/macros.h"
+#include "cyber/common/log.h"
+#include "cyber/logger/deferred_log.h"
 #include "cyber/logger/log_file_object.h"
 #include "cyber/logger/logger_util.h"
 
@@ -30,15 +33,66 @@ namespace cyber {
 namespace logger {
 
 static std::unordered_map<std::string, LogFileObject*> moduleLoggerMap;
-static std::unordered_map<char, int> log_level_map = {
-    {'F', 3}, {'E', 2}, {'W', 1}, {'I', 0}};
 
-AsyncLogger::AsyncLogger(google::base::Logger* wrapped) : wrapped_(wrapped) {
-  active_buf_.reset(new std::deque<Msg>());
-  flushing_buf_.reset(new std::deque<Msg>());
+std::atomic<AsyncLogger*> AsyncLogger::running_logger_ = {nullptr};
+
+namespace {
+
+const uint32_t kDefaultRingSizeKb = 256;
+
+// What precedes the message bytes in a text record.
+struct TextHeader {
+  time_t ts;
+  int32_t level;
+};
+
+int32_t LogLevel(char severity) {
+  switch (severity) {
+    case 'F':
+      return 3;
+    case 'E':
+      return 2;
+    case 'W':
+      return 1;
+    default:
+      return 0;
+  }
 }
 
+uint64_t NextLoggerId() {
+  static std::atomic<uint64_t> id = {0};
+  return ++id;
+}
+
+uint32_t RingCapacity() {
+  const char* size_kb = std::getenv("cyber_log_ring_size_kb");
+  uint32_t kb = size_kb == nullptr
+                    ? kDefaultRingSizeKb
+                    : static_cast<uint32_t>(std::strtoul(size_kb, nullptr, 10));
+  return (kb > 0 ? kb : kDefaultRingSizeKb) * 1024;
+}
+
+// The ring a thread writes to, released when the thread exits.
+struct ThreadRingHolder {
+  uint64_t logger_id = 0;
+  std::shared_ptr<LogRing> ring;
+  ~ThreadRingHolder() {
+    if (ring != nullptr) {
+      ring->Release();
+    }
+  }
+};
+
+thread_local ThreadRingHolder thread_ring;
+
+}  // namespace
+
+AsyncLogger::AsyncLogger(google::base::Logger* wrapped)
+    : wrapped_(wrapped), id_(NextLoggerId()), ring_capacity_(RingCapacity()) {}
+
 AsyncLogger::~AsyncLogger() {
+  AsyncLogger* self = this;
+  running_logger_.compare_exchange_strong(self, nullptr);
   for (auto& logger : moduleLoggerMap) {
     delete logger.second;
   }
@@ -48,6 +102,7 @@ AsyncLogger::~AsyncLogger() {
 void AsyncLogger::Start() {
   CHECK_EQ(state_.load(std::memory_order_acquire), INITTED);
   state_.store(RUNNING, std::memory_order_release);
+  running_logger_.store(this, std::memory_order_release);
   log_thread_ = std::thread(&AsyncLogger::RunThread, this);
   // std::cout << "Async Logger Start!" << std::endl;
 }
@@ -55,16 +110,56 @@ void AsyncLogger::Start() {
 void AsyncLogger::Stop() {
   CHECK_EQ(state_.load(std::memory_order_acquire), RUNNING);
   state_.store(STOPPED, std::memory_order_release);
+  AsyncLogger* self = this;
+  running_logger_.compare_exchange_strong(self, nullptr);
   if (log_thread_.joinable()) {
     log_thread_.join();
   }
 
-  FlushBuffer(active_buf_);
-  CHECK(active_buf_->empty());
-  CHECK(flushing_buf_->empty());
+  Drain();
   // std::cout << "Async Logger Stop!" << std::endl;
 }
 
+LogRing* AsyncLogger::ThreadRing() {
+  if (cyber_likely(thread_ring.logger_id == id_)) {
+    return thread_ring.ring.get();
+  }
+  if (state_.load(std::memory_order_acquire) != RUNNING) {
+    return nullptr;
+  }
+  if (thread_ring.ring != nullptr) {
+    thread_ring.ring->Release();
+    thread_ring.ring.reset();
+  }
+  std::lock_guard<std::mutex> lock(rings_mutex_);
+  thread_ring.logger_id = id_;
+  int num = ring_num_.load(std::memory_order_relaxed);
+  for (int i = 0; i < num; ++i) {
+    if (rings_[i]->TryAcquire()) {
+      thread_ring.ring = rings_[i];
+      return thread_ring.ring.get();
+    }
+  }
+  // the thread stays without a ring, its messages are dropped
+  if (num == kMaxRings) {
+    return nullptr;
+  }
+  rings_[num] = std::make_shared<LogRing>(ring_capacity_);
+  rings_[num]->TryAcquire();
+  ring_num_.store(num + 1, std::memory_order_release);
+  thread_ring.ring = rings_[num];
+  return thread_ring.ring.get();
+}
+
+uint64_t AsyncLogger::DropCount() {
+  uint64_t count = drop_count_.load(std::memory_order_relaxed);
+  int num = ring_num_.load(std::memory_order_acquire);
+  for (int i = 0; i < num; ++i) {
+    count += rings_[i]->DropNum();
+  }
+  return count;
+}
+
 void AsyncLogger::Write(bool force_flush, time_t timestamp, const char* message,
                         int message_len) {
   (void)force_flush;
@@ -72,13 +167,20 @@ void AsyncLogger::Write(bool force_flush, time_t timestamp, const char* message,
     // std::cout << "Async Logger not running!" << std::endl;
     return;
   }
-  auto msg_str = std::string(message, message_len);
-  while (flag_.test_and_set(std::memory_order_acquire)) {
-    cpu_relax();
+  LogRing* ring = ThreadRing();
+  if (cyber_unlikely(ring == nullptr)) {
+    drop_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  char* record = ring->Reserve(
+      static_cast<uint32_t>(sizeof(TextHeader) + message_len));
+  if (record == nullptr) {
+    return;
   }
-  active_buf_->emplace_back(timestamp, std::move(msg_str),
-                            log_level_map[message[0]]);
-  flag_.clear(std::memory_order_release);
+  TextHeader header = {timestamp, LogLevel(message[0])};
+  std::memcpy(record, &header, sizeof(header));
+  std::memcpy(record + sizeof(header), message, message_len);
+  ring->Commit(kTextRecord);
 }
 
 void AsyncLogger::Flush() {
@@ -91,44 +193,74 @@ uint32_t AsyncLogger::LogSize() { return wrapped_->LogSize(); }
 
 void AsyncLogger::RunThread() {
   while (state_ == RUNNING) {
-    while (flag_.test_and_set(std::memory_order_acquire)) {
-      cpu_relax();
-    }
-    active_buf_.swap(flushing_buf_);
-    flag_.clear(std::memory_order_release);
-    FlushBuffer(flushing_buf_);
-    if (active_buf_->size() < 800) {
+    if (Drain() < 800) {
       std::this_thread::sleep_for(std::chrono::milliseconds(1));
     }
+    uint64_t drop_count = DropCount();
+    if (cyber_unlikely(drop_count != reported_drop_count_)) {
+      AWARN << "async logger dropped " << drop_count - reported_drop_count_
+            << " log messages, total " << drop_count;
+      reported_drop_count_ = drop_count;
+    }
   }
 }
 
-void AsyncLogger::FlushBuffer(const std::unique_ptr<std::deque<Msg>>& buffer) {
-  std::string module_name = "";
-  while (!buffer->empty()) {
-    auto& msg = buffer->front();
-    FindModuleName(&(msg.message), &module_name);
-
-    LogFileObject* fileobject = nullptr;
-    if (moduleLoggerMap.find(module_name) != moduleLoggerMap.end()) {
-      fileobject = moduleLoggerMap[module_name];
+uint64_t AsyncLogger::Drain() {
+  std::string module_name;
+  std::string message;
+  uint64_t num = 0;
+  auto write = [&](uint32_t kind, const char* record, uint32_t size) {
+    time_t ts = 0;
+    int level = 0;
+    module_name.clear();
+    if (kind == kTextRecord) {
+      TextHeader header;
+      std::memcpy(&header, record, sizeof(header));
+      ts = header.ts;
+      level = header.level;
+      message.assign(record + sizeof(header), size - sizeof(header));
+      FindModuleName(&message, &module_name);
+    } else if (kind == kDeferredRecord) {
+      deferred::FormatRecord(record, size, &module_name, &message, &ts,
+                             &level);
     } else {
-      std::string file_name = module_name + ".log.INFO.";
-      if (!FLAGS_log_dir.empty()) {
-        file_name = FLAGS_log_dir + "/" + file_name;
-      }
-      fileobject = new LogFileObject(google::INFO, file_name.c_str());
-      fileobject->SetSymlinkBasename(module_name.c_str());
-      moduleLoggerMap[module_name] = fileobject;
+      return;
     }
-    if (fileobject) {
-      const bool force_flush = msg.level > 0;
-      fileobject->Write(force_flush, msg.ts, msg.message.data(),
-                        static_cast<int>(msg.message.size()));
+    WriteToModule(&module_name, level, ts, message);
+  };
+  int ring_num = ring_num_.load(std::memory_order_acquire);
+  for (int i = 0; i < ring_num; ++i) {
+    num += rings_[i]->Consume(write);
+  }
+  if (num > 0) {
+    flush_count_.fetch_add(1, std::memory_order_relaxed);
+    Flush();
+  }
+  return num;
+}
+
+void AsyncLogger::WriteToModule(std::string* module_name, int level,
+                                time_t timestamp, const std::string& message) {
+  if (module_name->empty()) {
+    CHECK_NOTNULL(common::GlobalData::Instance());
+    *module_name = common::GlobalData::Instance()->ProcessGroup();
+  }
+  LogFileObject* fileobject = nullptr;
+  auto it = moduleLoggerMap.find(*module_name);
+  if (it != moduleLoggerMap.end()) {
+    fileobject = it->second;
+  } else {
+    std::string file_name = *module_name + ".log.INFO.";
+    if (!FLAGS_log_dir.empty()) {
+      file_name = FLAGS_log_dir + "/" + file_name;
     }
-    buffer->pop_front();
+    fileobject = new LogFileObject(google::INFO, file_name.c_str());
+    fileobject->SetSymlinkBasename(module_name->c_str());
+    moduleLoggerMap[*module_name] = fileobject;
   }
-  Flush();
+  const bool force_flush = level > 0;
+  fileobject->Write(force_flush, timestamp, message.data(),
+                    static_cast<int>(message.size()));
 }
 
 }  // namespace logger
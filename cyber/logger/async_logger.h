@@ -21,16 +21,14 @@
 #include <condition_variable>
 #include <cstdint>
 #include <ctime>
-#include <deque>
 #include <iostream>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
-#include <utility>
-#include <vector>
 
 #include "cyber/common/macros.h"
+#include "cyber/logger/log_ring.h"
 #include "glog/logging.h"
 
 namespace apollo {
@@ -42,16 +40,16 @@ namespace logger {
  * @brief .
  * Wrapper for a glog Logger which asynchronously writes log messages.
  * This class starts a new thread responsible for forwarding the messages
- * to the logger, and performs double buffering. Writers append to the
- * current buffer and then wake up the logger thread. The logger swaps in
- * a new buffer and writes any accumulated messages to the wrapped
- * Logger.
+ * to the logger. Every thread that logs owns a lock-free ring (LogRing) the
+ * logger thread drains, so writers never wait for each other nor for the
+ * logger thread. Messages of the deferred macros (see deferred_log.h) are
+ * stored unformatted and only turned into text on the logger thread.
  *
- * This double-buffering design dramatically improves performance, especially
- * for logging messages which require flushing the underlying file (i.e WARNING
- * and above for default). The flush can take a couple of milliseconds, and in
- * some cases can even block for hundreds of milliseconds or more. With the
- * double-buffered approach, threads can proceed with useful work while the IO
+ * This design dramatically improves performance, especially for logging
+ * messages which require flushing the underlying file (i.e WARNING and above
+ * for default). The flush can take a couple of milliseconds, and in some
+ * cases can even block for hundreds of milliseconds or more. With the
+ * asynchronous approach, threads can proceed with useful work while the IO
  * thread blocks.
  *
  * The semantics provided by this wrapper are slightly weaker than the default
@@ -61,11 +59,14 @@ namespace logger {
  * a separate thread. This means that a crash just after a 'LOG_WARN' would
  * may be missing the message in the logs, but the perf benefit is probably
  * worth it. We do take care that a glog FATAL message flushes all buffered log
- * messages before exiting.
+ * messages before exiting. Messages of one thread keep their order, messages
+ * of different threads may be written slightly out of order.
  *
- * @warning The logger limits the total amount of buffer space, so if the
- * underlying log blocks for too long, eventually the threads generating the log
- * messages will block as well. This prevents runaway memory usage.
+ * @warning The ring of a thread is bounded (cyber_log_ring_size_kb, 256 KB by
+ * default), so if the underlying log blocks for too long, the messages that do
+ * not fit are dropped and counted. The logger reports the count in the log
+ * once it catches up. This prevents runaway memory usage and never blocks
+ * the threads generating the log messages.
  */
 class AsyncLogger : public google::base::Logger {
  public:
@@ -122,69 +123,68 @@ class AsyncLogger : public google::base::Logger {
    */
   std::thread* LogThread() { return &log_thread_; }
 
+  /**
+   * @brief Ring of the calling thread, registered on first use.
+   *
+   * @return nullptr if the logger is not running or all the rings are owned
+   * by other threads
+   */
+  LogRing* ThreadRing();
+
+  /**
+   * @brief Log messages dropped because a ring was full.
+   */
+  uint64_t DropCount();
+
+  /**
+   * @brief The started logger, nullptr if none is running.
+   */
+  static AsyncLogger* Running() {
+    return running_logger_.load(std::memory_order_acquire);
+  }
+
+  // kinds of ring records
+  static const uint32_t kTextRecord = 1;
+  static const uint32_t kDeferredRecord = 2;
+
  private:
-  // A buffered message.
-  //
-  // TODO(todd): using std::string for buffered messages is convenient but not
-  // as efficient as it could be. It's better to make the buffers just be
-  // Arenas and allocate both the message data and Msg struct from them, forming
-  // a linked list.
-  struct Msg {
-    time_t ts;
-    std::string message;
-    int32_t level;
-    Msg() : ts(0), message(), level(google::INFO) {}
-    Msg(time_t ts, std::string&& message, int32_t level)
-        : ts(ts), message(std::move(message)), level(level) {}
-    Msg(const Msg& rsh) {
-      ts = rsh.ts;
-      message = rsh.message;
-      level = rsh.level;
-    }
-    Msg(Msg&& rsh) {
-      ts = rsh.ts;
-      message = rsh.message;
-      level = rsh.level;
-    }
-    Msg& operator=(Msg&& rsh) {
-      ts = rsh.ts;
-      message = std::move(rsh.message);
-      level = rsh.level;
-      return *this;
-    }
-    Msg& operator=(const Msg& rsh) {
-      ts = rsh.ts;
-      message = rsh.message;
-      level = rsh.level;
-      return *this;
-    }
-  };
+  static const int kMaxRings = 256;
 
   void RunThread();
-  void FlushBuffer(const std::unique_ptr<std::deque<Msg>>& msg);
+  // Writes out the records of all rings, returns their number.
+  uint64_t Drain();
+  void WriteToModule(std::string* module_name, int level, time_t timestamp,
+                     const std::string& message);
 
   google::base::Logger* const wrapped_;
   std::thread log_thread_;
 
+  // Identifies the logger in the ring cached by each thread.
+  const uint64_t id_;
+  uint32_t ring_capacity_;
+
   // Count of how many times the writer thread has flushed the buffers.
   // 64 bits should be enough to never worry about overflow.
   std::atomic<uint64_t> flush_count_ = {0};
 
-  // Count of how many times the writer thread has dropped the log messages.
+  // Count of the log messages dropped by the threads without a ring, the
+  // rings count their own drops.
   // 64 bits should be enough to never worry about overflow.
-  uint64_t drop_count_ = 0;
-
-  // The buffer to which application threads append new log messages.
-  std::unique_ptr<std::deque<Msg>> active_buf_;
+  std::atomic<uint64_t> drop_count_ = {0};
+  // Drops already reported in the log, only used by the logger thread.
+  uint64_t reported_drop_count_ = 0;
 
-  // The buffer currently being flushed by the logger thread, cleared
-  // after a successful flush.
-  std::unique_ptr<std::deque<Msg>> flushing_buf_;
+  // Rings are only appended, under rings_mutex_, and released ones are
+  // reused by new threads.
+  std::mutex rings_mutex_;
+  std::shared_ptr<LogRing> rings_[kMaxRings];
+  std::atomic<int> ring_num_ = {0};
 
   // Trigger for the logger thread to stop.
   enum State { INITTED, RUNNING, STOPPED };
   std::atomic<State> state_ = {INITTED};
-  std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+
+  static std::atomic<AsyncLogger*> running_logger_;
 
   DISALLOW_COPY_AND_ASSIGN(AsyncLogger);
 };
@@ -0,0 +1,198 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares the cost of a log statement for the calling thread: the shared
+// spin-locked deque the async logger used before against the per-thread
+// rings, and a message formatted on the calling thread, as AINFO does,
+// against the deferred AINFO_FMT.
+//
+// The logger thread writes the messages to files in the current directory.
+// Each run logs a fixed number of messages into rings large enough to hold
+// them, so no message is dropped and only the cost of queueing is measured.
+//
+// bazel run //cyber/logger:async_logger_benchmark
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/base/macros.h"
+#include "cyber/logger/async_logger.h"
+#include "cyber/logger/deferred_log.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+const char kMessage[] =
+    "I0101 00:00:00.000000 12345 benchmark.cc:42] [benchmark]planning cycle "
+    "12345 took 12.5 ms\n";
+
+// The buffers AsyncLogger::Write appended to before: one deque for all
+// threads behind a spin lock, swapped out by the logger thread.
+class DequeLogger {
+ public:
+  DequeLogger() {
+    thread_ = std::thread([this]() {
+      std::deque<Msg> flushing;
+      while (!stop_.load()) {
+        while (flag_.test_and_set(std::memory_order_acquire)) {
+          cpu_relax();
+        }
+        active_.swap(flushing);
+        flag_.clear(std::memory_order_release);
+        flushing.clear();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  }
+  ~DequeLogger() {
+    stop_.store(true);
+    thread_.join();
+  }
+
+  void Write(time_t timestamp, const char* message, int message_len) {
+    auto msg_str = std::string(message, message_len);
+    while (flag_.test_and_set(std::memory_order_acquire)) {
+      cpu_relax();
+    }
+    active_.push_back({timestamp, std::move(msg_str), 0});
+    flag_.clear(std::memory_order_release);
+  }
+
+ private:
+  struct Msg {
+    time_t ts;
+    std::string message;
+    int32_t level;
+  };
+
+  std::deque<Msg> active_;
+  std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+  std::atomic<bool> stop_ = {false};
+  std::thread thread_;
+};
+
+const int kIterations = 200000;
+
+std::unique_ptr<DequeLogger> deque_logger;
+std::unique_ptr<AsyncLogger> async_logger;
+
+void SetUpDeque(const benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    deque_logger.reset(new DequeLogger());
+  }
+}
+
+void TearDownDeque(const benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    deque_logger.reset();
+  }
+}
+
+void SetUp(const benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    setenv("cyber_log_ring_size_kb", "65536", 0);
+    async_logger.reset(new AsyncLogger(google::base::GetLogger(google::INFO)));
+    async_logger->Start();
+  }
+}
+
+void TearDown(const benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    async_logger->Stop();
+    async_logger.reset();
+  }
+}
+
+void BM_DequeWrite(benchmark::State& state) {
+  for (auto _ : state) {
+    deque_logger->Write(0, kMessage, sizeof(kMessage) - 1);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DequeWrite)
+    ->ThreadRange(1, 8)
+    ->Iterations(kIterations)
+    ->Setup(SetUpDeque)
+    ->Teardown(TearDownDeque);
+
+void BM_RingWrite(benchmark::State& state) {
+  for (auto _ : state) {
+    async_logger->Write(false, 0, kMessage, sizeof(kMessage) - 1);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    state.counters["dropped"] =
+        static_cast<double>(async_logger->DropCount());
+  }
+}
+BENCHMARK(BM_RingWrite)
+    ->ThreadRange(1, 8)
+    ->Iterations(kIterations)
+    ->Setup(SetUp)
+    ->Teardown(TearDown);
+
+// The message built on the calling thread, the glog prefix left out.
+void BM_StreamFormat(benchmark::State& state) {
+  uint64_t seq = 0;
+  double cost = 12.5;
+  for (auto _ : state) {
+    std::ostringstream stream;
+    stream << LEFT_BRACKET << "benchmark" << RIGHT_BRACKET
+           << "planning cycle " << ++seq << " took " << cost << " ms";
+    auto message = stream.str();
+    async_logger->Write(false, 0, message.data(),
+                        static_cast<int>(message.size()));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StreamFormat)
+    ->ThreadRange(1, 8)
+    ->Iterations(kIterations)
+    ->Setup(SetUp)
+    ->Teardown(TearDown);
+
+void BM_DeferredFormat(benchmark::State& state) {
+  uint64_t seq = 0;
+  double cost = 12.5;
+  for (auto _ : state) {
+    ALOG_FMT(INFO, "planning cycle {} took {} ms", ++seq, cost);
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    state.counters["dropped"] =
+        static_cast<double>(async_logger->DropCount());
+  }
+}
+BENCHMARK(BM_DeferredFormat)
+    ->ThreadRange(1, 8)
+    ->Iterations(kIterations)
+    ->Setup(SetUp)
+    ->Teardown(TearDown);
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
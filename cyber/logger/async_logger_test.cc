@@ -16,10 +16,13 @@
 
 #include "cyber/logger/async_logger.h"
 
+#include <thread>
+
 #include "glog/logging.h"
 #include "gtest/gtest.h"
 
 #include "cyber/common/log.h"
+#include "cyber/logger/deferred_log.h"
 
 namespace apollo {
 namespace cyber {
@@ -69,6 +72,35 @@ TEST(AsyncLoggerTest, SetLoggerToGlog) {
   google::ShutdownGoogleLogging();
 }
 
+TEST(AsyncLoggerTest, ThreadRing) {
+  AsyncLogger logger(google::base::GetLogger(google::INFO));
+  EXPECT_EQ(nullptr, logger.ThreadRing());
+  EXPECT_EQ(nullptr, AsyncLogger::Running());
+
+  logger.Start();
+  EXPECT_EQ(&logger, AsyncLogger::Running());
+  LogRing* ring = logger.ThreadRing();
+  ASSERT_NE(nullptr, ring);
+  EXPECT_EQ(ring, logger.ThreadRing());
+
+  // a thread gets its own ring, which is reused once the thread exits
+  LogRing* other_ring = nullptr;
+  std::thread([&]() { other_ring = logger.ThreadRing(); }).join();
+  EXPECT_NE(nullptr, other_ring);
+  EXPECT_NE(ring, other_ring);
+  LogRing* reused_ring = nullptr;
+  std::thread([&]() { reused_ring = logger.ThreadRing(); }).join();
+  EXPECT_EQ(other_ring, reused_ring);
+
+  for (int i = 0; i < 100; ++i) {
+    ALOG_FMT(INFO, "deferred message {} of {}", i, 100);
+  }
+  logger.Stop();
+  EXPECT_TRUE(ring->Empty());
+  EXPECT_EQ(0, logger.DropCount());
+  EXPECT_EQ(nullptr, AsyncLogger::Running());
+}
+
 }  // namespace logger
 }  // namespace cyber
 }  // namespace apollo
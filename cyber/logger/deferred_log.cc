@@ -0,0 +1,174 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/deferred_log.h"
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+namespace deferred {
+
+namespace {
+
+const char kSeverityChar[] = "IWEF";
+
+// Appends the text of the argument at *args and moves past it.
+bool AppendArg(const char** args, const char* end, std::string* out) {
+  const char* p = *args;
+  if (p >= end) {
+    return false;
+  }
+  char type = *p++;
+  if (type == kString) {
+    uint32_t length = 0;
+    if (end - p < static_cast<int64_t>(sizeof(length))) {
+      return false;
+    }
+    std::memcpy(&length, p, sizeof(length));
+    p += sizeof(length);
+    if (end - p < static_cast<int64_t>(length)) {
+      return false;
+    }
+    out->append(p, length);
+    *args = p + length;
+    return true;
+  }
+
+  uint64_t bits = 0;
+  if (end - p < static_cast<int64_t>(sizeof(bits))) {
+    return false;
+  }
+  std::memcpy(&bits, p, sizeof(bits));
+  *args = p + sizeof(bits);
+  char buf[32];
+  switch (type) {
+    case kBool:
+      out->push_back(bits ? '1' : '0');
+      return true;
+    case kChar:
+      out->push_back(static_cast<char>(bits));
+      return true;
+    case kInt:
+      snprintf(buf, sizeof(buf), "%" PRId64, static_cast<int64_t>(bits));
+      break;
+    case kUint:
+      snprintf(buf, sizeof(buf), "%" PRIu64, bits);
+      break;
+    case kDouble: {
+      double value;
+      std::memcpy(&value, &bits, sizeof(value));
+      snprintf(buf, sizeof(buf), "%g", value);
+      break;
+    }
+    case kPointer:
+      snprintf(buf, sizeof(buf), "%p",
+               reinterpret_cast<void*>(static_cast<uintptr_t>(bits)));
+      break;
+    default:
+      return false;
+  }
+  out->append(buf);
+  return true;
+}
+
+const char* Basename(const char* file) {
+  const char* slash = std::strrchr(file, '/');
+  return slash ? slash + 1 : file;
+}
+
+}  // namespace
+
+int64_t NowNs() {
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+int32_t ThreadId() {
+  static thread_local int32_t tid =
+      static_cast<int32_t>(syscall(SYS_gettid));
+  return tid;
+}
+
+void FormatMessage(const char* format, const char* args, uint32_t args_size,
+                   std::string* module, std::string* message) {
+  const char* end = args + args_size;
+  module->clear();
+  AppendArg(&args, end, module);
+
+  for (const char* p = format; *p != '\0'; ++p) {
+    if (p[0] == '{' && p[1] == '}' && AppendArg(&args, end, message)) {
+      ++p;
+      continue;
+    }
+    message->push_back(*p);
+  }
+  while (args < end) {
+    message->push_back(' ');
+    if (!AppendArg(&args, end, message)) {
+      break;
+    }
+  }
+}
+
+void FormatRecord(const char* record, uint32_t size, std::string* module,
+                  std::string* line, time_t* timestamp, int* severity) {
+  RecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+  const LogSite* site = header.site;
+  *timestamp = static_cast<time_t>(header.time_ns / 1000000000);
+  *severity = site->severity;
+
+  struct tm tm_time;
+  localtime_r(timestamp, &tm_time);
+  char prefix[64];
+  snprintf(prefix, sizeof(prefix), "%c%02d%02d %02d:%02d:%02d.%06d %5d ",
+           kSeverityChar[site->severity & 3], 1 + tm_time.tm_mon,
+           tm_time.tm_mday, tm_time.tm_hour, tm_time.tm_min, tm_time.tm_sec,
+           static_cast<int>(header.time_ns % 1000000000 / 1000), header.tid);
+  line->assign(prefix);
+  line->append(Basename(site->file));
+  line->push_back(':');
+  line->append(std::to_string(site->line));
+  line->append("] ");
+  uint32_t args_size =
+      std::min(header.args_size, size - static_cast<uint32_t>(sizeof(header)));
+  FormatMessage(site->format, record + sizeof(header), args_size, module,
+                line);
+  line->push_back('\n');
+}
+
+void LogNow(const LogSite* site, const char* args, uint32_t args_size) {
+  std::string module;
+  std::string message;
+  FormatMessage(site->format, args, args_size, &module, &message);
+  google::LogMessage(site->file, site->line,
+                     static_cast<google::LogSeverity>(site->severity))
+          .stream()
+      << LEFT_BRACKET << module << RIGHT_BRACKET << message;
+}
+
+}  // namespace deferred
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,244 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief Log statements formatted on the logger thread.
+ *
+ * AINFO_FMT("planning cycle {} took {} ms", seq, cost) only copies the call
+ * site and the raw arguments into the calling thread's log ring, the string
+ * is built by the async logger thread. Every "{}" in the format is replaced
+ * by the next argument, extra arguments are appended after a space.
+ *
+ * Supported arguments are arithmetic types, enums, pointers, C strings and
+ * std::string. Other types do not compile, use the stream macros for them.
+ * When the async logger is not running, the message is formatted in place
+ * and goes through glog like any other.
+ */
+
+#ifndef CYBER_LOGGER_DEFERRED_LOG_H_
+#define CYBER_LOGGER_DEFERRED_LOG_H_
+
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <type_traits>
+
+#include "cyber/common/log.h"
+#include "cyber/logger/async_logger.h"
+
+// The format has to be a string literal, it is kept by the log site and
+// never copied; each argument is evaluated once.
+#define ALOG_FMT(severity, format, ...)                                    \
+  do {                                                                     \
+    static const ::apollo::cyber::logger::LogSite cyber_log_site = {       \
+        __FILE__, __LINE__, google::severity, "" format};                  \
+    ::apollo::cyber::logger::DeferredLog(&cyber_log_site,                  \
+                                         MODULE_NAME, ##__VA_ARGS__);      \
+  } while (0)
+
+#define AINFO_FMT(format, ...) ALOG_FMT(INFO, format, ##__VA_ARGS__)
+#define AWARN_FMT(format, ...) ALOG_FMT(WARNING, format, ##__VA_ARGS__)
+#define AERROR_FMT(format, ...) ALOG_FMT(ERROR, format, ##__VA_ARGS__)
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+// A log statement, its address identifies the format on the logger thread.
+struct LogSite {
+  const char* file;
+  int line;
+  int severity;
+  const char* format;
+};
+
+namespace deferred {
+
+enum ArgType : char {
+  kBool = 'b',
+  kChar = 'c',
+  kInt = 'i',
+  kUint = 'u',
+  kDouble = 'd',
+  kPointer = 'p',
+  kString = 's',
+};
+
+template <typename T>
+struct IsScalarArg {
+  static const bool value =
+      std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+      (std::is_pointer<T>::value &&
+       !std::is_same<typename std::decay<T>::type, char*>::value &&
+       !std::is_same<typename std::decay<T>::type, const char*>::value);
+};
+
+template <typename T>
+constexpr ArgType ScalarType() {
+  return std::is_same<T, bool>::value
+             ? kBool
+             : std::is_same<T, char>::value
+                   ? kChar
+                   : std::is_floating_point<T>::value
+                         ? kDouble
+                         : std::is_pointer<T>::value
+                               ? kPointer
+                               : std::is_unsigned<T>::value ? kUint : kInt;
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, uint64_t>::type
+ScalarBits(T value) {
+  double d = static_cast<double>(value);
+  uint64_t bits;
+  std::memcpy(&bits, &d, sizeof(bits));
+  return bits;
+}
+
+template <typename T>
+typename std::enable_if<std::is_pointer<T>::value, uint64_t>::type ScalarBits(
+    T value) {
+  return reinterpret_cast<uintptr_t>(value);
+}
+
+template <typename T>
+typename std::enable_if<
+    std::is_integral<T>::value || std::is_enum<T>::value, uint64_t>::type
+ScalarBits(T value) {
+  return static_cast<uint64_t>(value);
+}
+
+inline uint32_t ArgSize(const char* value) {
+  return static_cast<uint32_t>(1 + sizeof(uint32_t) +
+                               (value ? std::strlen(value) : 0));
+}
+inline uint32_t ArgSize(char* value) {
+  return ArgSize(static_cast<const char*>(value));
+}
+inline uint32_t ArgSize(const std::string& value) {
+  return static_cast<uint32_t>(1 + sizeof(uint32_t) + value.size());
+}
+template <typename T>
+typename std::enable_if<IsScalarArg<T>::value, uint32_t>::type ArgSize(
+    const T&) {
+  return 1 + sizeof(uint64_t);
+}
+
+inline char* EncodeString(char* buf, const char* data, uint32_t length) {
+  *buf++ = kString;
+  std::memcpy(buf, &length, sizeof(length));
+  buf += sizeof(length);
+  std::memcpy(buf, data, length);
+  return buf + length;
+}
+inline char* EncodeArg(char* buf, const char* value) {
+  if (value == nullptr) {
+    return EncodeString(buf, "", 0);
+  }
+  return EncodeString(buf, value,
+                      static_cast<uint32_t>(std::strlen(value)));
+}
+inline char* EncodeArg(char* buf, char* value) {
+  return EncodeArg(buf, static_cast<const char*>(value));
+}
+inline char* EncodeArg(char* buf, const std::string& value) {
+  return EncodeString(buf, value.data(),
+                      static_cast<uint32_t>(value.size()));
+}
+template <typename T>
+typename std::enable_if<IsScalarArg<T>::value, char*>::type EncodeArg(
+    char* buf, const T& value) {
+  *buf++ = ScalarType<T>();
+  uint64_t bits = ScalarBits(value);
+  std::memcpy(buf, &bits, sizeof(bits));
+  return buf + sizeof(bits);
+}
+
+inline uint32_t ArgsSize() { return 0; }
+template <typename T, typename... Args>
+uint32_t ArgsSize(const T& value, const Args&... args) {
+  return ArgSize(value) + ArgsSize(args...);
+}
+
+inline char* EncodeArgs(char* buf) { return buf; }
+template <typename T, typename... Args>
+char* EncodeArgs(char* buf, const T& value, const Args&... args) {
+  return EncodeArgs(EncodeArg(buf, value), args...);
+}
+
+// What precedes the arguments in a record.
+struct RecordHeader {
+  const LogSite* site;
+  int64_t time_ns;
+  int32_t tid;
+  uint32_t args_size;
+};
+
+int64_t NowNs();
+int32_t ThreadId();
+
+/**
+ * @brief Format the message of a record, without the glog prefix: the module
+ * name, which is encoded as the first argument, goes to module.
+ */
+void FormatMessage(const char* format, const char* args, uint32_t args_size,
+                   std::string* module, std::string* message);
+
+/**
+ * @brief Build the whole log line of a record as glog would have.
+ */
+void FormatRecord(const char* record, uint32_t size, std::string* module,
+                  std::string* line, time_t* timestamp, int* severity);
+
+// Formats in place and logs through glog, when no async logger runs.
+void LogNow(const LogSite* site, const char* args, uint32_t args_size);
+
+}  // namespace deferred
+
+template <typename... Args>
+void DeferredLog(const LogSite* site, const char* module,
+                 const Args&... args) {
+  if (site->severity < FLAGS_minloglevel) {
+    return;
+  }
+  uint32_t args_size = deferred::ArgsSize(module, args...);
+  AsyncLogger* logger = AsyncLogger::Running();
+  LogRing* ring = logger == nullptr ? nullptr : logger->ThreadRing();
+  if (ring == nullptr) {
+    std::string buf(args_size, '\0');
+    deferred::EncodeArgs(&buf[0], module, args...);
+    deferred::LogNow(site, buf.data(), args_size);
+    return;
+  }
+  char* record = ring->Reserve(
+      static_cast<uint32_t>(sizeof(deferred::RecordHeader)) + args_size);
+  if (record == nullptr) {
+    return;
+  }
+  deferred::RecordHeader header = {site, deferred::NowNs(),
+                                   deferred::ThreadId(), args_size};
+  std::memcpy(record, &header, sizeof(header));
+  deferred::EncodeArgs(record + sizeof(header), module, args...);
+  ring->Commit(AsyncLogger::kDeferredRecord);
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_LOGGER_DEFERRED_LOG_H_
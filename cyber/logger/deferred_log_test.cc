@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/deferred_log.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+enum class Color { RED = 2 };
+
+template <typename... Args>
+std::string Format(const char* format, const Args&... args) {
+  std::string buf(deferred::ArgsSize("module", args...), '\0');
+  deferred::EncodeArgs(&buf[0], "module", args...);
+  std::string module;
+  std::string message;
+  deferred::FormatMessage(format, buf.data(),
+                          static_cast<uint32_t>(buf.size()), &module,
+                          &message);
+  EXPECT_EQ("module", module);
+  return message;
+}
+
+TEST(DeferredLogTest, format_message) {
+  EXPECT_EQ("no arguments", Format("no arguments"));
+  EXPECT_EQ("int -3 uint 7 char c bool 1",
+            Format("int {} uint {} char {} bool {}", -3, 7u, 'c', true));
+  EXPECT_EQ("int64 -9223372036854775807 uint64 18446744073709551615",
+            Format("int64 {} uint64 {}", int64_t(-9223372036854775807),
+                   uint64_t(18446744073709551615ULL)));
+  EXPECT_EQ("double 0.5 float 1.25 large 1e+20",
+            Format("double {} float {} large {}", 0.5, 1.25f, 1e20));
+  EXPECT_EQ("enum 2", Format("enum {}", Color::RED));
+
+  char buf[] = "mutable";
+  const char* null_str = nullptr;
+  EXPECT_EQ("literal const mutable std  end",
+            Format("{} {} {} {} {} end", "literal", static_cast<const char*>(
+                                                        "const"),
+                   buf, std::string("std"), null_str));
+
+  int value = 0;
+  EXPECT_EQ(Format("{}", static_cast<void*>(&value)),
+            Format("{}", &value));
+  EXPECT_NE("0", Format("{}", &value));
+}
+
+TEST(DeferredLogTest, placeholder_mismatch) {
+  // missing arguments leave the placeholders, extra ones are appended
+  EXPECT_EQ("a 1 b {}", Format("a {} b {}", 1));
+  EXPECT_EQ("a 1 2 3", Format("a {}", 1, 2, 3));
+  EXPECT_EQ("{ } {x} 1", Format("{ } {x} {}", 1));
+}
+
+TEST(DeferredLogTest, format_record) {
+  static const LogSite site = {"/path/to/planning.cc", 42, google::WARNING,
+                               "cost {} ms"};
+  std::string args(deferred::ArgsSize("planning", 3.5), '\0');
+  deferred::EncodeArgs(&args[0], "planning", 3.5);
+  deferred::RecordHeader header = {&site, 1546300800123456789LL, 321,
+                                   static_cast<uint32_t>(args.size())};
+  std::string record(reinterpret_cast<const char*>(&header), sizeof(header));
+  record.append(args);
+
+  std::string module;
+  std::string line;
+  time_t timestamp = 0;
+  int severity = 0;
+  deferred::FormatRecord(record.data(), static_cast<uint32_t>(record.size()),
+                         &module, &line, &timestamp, &severity);
+  EXPECT_EQ("planning", module);
+  EXPECT_EQ(1546300800, timestamp);
+  EXPECT_EQ(google::WARNING, severity);
+  ASSERT_EQ('W', line[0]);
+  // the time of day depends on the time zone
+  EXPECT_EQ(".123456   321 planning.cc:42] cost 3.5 ms\n",
+            line.substr(line.find('.')));
+}
+
+TEST(DeferredLogTest, log_without_async_logger) {
+  ASSERT_EQ(nullptr, AsyncLogger::Running());
+  AINFO_FMT("formatted in place {} {}", 1, "two");
+  AERROR_FMT("formatted in place");
+}
+
+TEST(DeferredLogTest, arguments_evaluated_once) {
+  int seq = 0;
+  AINFO_FMT("cycle {}", ++seq);
+  ALOG_FMT(WARNING, "cycle {} of {}", ++seq, 2);
+  EXPECT_EQ(2, seq);
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,177 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_LOGGER_LOG_RING_H_
+#define CYBER_LOGGER_LOG_RING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "cyber/base/macros.h"
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+/**
+ * @class LogRing
+ * @brief Single producer, single consumer ring of variable sized log records.
+ *
+ * Each writer thread owns one ring and the logger thread drains all of them,
+ * so neither side takes a lock. A record that does not fit into the free
+ * space is dropped and counted instead of blocking the writer.
+ *
+ * Records are 8-byte aligned and never wrap: when one does not fit at the
+ * end of the buffer, the rest of the buffer is skipped with a padding record.
+ */
+class LogRing {
+ public:
+  // kind of the records filling the end of the buffer, never consumed
+  static const uint32_t kPadding = 0;
+
+  /**
+   * @param capacity in bytes, rounded up to a power of two
+   */
+  explicit LogRing(uint32_t capacity) {
+    capacity_ = 64;
+    while (capacity_ < capacity) {
+      capacity_ <<= 1;
+    }
+    buffer_.reset(new uint64_t[capacity_ / sizeof(uint64_t)]);
+  }
+
+  /**
+   * @brief Reserve the payload of the next record, called by the producer.
+   *
+   * @return nullptr if the ring is full, the record is then counted as
+   * dropped
+   */
+  char* Reserve(uint32_t size) {
+    uint64_t length = Align(sizeof(Header) + size);
+    if (cyber_unlikely(length > capacity_ / 2)) {
+      drop_num_.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    uint64_t contiguous = capacity_ - (pos & (capacity_ - 1));
+    uint64_t needed = length <= contiguous ? length : contiguous + length;
+    if (pos + needed - head_cache_ > capacity_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (pos + needed - head_cache_ > capacity_) {
+        drop_num_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+      }
+    }
+    if (length > contiguous) {
+      auto padding = HeaderAt(pos);
+      padding->size = static_cast<uint32_t>(contiguous - sizeof(Header));
+      padding->kind = kPadding;
+      pos += contiguous;
+    }
+    reserved_pos_ = pos;
+    reserved_size_ = size;
+    return reinterpret_cast<char*>(HeaderAt(pos) + 1);
+  }
+
+  /**
+   * @brief Publish the record reserved last to the consumer.
+   */
+  void Commit(uint32_t kind) {
+    auto header = HeaderAt(reserved_pos_);
+    header->size = reserved_size_;
+    header->kind = kind;
+    tail_.store(reserved_pos_ + Align(sizeof(Header) + reserved_size_),
+                std::memory_order_release);
+  }
+
+  /**
+   * @brief Hand the published records to func(kind, payload, size), called
+   * by the consumer.
+   *
+   * @return the number of records consumed
+   */
+  template <typename Func>
+  uint64_t Consume(Func&& func) {
+    uint64_t pos = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    uint64_t num = 0;
+    while (pos < tail) {
+      auto header = HeaderAt(pos);
+      if (header->kind != kPadding) {
+        func(header->kind, reinterpret_cast<const char*>(header + 1),
+             header->size);
+        ++num;
+      }
+      pos += Align(sizeof(Header) + header->size);
+      head_.store(pos, std::memory_order_release);
+    }
+    return num;
+  }
+
+  bool Empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+  uint64_t DropNum() const { return drop_num_.load(std::memory_order_relaxed); }
+  uint32_t Capacity() const { return static_cast<uint32_t>(capacity_); }
+
+  // Owned by a writer thread. A released ring is handed to the next thread
+  // that registers, with the records it still holds.
+  bool TryAcquire() {
+    bool expected = false;
+    return owned_.compare_exchange_strong(expected, true,
+                                          std::memory_order_acquire);
+  }
+  void Release() { owned_.store(false, std::memory_order_release); }
+
+ private:
+  struct Header {
+    uint32_t size;
+    uint32_t kind;
+  };
+
+  static uint64_t Align(uint64_t size) { return (size + 7) & ~uint64_t(7); }
+
+  Header* HeaderAt(uint64_t pos) {
+    return reinterpret_cast<Header*>(reinterpret_cast<char*>(buffer_.get()) +
+                                     (pos & (capacity_ - 1)));
+  }
+
+  uint64_t capacity_ = 0;
+  std::unique_ptr<uint64_t[]> buffer_;
+
+  // written by the consumer
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> head_ = {0};
+
+  // written by the producer
+  alignas(CACHELINE_SIZE) std::atomic<uint64_t> tail_ = {0};
+  uint64_t head_cache_ = 0;
+  uint64_t reserved_pos_ = 0;
+  uint32_t reserved_size_ = 0;
+  std::atomic<uint64_t> drop_num_ = {0};
+  std::atomic<bool> owned_ = {false};
+
+  DISALLOW_COPY_AND_ASSIGN(LogRing);
+};
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_LOGGER_LOG_RING_H_
@@ -0,0 +1,133 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/logger/log_ring.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace logger {
+
+bool Push(LogRing* ring, const std::string& text) {
+  char* record = ring->Reserve(static_cast<uint32_t>(text.size()));
+  if (record == nullptr) {
+    return false;
+  }
+  std::memcpy(record, text.data(), text.size());
+  ring->Commit(1);
+  return true;
+}
+
+std::vector<std::string> PopAll(LogRing* ring) {
+  std::vector<std::string> texts;
+  ring->Consume([&texts](uint32_t kind, const char* payload, uint32_t size) {
+    EXPECT_EQ(1, kind);
+    texts.emplace_back(payload, size);
+  });
+  return texts;
+}
+
+TEST(LogRingTest, reserve_commit_consume) {
+  LogRing ring(100);
+  EXPECT_EQ(128, ring.Capacity());
+  EXPECT_TRUE(ring.Empty());
+
+  // reserved but not committed records are not visible
+  ASSERT_NE(nullptr, ring.Reserve(3));
+  EXPECT_TRUE(ring.Empty());
+  EXPECT_TRUE(PopAll(&ring).empty());
+
+  EXPECT_TRUE(Push(&ring, "abc"));
+  EXPECT_TRUE(Push(&ring, ""));
+  EXPECT_TRUE(Push(&ring, "0123456789"));
+  EXPECT_FALSE(ring.Empty());
+  auto texts = PopAll(&ring);
+  ASSERT_EQ(3, texts.size());
+  EXPECT_EQ("abc", texts[0]);
+  EXPECT_EQ("", texts[1]);
+  EXPECT_EQ("0123456789", texts[2]);
+  EXPECT_TRUE(ring.Empty());
+  EXPECT_EQ(0, ring.DropNum());
+}
+
+TEST(LogRingTest, full_and_too_large) {
+  LogRing ring(128);
+  // 8 bytes of header and 24 of payload
+  int pushed = 0;
+  while (Push(&ring, std::string(24, 'x'))) {
+    ++pushed;
+  }
+  EXPECT_EQ(4, pushed);
+  EXPECT_EQ(1, ring.DropNum());
+  EXPECT_EQ(4, PopAll(&ring).size());
+  EXPECT_TRUE(Push(&ring, std::string(24, 'x')));
+
+  // larger than half of the ring
+  EXPECT_FALSE(Push(&ring, std::string(60, 'x')));
+  EXPECT_EQ(2, ring.DropNum());
+}
+
+TEST(LogRingTest, wrap_around) {
+  LogRing ring(256);
+  for (int i = 0; i < 1000; ++i) {
+    std::string text(i % 53, static_cast<char>('a' + i % 26));
+    ASSERT_TRUE(Push(&ring, text));
+    auto texts = PopAll(&ring);
+    ASSERT_EQ(1, texts.size());
+    EXPECT_EQ(text, texts[0]);
+  }
+  EXPECT_EQ(0, ring.DropNum());
+}
+
+TEST(LogRingTest, producer_consumer) {
+  LogRing ring(4096);
+  const int num = 100000;
+  std::thread producer([&ring]() {
+    for (int i = 0; i < num; ++i) {
+      auto text = std::to_string(i);
+      while (!Push(&ring, text)) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int next = 0;
+  while (next < num) {
+    ring.Consume([&next](uint32_t, const char* payload, uint32_t size) {
+      EXPECT_EQ(std::to_string(next), std::string(payload, size));
+      ++next;
+    });
+  }
+  producer.join();
+  EXPECT_TRUE(ring.Empty());
+}
+
+TEST(LogRingTest, acquire_release) {
+  LogRing ring(64);
+  EXPECT_TRUE(ring.TryAcquire());
+  EXPECT_FALSE(ring.TryAcquire());
+  ring.Release();
+  EXPECT_TRUE(ring.TryAcquire());
+}
+
+}  // namespace logger
+}  // namespace cyber
+}  // namespace apollo
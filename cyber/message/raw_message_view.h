@@ -0,0 +1,171 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_MESSAGE_RAW_MESSAGE_VIEW_H_
+#define CYBER_MESSAGE_RAW_MESSAGE_VIEW_H_
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include "cyber/message/protobuf_factory.h"
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+/**
+ * @class RawMessageView
+ * @brief Read-only counterpart of RawMessage. When delivered by the shared
+ * memory transport it borrows the payload in place: `holder` keeps the block
+ * read-locked for as long as the view (or a copy of it) is alive. On the other
+ * transports it falls back to owning a copy of the bytes.
+ *
+ * Views should be dropped promptly, since a writer cannot reuse a block while
+ * any reader still holds it. A channel may have as few as
+ * ShmConf::BLOCK_NUM_MORE (8) blocks, shared by all its readers; once they
+ * are all held, writes to the channel fail instead of waiting for a block.
+ * A view stays valid if the segment is remapped meanwhile.
+ */
+class RawMessageView {
+ public:
+  RawMessageView() = default;
+
+  RawMessageView(const RawMessageView &other)
+      : data_(other.data_),
+        size_(other.size_),
+        holder_(other.holder_),
+        owned_(other.owned_) {
+    if (holder_ == nullptr) {
+      data_ = owned_.data();
+    }
+  }
+
+  RawMessageView &operator=(const RawMessageView &other) {
+    if (this != &other) {
+      data_ = other.data_;
+      size_ = other.size_;
+      holder_ = other.holder_;
+      owned_ = other.owned_;
+      if (holder_ == nullptr) {
+        data_ = owned_.data();
+      }
+    }
+    return *this;
+  }
+
+  class Descriptor {
+   public:
+    std::string full_name() const { return "apollo.cyber.message.RawMessage"; }
+    std::string name() const { return "apollo.cyber.message.RawMessage"; }
+  };
+
+  static const Descriptor *descriptor() {
+    static Descriptor desc;
+    return &desc;
+  }
+
+  static void GetDescriptorString(const std::string &type,
+                                  std::string *desc_str) {
+    ProtobufFactory::Instance()->GetDescriptorString(type, desc_str);
+  }
+
+  static std::string TypeName() { return "apollo.cyber.message.RawMessage"; }
+
+  bool BorrowFromArray(const void *data, int size,
+                       const std::shared_ptr<const void> &holder) {
+    if (data == nullptr || size <= 0) {
+      return false;
+    }
+    owned_.clear();
+    data_ = reinterpret_cast<const char *>(data);
+    size_ = size;
+    holder_ = holder;
+    return true;
+  }
+
+  bool ParseFromArray(const void *data, int size) {
+    if (data == nullptr || size <= 0) {
+      return false;
+    }
+    owned_.assign(reinterpret_cast<const char *>(data), size);
+    Own();
+    return true;
+  }
+
+  bool ParseFromString(const std::string &str) {
+    owned_ = str;
+    Own();
+    return true;
+  }
+
+  bool SerializeToArray(void *data, int size) const {
+    if (data == nullptr || size < ByteSize()) {
+      return false;
+    }
+    memcpy(data, data_, size_);
+    return true;
+  }
+
+  bool SerializeToString(std::string *str) const {
+    if (str == nullptr) {
+      return false;
+    }
+    str->assign(data_, size_);
+    return true;
+  }
+
+  int ByteSize() const { return size_; }
+
+  const char *data() const { return data_; }
+  int size() const { return size_; }
+  bool is_borrowed() const { return holder_ != nullptr; }
+
+  /**
+   * @brief Interpret the payload as a fixed-layout struct written through
+   * LoanedMessage::Construct.
+   *
+   * @return nullptr if the payload is too small for T
+   */
+  template <typename T>
+  const T *As() const {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable types can be viewed in place");
+    if (static_cast<std::size_t>(size_) < sizeof(T)) {
+      return nullptr;
+    }
+    return reinterpret_cast<const T *>(data_);
+  }
+
+ private:
+  void Own() {
+    holder_ = nullptr;
+    data_ = owned_.data();
+    size_ = static_cast<int>(owned_.size());
+  }
+
+  const char *data_ = nullptr;
+  int size_ = 0;
+  std::shared_ptr<const void> holder_ = nullptr;
+  std::string owned_;
+};
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_MESSAGE_RAW_MESSAGE_VIEW_H_
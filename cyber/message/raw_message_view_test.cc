@@ -0,0 +1,89 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/message/raw_message_view.h"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include "gtest/gtest.h"
+
+#include "cyber/message/message_traits.h"
+
+namespace apollo {
+namespace cyber {
+namespace message {
+
+struct FixedLayout {
+  int32_t id;
+  double value;
+};
+
+TEST(RawMessageViewTest, borrow_from_array) {
+  auto buf = std::make_shared<std::string>("borrow_from_array");
+  RawMessageView view;
+  EXPECT_FALSE(view.BorrowFromArray(nullptr, 8, buf));
+  EXPECT_TRUE(view.BorrowFromArray(buf->data(),
+                                   static_cast<int>(buf->size()), buf));
+  EXPECT_TRUE(view.is_borrowed());
+  EXPECT_EQ(view.data(), buf->data());
+  EXPECT_EQ(view.ByteSize(), static_cast<int>(buf->size()));
+  EXPECT_EQ(buf.use_count(), 2);
+
+  RawMessageView copy(view);
+  EXPECT_EQ(copy.data(), buf->data());
+  EXPECT_EQ(buf.use_count(), 3);
+}
+
+TEST(RawMessageViewTest, parse_from_array) {
+  std::string str("parse_from_array");
+  RawMessageView view;
+  EXPECT_FALSE(view.ParseFromArray(str.data(), 0));
+  EXPECT_TRUE(view.ParseFromArray(str.data(), static_cast<int>(str.size())));
+  EXPECT_FALSE(view.is_borrowed());
+  EXPECT_NE(view.data(), str.data());
+
+  RawMessageView copy;
+  copy = view;
+  EXPECT_NE(copy.data(), view.data());
+
+  std::string out;
+  EXPECT_TRUE(copy.SerializeToString(&out));
+  EXPECT_EQ(out, str);
+}
+
+TEST(RawMessageViewTest, fixed_layout) {
+  FixedLayout layout{7, 3.5};
+  auto holder = std::make_shared<FixedLayout>(layout);
+  RawMessageView view;
+  EXPECT_TRUE(
+      BorrowFromArray(holder.get(), sizeof(FixedLayout), holder, &view));
+  ASSERT_NE(view.As<FixedLayout>(), nullptr);
+  EXPECT_EQ(view.As<FixedLayout>()->id, 7);
+  EXPECT_DOUBLE_EQ(view.As<FixedLayout>()->value, 3.5);
+
+  RawMessageView small;
+  EXPECT_TRUE(small.ParseFromString("x"));
+  EXPECT_EQ(small.As<FixedLayout>(), nullptr);
+}
+
+TEST(RawMessageViewTest, message_type) {
+  EXPECT_EQ(MessageType<RawMessageView>(), "apollo.cyber.message.RawMessage");
+}
+
+}  // namespace message
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,64 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/node/intra_direct_registry.h"
+
+#include <cstdlib>
+#include <string>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+
+IntraDirectRegistry::IntraDirectRegistry() {
+  const char* direct = std::getenv("cyber_intra_direct");
+  enabled_ = direct != nullptr && std::string(direct) == "1";
+  if (enabled_) {
+    AINFO << "intra process readers and writers take the direct path.";
+  }
+}
+
+void IntraDirectRegistry::Add(uint64_t role_id, const std::type_index& type) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = roles_.find(role_id);
+  if (itr == roles_.end()) {
+    roles_.emplace(role_id, std::make_pair(type, 1));
+    return;
+  }
+  if (itr->second.first != type) {
+    AWARN << "role " << role_id << " registered with another message type.";
+    return;
+  }
+  ++itr->second.second;
+}
+
+void IntraDirectRegistry::Remove(uint64_t role_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = roles_.find(role_id);
+  if (itr != roles_.end() && --itr->second.second == 0) {
+    roles_.erase(itr);
+  }
+}
+
+bool IntraDirectRegistry::Match(uint64_t role_id, const std::type_index& type) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = roles_.find(role_id);
+  return itr != roles_.end() && itr->second.first == type;
+}
+
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,69 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_NODE_INTRA_DIRECT_REGISTRY_H_
+#define CYBER_NODE_INTRA_DIRECT_REGISTRY_H_
+
+#include <cstdint>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+
+#include "cyber/common/macros.h"
+
+namespace apollo {
+namespace cyber {
+
+/**
+ * @class IntraDirectRegistry
+ * @brief The readers and writers of this process taking the direct path.
+ *
+ * With cyber_intra_direct=1, a Writer<M> puts its messages straight into the
+ * DataDispatcher<M> buffers of the channel, which wakes up the routines of
+ * every Reader<M> of the process. A writer and a reader registered with the
+ * same message type therefore skip the transport between them, so neither
+ * IntraDispatcher nor the serialization fallback is involved. Readers of
+ * another type, and those of other processes, still go through the
+ * transport.
+ *
+ * Roles are keyed by their id. Readers of a channel share the id of their
+ * receiver, so each id is counted.
+ */
+class IntraDirectRegistry {
+ public:
+  bool Enabled() const { return enabled_; }
+
+  void Add(uint64_t role_id, const std::type_index& type);
+  void Remove(uint64_t role_id);
+
+  /**
+   * @brief Whether the role is registered with the message type type.
+   */
+  bool Match(uint64_t role_id, const std::type_index& type);
+
+ private:
+  bool enabled_ = false;
+  std::mutex mutex_;
+  std::unordered_map<uint64_t, std::pair<std::type_index, int>> roles_;
+
+  DECLARE_SINGLETON(IntraDirectRegistry)
+};
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_NODE_INTRA_DIRECT_REGISTRY_H_
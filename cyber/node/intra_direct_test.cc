@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <typeindex>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/init.h"
+#include "cyber/message/raw_message.h"
+#include "cyber/node/intra_direct_registry.h"
+#include "cyber/node/reader.h"
+#include "cyber/node/writer.h"
+#include "cyber/proto/unit_test.pb.h"
+
+namespace apollo {
+namespace cyber {
+
+TEST(IntraDirectTest, registry) {
+  auto registry = IntraDirectRegistry::Instance();
+  EXPECT_TRUE(registry->Enabled());
+
+  std::type_index type(typeid(proto::UnitTest));
+  std::type_index raw_type(typeid(message::RawMessage));
+  EXPECT_FALSE(registry->Match(1, type));
+  registry->Add(1, type);
+  EXPECT_TRUE(registry->Match(1, type));
+  EXPECT_FALSE(registry->Match(1, raw_type));
+  EXPECT_FALSE(registry->Match(2, type));
+
+  // readers of a channel share their id
+  registry->Add(1, type);
+  registry->Remove(1);
+  EXPECT_TRUE(registry->Match(1, type));
+  registry->Remove(1);
+  EXPECT_FALSE(registry->Match(1, type));
+}
+
+TEST(IntraDirectTest, messaging) {
+  proto::RoleAttributes attr;
+  attr.set_node_name("writer");
+  attr.set_channel_name("intra_direct");
+  auto channel_id = common::GlobalData::RegisterChannel(attr.channel_name());
+  attr.set_channel_id(channel_id);
+
+  Writer<proto::UnitTest> writer(attr);
+  EXPECT_TRUE(writer.Init());
+
+  std::mutex mtx;
+  std::vector<std::shared_ptr<proto::UnitTest>> recv_msgs;
+  attr.set_node_name("reader_a");
+  Reader<proto::UnitTest> reader_a(
+      attr, [&](const std::shared_ptr<proto::UnitTest>& msg) {
+        std::lock_guard<std::mutex> lck(mtx);
+        recv_msgs.emplace_back(msg);
+      });
+  EXPECT_TRUE(reader_a.Init());
+
+  attr.set_node_name("reader_b");
+  Reader<proto::UnitTest> reader_b(
+      attr, [&](const std::shared_ptr<proto::UnitTest>& msg) {
+        std::lock_guard<std::mutex> lck(mtx);
+        recv_msgs.emplace_back(msg);
+      });
+  EXPECT_TRUE(reader_b.Init());
+
+  // a reader of another type still goes through the transport
+  std::vector<std::string> raw_msgs;
+  attr.set_node_name("raw_reader");
+  Reader<message::RawMessage> raw_reader(
+      attr, [&](const std::shared_ptr<message::RawMessage>& msg) {
+        std::lock_guard<std::mutex> lck(mtx);
+        raw_msgs.emplace_back(msg->message);
+      });
+  EXPECT_TRUE(raw_reader.Init());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  auto msg = std::make_shared<proto::UnitTest>();
+  msg->set_class_name("IntraDirectTest");
+  msg->set_case_name("messaging");
+  const int num = 5;
+  for (int i = 0; i < num; ++i) {
+    EXPECT_TRUE(writer.Write(msg));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  {
+    std::lock_guard<std::mutex> lck(mtx);
+    // every reader gets every message exactly once, the same instance
+    ASSERT_EQ(2 * num, recv_msgs.size());
+    for (auto& recv_msg : recv_msgs) {
+      EXPECT_EQ(msg.get(), recv_msg.get());
+    }
+    ASSERT_EQ(num, raw_msgs.size());
+    proto::UnitTest parsed;
+    EXPECT_TRUE(parsed.ParseFromString(raw_msgs[0]));
+    EXPECT_EQ("messaging", parsed.case_name());
+  }
+
+  // the remaining reader still gets the messages
+  reader_a.Shutdown();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  recv_msgs.clear();
+  EXPECT_TRUE(writer.Write(msg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  {
+    std::lock_guard<std::mutex> lck(mtx);
+    EXPECT_EQ(1, recv_msgs.size());
+  }
+
+  writer.Shutdown();
+  reader_b.Shutdown();
+  raw_reader.Shutdown();
+}
+
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  setenv("cyber_intra_direct", "1", 1);
+  testing::InitGoogleTest(&argc, argv);
+  apollo::cyber::Init(argv[0]);
+  return RUN_ALL_TESTS();
+}
@@ -46,6 +46,7 @@ class Node {
   template <typename M0, typename M1, typename M2, typename M3>
   friend class Component;
   friend class TimerComponent;
+  friend class SysMo;
   friend std::unique_ptr<Node> CreateNode(const std::string&,
                                           const std::string&);
   virtual ~Node();
@@ -122,6 +123,21 @@ class Node {
                     const CallbackFunc<MessageT>& reader_func = nullptr)
       -> std::shared_ptr<cyber::Reader<MessageT>>;
 
+  /**
+   * @brief Create a Reader which handles its messages in batches, for high
+   * rate channels
+   *
+   * @tparam MessageT Message Type
+   * @param config instance of `ReaderConfig`, whose batch_policy bounds the
+   * size and the latency of the batches
+   * @param batch_func invoked with the messages received since its last call
+   * @return std::shared_ptr<cyber::Reader<MessageT>> result Reader Object
+   */
+  template <typename MessageT>
+  auto CreateBatchReader(const ReaderConfig& config,
+                         const BatchCallbackFunc<MessageT>& batch_func)
+      -> std::shared_ptr<cyber::Reader<MessageT>>;
+
   /**
    * @brief Create a Service object with specific `service_name`
    *
@@ -232,6 +248,24 @@ auto Node::CreateReader(const ReaderConfig& config,
   return reader;
 }
 
+template <typename MessageT>
+auto Node::CreateBatchReader(const ReaderConfig& config,
+                             const BatchCallbackFunc<MessageT>& batch_func)
+    -> std::shared_ptr<cyber::Reader<MessageT>> {
+  std::lock_guard<std::mutex> lg(readers_mutex_);
+  if (readers_.find(config.channel_name) != readers_.end()) {
+    AWARN << "Failed to create reader: reader with the same channel already "
+             "exists.";
+    return nullptr;
+  }
+  auto reader = node_channel_impl_->template CreateBatchReader<MessageT>(
+      config, batch_func);
+  if (reader != nullptr) {
+    readers_.emplace(std::make_pair(config.channel_name, reader));
+  }
+  return reader;
+}
+
 template <typename MessageT>
 auto Node::CreateReader(const std::string& channel_name,
                         const CallbackFunc<MessageT>& reader_func)
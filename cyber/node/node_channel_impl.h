@@ -47,7 +47,8 @@ struct ReaderConfig {  ///< configurations for a Reader
   ReaderConfig(const ReaderConfig& other)
       : channel_name(other.channel_name),
         qos_profile(other.qos_profile),
-        pending_queue_size(other.pending_queue_size) {}
+        pending_queue_size(other.pending_queue_size),
+        batch_policy(other.batch_policy) {}
 
   std::string channel_name;       //< channel reads
   proto::QosProfile qos_profile;  //< the qos configuration
@@ -56,6 +57,11 @@ struct ReaderConfig {  ///< configurations for a Reader
    * Older messages will dropped if you have no time to handle
    */
   uint32_t pending_queue_size;
+  /**
+   * @brief size and latency bounds of the batches of a batch reader.
+   * Its pending_queue_size should hold at least max_batch_size messages.
+   */
+  croutine::BatchPolicy batch_policy;
 };
 
 /**
@@ -138,6 +144,11 @@ class NodeChannelImpl {
   auto CreateReader(const proto::RoleAttributes& role_attr)
       -> std::shared_ptr<Reader<MessageT>>;
 
+  template <typename MessageT>
+  auto CreateBatchReader(const ReaderConfig& config,
+                         const BatchCallbackFunc<MessageT>& batch_func)
+      -> std::shared_ptr<Reader<MessageT>>;
+
   template <typename MessageT>
   void FillInAttr(proto::RoleAttributes* attr);
 
@@ -230,6 +241,38 @@ auto NodeChannelImpl::CreateReader(const proto::RoleAttributes& role_attr)
   return this->template CreateReader<MessageT>(role_attr, nullptr);
 }
 
+template <typename MessageT>
+auto NodeChannelImpl::CreateBatchReader(
+    const ReaderConfig& config, const BatchCallbackFunc<MessageT>& batch_func)
+    -> std::shared_ptr<Reader<MessageT>> {
+  if (config.channel_name.empty()) {
+    AERROR << "Can't create a reader with empty channel name!";
+    return nullptr;
+  }
+
+  proto::RoleAttributes new_attr;
+  new_attr.set_channel_name(config.channel_name);
+  new_attr.mutable_qos_profile()->CopyFrom(config.qos_profile);
+  FillInAttr<MessageT>(&new_attr);
+
+  std::shared_ptr<Reader<MessageT>> reader_ptr = nullptr;
+  if (!is_reality_mode_) {
+    // messages are delivered one by one in simulation mode
+    auto reader_func = [batch_func](const std::shared_ptr<MessageT>& msg) {
+      batch_func({msg});
+    };
+    reader_ptr =
+        std::make_shared<blocker::IntraReader<MessageT>>(new_attr, reader_func);
+  } else {
+    reader_ptr = std::make_shared<Reader<MessageT>>(
+        new_attr, batch_func, config.batch_policy, config.pending_queue_size);
+  }
+
+  RETURN_VAL_IF_NULL(reader_ptr, nullptr);
+  RETURN_VAL_IF(!reader_ptr->Init(), nullptr);
+  return reader_ptr;
+}
+
 template <typename MessageT>
 void NodeChannelImpl::FillInAttr(proto::RoleAttributes* attr) {
   attr->set_host_name(node_attr_.host_name());
@@ -22,6 +22,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <typeindex>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -30,6 +31,7 @@
 #include "cyber/common/global_data.h"
 #include "cyber/croutine/routine_factory.h"
 #include "cyber/data/data_visitor.h"
+#include "cyber/node/intra_direct_registry.h"
 #include "cyber/node/reader_base.h"
 #include "cyber/proto/topology_change.pb.h"
 #include "cyber/scheduler/scheduler_factory.h"
@@ -43,6 +45,10 @@ namespace cyber {
 template <typename M0>
 using CallbackFunc = std::function<void(const std::shared_ptr<M0>&)>;
 
+template <typename M0>
+using BatchCallbackFunc =
+    std::function<void(const std::vector<std::shared_ptr<M0>>&)>;
+
 using proto::RoleType;
 
 const uint32_t DEFAULT_PENDING_QUEUE_SIZE = 1;
@@ -56,7 +62,9 @@ const uint32_t DEFAULT_PENDING_QUEUE_SIZE = 1;
  * messages from `PublishQueue` to `ObserveQueue`. But, if you have set
  * CallbackFunc, you can ignore this. One Reader uses one `ChannelBuffer`, the
  * message we are handling is stored in ChannelBuffer Reader will Join the
- * topology when init and Leave the topology when shutdown
+ * topology when init and Leave the topology when shutdown.
+ * A `BatchCallbackFunc` instead receives all the messages buffered since its
+ * last call at once, see `croutine::BatchPolicy`.
  * @warning To save resource, `ChannelBuffer` has limited length,
  * it's passed through the `pending_queue_size` param. pending_queue_size is
  * default set to 1, So, If you handle slower than writer sending, older
@@ -85,6 +93,19 @@ class Reader : public ReaderBase {
   explicit Reader(const proto::RoleAttributes& role_attr,
                   const CallbackFunc<MessageT>& reader_func = nullptr,
                   uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE);
+
+  /**
+   * Constructor a Reader object which handles its messages in batches.
+   * @param batch_func is called with the messages received since its last
+   * call, oldest first.
+   * @param batch_policy bounds the size and the latency of a batch.
+   * @param pending_queue_size is the max depth of message cache queue, which
+   * should hold at least one batch.
+   */
+  Reader(const proto::RoleAttributes& role_attr,
+         const BatchCallbackFunc<MessageT>& batch_func,
+         const croutine::BatchPolicy& batch_policy,
+         uint32_t pending_queue_size = DEFAULT_PENDING_QUEUE_SIZE);
   virtual ~Reader();
 
   /**
@@ -214,12 +235,18 @@ class Reader : public ReaderBase {
   void JoinTheTopology();
   void LeaveTheTopology();
   void OnChannelChange(const proto::ChangeMsg& change_msg);
+  // Whether the writer puts its messages into our buffers itself.
+  bool IsDirectWriter(const proto::RoleAttributes& writer_attr);
 
   CallbackFunc<MessageT> reader_func_;
+  BatchCallbackFunc<MessageT> batch_func_;
+  croutine::BatchPolicy batch_policy_;
   ReceiverPtr receiver_ = nullptr;
   std::string croutine_name_;
 
   BlockerPtr blocker_ = nullptr;
+  // registered to IntraDirectRegistry
+  bool direct_ = false;
 
   ChangeConnection change_conn_;
   service_discovery::ChannelManagerPtr channel_manager_ = nullptr;
@@ -236,6 +263,19 @@ Reader<MessageT>::Reader(const proto::RoleAttributes& role_attr,
       role_attr.qos_profile().depth(), role_attr.channel_name())));
 }
 
+template <typename MessageT>
+Reader<MessageT>::Reader(const proto::RoleAttributes& role_attr,
+                         const BatchCallbackFunc<MessageT>& batch_func,
+                         const croutine::BatchPolicy& batch_policy,
+                         uint32_t pending_queue_size)
+    : ReaderBase(role_attr),
+      pending_queue_size_(pending_queue_size),
+      batch_func_(batch_func),
+      batch_policy_(batch_policy) {
+  blocker_.reset(new blocker::Blocker<MessageT>(blocker::BlockerAttr(
+      role_attr.qos_profile().depth(), role_attr.channel_name())));
+}
+
 template <typename MessageT>
 Reader<MessageT>::~Reader() {
   Shutdown();
@@ -258,22 +298,35 @@ bool Reader<MessageT>::Init() {
   if (init_.exchange(true)) {
     return true;
   }
-  std::function<void(const std::shared_ptr<MessageT>&)> func;
-  if (reader_func_ != nullptr) {
-    func = [this](const std::shared_ptr<MessageT>& msg) {
-      this->Enqueue(msg);
-      this->reader_func_(msg);
-    };
-  } else {
-    func = [this](const std::shared_ptr<MessageT>& msg) { this->Enqueue(msg); };
-  }
   auto sched = scheduler::Instance();
   croutine_name_ = role_attr_.node_name() + "_" + role_attr_.channel_name();
   auto dv = std::make_shared<data::DataVisitor<MessageT>>(
       role_attr_.channel_id(), pending_queue_size_);
   // Using factory to wrap templates.
-  croutine::RoutineFactory factory =
-      croutine::CreateRoutineFactory<MessageT>(std::move(func), dv);
+  croutine::RoutineFactory factory;
+  if (batch_func_ != nullptr) {
+    auto func = [this](const std::vector<std::shared_ptr<MessageT>>& msgs) {
+      for (auto& msg : msgs) {
+        this->Enqueue(msg);
+      }
+      this->batch_func_(msgs);
+    };
+    factory = croutine::CreateBatchRoutineFactory<MessageT>(
+        std::move(func), dv, batch_policy_);
+  } else {
+    std::function<void(const std::shared_ptr<MessageT>&)> func;
+    if (reader_func_ != nullptr) {
+      func = [this](const std::shared_ptr<MessageT>& msg) {
+        this->Enqueue(msg);
+        this->reader_func_(msg);
+      };
+    } else {
+      func = [this](const std::shared_ptr<MessageT>& msg) {
+        this->Enqueue(msg);
+      };
+    }
+    factory = croutine::CreateRoutineFactory<MessageT>(std::move(func), dv);
+  }
   if (!sched->CreateTask(factory, croutine_name_)) {
     AERROR << "Create Task Failed!";
     init_.store(false);
@@ -282,6 +335,11 @@ bool Reader<MessageT>::Init() {
 
   receiver_ = ReceiverManager<MessageT>::Instance()->GetReceiver(role_attr_);
   this->role_attr_.set_id(receiver_->id().HashValue());
+  direct_ = IntraDirectRegistry::Instance()->Enabled();
+  if (direct_) {
+    IntraDirectRegistry::Instance()->Add(role_attr_.id(),
+                                         std::type_index(typeid(MessageT)));
+  }
   channel_manager_ =
       service_discovery::TopologyManager::Instance()->channel_manager();
   JoinTheTopology();
@@ -295,6 +353,9 @@ void Reader<MessageT>::Shutdown() {
     return;
   }
   LeaveTheTopology();
+  if (direct_) {
+    IntraDirectRegistry::Instance()->Remove(role_attr_.id());
+  }
   receiver_ = nullptr;
   channel_manager_ = nullptr;
 
@@ -314,7 +375,9 @@ void Reader<MessageT>::JoinTheTopology() {
   std::vector<proto::RoleAttributes> writers;
   channel_manager_->GetWritersOfChannel(channel_name, &writers);
   for (auto& writer : writers) {
-    receiver_->Enable(writer);
+    if (!IsDirectWriter(writer)) {
+      receiver_->Enable(writer);
+    }
   }
   channel_manager_->Join(this->role_attr_, proto::RoleType::ROLE_READER,
                          message::HasSerializer<MessageT>::value);
@@ -339,12 +402,21 @@ void Reader<MessageT>::OnChannelChange(const proto::ChangeMsg& change_msg) {
 
   auto operate_type = change_msg.operate_type();
   if (operate_type == proto::OperateType::OPT_JOIN) {
-    receiver_->Enable(writer_attr);
+    if (!IsDirectWriter(writer_attr)) {
+      receiver_->Enable(writer_attr);
+    }
   } else {
     receiver_->Disable(writer_attr);
   }
 }
 
+template <typename MessageT>
+bool Reader<MessageT>::IsDirectWriter(
+    const proto::RoleAttributes& writer_attr) {
+  return direct_ && IntraDirectRegistry::Instance()->Match(
+                        writer_attr.id(), std::type_index(typeid(MessageT)));
+}
+
 template <typename MessageT>
 bool Reader<MessageT>::HasReceived() const {
   return !blocker_->IsPublishedEmpty();
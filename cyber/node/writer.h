@@ -17,14 +17,21 @@
 #ifndef CYBER_NODE_WRITER_H_
 #define CYBER_NODE_WRITER_H_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <typeindex>
 #include <vector>
 
 #include "cyber/common/log.h"
+#include "cyber/data/data_dispatcher.h"
+#include "cyber/node/intra_direct_registry.h"
 #include "cyber/node/writer_base.h"
 #include "cyber/proto/topology_change.pb.h"
 #include "cyber/service_discovery/topology_manager.h"
+#include "cyber/transport/message/loaned_message.h"
 #include "cyber/transport/transport.h"
 
 namespace apollo {
@@ -41,6 +48,7 @@ template <typename MessageT>
 class Writer : public WriterBase {
  public:
   using TransmitterPtr = std::shared_ptr<transport::Transmitter<MessageT>>;
+  using LoanedMessage = transport::LoanedMessage<MessageT>;
   using ChangeConnection =
       typename service_discovery::Manager::ChangeConnection;
 
@@ -83,6 +91,25 @@ class Writer : public WriterBase {
    */
   virtual bool Write(const std::shared_ptr<MessageT>& msg_ptr);
 
+  /**
+   * @brief Borrow a shared memory block of at least `size` bytes to build the
+   * next message in place, skipping the serialize step of Write. Only
+   * available when readers are reached through the SHM transport.
+   *
+   * @param size the payload size in bytes
+   * @return an invalid LoanedMessage if no block could be borrowed
+   */
+  LoanedMessage Loan(std::size_t size);
+
+  /**
+   * @brief Publish a message previously obtained by Loan
+   *
+   * @param loaned_msg the loan to consume
+   * @return true if write successfully
+   * @return false if write failed
+   */
+  bool Write(LoanedMessage* loaned_msg);
+
   /**
    * @brief Is there any Reader that subscribes our Channel?
    * You can publish message when this return true
@@ -103,9 +130,21 @@ class Writer : public WriterBase {
   void JoinTheTopology();
   void LeaveTheTopology();
   void OnChannelChange(const proto::ChangeMsg& change_msg);
+  // Connects the reader through the transport, unless it takes the direct
+  // path.
+  void EnableReader(const proto::RoleAttributes& reader_attr);
+  void DisableReader(const proto::RoleAttributes& reader_attr);
+  void DispatchDirect(const std::shared_ptr<MessageT>& msg_ptr);
 
   TransmitterPtr transmitter_;
 
+  // Whether the writer is registered to IntraDirectRegistry, and the
+  // readers it reaches directly.
+  bool direct_ = false;
+  std::mutex direct_mutex_;
+  std::multiset<uint64_t> direct_readers_;
+  std::atomic<size_t> direct_reader_num_ = {0};
+
   ChangeConnection change_conn_;
   service_discovery::ChannelManagerPtr channel_manager_;
 };
@@ -135,6 +174,14 @@ bool Writer<MessageT>::Init() {
     init_ = true;
   }
   this->role_attr_.set_id(transmitter_->id().HashValue());
+  // late joiners get the history through the transport
+  auto registry = IntraDirectRegistry::Instance();
+  direct_ = registry->Enabled() &&
+            role_attr_.qos_profile().durability() !=
+                proto::QosDurabilityPolicy::DURABILITY_TRANSIENT_LOCAL;
+  if (direct_) {
+    registry->Add(role_attr_.id(), std::type_index(typeid(MessageT)));
+  }
   channel_manager_ =
       service_discovery::TopologyManager::Instance()->channel_manager();
   JoinTheTopology();
@@ -151,6 +198,12 @@ void Writer<MessageT>::Shutdown() {
     init_ = false;
   }
   LeaveTheTopology();
+  if (direct_) {
+    IntraDirectRegistry::Instance()->Remove(role_attr_.id());
+    std::lock_guard<std::mutex> lock(direct_mutex_);
+    direct_readers_.clear();
+    direct_reader_num_.store(0);
+  }
   transmitter_ = nullptr;
   channel_manager_ = nullptr;
 }
@@ -165,9 +218,52 @@ bool Writer<MessageT>::Write(const MessageT& msg) {
 template <typename MessageT>
 bool Writer<MessageT>::Write(const std::shared_ptr<MessageT>& msg_ptr) {
   RETURN_VAL_IF(!WriterBase::IsInit(), false);
+  DispatchDirect(msg_ptr);
   return transmitter_->Transmit(msg_ptr);
 }
 
+template <typename MessageT>
+void Writer<MessageT>::DispatchDirect(
+    const std::shared_ptr<MessageT>& msg_ptr) {
+  if (direct_reader_num_.load(std::memory_order_acquire) == 0) {
+    return;
+  }
+  data::DataDispatcher<MessageT>::Instance()->Dispatch(role_attr_.channel_id(),
+                                                       msg_ptr);
+}
+
+template <typename MessageT>
+typename Writer<MessageT>::LoanedMessage Writer<MessageT>::Loan(
+    std::size_t size) {
+  RETURN_VAL_IF(!WriterBase::IsInit(), LoanedMessage());
+  RETURN_VAL_IF_NULL(transmitter_, LoanedMessage());
+  transport::WritableBlock block;
+  if (!transmitter_->AcquireLoan(size, &block)) {
+    return LoanedMessage();
+  }
+  return LoanedMessage(transmitter_, block, size);
+}
+
+template <typename MessageT>
+bool Writer<MessageT>::Write(LoanedMessage* loaned_msg) {
+  RETURN_VAL_IF_NULL(loaned_msg, false);
+  RETURN_VAL_IF(!WriterBase::IsInit(), false);
+  // the block may be reused by other writers once it is published
+  if (direct_reader_num_.load(std::memory_order_acquire) > 0 &&
+      loaned_msg->IsValid()) {
+    auto msg_ptr = std::make_shared<MessageT>();
+    if (message::ParseFromArray(loaned_msg->data(),
+                                static_cast<int>(loaned_msg->size()),
+                                msg_ptr.get())) {
+      DispatchDirect(msg_ptr);
+    } else {
+      AERROR << "parse loaned message failed, channel: "
+             << role_attr_.channel_name();
+    }
+  }
+  return loaned_msg->Publish();
+}
+
 template <typename MessageT>
 void Writer<MessageT>::JoinTheTopology() {
   // add listener
@@ -179,7 +275,7 @@ void Writer<MessageT>::JoinTheTopology() {
   std::vector<proto::RoleAttributes> readers;
   channel_manager_->GetReadersOfChannel(channel_name, &readers);
   for (auto& reader : readers) {
-    transmitter_->Enable(reader);
+    EnableReader(reader);
   }
 
   channel_manager_->Join(this->role_attr_, proto::RoleType::ROLE_WRITER,
@@ -205,10 +301,39 @@ void Writer<MessageT>::OnChannelChange(const proto::ChangeMsg& change_msg) {
 
   auto operate_type = change_msg.operate_type();
   if (operate_type == proto::OperateType::OPT_JOIN) {
-    transmitter_->Enable(reader_attr);
+    EnableReader(reader_attr);
   } else {
-    transmitter_->Disable(reader_attr);
+    DisableReader(reader_attr);
+  }
+}
+
+template <typename MessageT>
+void Writer<MessageT>::EnableReader(const proto::RoleAttributes& reader_attr) {
+  if (direct_ && IntraDirectRegistry::Instance()->Match(
+                     reader_attr.id(), std::type_index(typeid(MessageT)))) {
+    std::lock_guard<std::mutex> lock(direct_mutex_);
+    direct_readers_.insert(reader_attr.id());
+    direct_reader_num_.store(direct_readers_.size(),
+                             std::memory_order_release);
+    return;
+  }
+  transmitter_->Enable(reader_attr);
+}
+
+template <typename MessageT>
+void Writer<MessageT>::DisableReader(const proto::RoleAttributes& reader_attr) {
+  // the reader may have left the registry already
+  {
+    std::lock_guard<std::mutex> lock(direct_mutex_);
+    auto itr = direct_readers_.find(reader_attr.id());
+    if (itr != direct_readers_.end()) {
+      direct_readers_.erase(itr);
+      direct_reader_num_.store(direct_readers_.size(),
+                               std::memory_order_release);
+      return;
+    }
   }
+  transmitter_->Disable(reader_attr);
 }
 
 template <typename MessageT>
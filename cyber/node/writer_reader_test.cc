@@ -162,6 +162,63 @@ TEST(WriterReaderTest, messaging) {
   reader_b.Shutdown();
 }
 
+TEST(WriterReaderTest, batch_messaging) {
+  proto::RoleAttributes attr;
+  attr.set_node_name("writer");
+  attr.set_channel_name("batch_messaging");
+  auto channel_id = common::GlobalData::RegisterChannel(attr.channel_name());
+  attr.set_channel_id(channel_id);
+
+  Writer<proto::UnitTest> writer(attr);
+  EXPECT_TRUE(writer.Init());
+
+  std::mutex mtx;
+  std::vector<size_t> batch_sizes;
+  std::vector<std::string> recv_cases;
+  attr.set_node_name("batch_reader");
+  croutine::BatchPolicy policy;
+  policy.max_batch_size = 4;
+  policy.max_latency_us = 100000;
+  Reader<proto::UnitTest> reader(
+      attr,
+      [&](const std::vector<std::shared_ptr<proto::UnitTest>>& msgs) {
+        std::lock_guard<std::mutex> lck(mtx);
+        batch_sizes.push_back(msgs.size());
+        for (auto& msg : msgs) {
+          recv_cases.push_back(msg->case_name());
+        }
+      },
+      policy, 16);
+  EXPECT_TRUE(reader.Init());
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  const int num = 6;
+  for (int i = 0; i < num; ++i) {
+    auto msg = std::make_shared<proto::UnitTest>();
+    msg->set_case_name(std::to_string(i));
+    EXPECT_TRUE(writer.Write(msg));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  {
+    std::lock_guard<std::mutex> lck(mtx);
+    // messages are delivered in order, at most max_batch_size at once, and
+    // the last incomplete batch once the latency is reached
+    ASSERT_EQ(num, recv_cases.size());
+    for (int i = 0; i < num; ++i) {
+      EXPECT_EQ(std::to_string(i), recv_cases[i]);
+    }
+    EXPECT_LT(1, recv_cases.size() / batch_sizes.size());
+    for (auto size : batch_sizes) {
+      EXPECT_GE(policy.max_batch_size, size);
+    }
+  }
+  EXPECT_TRUE(reader.HasReceived());
+
+  writer.Shutdown();
+  reader.Shutdown();
+}
+
 TEST(WriterReaderTest, observe) {
   proto::RoleAttributes attr;
   attr.set_node_name("node");
@@ -0,0 +1,191 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/file/chunk_codec.h"
+
+#include <cstring>
+
+#include "lz4.h"
+#include "zstd.h"
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+namespace {
+
+// far above any chunk a writer produces, so that a corrupted frame can not
+// make the reader allocate an arbitrary amount of memory
+constexpr uint64_t kMaxChunkRawSize = 1ULL << 31;
+// an lz4 sequence expands to at most this many bytes per input byte
+constexpr uint64_t kMaxLz4Ratio = 255;
+
+bool IsRawSizeValid(const ChunkFrame& frame, const char* src,
+                    size_t src_size) {
+  if (frame.raw_size > kMaxChunkRawSize) {
+    return false;
+  }
+  switch (static_cast<ChunkCompression>(frame.compression)) {
+    case ChunkCompression::LZ4:
+      return frame.raw_size <= LZ4_MAX_INPUT_SIZE &&
+             frame.raw_size <= src_size * kMaxLz4Ratio;
+    case ChunkCompression::ZSTD:
+      // the zstd frame records the content size as well
+      return ZSTD_getFrameContentSize(src, src_size) == frame.raw_size;
+    default:
+      return true;
+  }
+}
+
+}  // namespace
+
+bool ParseChunkCompression(const std::string& name,
+                           ChunkCompression* compression) {
+  if (name == "none") {
+    *compression = ChunkCompression::NONE;
+  } else if (name == "lz4") {
+    *compression = ChunkCompression::LZ4;
+  } else if (name == "zstd") {
+    *compression = ChunkCompression::ZSTD;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+const char* ChunkCompressionName(ChunkCompression compression) {
+  switch (compression) {
+    case ChunkCompression::NONE:
+      return "none";
+    case ChunkCompression::LZ4:
+      return "lz4";
+    case ChunkCompression::ZSTD:
+      return "zstd";
+    default:
+      return "unknown";
+  }
+}
+
+bool IsChunkFrame(const ChunkFrame& frame) {
+  return memcmp(frame.magic, CHUNK_FRAME_MAGIC, sizeof(frame.magic)) == 0;
+}
+
+bool CompressChunk(ChunkCompression compression, int level,
+                   const std::string& raw, std::string* framed) {
+  ChunkFrame frame;
+  memcpy(frame.magic, CHUNK_FRAME_MAGIC, sizeof(frame.magic));
+  frame.compression = static_cast<uint32_t>(compression);
+  frame.raw_size = raw.size();
+
+  size_t bound = 0;
+  switch (compression) {
+    case ChunkCompression::LZ4:
+      if (raw.size() > LZ4_MAX_INPUT_SIZE) {
+        AERROR << "chunk too large for lz4: " << raw.size();
+        return false;
+      }
+      bound = LZ4_compressBound(static_cast<int>(raw.size()));
+      break;
+    case ChunkCompression::ZSTD:
+      bound = ZSTD_compressBound(raw.size());
+      break;
+    default:
+      AERROR << "unsupported chunk compression: "
+             << static_cast<uint32_t>(compression);
+      return false;
+  }
+
+  framed->resize(sizeof(frame) + bound);
+  memcpy(&(*framed)[0], &frame, sizeof(frame));
+  char* dst = &(*framed)[sizeof(frame)];
+  size_t size = 0;
+  if (compression == ChunkCompression::LZ4) {
+    int ret = level > 1 ? LZ4_compress_fast(raw.data(), dst,
+                                            static_cast<int>(raw.size()),
+                                            static_cast<int>(bound), level)
+                        : LZ4_compress_default(raw.data(), dst,
+                                               static_cast<int>(raw.size()),
+                                               static_cast<int>(bound));
+    if (ret <= 0) {
+      AERROR << "lz4 compress failed.";
+      return false;
+    }
+    size = ret;
+  } else {
+    size_t ret = ZSTD_compress(dst, bound, raw.data(), raw.size(),
+                               level > 0 ? level : ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(ret)) {
+      AERROR << "zstd compress failed: " << ZSTD_getErrorName(ret);
+      return false;
+    }
+    size = ret;
+  }
+  framed->resize(sizeof(frame) + size);
+  return true;
+}
+
+bool DecompressChunk(const char* framed, size_t size, std::string* raw) {
+  ChunkFrame frame;
+  if (size < sizeof(frame)) {
+    AERROR << "chunk is smaller than its frame: " << size;
+    return false;
+  }
+  memcpy(&frame, framed, sizeof(frame));
+  if (!IsChunkFrame(frame)) {
+    AERROR << "chunk frame magic mismatch.";
+    return false;
+  }
+
+  const char* src = framed + sizeof(frame);
+  size_t src_size = size - sizeof(frame);
+  if (!IsRawSizeValid(frame, src, src_size)) {
+    AERROR << "invalid chunk raw size: " << frame.raw_size
+           << ", compressed size: " << src_size;
+    return false;
+  }
+  raw->resize(frame.raw_size);
+  switch (static_cast<ChunkCompression>(frame.compression)) {
+    case ChunkCompression::LZ4: {
+      int ret = LZ4_decompress_safe(src, &(*raw)[0],
+                                    static_cast<int>(src_size),
+                                    static_cast<int>(frame.raw_size));
+      if (ret < 0 || static_cast<uint64_t>(ret) != frame.raw_size) {
+        AERROR << "lz4 decompress failed: " << ret;
+        return false;
+      }
+      break;
+    }
+    case ChunkCompression::ZSTD: {
+      size_t ret = ZSTD_decompress(&(*raw)[0], frame.raw_size, src, src_size);
+      if (ZSTD_isError(ret) || ret != frame.raw_size) {
+        AERROR << "zstd decompress failed: "
+               << (ZSTD_isError(ret) ? ZSTD_getErrorName(ret) : "size");
+        return false;
+      }
+      break;
+    }
+    default:
+      AERROR << "unsupported chunk compression: " << frame.compression;
+      return false;
+  }
+  return true;
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
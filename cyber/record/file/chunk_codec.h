@@ -0,0 +1,74 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_RECORD_FILE_CHUNK_CODEC_H_
+#define CYBER_RECORD_FILE_CHUNK_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+enum class ChunkCompression : uint32_t {
+  NONE = 0,
+  LZ4 = 1,   // fast, for recording on the vehicle
+  ZSTD = 2,  // dense, for archiving
+};
+
+/**
+ * @brief Header in front of a compressed chunk body section. A serialized
+ * ChunkBody never starts with a zero byte (field number 0 is not a valid
+ * protobuf tag), so the leading zero of the magic tells compressed chunks
+ * apart from the raw ones of older files.
+ */
+struct ChunkFrame {
+  char magic[4];
+  uint32_t compression;
+  uint64_t raw_size;
+};
+
+const char CHUNK_FRAME_MAGIC[4] = {'\0', 'C', 'K', 'Z'};
+
+bool ParseChunkCompression(const std::string& name,
+                           ChunkCompression* compression);
+const char* ChunkCompressionName(ChunkCompression compression);
+
+bool IsChunkFrame(const ChunkFrame& frame);
+
+/**
+ * @brief Compress a serialized chunk body into a ChunkFrame followed by the
+ * compressed bytes.
+ *
+ * @param level codec specific level, 0 for the codec default
+ *
+ * @return false if the codec is not supported or failed
+ */
+bool CompressChunk(ChunkCompression compression, int level,
+                   const std::string& raw, std::string* framed);
+
+/**
+ * @brief Inverse of CompressChunk, `framed` must start with a ChunkFrame.
+ */
+bool DecompressChunk(const char* framed, size_t size, std::string* raw);
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_RECORD_FILE_CHUNK_CODEC_H_
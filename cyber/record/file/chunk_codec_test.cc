@@ -0,0 +1,117 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/file/chunk_codec.h"
+
+#include <cstring>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+std::string MakeRawChunk() {
+  std::string raw;
+  for (int i = 0; i < 10000; ++i) {
+    raw.append("\x0a\x10/apollo/sensor/");
+    raw.append(std::to_string(i % 17));
+  }
+  return raw;
+}
+
+TEST(ChunkCodecTest, parse_name) {
+  ChunkCompression compression = ChunkCompression::NONE;
+  EXPECT_TRUE(ParseChunkCompression("lz4", &compression));
+  EXPECT_EQ(ChunkCompression::LZ4, compression);
+  EXPECT_TRUE(ParseChunkCompression("zstd", &compression));
+  EXPECT_EQ(ChunkCompression::ZSTD, compression);
+  EXPECT_TRUE(ParseChunkCompression("none", &compression));
+  EXPECT_EQ(ChunkCompression::NONE, compression);
+  EXPECT_FALSE(ParseChunkCompression("bz2", &compression));
+  EXPECT_STREQ("zstd", ChunkCompressionName(ChunkCompression::ZSTD));
+}
+
+TEST(ChunkCodecTest, round_trip) {
+  auto raw = MakeRawChunk();
+  for (auto compression : {ChunkCompression::LZ4, ChunkCompression::ZSTD}) {
+    std::string framed;
+    ASSERT_TRUE(CompressChunk(compression, 0, raw, &framed));
+    EXPECT_LT(framed.size(), raw.size());
+
+    ChunkFrame frame;
+    memcpy(&frame, framed.data(), sizeof(frame));
+    EXPECT_TRUE(IsChunkFrame(frame));
+    EXPECT_EQ(static_cast<uint32_t>(compression), frame.compression);
+    EXPECT_EQ(raw.size(), frame.raw_size);
+
+    std::string decompressed;
+    ASSERT_TRUE(DecompressChunk(framed.data(), framed.size(), &decompressed));
+    EXPECT_EQ(raw, decompressed);
+
+    // truncated input must be rejected instead of read out of bounds
+    EXPECT_FALSE(
+        DecompressChunk(framed.data(), framed.size() / 2, &decompressed));
+  }
+}
+
+TEST(ChunkCodecTest, corrupted_raw_size) {
+  auto raw = MakeRawChunk();
+  for (auto compression : {ChunkCompression::LZ4, ChunkCompression::ZSTD}) {
+    std::string framed;
+    ASSERT_TRUE(CompressChunk(compression, 0, raw, &framed));
+    ChunkFrame frame;
+    memcpy(&frame, framed.data(), sizeof(frame));
+
+    // rejected before anything is allocated for them
+    for (uint64_t raw_size : {UINT64_MAX, uint64_t{1} << 40,
+                              uint64_t{raw.size()} * 1000}) {
+      frame.raw_size = raw_size;
+      std::string corrupted = framed;
+      memcpy(&corrupted[0], &frame, sizeof(frame));
+      std::string decompressed;
+      EXPECT_FALSE(
+          DecompressChunk(corrupted.data(), corrupted.size(), &decompressed));
+      EXPECT_TRUE(decompressed.empty());
+    }
+
+    // plausible but wrong
+    frame.raw_size = raw.size() + 1;
+    std::string corrupted = framed;
+    memcpy(&corrupted[0], &frame, sizeof(frame));
+    std::string decompressed;
+    EXPECT_FALSE(
+        DecompressChunk(corrupted.data(), corrupted.size(), &decompressed));
+  }
+}
+
+TEST(ChunkCodecTest, raw_chunk_is_not_a_frame) {
+  auto raw = MakeRawChunk();
+  ChunkFrame frame;
+  memcpy(&frame, raw.data(), sizeof(frame));
+  EXPECT_FALSE(IsChunkFrame(frame));
+
+  std::string framed;
+  EXPECT_FALSE(CompressChunk(ChunkCompression::NONE, 0, raw, &framed));
+  std::string decompressed;
+  EXPECT_FALSE(DecompressChunk(raw.data(), raw.size(), &decompressed));
+  EXPECT_FALSE(DecompressChunk(raw.data(), 4, &decompressed));
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
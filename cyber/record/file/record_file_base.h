@@ -21,6 +21,7 @@
 #include <string>
 
 #include "cyber/proto/record.pb.h"
+#include "cyber/proto/record_index.pb.h"
 
 namespace apollo {
 namespace cyber {
@@ -37,6 +38,7 @@ class RecordFileBase {
   const std::string& GetPath() const { return path_; }
   const proto::Header& GetHeader() const { return header_; }
   const proto::Index& GetIndex() const { return index_; }
+  const proto::ChunkIndex& GetChunkIndex() const { return chunk_index_; }
   int64_t CurrentPosition();
   bool SetPosition(int64_t position);
 
@@ -45,6 +47,7 @@ class RecordFileBase {
   std::string path_;
   proto::Header header_;
   proto::Index index_;
+  proto::ChunkIndex chunk_index_;
   int fd_;
 };
 
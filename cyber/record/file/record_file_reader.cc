@@ -109,6 +109,59 @@ bool RecordFileReader::ReadIndex() {
   return true;
 }
 
+bool RecordFileReader::ReadChunkIndex() {
+  chunk_index_.Clear();
+  if (!SetPosition(header_.index_position())) {
+    AERROR << "Skip bytes for reaching the index section failed.";
+    return false;
+  }
+  Section section;
+  if (!ReadSection(&section) || !SkipSection(section.size)) {
+    AERROR << "Skip index section fail, maybe file is broken.";
+    return false;
+  }
+  bool found = false;
+  if (CurrentPosition() < static_cast<int64_t>(header_.size()) &&
+      ReadSection(&section) && section.type == SECTION_CHUNK_INDEX) {
+    found = ReadSection<proto::ChunkIndex>(section.size, &chunk_index_);
+    if (!found) {
+      AWARN << "Read chunk index section fail, rebuild it from the index.";
+      chunk_index_.Clear();
+    }
+  }
+  if (!found) {
+    BuildChunkIndex();
+  }
+  Reset();
+  return true;
+}
+
+void RecordFileReader::BuildChunkIndex() {
+  for (const auto& single_index : index_.indexes()) {
+    if (single_index.type() == SectionType::SECTION_CHUNK_HEADER &&
+        single_index.has_chunk_header_cache()) {
+      const auto& cache = single_index.chunk_header_cache();
+      auto chunk = chunk_index_.add_chunk();
+      chunk->set_header_position(single_index.position());
+      chunk->set_begin_time(cache.begin_time());
+      chunk->set_end_time(cache.end_time());
+      chunk->set_message_number(cache.message_number());
+    } else if (single_index.type() == SectionType::SECTION_CHUNK_BODY &&
+               chunk_index_.chunk_size() > 0) {
+      auto chunk = chunk_index_.mutable_chunk(chunk_index_.chunk_size() - 1);
+      if (!chunk->has_body_position()) {
+        chunk->set_body_position(single_index.position());
+      }
+    }
+  }
+  // a header whose body never made it to the file can not be read
+  while (chunk_index_.chunk_size() > 0 &&
+         !chunk_index_.chunk(chunk_index_.chunk_size() - 1)
+              .has_body_position()) {
+    chunk_index_.mutable_chunk()->RemoveLast();
+  }
+}
+
 bool RecordFileReader::ReadSection(Section* section) {
   ssize_t count = read(fd_, section, sizeof(struct Section));
   if (count < 0) {
@@ -127,6 +180,45 @@ bool RecordFileReader::ReadSection(Section* section) {
   return true;
 }
 
+bool RecordFileReader::IsCompressedSection(int64_t size) {
+  ChunkFrame frame;
+  if (size < static_cast<int64_t>(sizeof(frame))) {
+    return false;
+  }
+  ssize_t count = pread(fd_, &frame, sizeof(frame), CurrentPosition());
+  return count == sizeof(frame) && IsChunkFrame(frame);
+}
+
+bool RecordFileReader::ReadCompressedSection(
+    int64_t size, google::protobuf::Message* message) {
+  std::string framed(size, '\0');
+  int64_t offset = 0;
+  while (offset < size) {
+    ssize_t count = read(fd_, &framed[offset], size - offset);
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      AERROR << "Read fd failed, fd_: " << fd_ << ", expect count: " << size
+             << ", actual count: " << offset << ", errno: " << errno;
+      end_of_file_ = count == 0;
+      return false;
+    }
+    offset += count;
+  }
+
+  std::string raw;
+  if (!DecompressChunk(framed.data(), framed.size(), &raw)) {
+    AERROR << "Decompress section failed, file: " << path_;
+    return false;
+  }
+  if (!message->ParseFromString(raw)) {
+    AERROR << "Parse section message failed.";
+    return false;
+  }
+  return true;
+}
+
 bool RecordFileReader::SkipSection(int64_t size) {
   int64_t pos = CurrentPosition();
   if (size > INT64_MAX - pos) {
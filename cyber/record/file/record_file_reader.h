@@ -20,6 +20,7 @@
 #include <fstream>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 
@@ -29,6 +30,7 @@
 #include "google/protobuf/text_format.h"
 
 #include "cyber/common/log.h"
+#include "cyber/record/file/chunk_codec.h"
 #include "cyber/record/file/record_file_base.h"
 #include "cyber/record/file/section.h"
 #include "cyber/time/time.h"
@@ -53,10 +55,20 @@ class RecordFileReader : public RecordFileBase {
   template <typename T>
   bool ReadSection(int64_t size, T* message);
   bool ReadIndex();
+
+  /**
+   * @brief Load the chunk index that follows the index section. Files written
+   * before it existed get one rebuilt from the index section, without the
+   * channels of each chunk. Call it after ReadIndex succeeded.
+   */
+  bool ReadChunkIndex();
   bool EndOfFile() { return end_of_file_; }
 
  private:
   bool ReadHeader();
+  void BuildChunkIndex();
+  bool IsCompressedSection(int64_t size);
+  bool ReadCompressedSection(int64_t size, google::protobuf::Message* message);
   bool end_of_file_ = false;
 };
 
@@ -66,6 +78,10 @@ bool RecordFileReader::ReadSection(int64_t size, T* message) {
     AERROR << "Size value greater than the range of int value.";
     return false;
   }
+  // chunk bodies may be compressed, older files only hold raw ones
+  if (std::is_same<T, proto::ChunkBody>::value && IsCompressedSection(size)) {
+    return ReadCompressedSection(size, message);
+  }
   FileInputStream raw_input(fd_, static_cast<int>(size));
   CodedInputStream coded_input(&raw_input);
   CodedInputStream::Limit limit = coded_input.PushLimit(static_cast<int>(size));
@@ -288,7 +288,8 @@ TEST(RecordFileTest, TestIndex) {
          reader.ReadSection(&section) && reader.SkipSection(section.size);
          pos = reader.CurrentPosition()) {
       // Find index at position
-      if (section.type != SectionType::SECTION_INDEX) {
+      if (section.type != SectionType::SECTION_INDEX &&
+          section.type != SECTION_CHUNK_INDEX) {
         bool found = false;
         proto::SingleIndex match;
         for (const auto& row : index.indexes()) {
@@ -303,6 +304,76 @@ TEST(RecordFileTest, TestIndex) {
         EXPECT_EQ(match.type(), section.type);
       }
     }
+
+    ASSERT_TRUE(reader.ReadChunkIndex());
+    const auto& chunk_index = reader.GetChunkIndex();
+    ASSERT_EQ(1, chunk_index.chunk_size());
+    ASSERT_EQ(2, chunk_index.channel_name_size());
+    const auto& chunk = chunk_index.chunk(0);
+    ASSERT_EQ(2, chunk.channel_size());
+    for (const auto& channel : chunk.channel()) {
+      const auto& name = chunk_index.channel_name(channel.channel_id());
+      if (name == kChan1) {
+        EXPECT_EQ(2, channel.message_number());
+        EXPECT_EQ(1e9, channel.begin_time());
+        EXPECT_EQ(3e9, channel.end_time());
+      } else {
+        EXPECT_EQ(kChan2, name);
+        EXPECT_EQ(1, channel.message_number());
+        EXPECT_EQ(2e9, channel.begin_time());
+      }
+    }
+  }
+}
+
+TEST(RecordFileTest, TestCompressedChunk) {
+  for (auto compression : {ChunkCompression::LZ4, ChunkCompression::ZSTD}) {
+    RecordFileWriter rfw;
+    rfw.SetCompression(compression);
+    ASSERT_TRUE(rfw.Open(kTestFile1));
+    Header hdr = HeaderBuilder::GetHeaderWithSegmentParams(0, 0);
+    hdr.set_chunk_interval(0);
+    hdr.set_chunk_raw_size(0);
+    ASSERT_TRUE(rfw.WriteHeader(hdr));
+
+    Channel chan;
+    chan.set_name(kChan1);
+    chan.set_message_type(kMsgType);
+    chan.set_proto_desc(kStr10B);
+    ASSERT_TRUE(rfw.WriteChannel(chan));
+
+    SingleMessage msg;
+    msg.set_channel_name(chan.name());
+    msg.set_content(std::string(4096, 'x'));
+    msg.set_time(1e9);
+    ASSERT_TRUE(rfw.WriteMessage(msg));
+    rfw.Close();
+
+    RecordFileReader rfr;
+    ASSERT_TRUE(rfr.Open(kTestFile1));
+    Section sec;
+    ASSERT_TRUE(rfr.ReadSection(&sec));
+    ASSERT_EQ(SectionType::SECTION_CHANNEL, sec.type);
+    ASSERT_TRUE(rfr.SkipSection(sec.size));
+    ASSERT_TRUE(rfr.ReadSection(&sec));
+    ASSERT_EQ(SectionType::SECTION_CHUNK_HEADER, sec.type);
+    ChunkHeader ckh;
+    ASSERT_TRUE(rfr.ReadSection<ChunkHeader>(sec.size, &ckh));
+    ASSERT_EQ(4096, ckh.raw_size());
+
+    ASSERT_TRUE(rfr.ReadSection(&sec));
+    ASSERT_EQ(SectionType::SECTION_CHUNK_BODY, sec.type);
+    ASSERT_LT(sec.size, 4096);
+    ChunkBody ckb;
+    ASSERT_TRUE(rfr.ReadSection<ChunkBody>(sec.size, &ckb));
+    ASSERT_EQ(1, ckb.messages_size());
+    ASSERT_EQ(msg.content(), ckb.messages(0).content());
+
+    // the index section follows the decompressed chunk
+    ASSERT_TRUE(rfr.ReadSection(&sec));
+    ASSERT_EQ(SectionType::SECTION_INDEX, sec.type);
+    rfr.Close();
+    ASSERT_FALSE(remove(kTestFile1));
   }
 }
 
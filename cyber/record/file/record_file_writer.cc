@@ -29,6 +29,8 @@ using apollo::cyber::proto::Channel;
 using apollo::cyber::proto::ChannelCache;
 using apollo::cyber::proto::ChunkBody;
 using apollo::cyber::proto::ChunkBodyCache;
+using apollo::cyber::proto::ChunkCache;
+using apollo::cyber::proto::ChunkChannelCache;
 using apollo::cyber::proto::ChunkHeader;
 using apollo::cyber::proto::ChunkHeaderCache;
 using apollo::cyber::proto::Header;
@@ -91,6 +93,8 @@ void RecordFileWriter::Close() {
 
     if (!WriteIndex()) {
       AERROR << "Write index section failed, file: " << path_;
+    } else if (!WriteChunkIndex()) {
+      AERROR << "Write chunk index section failed, file: " << path_;
     }
 
     header_.set_is_complete(true);
@@ -136,6 +140,40 @@ bool RecordFileWriter::WriteIndex() {
   return true;
 }
 
+bool RecordFileWriter::WriteChunkIndex() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::string data;
+  if (!chunk_index_.SerializeToString(&data)) {
+    AERROR << "Serialize chunk index fail";
+    return false;
+  }
+  return WriteSection(SECTION_CHUNK_INDEX, data);
+}
+
+void RecordFileWriter::AddChunkCache(const Chunk& chunk,
+                                     uint64_t header_position,
+                                     uint64_t body_position) {
+  ChunkCache* chunk_cache = chunk_index_.add_chunk();
+  chunk_cache->set_header_position(header_position);
+  chunk_cache->set_body_position(body_position);
+  chunk_cache->set_begin_time(chunk.header_.begin_time());
+  chunk_cache->set_end_time(chunk.header_.end_time());
+  chunk_cache->set_message_number(chunk.header_.message_number());
+  for (const auto& item : chunk.channels_) {
+    auto search = chunk_channel_ids_.find(item.first);
+    if (search == chunk_channel_ids_.end()) {
+      search = chunk_channel_ids_
+                   .insert(std::make_pair(item.first,
+                                          chunk_index_.channel_name_size()))
+                   .first;
+      chunk_index_.add_channel_name(item.first);
+    }
+    ChunkChannelCache* channel_cache = chunk_cache->add_channel();
+    *channel_cache = item.second;
+    channel_cache->set_channel_id(search->second);
+  }
+}
+
 bool RecordFileWriter::WriteChannel(const Channel& channel) {
   std::lock_guard<std::mutex> lock(mutex_);
   uint64_t pos = CurrentPosition();
@@ -156,17 +194,45 @@ bool RecordFileWriter::WriteChannel(const Channel& channel) {
   return true;
 }
 
-bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
-                                  const ChunkBody& chunk_body) {
+void RecordFileWriter::SetCompression(ChunkCompression compression,
+                                      int level) {
   std::lock_guard<std::mutex> lock(mutex_);
-  uint64_t pos = CurrentPosition();
+  compression_ = compression;
+  compression_level_ = level;
+}
+
+bool RecordFileWriter::WriteChunk(const Chunk& chunk) {
+  const ChunkHeader& chunk_header = chunk.header_;
+  const ChunkBody& chunk_body = *chunk.body_;
+  // compress outside of the lock, this runs on the flush thread
+  std::string framed;
+  ChunkCompression compression;
+  int level;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    compression = compression_;
+    level = compression_level_;
+  }
+  if (compression != ChunkCompression::NONE) {
+    std::string raw;
+    if (!chunk_body.SerializeToString(&raw) ||
+        !CompressChunk(compression, level, raw, &framed)) {
+      AWARN << "Compress chunk failed, write it raw.";
+      framed.clear();
+    } else if (framed.size() >= raw.size()) {
+      framed.clear();
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t header_pos = CurrentPosition();
   if (!WriteSection<ChunkHeader>(chunk_header)) {
     AERROR << "Write chunk header fail";
     return false;
   }
   SingleIndex* single_index = index_.add_indexes();
   single_index->set_type(SectionType::SECTION_CHUNK_HEADER);
-  single_index->set_position(pos);
+  single_index->set_position(header_pos);
   ChunkHeaderCache* chunk_header_cache = new ChunkHeaderCache();
   chunk_header_cache->set_begin_time(chunk_header.begin_time());
   chunk_header_cache->set_end_time(chunk_header.end_time());
@@ -174,8 +240,11 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   chunk_header_cache->set_raw_size(chunk_header.raw_size());
   single_index->set_allocated_chunk_header_cache(chunk_header_cache);
 
-  pos = CurrentPosition();
-  if (!WriteSection<ChunkBody>(chunk_body)) {
+  uint64_t pos = CurrentPosition();
+  bool written = framed.empty()
+                     ? WriteSection<ChunkBody>(chunk_body)
+                     : WriteSection(SectionType::SECTION_CHUNK_BODY, framed);
+  if (!written) {
     AERROR << "Write chunk body fail";
     return false;
   }
@@ -192,6 +261,33 @@ bool RecordFileWriter::WriteChunk(const ChunkHeader& chunk_header,
   ChunkBodyCache* chunk_body_cache = new ChunkBodyCache();
   chunk_body_cache->set_message_number(chunk_body.messages_size());
   single_index->set_allocated_chunk_body_cache(chunk_body_cache);
+  AddChunkCache(chunk, header_pos, pos);
+  return true;
+}
+
+bool RecordFileWriter::WriteSection(SectionType type, const std::string& data) {
+  Section section;
+  /// zero out whole struct even if padded
+  memset(&section, 0, sizeof(section));
+  section = {type, static_cast<int64_t>(data.size())};
+  ssize_t count = write(fd_, &section, sizeof(section));
+  if (count != sizeof(section)) {
+    AERROR << "Write fd failed, fd: " << fd_ << ", errno: " << errno;
+    return false;
+  }
+  size_t offset = 0;
+  while (offset < data.size()) {
+    count = write(fd_, data.data() + offset, data.size() - offset);
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      AERROR << "Write fd failed, fd: " << fd_ << ", errno: " << errno;
+      return false;
+    }
+    offset += count;
+  }
+  header_.set_size(CurrentPosition());
   return true;
 }
 
@@ -236,7 +332,7 @@ void RecordFileWriter::Flush() {
     if (chunk_flush_->empty()) {
       continue;
     }
-    if (!WriteChunk(chunk_flush_->header_, *(chunk_flush_->body_.get()))) {
+    if (!WriteChunk(*chunk_flush_)) {
       AERROR << "Write chunk fail.";
     }
     chunk_flush_->clear();
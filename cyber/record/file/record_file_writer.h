@@ -31,6 +31,7 @@
 #include "google/protobuf/text_format.h"
 
 #include "cyber/common/log.h"
+#include "cyber/record/file/chunk_codec.h"
 #include "cyber/record/file/record_file_base.h"
 #include "cyber/record/file/section.h"
 #include "cyber/time/time.h"
@@ -48,6 +49,7 @@ struct Chunk {
     header_.set_end_time(0);
     header_.set_message_number(0);
     header_.set_raw_size(0);
+    channels_.clear();
   }
 
   inline void add(const proto::SingleMessage& message) {
@@ -65,6 +67,15 @@ struct Chunk {
     }
     header_.set_message_number(header_.message_number() + 1);
     header_.set_raw_size(header_.raw_size() + message.content().size());
+    proto::ChunkChannelCache& channel = channels_[message.channel_name()];
+    if (channel.message_number() == 0 ||
+        channel.begin_time() > message.time()) {
+      channel.set_begin_time(message.time());
+    }
+    if (channel.end_time() < message.time()) {
+      channel.set_end_time(message.time());
+    }
+    channel.set_message_number(channel.message_number() + 1);
   }
 
   inline bool empty() { return header_.message_number() == 0; }
@@ -72,6 +83,7 @@ struct Chunk {
   std::mutex mutex_;
   proto::ChunkHeader header_;
   std::unique_ptr<proto::ChunkBody> body_ = nullptr;
+  std::unordered_map<std::string, proto::ChunkChannelCache> channels_;
 };
 
 class RecordFileWriter : public RecordFileBase {
@@ -85,12 +97,23 @@ class RecordFileWriter : public RecordFileBase {
   bool WriteMessage(const proto::SingleMessage& message);
   uint64_t GetMessageNumber(const std::string& channel_name) const;
 
+  /**
+   * @brief Compress every chunk body written from now on. Compression runs
+   * on the flush thread, and chunks that do not shrink are kept raw.
+   *
+   * @param level codec specific level, 0 for the codec default
+   */
+  void SetCompression(ChunkCompression compression, int level = 0);
+
  private:
-  bool WriteChunk(const proto::ChunkHeader& chunk_header,
-                  const proto::ChunkBody& chunk_body);
+  bool WriteChunk(const Chunk& chunk);
   template <typename T>
   bool WriteSection(const T& message);
+  bool WriteSection(proto::SectionType type, const std::string& data);
   bool WriteIndex();
+  bool WriteChunkIndex();
+  void AddChunkCache(const Chunk& chunk, uint64_t header_position,
+                     uint64_t body_position);
   void Flush();
   bool is_writing_ = false;
   std::unique_ptr<Chunk> chunk_active_ = nullptr;
@@ -99,6 +122,9 @@ class RecordFileWriter : public RecordFileBase {
   std::mutex flush_mutex_;
   std::condition_variable flush_cv_;
   std::unordered_map<std::string, uint64_t> channel_message_number_map_;
+  std::unordered_map<std::string, uint32_t> chunk_channel_ids_;
+  ChunkCompression compression_ = ChunkCompression::NONE;
+  int compression_level_ = 0;
 };
 
 template <typename T>
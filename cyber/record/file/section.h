@@ -26,6 +26,12 @@ struct Section {
   int64_t size;
 };
 
+/// Section holding proto::ChunkIndex, right after the index section. It is
+/// kept out of proto::SectionType on purpose, readers which stop at the index
+/// section never reach it. The value stays within the range of the enum.
+const proto::SectionType SECTION_CHUNK_INDEX =
+    static_cast<proto::SectionType>(7);
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
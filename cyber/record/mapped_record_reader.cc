@@ -0,0 +1,402 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/mapped_record_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <utility>
+
+#include "cyber/common/log.h"
+#include "cyber/record/file/chunk_codec.h"
+#include "cyber/record/file/record_file_base.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::proto::ChunkHeader;
+using apollo::cyber::proto::Index;
+using apollo::cyber::proto::SectionType;
+
+namespace {
+
+// protobuf wire types
+constexpr uint32_t kWireVarint = 0;
+constexpr uint32_t kWireFixed64 = 1;
+constexpr uint32_t kWireLength = 2;
+constexpr uint32_t kWireFixed32 = 5;
+
+// field numbers of ChunkBody and SingleMessage in record.proto
+constexpr uint32_t kChunkBodyMessages = 1;
+constexpr uint32_t kMessageChannelName = 1;
+constexpr uint32_t kMessageTime = 2;
+constexpr uint32_t kMessageContent = 3;
+
+bool ReadVarint(const char** p, const char* end, uint64_t* value) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(*(*p)++);
+    result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      *value = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ReadBytes(const char** p, const char* end, std::string_view* bytes) {
+  uint64_t length = 0;
+  if (!ReadVarint(p, end, &length) ||
+      length > static_cast<uint64_t>(end - *p)) {
+    return false;
+  }
+  *bytes = std::string_view(*p, length);
+  *p += length;
+  return true;
+}
+
+bool SkipField(uint32_t wire_type, const char** p, const char* end) {
+  uint64_t value = 0;
+  std::string_view bytes;
+  switch (wire_type) {
+    case kWireVarint:
+      return ReadVarint(p, end, &value);
+    case kWireFixed64:
+    case kWireFixed32: {
+      int64_t length = wire_type == kWireFixed64 ? 8 : 4;
+      if (end - *p < length) {
+        return false;
+      }
+      *p += length;
+      return true;
+    }
+    case kWireLength:
+      return ReadBytes(p, end, &bytes);
+    default:
+      return false;
+  }
+}
+
+bool ParseMessage(std::string_view bytes, RecordMessageView* message) {
+  *message = RecordMessageView();
+  const char* p = bytes.data();
+  const char* end = p + bytes.size();
+  while (p < end) {
+    uint64_t tag = 0;
+    if (!ReadVarint(&p, end, &tag)) {
+      return false;
+    }
+    uint32_t field = static_cast<uint32_t>(tag >> 3);
+    uint32_t wire_type = static_cast<uint32_t>(tag & 0x7);
+    bool ok = false;
+    if (field == kMessageChannelName && wire_type == kWireLength) {
+      ok = ReadBytes(&p, end, &message->channel_name);
+    } else if (field == kMessageTime && wire_type == kWireVarint) {
+      ok = ReadVarint(&p, end, &message->time);
+    } else if (field == kMessageContent && wire_type == kWireLength) {
+      ok = ReadBytes(&p, end, &message->content);
+    } else {
+      ok = SkipField(wire_type, &p, end);
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Parse one field of a serialized ChunkBody, which is a message unless the
+// body carries fields this reader does not know about.
+bool ParseChunkField(const char** p, const char* end,
+                     RecordMessageView* message, bool* is_message) {
+  uint64_t tag = 0;
+  if (!ReadVarint(p, end, &tag)) {
+    return false;
+  }
+  uint32_t field = static_cast<uint32_t>(tag >> 3);
+  uint32_t wire_type = static_cast<uint32_t>(tag & 0x7);
+  *is_message = field == kChunkBodyMessages && wire_type == kWireLength;
+  if (!*is_message) {
+    return SkipField(wire_type, p, end);
+  }
+  std::string_view bytes;
+  return ReadBytes(p, end, &bytes) && ParseMessage(bytes, message);
+}
+
+}  // namespace
+
+MappedRecordReader::MappedRecordReader(const std::string& file) {
+  file_ = file;
+  if (!Map(file)) {
+    return;
+  }
+  Section section;
+  const char* data = nullptr;
+  if (!ReadSection(&section, &data) ||
+      section.type != SectionType::SECTION_HEADER ||
+      !header_.ParseFromArray(data, static_cast<int>(section.size))) {
+    AERROR << "Read header section fail, file is broken or it is not a record "
+              "file.";
+    Unmap();
+    return;
+  }
+  is_valid_ = true;
+  if (header_.is_complete() && !ReadIndex()) {
+    AERROR << "Read index section fail, file: " << file_;
+  }
+  Reset();
+}
+
+MappedRecordReader::~MappedRecordReader() { Unmap(); }
+
+bool MappedRecordReader::Map(const std::string& file) {
+  int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    AERROR << "Open file failed, file: " << file << ", errno: " << errno;
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) < 0 || file_stat.st_size <= 0) {
+    AERROR << "Stat file failed or file is empty, file: " << file;
+    close(fd);
+    return false;
+  }
+  size_t size = static_cast<size_t>(file_stat.st_size);
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    AERROR << "Map file failed, file: " << file << ", errno: " << errno;
+    return false;
+  }
+  // records are read front to back, let the kernel read ahead aggressively
+  // and drop the pages behind us early
+  if (madvise(addr, size, MADV_SEQUENTIAL) != 0) {
+    AWARN << "madvise failed, file: " << file << ", errno: " << errno;
+  }
+  data_ = static_cast<const char*>(addr);
+  size_ = size;
+  return true;
+}
+
+void MappedRecordReader::Unmap() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+  }
+  is_valid_ = false;
+}
+
+bool MappedRecordReader::ReadSection(Section* section, const char** data) {
+  if (position_ > size_ || size_ - position_ < sizeof(Section)) {
+    return false;
+  }
+  memcpy(section, data_ + position_, sizeof(Section));
+  size_t remain = size_ - position_ - sizeof(Section);
+  if (section->size < 0 || static_cast<uint64_t>(section->size) > remain) {
+    AERROR << "Section size out of file, file: " << file_
+           << ", position: " << position_ << ", size: " << section->size;
+    return false;
+  }
+  *data = data_ + position_ + sizeof(Section);
+  position_ += sizeof(Section) + section->size;
+  return true;
+}
+
+bool MappedRecordReader::ReadIndex() {
+  position_ = header_.index_position();
+  Section section;
+  const char* data = nullptr;
+  if (!ReadSection(&section, &data) ||
+      section.type != SectionType::SECTION_INDEX) {
+    return false;
+  }
+  Index index;
+  if (!index.ParseFromArray(data, static_cast<int>(section.size))) {
+    return false;
+  }
+  for (const auto& single_idx : index.indexes()) {
+    if (single_idx.type() != SectionType::SECTION_CHANNEL) {
+      continue;
+    }
+    if (!single_idx.has_channel_cache()) {
+      AERROR << "Single channel index does not have channel_cache.";
+      continue;
+    }
+    const auto& channel_cache = single_idx.channel_cache();
+    channel_info_.insert(std::make_pair(channel_cache.name(), channel_cache));
+  }
+  return true;
+}
+
+void MappedRecordReader::Reset() {
+  position_ = sizeof(Section) + HEADER_LENGTH;
+  reach_end_ = false;
+  chunk_cursor_ = nullptr;
+  chunk_end_ = nullptr;
+}
+
+bool MappedRecordReader::ReadMessage(RecordMessageView* message,
+                                     uint64_t begin_time, uint64_t end_time) {
+  if (!is_valid_) {
+    return false;
+  }
+
+  if (begin_time > header_.end_time() || end_time < header_.begin_time()) {
+    return false;
+  }
+
+  while (true) {
+    while (chunk_cursor_ < chunk_end_) {
+      const char* cursor = chunk_cursor_;
+      RecordMessageView next;
+      bool is_message = false;
+      if (!ParseChunkField(&cursor, chunk_end_, &next, &is_message)) {
+        AERROR << "Broken chunk body, file: " << file_;
+        chunk_cursor_ = chunk_end_;
+        return false;
+      }
+      if (is_message && next.time > end_time) {
+        return false;
+      }
+      chunk_cursor_ = cursor;
+      if (!is_message || next.time < begin_time) {
+        continue;
+      }
+      *message = next;
+      return true;
+    }
+
+    if (!ReadNextChunk(begin_time, end_time)) {
+      return false;
+    }
+  }
+}
+
+bool MappedRecordReader::ReadNextChunk(uint64_t begin_time,
+                                       uint64_t end_time) {
+  bool skip_next_chunk_body = false;
+  while (!reach_end_) {
+    // files which are not complete end without an index section
+    if (position_ >= size_) {
+      reach_end_ = true;
+      break;
+    }
+    size_t section_position = position_;
+    Section section;
+    const char* data = nullptr;
+    if (!ReadSection(&section, &data)) {
+      AERROR << "Failed to read section, file: " << file_;
+      return false;
+    }
+    switch (section.type) {
+      case SectionType::SECTION_INDEX: {
+        reach_end_ = true;
+        break;
+      }
+      case SectionType::SECTION_CHANNEL: {
+        break;
+      }
+      case SectionType::SECTION_CHUNK_HEADER: {
+        ChunkHeader header;
+        if (!header.ParseFromArray(data, static_cast<int>(section.size))) {
+          AERROR << "Failed to read chunk header section.";
+          return false;
+        }
+        if (header.begin_time() > end_time) {
+          // come back to this chunk with the next time range
+          position_ = section_position;
+          return false;
+        }
+        skip_next_chunk_body = header.end_time() < begin_time;
+        break;
+      }
+      case SectionType::SECTION_CHUNK_BODY: {
+        if (skip_next_chunk_body) {
+          skip_next_chunk_body = false;
+          break;
+        }
+        size_t body_size = static_cast<size_t>(section.size);
+        ChunkFrame frame;
+        if (body_size >= sizeof(frame)) {
+          memcpy(&frame, data, sizeof(frame));
+        }
+        if (body_size >= sizeof(frame) && IsChunkFrame(frame)) {
+          if (!DecompressChunk(data, body_size, &chunk_buffer_)) {
+            AERROR << "Decompress chunk body failed, file: " << file_;
+            return false;
+          }
+          data = chunk_buffer_.data();
+          body_size = chunk_buffer_.size();
+        }
+        chunk_cursor_ = data;
+        chunk_end_ = data + body_size;
+        return true;
+      }
+      default: {
+        AERROR << "Invalid section, type: " << section.type
+               << ", size: " << section.size;
+        return false;
+      }
+    }
+  }
+  return false;
+}
+
+uint64_t MappedRecordReader::GetMessageNumber(
+    const std::string& channel_name) const {
+  auto search = channel_info_.find(channel_name);
+  if (search == channel_info_.end()) {
+    return 0;
+  }
+  return search->second.message_number();
+}
+
+const std::string& MappedRecordReader::GetMessageType(
+    const std::string& channel_name) const {
+  auto search = channel_info_.find(channel_name);
+  if (search == channel_info_.end()) {
+    return null_type_;
+  }
+  return search->second.message_type();
+}
+
+const std::string& MappedRecordReader::GetProtoDesc(
+    const std::string& channel_name) const {
+  auto search = channel_info_.find(channel_name);
+  if (search == channel_info_.end()) {
+    return null_type_;
+  }
+  return search->second.proto_desc();
+}
+
+std::set<std::string> MappedRecordReader::GetChannelList() const {
+  std::set<std::string> channel_list;
+  for (auto& item : channel_info_) {
+    channel_list.insert(item.first);
+  }
+  return channel_list;
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_RECORD_MAPPED_RECORD_READER_H_
+#define CYBER_RECORD_MAPPED_RECORD_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "cyber/proto/record.pb.h"
+#include "cyber/record/file/section.h"
+#include "cyber/record/record_base.h"
+#include "cyber/record/record_message.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+/**
+ * @brief Record reader for offline batch processing. The file is mapped into
+ * memory with a sequential access hint and chunk bodies are walked in place,
+ * so every message comes out as views into the mapping instead of copies.
+ *
+ * The views stay valid as long as the reader lives, except for compressed
+ * chunks: those are inflated into a buffer that the next chunk reuses.
+ */
+class MappedRecordReader : public RecordBase {
+ public:
+  using ChannelInfoMap = std::unordered_map<std::string, proto::ChannelCache>;
+
+  /**
+   * @brief The constructor with record file path as parameter.
+   *
+   * @param file
+   */
+  explicit MappedRecordReader(const std::string& file);
+
+  /**
+   * @brief The destructor.
+   */
+  virtual ~MappedRecordReader();
+
+  /**
+   * @brief Is this record reader is valid.
+   *
+   * @return True for valid, false for not.
+   */
+  bool IsValid() const { return is_valid_; }
+
+  /**
+   * @brief Read one message from reader.
+   *
+   * @param message
+   * @param begin_time
+   * @param end_time
+   *
+   * @return True for success, false for not.
+   */
+  bool ReadMessage(RecordMessageView* message, uint64_t begin_time = 0,
+                   uint64_t end_time = UINT64_MAX);
+
+  /**
+   * @brief Go back to the first message.
+   */
+  void Reset();
+
+  uint64_t GetMessageNumber(const std::string& channel_name) const override;
+  const std::string& GetMessageType(
+      const std::string& channel_name) const override;
+  const std::string& GetProtoDesc(
+      const std::string& channel_name) const override;
+  std::set<std::string> GetChannelList() const override;
+
+ private:
+  bool Map(const std::string& file);
+  void Unmap();
+  bool ReadSection(Section* section, const char** data);
+  bool ReadIndex();
+  bool ReadNextChunk(uint64_t begin_time, uint64_t end_time);
+
+  bool is_valid_ = false;
+  bool reach_end_ = false;
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  size_t position_ = 0;
+  // unread part of the current chunk body
+  const char* chunk_cursor_ = nullptr;
+  const char* chunk_end_ = nullptr;
+  std::string chunk_buffer_;
+  ChannelInfoMap channel_info_;
+};
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_RECORD_MAPPED_RECORD_READER_H_
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/record/mapped_record_reader.h"
+
+#include <memory>
+#include <string>
+#include "gtest/gtest.h"
+
+#include "cyber/record/record_reader.h"
+#include "cyber/record/record_writer.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::message::RawMessage;
+
+constexpr char kChannelName1[] = "/test/channel1";
+constexpr char kChannelName2[] = "/test/channel2";
+constexpr char kMessageType1[] = "apollo.cyber.proto.Test";
+constexpr char kProtoDesc[] = "1234567890";
+constexpr char kTestFile[] = "mapped_record_reader_test.record";
+constexpr uint32_t kMessageNum = 64;
+
+void ConstructRecord(ChunkCompression compression) {
+  RecordWriter writer;
+  writer.SetSizeOfFileSegmentation(0);
+  writer.SetIntervalOfFileSegmentation(0);
+  writer.SetCompression(compression);
+  writer.Open(kTestFile);
+  writer.WriteChannel(kChannelName1, kMessageType1, kProtoDesc);
+  writer.WriteChannel(kChannelName2, kMessageType1, kProtoDesc);
+  for (uint32_t i = 0; i < kMessageNum; ++i) {
+    // binary content with embedded zeros, repeated so that it compresses
+    std::string content(256, static_cast<char>(i));
+    content[0] = '\0';
+    auto msg = std::make_shared<RawMessage>(content);
+    writer.WriteMessage(i % 2 ? kChannelName2 : kChannelName1, msg, i + 1);
+  }
+  writer.Close();
+}
+
+TEST(MappedRecordReaderTest, ReadAll) {
+  for (auto compression : {ChunkCompression::NONE, ChunkCompression::LZ4}) {
+    ConstructRecord(compression);
+
+    MappedRecordReader mapped_reader(kTestFile);
+    ASSERT_TRUE(mapped_reader.IsValid());
+    EXPECT_EQ(kMessageNum / 2, mapped_reader.GetMessageNumber(kChannelName1));
+    EXPECT_EQ(kMessageType1, mapped_reader.GetMessageType(kChannelName2));
+    EXPECT_EQ(kProtoDesc, mapped_reader.GetProtoDesc(kChannelName2));
+    EXPECT_EQ(2, mapped_reader.GetChannelList().size());
+
+    RecordReader reader(kTestFile);
+    RecordMessage expected;
+    RecordMessageView message;
+    uint32_t count = 0;
+    while (mapped_reader.ReadMessage(&message)) {
+      ASSERT_TRUE(reader.ReadMessage(&expected));
+      EXPECT_EQ(expected.channel_name, message.channel_name);
+      EXPECT_EQ(expected.content, message.content);
+      EXPECT_EQ(expected.time, message.time);
+      ++count;
+    }
+    EXPECT_FALSE(reader.ReadMessage(&expected));
+    EXPECT_EQ(kMessageNum, count);
+    ASSERT_FALSE(remove(kTestFile));
+  }
+}
+
+TEST(MappedRecordReaderTest, TimeRange) {
+  ConstructRecord(ChunkCompression::NONE);
+  MappedRecordReader reader(kTestFile);
+  ASSERT_TRUE(reader.IsValid());
+
+  RecordMessageView message;
+  for (uint64_t time = 10; time <= 20; ++time) {
+    ASSERT_TRUE(reader.ReadMessage(&message, 10, 20));
+    EXPECT_EQ(time, message.time);
+  }
+  EXPECT_FALSE(reader.ReadMessage(&message, 10, 20));
+
+  // the next range goes on where the previous one stopped
+  ASSERT_TRUE(reader.ReadMessage(&message, 21, 30));
+  EXPECT_EQ(21, message.time);
+
+  reader.Reset();
+  ASSERT_TRUE(reader.ReadMessage(&message));
+  EXPECT_EQ(1, message.time);
+  EXPECT_EQ(kChannelName1, message.channel_name);
+  EXPECT_FALSE(reader.ReadMessage(&message, kMessageNum + 1, UINT64_MAX));
+  ASSERT_FALSE(remove(kTestFile));
+}
+
+TEST(MappedRecordReaderTest, InvalidFile) {
+  MappedRecordReader reader("not_exist.record");
+  EXPECT_FALSE(reader.IsValid());
+  RecordMessageView message;
+  EXPECT_FALSE(reader.ReadMessage(&message));
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
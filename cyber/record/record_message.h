@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
 
 namespace apollo {
 namespace cyber {
@@ -64,6 +65,27 @@ struct RecordMessage {
   uint64_t time;
 };
 
+/**
+ * @brief Record message borrowed from the reader that produced it, see
+ * MappedRecordReader for how long the views stay valid.
+ */
+struct RecordMessageView {
+  /**
+   * @brief The channel name of the message.
+   */
+  std::string_view channel_name;
+
+  /**
+   * @brief The serialized content of the message.
+   */
+  std::string_view content;
+
+  /**
+   * @brief The time (nanosecond) of the message.
+   */
+  uint64_t time = 0;
+};
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
@@ -16,6 +16,7 @@
 
 #include "cyber/record/record_reader.h"
 
+#include <algorithm>
 #include <utility>
 
 namespace apollo {
@@ -24,6 +25,7 @@ namespace record {
 
 using apollo::cyber::proto::Channel;
 using apollo::cyber::proto::ChunkBody;
+using apollo::cyber::proto::ChunkCache;
 using apollo::cyber::proto::ChunkHeader;
 using apollo::cyber::proto::SectionType;
 
@@ -53,6 +55,14 @@ RecordReader::RecordReader(const std::string& file) {
       channel_info_.insert(
           std::make_pair(channel_cache->name(), *channel_cache));
     }
+    has_chunk_index_ = file_reader_->ReadChunkIndex();
+  }
+  if (has_chunk_index_) {
+    uint64_t max_end_time = 0;
+    for (const auto& chunk : file_reader_->GetChunkIndex().chunk()) {
+      max_end_time = std::max(max_end_time, chunk.end_time());
+      chunk_max_end_time_.push_back(max_end_time);
+    }
   }
   file_reader_->Reset();
 }
@@ -61,9 +71,21 @@ void RecordReader::Reset() {
   file_reader_->Reset();
   reach_end_ = false;
   message_index_ = 0;
+  next_chunk_ = -1;
   chunk_.reset(new ChunkBody());
 }
 
+void RecordReader::SetChannelFilter(const std::set<std::string>& channels) {
+  channel_filter_ = channels;
+  channel_wanted_.clear();
+  if (!has_chunk_index_) {
+    return;
+  }
+  for (const auto& name : file_reader_->GetChunkIndex().channel_name()) {
+    channel_wanted_.push_back(channels.count(name) > 0);
+  }
+}
+
 std::set<std::string> RecordReader::GetChannelList() const {
   std::set<std::string> channel_list;
   for (auto& item : channel_info_) {
@@ -92,6 +114,10 @@ bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
     if (time < begin_time) {
       continue;
     }
+    if (!channel_filter_.empty() &&
+        channel_filter_.count(next_message.channel_name()) == 0) {
+      continue;
+    }
 
     message->channel_name = next_message.channel_name();
     message->content = next_message.content();
@@ -110,6 +136,9 @@ bool RecordReader::ReadMessage(RecordMessage* message, uint64_t begin_time,
 }
 
 bool RecordReader::ReadNextChunk(uint64_t begin_time, uint64_t end_time) {
+  if (has_chunk_index_) {
+    return ReadIndexedChunk(begin_time, end_time);
+  }
   bool skip_next_chunk_body = false;
   while (!reach_end_) {
     Section section;
@@ -171,6 +200,65 @@ bool RecordReader::ReadNextChunk(uint64_t begin_time, uint64_t end_time) {
   return false;
 }
 
+bool RecordReader::ReadIndexedChunk(uint64_t begin_time, uint64_t end_time) {
+  const auto& chunk_index = file_reader_->GetChunkIndex();
+  if (next_chunk_ < 0) {
+    next_chunk_ = SeekChunk(begin_time);
+  }
+  while (next_chunk_ < chunk_index.chunk_size()) {
+    const auto& chunk = chunk_index.chunk(next_chunk_);
+    if (chunk.begin_time() > end_time) {
+      return false;
+    }
+    ++next_chunk_;
+    if (chunk.end_time() < begin_time || !IsChunkNeeded(chunk, begin_time)) {
+      continue;
+    }
+
+    Section section;
+    if (!file_reader_->SetPosition(chunk.body_position()) ||
+        !file_reader_->ReadSection(&section)) {
+      AERROR << "Failed to read section, file: " << file_reader_->GetPath();
+      return false;
+    }
+    if (section.type != SectionType::SECTION_CHUNK_BODY) {
+      AERROR << "Chunk index does not point to a chunk body, file: "
+             << file_reader_->GetPath();
+      return false;
+    }
+    chunk_.reset(new ChunkBody());
+    if (!file_reader_->ReadSection<ChunkBody>(section.size, chunk_.get())) {
+      AERROR << "Failed to read chunk body section.";
+      return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+bool RecordReader::IsChunkNeeded(const ChunkCache& chunk,
+                                 uint64_t begin_time) const {
+  if (channel_filter_.empty() || chunk.channel_size() == 0) {
+    return true;
+  }
+  // a channel that only starts later keeps the chunk, the following reads
+  // pick its messages up from the loaded body
+  for (const auto& channel : chunk.channel()) {
+    if (channel.channel_id() < channel_wanted_.size() &&
+        channel_wanted_[channel.channel_id()] &&
+        channel.end_time() >= begin_time) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int RecordReader::SeekChunk(uint64_t begin_time) const {
+  auto iter = std::lower_bound(chunk_max_end_time_.begin(),
+                               chunk_max_end_time_.end(), begin_time);
+  return static_cast<int>(iter - chunk_max_end_time_.begin());
+}
+
 uint64_t RecordReader::GetMessageNumber(const std::string& channel_name) const {
   auto search = channel_info_.find(channel_name);
   if (search == channel_info_.end()) {
@@ -21,6 +21,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/proto/record.pb.h"
 #include "cyber/record/file/record_file_reader.h"
@@ -75,6 +76,14 @@ class RecordReader : public RecordBase {
    */
   void Reset();
 
+  /**
+   * @brief Only read messages of the given channels, all of them if empty.
+   * Chunks holding none of these channels are skipped without being read.
+   *
+   * @param channels
+   */
+  void SetChannelFilter(const std::set<std::string>& channels);
+
   /**
    * @brief Get message number by channel name.
    *
@@ -111,8 +120,23 @@ class RecordReader : public RecordBase {
    */
   std::set<std::string> GetChannelList() const override;
 
+  /**
+   * @brief Get the running maximum of the chunk end times, in chunk order.
+   * The messages of the chunks up to i are all at or before the i-th time,
+   * so these are the points a file can be split at by time. Empty without
+   * a chunk index.
+   *
+   * @return Nondecreasing end times, one per chunk.
+   */
+  const std::vector<uint64_t>& GetChunkMaxEndTimes() const {
+    return chunk_max_end_time_;
+  }
+
  private:
   bool ReadNextChunk(uint64_t begin_time, uint64_t end_time);
+  bool ReadIndexedChunk(uint64_t begin_time, uint64_t end_time);
+  bool IsChunkNeeded(const proto::ChunkCache& chunk, uint64_t begin_time) const;
+  int SeekChunk(uint64_t begin_time) const;
 
   bool is_valid_ = false;
   bool reach_end_ = false;
@@ -121,6 +145,15 @@ class RecordReader : public RecordBase {
   int message_index_ = 0;
   ChannelInfoMap channel_info_;
   FileReaderPtr file_reader_;
+
+  // chunk lookup through the chunk index, files without index are scanned
+  bool has_chunk_index_ = false;
+  int next_chunk_ = -1;
+  // running maximum of the chunk end times, sorted for the binary search
+  std::vector<uint64_t> chunk_max_end_time_;
+  std::set<std::string> channel_filter_;
+  // indexed by the channel id of the chunk index
+  std::vector<bool> channel_wanted_;
 };
 
 }  // namespace record
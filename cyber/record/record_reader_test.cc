@@ -15,9 +15,12 @@
  *****************************************************************************/
 
 #include "cyber/record/record_reader.h"
+#include "cyber/record/header_builder.h"
 #include "cyber/record/record_writer.h"
 
+#include <chrono>
 #include <string>
+#include <thread>
 #include "gtest/gtest.h"
 
 namespace apollo {
@@ -27,6 +30,7 @@ namespace record {
 using apollo::cyber::message::RawMessage;
 
 constexpr char kChannelName1[] = "/test/channel1";
+constexpr char kChannelName2[] = "/test/channel2";
 constexpr char kMessageType1[] = "apollo.cyber.proto.Test";
 constexpr char kProtoDesc[] = "1234567890";
 constexpr char kStr10B[] = "1234567890";
@@ -86,6 +90,78 @@ TEST(RecordTest, TestSingleRecordFile) {
   ASSERT_FALSE(remove(kTestFile));
 }
 
+TEST(RecordTest, TestChunkIndex) {
+  const uint64_t kStep = 1000000;  // 1ms
+  const uint32_t kNum = 200;
+  RecordWriter writer(HeaderBuilder::GetHeaderWithChunkParams(10 * kStep, 0));
+  writer.SetSizeOfFileSegmentation(0);
+  writer.SetIntervalOfFileSegmentation(0);
+  writer.Open(kTestFile);
+  writer.WriteChannel(kChannelName1, kMessageType1, kProtoDesc);
+  writer.WriteChannel(kChannelName2, kMessageType1, kProtoDesc);
+  for (uint32_t i = 0; i < kNum; ++i) {
+    auto msg = std::make_shared<RawMessage>(std::to_string(i));
+    writer.WriteMessage(kChannelName1, msg, i * kStep);
+    // the second channel only shows up in the middle of the record
+    if (i >= 100 && i < 110) {
+      writer.WriteMessage(kChannelName2, msg, i * kStep);
+    }
+    if (i % 10 == 0) {
+      // leave the flush thread some time so that chunks are not merged
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  writer.Close();
+
+  RecordFileReader file_reader;
+  ASSERT_TRUE(file_reader.Open(kTestFile));
+  ASSERT_TRUE(file_reader.ReadIndex());
+  ASSERT_TRUE(file_reader.ReadChunkIndex());
+  const auto& chunk_index = file_reader.GetChunkIndex();
+  ASSERT_EQ(file_reader.GetHeader().chunk_number(), chunk_index.chunk_size());
+  ASSERT_GT(chunk_index.chunk_size(), 1);
+  ASSERT_EQ(2, chunk_index.channel_name_size());
+  uint64_t message_number = 0;
+  for (const auto& chunk : chunk_index.chunk()) {
+    ASSERT_LE(chunk.begin_time(), chunk.end_time());
+    for (const auto& channel : chunk.channel()) {
+      message_number += channel.message_number();
+    }
+  }
+  ASSERT_EQ(kNum + 10, message_number);
+  file_reader.Close();
+
+  RecordReader reader(kTestFile);
+  RecordMessage message;
+
+  // seek into the middle
+  ASSERT_TRUE(reader.ReadMessage(&message, 150 * kStep));
+  ASSERT_EQ(150 * kStep, message.time);
+  ASSERT_EQ(kChannelName1, message.channel_name);
+
+  // only the chunks of the second channel
+  reader.SetChannelFilter({kChannelName2});
+  reader.Reset();
+  for (uint32_t i = 100; i < 110; ++i) {
+    ASSERT_TRUE(reader.ReadMessage(&message));
+    ASSERT_EQ(kChannelName2, message.channel_name);
+    ASSERT_EQ(i * kStep, message.time);
+  }
+  ASSERT_FALSE(reader.ReadMessage(&message));
+
+  // time windows read in a row, as the viewer does
+  reader.SetChannelFilter({});
+  reader.Reset();
+  uint32_t count = 0;
+  for (uint64_t begin = 0; begin < kNum * kStep; begin += 15 * kStep) {
+    while (reader.ReadMessage(&message, begin, begin + 15 * kStep - 1)) {
+      ++count;
+    }
+  }
+  ASSERT_EQ(kNum + 10, count);
+  ASSERT_FALSE(remove(kTestFile));
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
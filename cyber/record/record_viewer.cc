@@ -101,6 +101,7 @@ void RecordViewer::Init() {
 
 void RecordViewer::Reset() {
   for (auto& reader : readers_) {
+    reader->SetChannelFilter(channels_);
     reader->Reset();
   }
   std::fill(readers_finished_.begin(), readers_finished_.end(), false);
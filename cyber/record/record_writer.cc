@@ -46,6 +46,7 @@ bool RecordWriter::Open(const std::string& file) {
     path_ = file_;
   }
   file_writer_.reset(new RecordFileWriter());
+  file_writer_->SetCompression(compression_, compression_level_);
   if (!file_writer_->Open(path_)) {
     AERROR << "Failed to open output record file: " << path_;
     return false;
@@ -68,6 +69,7 @@ void RecordWriter::Close() {
 
 bool RecordWriter::SplitOutfile() {
   file_writer_.reset(new RecordFileWriter());
+  file_writer_->SetCompression(compression_, compression_level_);
   if (file_index_ > 99999) {
     AWARN << "More than 99999 record files had been recored, will restart "
           << "counting from 0.";
@@ -169,6 +171,16 @@ bool RecordWriter::SetIntervalOfFileSegmentation(uint64_t time_sec) {
   return true;
 }
 
+bool RecordWriter::SetCompression(ChunkCompression compression, int level) {
+  if (is_opened_) {
+    AWARN << "Please call this interface before opening file.";
+    return false;
+  }
+  compression_ = compression;
+  compression_level_ = level;
+  return true;
+}
+
 bool RecordWriter::IsNewChannel(const std::string& channel_name) const {
   return channel_message_number_map_.find(channel_name) ==
          channel_message_number_map_.end();
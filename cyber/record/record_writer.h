@@ -125,6 +125,16 @@ class RecordWriter : public RecordBase {
    */
   bool SetIntervalOfFileSegmentation(uint64_t time_sec);
 
+  /**
+   * @brief Compress the chunks of the record files opened from now on.
+   *
+   * @param compression codec, LZ4 for speed or ZSTD for size
+   * @param level codec specific level, 0 for the codec default
+   *
+   * @return True for success, false for fail.
+   */
+  bool SetCompression(ChunkCompression compression, int level = 0);
+
   /**
    * @brief Get message number by channel name.
    *
@@ -180,6 +190,8 @@ class RecordWriter : public RecordBase {
   uint64_t segment_raw_size_ = 0;
   uint64_t segment_begin_time_ = 0;
   uint32_t file_index_ = 0;
+  ChunkCompression compression_ = ChunkCompression::NONE;
+  int compression_level_ = 0;
   MessageNumberMap channel_message_number_map_;
   MessageTypeMap channel_message_type_map_;
   MessageProtoDescMap channel_proto_desc_map_;
@@ -20,10 +20,7 @@
 #include <memory>
 #include <utility>
 
-#include "cyber/common/environment.h"
-#include "cyber/common/file.h"
 #include "cyber/scheduler/policy/classic_context.h"
-#include "cyber/scheduler/processor.h"
 
 namespace apollo {
 namespace cyber {
@@ -31,81 +28,21 @@ namespace scheduler {
 
 using apollo::cyber::base::ReadLockGuard;
 using apollo::cyber::base::WriteLockGuard;
-using apollo::cyber::common::GetAbsolutePath;
-using apollo::cyber::common::GetProtoFromFile;
 using apollo::cyber::common::GlobalData;
-using apollo::cyber::common::PathExists;
-using apollo::cyber::common::WorkRoot;
 using apollo::cyber::croutine::RoutineState;
 
 SchedulerClassic::SchedulerClassic() {
-  std::string conf("conf/");
-  conf.append(GlobalData::Instance()->ProcessGroup()).append(".conf");
-  auto cfg_file = GetAbsolutePath(WorkRoot(), conf);
-
-  apollo::cyber::proto::CyberConfig cfg;
-  if (PathExists(cfg_file) && GetProtoFromFile(cfg_file, &cfg)) {
-    for (auto& thr : cfg.scheduler_conf().threads()) {
-      inner_thr_confs_[thr.name()] = thr;
-    }
-
-    if (cfg.scheduler_conf().has_process_level_cpuset()) {
-      process_level_cpuset_ = cfg.scheduler_conf().process_level_cpuset();
-      ProcessLevelResourceControl();
-    }
-
-    classic_conf_ = cfg.scheduler_conf().classic_conf();
-    for (auto& group : classic_conf_.groups()) {
-      auto& group_name = group.name();
-      for (auto task : group.tasks()) {
-        task.set_group_name(group_name);
-        cr_confs_[task.name()] = task;
-      }
-    }
-  } else {
-    // if do not set default_proc_num in scheduler conf
-    // give a default value
-    uint32_t proc_num = 2;
-    auto& global_conf = GlobalData::Instance()->Config();
-    if (global_conf.has_scheduler_conf() &&
-        global_conf.scheduler_conf().has_default_proc_num()) {
-      proc_num = global_conf.scheduler_conf().default_proc_num();
-    }
-    task_pool_size_ = proc_num;
-
-    auto sched_group = classic_conf_.add_groups();
-    sched_group->set_name(DEFAULT_GROUP_NAME);
-    sched_group->set_processor_num(proc_num);
-  }
-
+  LoadClassicConf(&classic_conf_, &cr_confs_);
   CreateProcessor();
 }
 
 void SchedulerClassic::CreateProcessor() {
   for (auto& group : classic_conf_.groups()) {
-    auto& group_name = group.name();
-    auto proc_num = group.processor_num();
-    if (task_pool_size_ == 0) {
-      task_pool_size_ = proc_num;
-    }
-
-    auto& affinity = group.affinity();
-    auto& processor_policy = group.processor_policy();
-    auto processor_prio = group.processor_prio();
-    std::vector<int> cpuset;
-    ParseCpuset(group.cpuset(), &cpuset);
-
-    for (uint32_t i = 0; i < proc_num; i++) {
-      auto ctx = std::make_shared<ClassicContext>(group_name);
-      pctxs_.emplace_back(ctx);
-
-      auto proc = std::make_shared<Processor>();
-      proc->BindContext(ctx);
-      SetSchedAffinity(proc->Thread(), cpuset, affinity, i);
-      SetSchedPolicy(proc->Thread(), processor_policy, processor_prio,
-                     proc->Tid());
-      processors_.emplace_back(proc);
+    std::vector<std::shared_ptr<ProcessorContext>> ctxs;
+    for (uint32_t i = 0; i < group.processor_num(); i++) {
+      ctxs.emplace_back(std::make_shared<ClassicContext>(group.name()));
     }
+    CreateGroupProcessors(group, ctxs);
   }
 }
 
@@ -0,0 +1,222 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/scheduler_work_stealing.h"
+
+#include <memory>
+#include <utility>
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::base::ReadLockGuard;
+using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::RoutineState;
+
+SchedulerWorkStealing::SchedulerWorkStealing(bool cross_group)
+    : cross_group_(cross_group) {
+  LoadClassicConf(&classic_conf_, &cr_confs_);
+  CreateProcessor();
+}
+
+void SchedulerWorkStealing::CreateProcessor() {
+  // victims are fixed before any processor starts running its context
+  std::vector<WorkStealingContext*> all_ctxs;
+  for (auto& group : classic_conf_.groups()) {
+    auto& ctxs = grp_ctxs_[group.name()];
+    for (uint32_t i = 0; i < group.processor_num(); i++) {
+      auto ctx = std::make_shared<WorkStealingContext>(group.name());
+      ctxs.emplace_back(ctx);
+      all_ctxs.emplace_back(ctx.get());
+    }
+  }
+
+  for (auto ctx : all_ctxs) {
+    std::vector<WorkStealingContext*> siblings;
+    for (auto& sibling : grp_ctxs_[ctx->group_name()]) {
+      siblings.emplace_back(sibling.get());
+    }
+    std::vector<WorkStealingContext*> remotes;
+    if (cross_group_) {
+      for (auto remote : all_ctxs) {
+        if (remote->group_name() != ctx->group_name()) {
+          remotes.emplace_back(remote);
+        }
+      }
+    }
+    ctx->SetVictims(siblings, remotes);
+  }
+
+  for (auto& group : classic_conf_.groups()) {
+    auto& ctxs = grp_ctxs_[group.name()];
+    CreateGroupProcessors(group, std::vector<std::shared_ptr<ProcessorContext>>(
+                                     ctxs.begin(), ctxs.end()));
+  }
+}
+
+WorkStealingContext* SchedulerWorkStealing::LeastLoadedContext(
+    const std::string& group_name) {
+  auto itr = grp_ctxs_.find(group_name);
+  if (itr == grp_ctxs_.end() || itr->second.empty()) {
+    return nullptr;
+  }
+
+  WorkStealingContext* least = nullptr;
+  for (auto& ctx : itr->second) {
+    if (least == nullptr || ctx->cr_num() < least->cr_num()) {
+      least = ctx.get();
+    }
+  }
+  return least;
+}
+
+bool SchedulerWorkStealing::DispatchTask(const std::shared_ptr<CRoutine>& cr) {
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  MutexWrapper* wrapper = nullptr;
+  if (!id_map_mutex_.Get(cr->id(), &wrapper)) {
+    {
+      std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+      if (!id_map_mutex_.Get(cr->id(), &wrapper)) {
+        wrapper = new MutexWrapper();
+        id_map_mutex_.Set(cr->id(), wrapper);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lg(wrapper->Mutex());
+
+  {
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    if (id_cr_.find(cr->id()) != id_cr_.end()) {
+      return false;
+    }
+    id_cr_[cr->id()] = cr;
+  }
+
+  if (cr_confs_.find(cr->name()) != cr_confs_.end()) {
+    ClassicTask task = cr_confs_[cr->name()];
+    cr->set_priority(task.prio());
+    cr->set_group_name(task.group_name());
+  } else {
+    // croutine that not exist in conf
+    cr->set_group_name(classic_conf_.groups(0).name());
+  }
+
+  if (cr->priority() >= MAX_PRIO) {
+    AWARN << cr->name() << " prio is greater than MAX_PRIO[ << " << MAX_PRIO
+          << "].";
+    cr->set_priority(MAX_PRIO - 1);
+  }
+
+  auto ctx = LeastLoadedContext(cr->group_name());
+  if (ctx == nullptr) {
+    AWARN << cr->name() << " group " << cr->group_name()
+          << " has no processor, use " << classic_conf_.groups(0).name();
+    cr->set_group_name(classic_conf_.groups(0).name());
+    ctx = LeastLoadedContext(cr->group_name());
+    if (ctx == nullptr) {
+      AERROR << cr->name() << " has no processor to run on.";
+      WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+      id_cr_.erase(cr->id());
+      return false;
+    }
+  }
+
+  // Enqueue task.
+  ctx->Enqueue(cr);
+  {
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    id_ctx_[cr->id()] = ctx;
+  }
+
+  ctx->Notify();
+  return true;
+}
+
+bool SchedulerWorkStealing::NotifyProcessor(uint64_t crid) {
+  if (cyber_unlikely(stop_)) {
+    return true;
+  }
+
+  {
+    ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    auto itr = id_cr_.find(crid);
+    if (itr != id_cr_.end()) {
+      auto cr = itr->second;
+      if (cr->state() == RoutineState::DATA_WAIT ||
+          cr->state() == RoutineState::IO_WAIT) {
+        cr->SetUpdateFlag();
+      }
+
+      auto ctx_itr = id_ctx_.find(crid);
+      if (ctx_itr != id_ctx_.end()) {
+        ctx_itr->second->Notify();
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SchedulerWorkStealing::RemoveTask(const std::string& name) {
+  if (cyber_unlikely(stop_)) {
+    return true;
+  }
+
+  auto crid = GlobalData::GenerateHashId(name);
+  return RemoveCRoutine(crid);
+}
+
+bool SchedulerWorkStealing::RemoveCRoutine(uint64_t crid) {
+  // we use multi-key mutex to prevent race condition
+  // when del && add cr with same crid
+  MutexWrapper* wrapper = nullptr;
+  if (!id_map_mutex_.Get(crid, &wrapper)) {
+    {
+      std::lock_guard<std::mutex> wl_lg(cr_wl_mtx_);
+      if (!id_map_mutex_.Get(crid, &wrapper)) {
+        wrapper = new MutexWrapper();
+        id_map_mutex_.Set(crid, wrapper);
+      }
+    }
+  }
+  std::lock_guard<std::mutex> lg(wrapper->Mutex());
+
+  std::shared_ptr<CRoutine> cr = nullptr;
+  WorkStealingContext* ctx = nullptr;
+  {
+    WriteLockGuard<AtomicRWLock> lk(id_cr_lock_);
+    if (id_cr_.find(crid) != id_cr_.end()) {
+      cr = id_cr_[crid];
+      id_cr_[crid]->Stop();
+      id_cr_.erase(crid);
+    } else {
+      return false;
+    }
+    auto itr = id_ctx_.find(crid);
+    if (itr != id_ctx_.end()) {
+      ctx = itr->second;
+      id_ctx_.erase(itr);
+    }
+  }
+  return ctx != nullptr && ctx->RemoveCRoutine(cr);
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,207 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/scheduler/policy/work_stealing_context.h"
+
+#include <chrono>
+#include <climits>
+#include <thread>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using apollo::cyber::base::AtomicRWLock;
+using apollo::cyber::base::ReadLockGuard;
+using apollo::cyber::base::WriteLockGuard;
+using apollo::cyber::croutine::CRoutine;
+using apollo::cyber::croutine::RoutineState;
+
+WorkStealingContext::WorkStealingContext(const std::string& group_name)
+    : group_name_(group_name) {}
+
+void WorkStealingContext::SetVictims(
+    const std::vector<WorkStealingContext*>& siblings,
+    const std::vector<WorkStealingContext*>& remotes) {
+  siblings_.clear();
+  for (auto ctx : siblings) {
+    if (ctx != this) {
+      siblings_.emplace_back(ctx);
+    }
+  }
+  remotes_ = remotes;
+}
+
+std::shared_ptr<CRoutine> WorkStealingContext::NextRoutine() {
+  if (cyber_unlikely(stop_.load())) {
+    return nullptr;
+  }
+
+  auto cr = NextLocalRoutine();
+  if (cr != nullptr) {
+    return cr;
+  }
+
+  cr = Steal(siblings_);
+  if (cr != nullptr) {
+    return cr;
+  }
+
+  return Steal(remotes_);
+}
+
+std::shared_ptr<CRoutine> WorkStealingContext::NextLocalRoutine() {
+  for (int i = MAX_PRIO - 1; i >= 0; --i) {
+    ReadLockGuard<AtomicRWLock> lk(lqs_.at(i));
+    for (auto& cr : rqs_.at(i)) {
+      if (!cr->Acquire()) {
+        continue;
+      }
+
+      if (cr->UpdateState() == RoutineState::READY) {
+        return cr;
+      }
+
+      cr->Release();
+    }
+  }
+
+  return nullptr;
+}
+
+std::shared_ptr<CRoutine> WorkStealingContext::Steal(
+    const std::vector<WorkStealingContext*>& victims) {
+  auto victim_num = static_cast<uint32_t>(victims.size());
+  if (victim_num == 0) {
+    return nullptr;
+  }
+
+  // take the highest priority ready croutine of all victims, starting from
+  // the victim we last stole from
+  for (int i = MAX_PRIO - 1; i >= 0; --i) {
+    for (uint32_t j = 0; j < victim_num; ++j) {
+      auto index = (victim_offset_ + j) % victim_num;
+      auto cr = victims[index]->StealFrom(i);
+      if (cr != nullptr) {
+        victim_offset_ = index;
+        return cr;
+      }
+    }
+  }
+
+  ++victim_offset_;
+  return nullptr;
+}
+
+std::shared_ptr<CRoutine> WorkStealingContext::StealFrom(uint32_t prio) {
+  ReadLockGuard<AtomicRWLock> lk(lqs_.at(prio));
+  auto& rq = rqs_.at(prio);
+  // the owner scans from the front, thieves from the back
+  for (auto it = rq.rbegin(); it != rq.rend(); ++it) {
+    auto& cr = *it;
+    if (!cr->Acquire()) {
+      continue;
+    }
+
+    if (cr->UpdateState() == RoutineState::READY) {
+      return cr;
+    }
+
+    cr->Release();
+  }
+
+  return nullptr;
+}
+
+void WorkStealingContext::Wait() {
+  std::unique_lock<std::mutex> lk(mtx_wq_);
+  idle_.store(true);
+  cv_wq_.wait_for(lk, std::chrono::milliseconds(1000),
+                  [&]() { return notify_ > 0; });
+  idle_.store(false);
+  if (notify_ > 0) {
+    notify_--;
+  }
+}
+
+void WorkStealingContext::Shutdown() {
+  stop_.store(true);
+  mtx_wq_.lock();
+  notify_ = UCHAR_MAX;
+  mtx_wq_.unlock();
+  cv_wq_.notify_all();
+}
+
+void WorkStealingContext::Notify() {
+  WakeUp();
+  if (idle_.load()) {
+    return;
+  }
+
+  // the owner is busy, let an idle victim pick the croutine up
+  for (auto ctx : siblings_) {
+    if (ctx->idle()) {
+      ctx->WakeUp();
+      return;
+    }
+  }
+  for (auto ctx : remotes_) {
+    if (ctx->idle()) {
+      ctx->WakeUp();
+      return;
+    }
+  }
+}
+
+void WorkStealingContext::WakeUp() {
+  mtx_wq_.lock();
+  notify_++;
+  mtx_wq_.unlock();
+  cv_wq_.notify_one();
+}
+
+void WorkStealingContext::Enqueue(const std::shared_ptr<CRoutine>& cr) {
+  WriteLockGuard<AtomicRWLock> lk(lqs_.at(cr->priority()));
+  rqs_.at(cr->priority()).emplace_back(cr);
+  cr_num_.fetch_add(1);
+}
+
+bool WorkStealingContext::RemoveCRoutine(const std::shared_ptr<CRoutine>& cr) {
+  auto crid = cr->id();
+  WriteLockGuard<AtomicRWLock> lk(lqs_.at(cr->priority()));
+  auto& croutines = rqs_.at(cr->priority());
+  for (auto it = croutines.begin(); it != croutines.end(); ++it) {
+    if ((*it)->id() == crid) {
+      auto cr = *it;
+      cr->Stop();
+      while (!cr->Acquire()) {
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+        AINFO_EVERY(1000) << "waiting for task " << cr->name() << " completion";
+      }
+      croutines.erase(it);
+      cr_num_.fetch_sub(1);
+      cr->Release();
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
+#define CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "cyber/base/atomic_rw_lock.h"
+#include "cyber/croutine/croutine.h"
+#include "cyber/scheduler/policy/classic_context.h"
+#include "cyber/scheduler/processor_context.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+using CROUTINE_DEQUE = std::deque<std::shared_ptr<CRoutine>>;
+using MULTI_PRIO_DEQUE = std::array<CROUTINE_DEQUE, MAX_PRIO>;
+
+/**
+ * @class WorkStealingContext
+ * @brief Per-processor context of the work-stealing policy. Every croutine is
+ * homed on exactly one processor and lives in that processor's priority
+ * deques. The owner scans its deques from the front; once it runs dry it
+ * steals ready croutines from the back of its victims' deques, highest
+ * priority first across all victims.
+ *
+ * Victims are the other processors of the same group, plus the processors of
+ * the other groups when cross-group stealing is enabled. Victims must be set
+ * before the context is bound to a processor and never change afterwards.
+ */
+class WorkStealingContext : public ProcessorContext {
+ public:
+  explicit WorkStealingContext(const std::string &group_name);
+
+  std::shared_ptr<CRoutine> NextRoutine() override;
+  void Wait() override;
+  void Shutdown() override;
+
+  void SetVictims(const std::vector<WorkStealingContext *> &siblings,
+                  const std::vector<WorkStealingContext *> &remotes);
+
+  void Enqueue(const std::shared_ptr<CRoutine> &cr);
+  bool RemoveCRoutine(const std::shared_ptr<CRoutine> &cr);
+
+  // Wake the owner, and an idle victim as well if the owner is busy.
+  void Notify();
+
+  uint32_t cr_num() const { return cr_num_.load(); }
+  bool idle() const { return idle_.load(); }
+  const std::string &group_name() const { return group_name_; }
+
+ private:
+  std::shared_ptr<CRoutine> NextLocalRoutine();
+  std::shared_ptr<CRoutine> Steal(
+      const std::vector<WorkStealingContext *> &victims);
+  std::shared_ptr<CRoutine> StealFrom(uint32_t prio);
+  void WakeUp();
+
+  MULTI_PRIO_DEQUE rqs_;
+  LOCK_QUEUE lqs_;
+  std::atomic<uint32_t> cr_num_ = {0};
+
+  std::vector<WorkStealingContext *> siblings_;
+  std::vector<WorkStealingContext *> remotes_;
+  uint32_t victim_offset_ = 0;
+
+  std::atomic<bool> idle_ = {false};
+  std::mutex mtx_wq_;
+  std::condition_variable cv_wq_;
+  int notify_ = 0;
+
+  std::string group_name_;
+};
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_SCHEDULER_POLICY_WORK_STEALING_CONTEXT_H_
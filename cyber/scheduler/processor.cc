@@ -31,6 +31,17 @@ namespace cyber {
 namespace scheduler {
 
 using apollo::cyber::common::GlobalData;
+using apollo::cyber::croutine::RoutineState;
+
+namespace {
+
+uint64_t SteadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
 
 Processor::Processor() { running_.store(true); }
 
@@ -47,7 +58,20 @@ void Processor::Run() {
       if (croutine) {
         snap_shot_->execute_start_time.store(cyber::Time::Now().ToNanosecond());
         snap_shot_->routine_name = croutine->name();
+        auto start = SteadyNowNs();
+        auto ready_time = croutine->TakeReadyTime();
+        if (ready_time != 0 && start > ready_time) {
+          croutine->wait_latency().Record(start - ready_time);
+          snap_shot_->wait_latency.Record(start - ready_time);
+        }
         croutine->Resume();
+        auto end = SteadyNowNs();
+        croutine->run_time().Record(end - start);
+        snap_shot_->run_time.Record(end - start);
+        if (croutine->state() == RoutineState::READY) {
+          // yielded, runnable again right away
+          croutine->MarkReady(end);
+        }
         croutine->Release();
       } else {
         snap_shot_->execute_start_time.store(0);
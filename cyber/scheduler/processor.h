@@ -25,6 +25,7 @@
 #include <thread>
 #include <vector>
 
+#include "cyber/base/histogram.h"
 #include "cyber/croutine/croutine.h"
 #include "cyber/proto/scheduler_conf.pb.h"
 #include "cyber/scheduler/processor_context.h"
@@ -39,6 +40,9 @@ struct Snapshot {
   std::atomic<uint64_t> execute_start_time = {0};
   std::atomic<pid_t> processor_id = {0};
   std::string routine_name;
+  // written by the processor thread only, sampled by the scheduler
+  base::Histogram wait_latency;
+  base::Histogram run_time;
 };
 
 class Processor {
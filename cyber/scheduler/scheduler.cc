@@ -24,6 +24,7 @@
 #include "cyber/common/global_data.h"
 #include "cyber/common/util.h"
 #include "cyber/data/data_visitor.h"
+#include "cyber/scheduler/policy/classic_context.h"
 #include "cyber/scheduler/processor.h"
 #include "cyber/scheduler/processor_context.h"
 
@@ -31,7 +32,48 @@ namespace apollo {
 namespace cyber {
 namespace scheduler {
 
+using apollo::cyber::common::GetAbsolutePath;
+using apollo::cyber::common::GetProtoFromFile;
 using apollo::cyber::common::GlobalData;
+using apollo::cyber::common::PathExists;
+using apollo::cyber::common::WorkRoot;
+
+namespace {
+
+void FillHistogram(const base::Histogram& hist,
+                   proto::LatencyHistogram* msg) {
+  msg->set_count(hist.count());
+  msg->set_sum_ns(hist.sum());
+  msg->set_max_ns(hist.max());
+  msg->set_p50_ns(hist.Percentile(50));
+  msg->set_p99_ns(hist.Percentile(99));
+  uint32_t bucket_num = base::Histogram::kBucketNum;
+  while (bucket_num > 0 && hist.bucket(bucket_num - 1) == 0) {
+    --bucket_num;
+  }
+  for (uint32_t i = 0; i < bucket_num; ++i) {
+    msg->add_bucket(hist.bucket(i));
+  }
+}
+
+// Bytes of a croutine stack configured as stack_size_kb, fallback if it is
+// unset or zero.
+size_t StackSize(const std::string& name, uint32_t stack_size_kb,
+                 size_t fallback) {
+  if (stack_size_kb == 0) {
+    return fallback;
+  }
+  size_t stack_size = static_cast<size_t>(stack_size_kb) * 1024;
+  if (stack_size < croutine::MIN_STACK_SIZE) {
+    AWARN << "stack of croutine " << name << " raised from " << stack_size_kb
+          << " KB to the minimum " << croutine::MIN_STACK_SIZE / 1024
+          << " KB.";
+    return croutine::MIN_STACK_SIZE;
+  }
+  return stack_size;
+}
+
+}  // namespace
 
 bool Scheduler::CreateTask(const RoutineFactory& factory,
                            const std::string& name) {
@@ -48,7 +90,16 @@ bool Scheduler::CreateTask(std::function<void()>&& func,
 
   auto task_id = GlobalData::RegisterTaskName(name);
 
-  auto cr = std::make_shared<CRoutine>(func);
+  size_t stack_size = default_cr_stack_size_;
+  auto stack_search = cr_stack_sizes_.find(name);
+  if (stack_search != cr_stack_sizes_.end()) {
+    stack_size = stack_search->second;
+  }
+  auto cr = std::make_shared<CRoutine>(func, stack_size);
+  if (!cr->Valid()) {
+    AERROR << "no stack of " << stack_size << " bytes for croutine: " << name;
+    return false;
+  }
   cr->set_id(task_id);
   cr->set_name(name);
   AINFO << "create croutine: " << name;
@@ -86,6 +137,76 @@ void Scheduler::ProcessLevelResourceControl() {
   pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
 }
 
+void Scheduler::LoadClassicConf(
+    proto::ClassicConf* classic_conf,
+    std::unordered_map<std::string, proto::ClassicTask>* cr_confs) {
+  std::string conf("conf/");
+  conf.append(GlobalData::Instance()->ProcessGroup()).append(".conf");
+  auto cfg_file = GetAbsolutePath(WorkRoot(), conf);
+
+  apollo::cyber::proto::CyberConfig cfg;
+  if (PathExists(cfg_file) && GetProtoFromFile(cfg_file, &cfg)) {
+    for (auto& thr : cfg.scheduler_conf().threads()) {
+      inner_thr_confs_[thr.name()] = thr;
+    }
+
+    if (cfg.scheduler_conf().has_process_level_cpuset()) {
+      process_level_cpuset_ = cfg.scheduler_conf().process_level_cpuset();
+      ProcessLevelResourceControl();
+    }
+
+    *classic_conf = cfg.scheduler_conf().classic_conf();
+    for (auto& group : classic_conf->groups()) {
+      auto& group_name = group.name();
+      for (auto task : group.tasks()) {
+        task.set_group_name(group_name);
+        (*cr_confs)[task.name()] = task;
+      }
+    }
+  }
+
+  if (classic_conf->groups_size() == 0) {
+    // if do not set default_proc_num in scheduler conf
+    // give a default value
+    uint32_t proc_num = 2;
+    auto& global_conf = GlobalData::Instance()->Config();
+    if (global_conf.has_scheduler_conf() &&
+        global_conf.scheduler_conf().has_default_proc_num()) {
+      proc_num = global_conf.scheduler_conf().default_proc_num();
+    }
+    task_pool_size_ = proc_num;
+
+    auto sched_group = classic_conf->add_groups();
+    sched_group->set_name(DEFAULT_GROUP_NAME);
+    sched_group->set_processor_num(proc_num);
+  }
+}
+
+void Scheduler::CreateGroupProcessors(
+    const proto::SchedGroup& group,
+    const std::vector<std::shared_ptr<ProcessorContext>>& ctxs) {
+  if (task_pool_size_ == 0) {
+    task_pool_size_ = group.processor_num();
+  }
+
+  auto& affinity = group.affinity();
+  auto& processor_policy = group.processor_policy();
+  auto processor_prio = group.processor_prio();
+  std::vector<int> cpuset;
+  ParseCpuset(group.cpuset(), &cpuset);
+
+  for (uint32_t i = 0; i < ctxs.size(); i++) {
+    pctxs_.emplace_back(ctxs[i]);
+
+    auto proc = std::make_shared<Processor>();
+    proc->BindContext(ctxs[i]);
+    SetSchedAffinity(proc->Thread(), cpuset, affinity, i);
+    SetSchedPolicy(proc->Thread(), processor_policy, processor_prio,
+                   proc->Tid());
+    processors_.emplace_back(proc);
+  }
+}
+
 void Scheduler::SetInnerThreadAttr(const std::string& name, std::thread* thr) {
   if (thr != nullptr && inner_thr_confs_.find(name) != inner_thr_confs_.end()) {
     auto th_conf = inner_thr_confs_[name];
@@ -121,6 +242,47 @@ void Scheduler::CheckSchedStatus() {
   snap_info.clear();
 }
 
+void Scheduler::GetSchedulerStats(proto::SchedulerStats* stats) {
+  stats->Clear();
+  stats->set_process_group(GlobalData::Instance()->ProcessGroup());
+  stats->set_process_id(GlobalData::Instance()->ProcessId());
+  stats->set_timestamp(Time::Now().ToNanosecond());
+  for (auto& processor : processors_) {
+    auto snap = processor->ProcSnapshot();
+    auto proc_stats = stats->add_processor();
+    proc_stats->set_processor_id(snap->processor_id.load());
+    if (snap->execute_start_time.load()) {
+      proc_stats->set_routine_name(snap->routine_name);
+    }
+    FillHistogram(snap->wait_latency, proc_stats->mutable_wait_latency());
+    FillHistogram(snap->run_time, proc_stats->mutable_run_time());
+  }
+
+  ReadLockGuard<AtomicRWLock> lk(id_cr_lock_);
+  for (auto& id_cr : id_cr_) {
+    auto& cr = id_cr.second;
+    auto cr_stats = stats->add_croutine();
+    cr_stats->set_name(cr->name());
+    cr_stats->set_id(cr->id());
+    cr_stats->set_priority(cr->priority());
+    cr_stats->set_group_name(cr->group_name());
+    FillHistogram(cr->wait_latency(), cr_stats->mutable_wait_latency());
+    FillHistogram(cr->run_time(), cr_stats->mutable_run_time());
+    cr_stats->set_stack_size(cr->stack_size());
+    cr_stats->set_stack_high_water(cr->stack_high_water());
+  }
+}
+
+void Scheduler::SetCRoutineConf(const proto::CRoutineConf& conf) {
+  default_cr_stack_size_ =
+      StackSize("default", conf.default_stack_size_kb(), croutine::STACK_SIZE);
+  cr_stack_sizes_.clear();
+  for (const auto& stack : conf.stack()) {
+    cr_stack_sizes_[stack.name()] =
+        StackSize(stack.name(), stack.stack_size_kb(), default_cr_stack_size_);
+  }
+}
+
 void Scheduler::Shutdown() {
   if (cyber_unlikely(stop_.exchange(true))) {
     return;
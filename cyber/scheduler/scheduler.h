@@ -35,6 +35,9 @@
 #include "cyber/croutine/croutine.h"
 #include "cyber/croutine/routine_factory.h"
 #include "cyber/proto/choreography_conf.pb.h"
+#include "cyber/proto/classic_conf.pb.h"
+#include "cyber/proto/croutine_conf.pb.h"
+#include "cyber/proto/scheduler_stats.pb.h"
 #include "cyber/scheduler/common/mutex_wrapper.h"
 #include "cyber/scheduler/common/pin_thread.h"
 
@@ -77,14 +80,43 @@ class Scheduler {
 
   void CheckSchedStatus();
 
+  /**
+   * @brief Sample the wake-to-run latency and run time histograms of every
+   * processor and croutine. Recording is lock-free, so this may be called at
+   * any time without disturbing the processors.
+   */
+  void GetSchedulerStats(proto::SchedulerStats* stats);
+
   void SetInnerThreadConfs(
       const std::unordered_map<std::string, InnerThread>& confs) {
     inner_thr_confs_ = confs;
   }
 
+  /**
+   * @brief Set the stack sizes of the croutines created from now on.
+   */
+  void SetCRoutineConf(const proto::CRoutineConf& conf);
+
  protected:
   Scheduler() : stop_(false) {}
 
+  /**
+   * @brief Load the classic groups and task confs from the conf of the
+   * process group, with its inner thread confs and process level cpuset. A
+   * default group is added if no group is configured.
+   */
+  void LoadClassicConf(
+      proto::ClassicConf* classic_conf,
+      std::unordered_map<std::string, proto::ClassicTask>* cr_confs);
+
+  /**
+   * @brief Create a processor for each context of a group, with the cpuset,
+   * affinity and policy of the group.
+   */
+  void CreateGroupProcessors(
+      const proto::SchedGroup& group,
+      const std::vector<std::shared_ptr<ProcessorContext>>& ctxs);
+
   AtomicRWLock id_cr_lock_;
   AtomicHashMap<uint64_t, MutexWrapper*> id_map_mutex_;
   std::mutex cr_wl_mtx_;
@@ -95,6 +127,10 @@ class Scheduler {
 
   std::unordered_map<std::string, InnerThread> inner_thr_confs_;
 
+  // croutine stack sizes in bytes, by task name
+  std::unordered_map<std::string, size_t> cr_stack_sizes_;
+  size_t default_cr_stack_size_ = croutine::STACK_SIZE;
+
   std::string process_level_cpuset_;
   uint32_t proc_num_ = 0;
   uint32_t task_pool_size_ = 0;
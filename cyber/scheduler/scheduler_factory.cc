@@ -29,6 +29,7 @@
 #include "cyber/common/util.h"
 #include "cyber/scheduler/policy/scheduler_choreography.h"
 #include "cyber/scheduler/policy/scheduler_classic.h"
+#include "cyber/scheduler/policy/scheduler_work_stealing.h"
 #include "cyber/scheduler/scheduler.h"
 
 namespace apollo {
@@ -66,10 +67,23 @@ Scheduler* Instance() {
         obj = new SchedulerClassic();
       } else if (!policy.compare("choreography")) {
         obj = new SchedulerChoreography();
+      } else if (!policy.compare("work_stealing")) {
+        obj = new SchedulerWorkStealing(false);
+      } else if (!policy.compare("work_stealing_cross_group")) {
+        obj = new SchedulerWorkStealing(true);
       } else {
         AWARN << "Invalid scheduler policy: " << policy;
         obj = new SchedulerClassic();
       }
+
+      std::string cr_conf("conf/");
+      cr_conf.append(GlobalData::Instance()->ProcessGroup())
+          .append(".croutine.conf");
+      auto cr_conf_file = GetAbsolutePath(WorkRoot(), cr_conf);
+      apollo::cyber::proto::CRoutineConf cr_cfg;
+      if (PathExists(cr_conf_file) && GetProtoFromFile(cr_conf_file, &cr_cfg)) {
+        obj->SetCRoutineConf(cr_cfg);
+      }
       instance.store(obj, std::memory_order_release);
     }
   }
@@ -66,6 +66,29 @@ TEST(SchedulerTest, notify_task) {
   EXPECT_TRUE(sched->NotifyTask(id));
 }
 
+TEST(SchedulerTest, scheduler_stats) {
+  auto sched = Instance();
+  cyber::Init("scheduler_test");
+  std::string name = "stats_task";
+  EXPECT_TRUE(sched->CreateTask(&proc, name));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  proto::SchedulerStats stats;
+  sched->GetSchedulerStats(&stats);
+  EXPECT_EQ(stats.process_group(), GlobalData::Instance()->ProcessGroup());
+  EXPECT_GT(stats.processor_size(), 0);
+  bool found = false;
+  for (auto& cr_stats : stats.croutine()) {
+    if (cr_stats.name() == name) {
+      found = true;
+      EXPECT_GE(cr_stats.run_time().count(), 1);
+      EXPECT_LE(cr_stats.run_time().p50_ns(), cr_stats.run_time().max_ns());
+    }
+  }
+  EXPECT_TRUE(found);
+  EXPECT_TRUE(sched->RemoveTask(name));
+}
+
 TEST(SchedulerTest, set_inner_thread_attr) {
   auto sched = Instance();
   cyber::Init("scheduler_test");
@@ -0,0 +1,137 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include "cyber/common/global_data.h"
+#include "cyber/cyber.h"
+#include "cyber/scheduler/policy/work_stealing_context.h"
+#include "cyber/scheduler/processor.h"
+
+namespace apollo {
+namespace cyber {
+namespace scheduler {
+
+void func() {}
+
+std::shared_ptr<CRoutine> MakeCRoutine(const std::string& name,
+                                       uint32_t prio) {
+  auto cr = std::make_shared<CRoutine>(func);
+  cr->set_id(GlobalData::RegisterTaskName(name));
+  cr->set_name(name);
+  cr->set_priority(prio);
+  return cr;
+}
+
+TEST(SchedulerWorkStealingTest, steal_within_group) {
+  WorkStealingContext owner("grp");
+  WorkStealingContext thief("grp");
+  std::vector<WorkStealingContext*> group = {&owner, &thief};
+  owner.SetVictims(group, {});
+  thief.SetVictims(group, {});
+
+  auto low = MakeCRoutine("ws_low", 1);
+  auto high = MakeCRoutine("ws_high", 10);
+  owner.Enqueue(low);
+  owner.Enqueue(high);
+  EXPECT_EQ(2, owner.cr_num());
+  EXPECT_EQ(0, thief.cr_num());
+
+  // the highest priority croutine is stolen first
+  auto cr = thief.NextRoutine();
+  ASSERT_NE(nullptr, cr);
+  EXPECT_EQ(high->id(), cr->id());
+
+  // a running croutine can not be taken twice
+  auto other = owner.NextRoutine();
+  ASSERT_NE(nullptr, other);
+  EXPECT_EQ(low->id(), other->id());
+  EXPECT_EQ(nullptr, thief.NextRoutine());
+
+  cr->Release();
+  other->Release();
+
+  EXPECT_TRUE(owner.RemoveCRoutine(high));
+  EXPECT_FALSE(thief.RemoveCRoutine(low));
+  EXPECT_TRUE(owner.RemoveCRoutine(low));
+  EXPECT_EQ(0, owner.cr_num());
+}
+
+TEST(SchedulerWorkStealingTest, steal_across_groups) {
+  WorkStealingContext owner("grp_a");
+  WorkStealingContext isolated("grp_b");
+  WorkStealingContext remote("grp_b");
+  owner.SetVictims({&owner}, {});
+  isolated.SetVictims({&isolated}, {});
+  remote.SetVictims({&remote}, {&owner});
+
+  auto cr = MakeCRoutine("ws_remote", 0);
+  owner.Enqueue(cr);
+
+  EXPECT_EQ(nullptr, isolated.NextRoutine());
+  auto stolen = remote.NextRoutine();
+  ASSERT_NE(nullptr, stolen);
+  EXPECT_EQ(cr->id(), stolen->id());
+  stolen->Release();
+
+  EXPECT_TRUE(owner.RemoveCRoutine(cr));
+  EXPECT_EQ(nullptr, remote.NextRoutine());
+}
+
+TEST(SchedulerWorkStealingTest, notify_idle_victim) {
+  WorkStealingContext owner("grp");
+  WorkStealingContext thief("grp");
+  std::vector<WorkStealingContext*> group = {&owner, &thief};
+  owner.SetVictims(group, {});
+  thief.SetVictims(group, {});
+
+  auto processor = std::make_shared<Processor>();
+  processor->BindContext(std::shared_ptr<ProcessorContext>(
+      &thief, [](ProcessorContext*) {}));
+  while (!thief.idle()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // the owner is not waiting, so the notification goes to the idle thief
+  std::atomic<bool> done = {false};
+  auto cr = std::make_shared<CRoutine>([&done]() { done.store(true); });
+  cr->set_id(GlobalData::RegisterTaskName("ws_notify"));
+  cr->set_name("ws_notify");
+  owner.Enqueue(cr);
+  owner.Notify();
+
+  auto start = std::chrono::steady_clock::now();
+  while (!done.load()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+
+  processor->Stop();
+  EXPECT_TRUE(owner.RemoveCRoutine(cr));
+}
+
+}  // namespace scheduler
+}  // namespace cyber
+}  // namespace apollo
+
+int main(int argc, char** argv) {
+  testing::InitGoogleTest(&argc, argv);
+  apollo::cyber::Init(argv[0]);
+  auto res = RUN_ALL_TESTS();
+  apollo::cyber::Clear();
+  return res;
+}
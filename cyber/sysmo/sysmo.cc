@@ -16,18 +16,35 @@
 
 #include "cyber/sysmo/sysmo.h"
 
+#include <algorithm>
+
 #include "cyber/common/environment.h"
+#include "cyber/common/global_data.h"
 
 namespace apollo {
 namespace cyber {
 
 using apollo::cyber::common::GetEnv;
+using apollo::cyber::common::GlobalData;
 
 SysMo::SysMo() { Start(); }
 
 void SysMo::Start() {
   auto sysmo_start = GetEnv("sysmo_start");
   if (sysmo_start != "" && std::stoi(sysmo_start)) {
+    check_status_ = true;
+  }
+
+  auto sched_stats = GetEnv("sysmo_sched_stats");
+  if (sched_stats != "" && std::stoi(sched_stats)) {
+    publish_stats_ = true;
+    auto interval = GetEnv("sysmo_sched_stats_interval_ms");
+    if (interval != "") {
+      stats_interval_ms_ = std::max(std::stoi(interval), sysmo_interval_ms_);
+    }
+  }
+
+  if (check_status_ || publish_stats_) {
     start_ = true;
     sysmo_ = std::thread(&SysMo::Checker, this);
   }
@@ -42,15 +59,48 @@ void SysMo::Shutdown() {
   if (sysmo_.joinable()) {
     sysmo_.join();
   }
+  stats_writer_ = nullptr;
+  node_ = nullptr;
 }
 
 void SysMo::Checker() {
   while (cyber_unlikely(!shut_down_.load())) {
-    scheduler::Instance()->CheckSchedStatus();
+    if (check_status_) {
+      scheduler::Instance()->CheckSchedStatus();
+    }
+    if (publish_stats_) {
+      PublishSchedStats();
+    }
     std::unique_lock<std::mutex> lk(lk_);
     cv_.wait_for(lk, std::chrono::milliseconds(sysmo_interval_ms_));
   }
 }
 
+void SysMo::PublishSchedStats() {
+  auto now = std::chrono::steady_clock::now();
+  if (stats_writer_ != nullptr &&
+      now - last_stats_time_ < std::chrono::milliseconds(stats_interval_ms_)) {
+    return;
+  }
+  last_stats_time_ = now;
+
+  if (stats_writer_ == nullptr) {
+    auto suffix = GlobalData::Instance()->ProcessGroup() + "_" +
+                  std::to_string(GlobalData::Instance()->ProcessId());
+    node_.reset(new Node("sysmo_" + suffix));
+    stats_writer_ = node_->CreateWriter<SchedulerStats>(
+        "/apollo/cyber/sched_stats/" + suffix);
+    if (stats_writer_ == nullptr) {
+      AERROR << "create scheduler stats writer failed.";
+      publish_stats_ = false;
+      return;
+    }
+  }
+
+  auto stats = std::make_shared<SchedulerStats>();
+  scheduler::Instance()->GetSchedulerStats(stats.get());
+  stats_writer_->Write(stats);
+}
+
 }  // namespace cyber
 }  // namespace apollo
@@ -20,17 +20,30 @@
 #include <chrono>
 #include <condition_variable>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
+#include "cyber/node/node.h"
+#include "cyber/proto/scheduler_stats.pb.h"
 #include "cyber/scheduler/scheduler_factory.h"
 
 namespace apollo {
 namespace cyber {
 
+using apollo::cyber::proto::SchedulerStats;
 using apollo::cyber::scheduler::Scheduler;
 
+/**
+ * @class SysMo
+ * @brief System monitor thread. With env sysmo_start=1 it logs what every
+ * processor is running; with env sysmo_sched_stats=1 it publishes the
+ * scheduler latency histograms as SchedulerStats on
+ * /apollo/cyber/sched_stats/<process_group>_<pid> every
+ * sysmo_sched_stats_interval_ms (1000 by default), to be watched with
+ * cyber_monitor.
+ */
 class SysMo {
  public:
   void Start();
@@ -38,11 +51,18 @@ class SysMo {
 
  private:
   void Checker();
+  void PublishSchedStats();
 
   std::atomic<bool> shut_down_{false};
   bool start_ = false;
+  bool check_status_ = false;
+  bool publish_stats_ = false;
 
   int sysmo_interval_ms_ = 100;
+  int stats_interval_ms_ = 1000;
+  std::chrono::steady_clock::time_point last_stats_time_;
+  std::unique_ptr<Node> node_;
+  std::shared_ptr<Writer<SchedulerStats>> stats_writer_;
   std::condition_variable cv_;
   std::mutex lk_;
   std::thread sysmo_;
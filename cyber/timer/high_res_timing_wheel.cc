@@ -0,0 +1,258 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/timer/high_res_timing_wheel.h"
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+
+#include "cyber/common/log.h"
+#include "cyber/scheduler/scheduler_factory.h"
+#include "cyber/task/task.h"
+#include "cyber/time/time.h"
+
+namespace apollo {
+namespace cyber {
+
+HighResTimingWheel::HighResTimingWheel() {}
+
+HighResTimingWheel::~HighResTimingWheel() {
+  Shutdown();
+  if (timer_fd_ >= 0) {
+    close(timer_fd_);
+  }
+}
+
+uint64_t HighResTimingWheel::ToTick(uint64_t time_ns) {
+  return (time_ns + HIGH_RES_TIMER_RESOLUTION_NS - 1) /
+         HIGH_RES_TIMER_RESOLUTION_NS;
+}
+
+void HighResTimingWheel::Start() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (running_.load()) {
+    return;
+  }
+  if (timer_fd_ < 0) {
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    if (timer_fd_ < 0) {
+      AERROR << "timerfd_create failed, errno: " << errno;
+      return;
+    }
+  }
+  current_tick_ =
+      Time::MonoTime().ToNanosecond() / HIGH_RES_TIMER_RESOLUTION_NS;
+  running_.store(true);
+  thread_ = std::thread(&HighResTimingWheel::ThreadFunc, this);
+  scheduler::Instance()->SetInnerThreadAttr("timer", &thread_);
+  ADEBUG << "HighResTimingWheel start ok";
+}
+
+void HighResTimingWheel::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_.exchange(false)) {
+      return;
+    }
+    // an expiry in the past wakes the thread up right away
+    struct itimerspec spec = {};
+    spec.it_value.tv_nsec = 1;
+    timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr);
+    armed_tick_ = kNoTick;
+  }
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void HighResTimingWheel::AddTask(const std::shared_ptr<TimerTask>& task) {
+  if (!running_.load()) {
+    Start();
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (armed_tick_ == kNoTick) {
+    // the wheel is empty and has not moved since, catch it up so that the
+    // task lands in the right slot
+    current_tick_ =
+        std::max(current_tick_, Time::MonoTime().ToNanosecond() /
+                                    HIGH_RES_TIMER_RESOLUTION_NS);
+  }
+  Insert(task);
+  uint64_t tick = std::max(ToTick(task->deadline_ns), current_tick_);
+  if (tick < armed_tick_) {
+    Arm(tick);
+  }
+}
+
+void HighResTimingWheel::Insert(const std::shared_ptr<TimerTask>& task) {
+  uint64_t tick = std::max(ToTick(task->deadline_ns), current_tick_);
+  uint32_t level = 0;
+  while (level + 1 < kLevelNum &&
+         (tick >> (kSlotBits * (level + 1))) !=
+             (current_tick_ >> (kSlotBits * (level + 1)))) {
+    ++level;
+  }
+  auto index = (tick >> (kSlotBits * level)) & (kSlotNum - 1);
+  slots_[level][index].emplace_back(task);
+}
+
+void HighResTimingWheel::Cascade(uint32_t level, uint64_t tick) {
+  auto index = (tick >> (kSlotBits * level)) & (kSlotNum - 1);
+  Slot slot;
+  slot.swap(slots_[level][index]);
+  for (auto& task_wptr : slot) {
+    if (auto task = task_wptr.lock()) {
+      Insert(task);
+    }
+  }
+}
+
+void HighResTimingWheel::Advance(uint64_t now_ns,
+                                 std::vector<Firing>* firings) {
+  uint64_t now_tick = now_ns / HIGH_RES_TIMER_RESOLUTION_NS;
+  for (; current_tick_ <= now_tick; ++current_tick_) {
+    // skip the ticks with nothing to fire or cascade, all of them when the
+    // wheel is empty
+    uint64_t next_tick = NextTick();
+    if (next_tick > now_tick) {
+      current_tick_ = now_tick + 1;
+      break;
+    }
+    current_tick_ = std::max(current_tick_, next_tick);
+
+    // tasks of higher levels move down when the wheel reaches their slot
+    for (uint32_t level = kLevelNum - 1; level > 0; --level) {
+      if ((current_tick_ & ((1ULL << (kSlotBits * level)) - 1)) == 0) {
+        Cascade(level, current_tick_);
+      }
+    }
+
+    Slot slot;
+    slot.swap(slots_[0][current_tick_ & (kSlotNum - 1)]);
+    for (auto& task_wptr : slot) {
+      auto task = task_wptr.lock();
+      if (!task) {
+        continue;
+      }
+      firings->push_back({task_wptr, task->deadline_ns});
+      if (task->interval_ns == 0) {
+        continue;
+      }
+      // keep the phase of periodic tasks, skipping the periods missed
+      uint64_t deadline = task->deadline_ns + task->interval_ns;
+      if (deadline <= now_ns) {
+        deadline +=
+            (now_ns - deadline) / task->interval_ns * task->interval_ns +
+            task->interval_ns;
+      }
+      task->deadline_ns = deadline;
+      Insert(task);
+    }
+  }
+}
+
+uint64_t HighResTimingWheel::NextTick() const {
+  uint64_t next = kNoTick;
+  for (uint64_t index = current_tick_ & (kSlotNum - 1); index < kSlotNum;
+       ++index) {
+    if (!slots_[0][index].empty()) {
+      next = (current_tick_ & ~(kSlotNum - 1)) + index;
+      break;
+    }
+  }
+  // a slot of a higher level is due when the wheel reaches its start, which
+  // may be the current tick if the slot was filled just before it
+  for (uint32_t level = 1; level < kLevelNum; ++level) {
+    uint64_t current = current_tick_ >> (kSlotBits * level);
+    bool at_start =
+        (current_tick_ & ((1ULL << (kSlotBits * level)) - 1)) == 0;
+    for (uint64_t i = at_start ? 0 : 1; i < kSlotNum; ++i) {
+      if (!slots_[level][(current + i) & (kSlotNum - 1)].empty()) {
+        next = std::min(next, (current + i) << (kSlotBits * level));
+        break;
+      }
+    }
+  }
+  return next;
+}
+
+void HighResTimingWheel::Arm(uint64_t tick) {
+  armed_tick_ = tick;
+  struct itimerspec spec = {};
+  if (tick != kNoTick) {
+    uint64_t time_ns = tick * HIGH_RES_TIMER_RESOLUTION_NS;
+    spec.it_value.tv_sec = static_cast<time_t>(time_ns / 1000000000UL);
+    spec.it_value.tv_nsec =
+        static_cast<decltype(spec.it_value.tv_nsec)>(time_ns % 1000000000UL);
+  }
+  if (timerfd_settime(timer_fd_, TFD_TIMER_ABSTIME, &spec, nullptr) != 0) {
+    AERROR << "timerfd_settime failed, errno: " << errno;
+  }
+}
+
+void HighResTimingWheel::ThreadFunc() {
+  while (running_.load()) {
+    uint64_t expirations = 0;
+    if (read(timer_fd_, &expirations, sizeof(expirations)) < 0 &&
+        errno != EINTR) {
+      AERROR << "read timerfd failed, errno: " << errno;
+      break;
+    }
+    if (!running_.load()) {
+      break;
+    }
+
+    std::vector<Firing> firings;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      Advance(Time::MonoTime().ToNanosecond(), &firings);
+      Arm(NextTick());
+    }
+    if (!firings.empty()) {
+      fired_batch_num_.fetch_add(1);
+      cyber::Async([this, firings] {
+        if (this->running_.load()) {
+          Run(firings);
+        }
+      });
+    }
+  }
+}
+
+void HighResTimingWheel::Run(const std::vector<Firing>& firings) {
+  for (const auto& firing : firings) {
+    auto task = firing.task.lock();
+    if (!task) {
+      continue;
+    }
+    auto callback = task->callback;
+    auto stats = task->stats;
+    task.reset();
+    if (stats != nullptr) {
+      uint64_t now = Time::MonoTime().ToNanosecond();
+      stats->jitter.Record(now > firing.deadline_ns ? now - firing.deadline_ns
+                                                    : 0);
+    }
+    callback();
+  }
+}
+
+}  // namespace cyber
+}  // namespace apollo
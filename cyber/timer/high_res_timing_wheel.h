@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TIMER_HIGH_RES_TIMING_WHEEL_H_
+#define CYBER_TIMER_HIGH_RES_TIMING_WHEEL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "cyber/common/macros.h"
+#include "cyber/timer/timer_task.h"
+
+namespace apollo {
+namespace cyber {
+
+static const uint64_t HIGH_RES_TIMER_RESOLUTION_NS = 100000;
+
+/**
+ * @class HighResTimingWheel
+ * @brief Hierarchical timing wheel with 100us slots for the high resolution
+ * timers.
+ *
+ * Instead of ticking at a fixed rate, the wheel thread sleeps on a timerfd
+ * armed for the next slot that holds a task, so it only wakes up when there
+ * is something to do. Periodic tasks are rescheduled from their previous
+ * deadline, not from the end of their run, so they do not drift. All tasks
+ * of a slot are handed to the scheduler in one submission.
+ *
+ * Levels have 64 slots each. A task goes to the lowest level at which its
+ * tick and the current tick only differ within the level, and moves down
+ * when the wheel reaches the start of its slot.
+ */
+class HighResTimingWheel {
+ public:
+  ~HighResTimingWheel();
+
+  void Start();
+  void Shutdown();
+
+  /**
+   * @brief Schedule the task at task->deadline_ns, in monotonic time.
+   * Periodic tasks are rescheduled by the wheel until they are released.
+   */
+  void AddTask(const std::shared_ptr<TimerTask>& task);
+
+  uint64_t FiredBatchNum() const { return fired_batch_num_.load(); }
+
+ private:
+  using Slot = std::vector<std::weak_ptr<TimerTask>>;
+
+  struct Firing {
+    std::weak_ptr<TimerTask> task;
+    uint64_t deadline_ns;
+  };
+
+  static uint64_t ToTick(uint64_t time_ns);
+
+  void ThreadFunc();
+  // the following need mutex_
+  void Insert(const std::shared_ptr<TimerTask>& task);
+  void Cascade(uint32_t level, uint64_t tick);
+  void Advance(uint64_t now_ns, std::vector<Firing>* firings);
+  uint64_t NextTick() const;
+  void Arm(uint64_t tick);
+
+  static void Run(const std::vector<Firing>& firings);
+
+  static const uint32_t kLevelNum = 4;
+  static const uint32_t kSlotBits = 6;
+  static const uint64_t kSlotNum = 1ULL << kSlotBits;
+  static const uint64_t kNoTick = UINT64_MAX;
+
+  std::mutex mutex_;
+  Slot slots_[kLevelNum][kSlotNum];
+  // next tick to process
+  uint64_t current_tick_ = 0;
+  // tick the timerfd is armed for
+  uint64_t armed_tick_ = kNoTick;
+
+  int timer_fd_ = -1;
+  std::atomic<bool> running_ = {false};
+  std::atomic<uint64_t> fired_batch_num_ = {0};
+  std::thread thread_;
+
+  DECLARE_SINGLETON(HighResTimingWheel)
+};
+
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TIMER_HIGH_RES_TIMING_WHEEL_H_
@@ -16,6 +16,9 @@
 
 #include "cyber/timer/timer.h"
 
+#include <cstdlib>
+
+#include "cyber/common/environment.h"
 #include "cyber/common/global_data.h"
 
 namespace apollo {
@@ -57,7 +60,12 @@ bool Timer::InitTimerTask() {
     return false;
   }
 
+  if (IsHighResolution()) {
+    return InitHighResTimerTask();
+  }
+
   task_.reset(new TimerTask(timer_id_));
+  task_->stats = stats_;
   task_->interval_ms = timer_opt_.period;
   task_->next_fire_duration_ms = task_->interval_ms;
   if (timer_opt_.oneshot) {
@@ -90,8 +98,10 @@ bool Timer::InitTimerTask() {
       if (task->last_execute_time_ns == 0) {
         task->last_execute_time_ns = start;
       } else {
-        task->accumulated_error_ns +=
+        int64_t error_ns =
             start - task->last_execute_time_ns - task->interval_ms * 1000000;
+        task->stats->jitter.Record(std::abs(error_ns));
+        task->accumulated_error_ns += error_ns;
       }
       ADEBUG << "start: " << start << "\t last: " << task->last_execute_time_ns
              << "\t execut time:" << execute_time_ms
@@ -124,6 +134,37 @@ bool Timer::InitTimerTask() {
   return true;
 }
 
+bool Timer::IsHighResolution() const {
+  static const bool env_high_resolution =
+      common::GetEnv("cyber_timer_high_resolution") == "1";
+  return timer_opt_.high_resolution || env_high_resolution;
+}
+
+bool Timer::InitHighResTimerTask() {
+  task_.reset(new TimerTask(timer_id_));
+  task_->stats = stats_;
+  task_->interval_ms = timer_opt_.period;
+  uint64_t interval_ns = static_cast<uint64_t>(timer_opt_.period) * 1000000;
+  task_->deadline_ns = Time::MonoTime().ToNanosecond() + interval_ns;
+  task_->interval_ns = timer_opt_.oneshot ? 0 : interval_ns;
+  std::weak_ptr<TimerTask> task_weak_ptr = task_;
+  task_->callback = [callback = this->timer_opt_.callback, task_weak_ptr]() {
+    auto task = task_weak_ptr.lock();
+    if (!task) {
+      return;
+    }
+    // the wheel keeps firing periodic tasks on schedule, skip the firings
+    // which come while the previous run is still going on
+    std::unique_lock<std::mutex> lock(task->mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      task->stats->overrun_num.fetch_add(1);
+      return;
+    }
+    callback();
+  };
+  return true;
+}
+
 void Timer::Start() {
   if (!common::GlobalData::Instance()->IsRealityMode()) {
     return;
@@ -131,7 +172,11 @@ void Timer::Start() {
 
   if (!started_.exchange(true)) {
     if (InitTimerTask()) {
-      timing_wheel_->AddTask(task_);
+      if (IsHighResolution()) {
+        HighResTimingWheel::Instance()->AddTask(task_);
+      } else {
+        timing_wheel_->AddTask(task_);
+      }
       AINFO << "start timer [" << task_->timer_id_ << "]";
     }
   }
@@ -20,6 +20,7 @@
 #include <atomic>
 #include <memory>
 
+#include "cyber/timer/high_res_timing_wheel.h"
 #include "cyber/timer/timing_wheel.h"
 
 namespace apollo {
@@ -61,6 +62,13 @@ struct TimerOption {
    * False: perform the callback every timed period
    */
   bool oneshot;
+
+  /**
+   * True: run on the high resolution wheel, which fires within 100us of the
+   * due time and keeps the phase of periodic timers. Also turned on for all
+   * timers by the environment variable cyber_timer_high_resolution=1.
+   */
+  bool high_resolution = false;
 };
 
 /**
@@ -109,12 +117,21 @@ class Timer {
    */
   void Stop();
 
+  /**
+   * @brief Jitter and overrun statistics of the timer, kept across Start and
+   * Stop.
+   */
+  const TimerStats& stats() const { return *stats_; }
+
  private:
   bool InitTimerTask();
+  bool InitHighResTimerTask();
+  bool IsHighResolution() const;
   uint64_t timer_id_;
   TimerOption timer_opt_;
   TimingWheel* timing_wheel_ = nullptr;
   std::shared_ptr<TimerTask> task_;
+  std::shared_ptr<TimerStats> stats_ = std::make_shared<TimerStats>();
   std::atomic<bool> started_ = {false};
 };
 
@@ -17,14 +17,25 @@
 #ifndef CYBER_TIMER_TIMER_TASK_H_
 #define CYBER_TIMER_TIMER_TASK_H_
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <mutex>
 
+#include "cyber/base/histogram.h"
+
 namespace apollo {
 namespace cyber {
 
 class TimerBucket;
 
+struct TimerStats {
+  // delay from the time the callback was due to the time it started
+  base::Histogram jitter;
+  // periodic firings skipped because the previous run had not finished
+  std::atomic<uint64_t> overrun_num = {0};
+};
+
 struct TimerTask {
   explicit TimerTask(uint64_t timer_id) : timer_id_(timer_id) {}
   uint64_t timer_id_ = 0;
@@ -35,6 +46,12 @@ struct TimerTask {
   int64_t accumulated_error_ns = 0;
   uint64_t last_execute_time_ns = 0;
   std::mutex mutex;
+
+  // high resolution mode: next fire time in monotonic ns, and the period,
+  // 0 for oneshot tasks
+  uint64_t deadline_ns = 0;
+  uint64_t interval_ns = 0;
+  std::shared_ptr<TimerStats> stats;
 };
 
 }  // namespace cyber
@@ -16,8 +16,10 @@
 
 /* note that the frame code of the following is Generated by script  */
 
+#include <atomic>
 #include <memory>
 #include <utility>
+#include <vector>
 #include "gtest/gtest.h"
 
 #include "cyber/common/util.h"
@@ -74,6 +76,59 @@ TEST(TimerTest, start_stop) {
   }
 }
 
+TEST(TimerTest, high_resolution_one_shot) {
+  std::atomic<int> count = {0};
+  TimerOption opt(50, [&count] { ++count; }, true);
+  opt.high_resolution = true;
+  Timer timer(opt);
+  timer.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(40));
+  EXPECT_EQ(0, count.load());
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(1, count.load());
+  EXPECT_EQ(1, timer.stats().jitter.count());
+  timer.Stop();
+}
+
+TEST(TimerTest, high_resolution_cycle) {
+  std::atomic<int> count = {0};
+  TimerOption opt(10, [&count] { ++count; }, false);
+  opt.high_resolution = true;
+  Timer timer(opt);
+  timer.Start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(1005));
+  timer.Stop();
+  // firings are scheduled from the start time, so they do not drift
+  EXPECT_GE(count.load(), 95);
+  EXPECT_LE(count.load(), 100);
+  EXPECT_EQ(count.load() + timer.stats().overrun_num.load(),
+            timer.stats().jitter.count());
+
+  int stopped_count = count.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(stopped_count, count.load());
+}
+
+TEST(TimerTest, high_resolution_many) {
+  const int kTimerNum = 200;
+  std::atomic<int> count = {0};
+  std::vector<std::unique_ptr<Timer>> timers;
+  for (int i = 0; i < kTimerNum; ++i) {
+    // periods up to several seconds land on the higher wheel levels
+    TimerOption opt(static_cast<uint32_t>(i * 25 + 1), [&count] { ++count; },
+                    true);
+    opt.high_resolution = true;
+    timers.emplace_back(new Timer(opt));
+    timers.back()->Start();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(5500));
+  EXPECT_EQ(kTimerNum, count.load());
+  for (auto& timer : timers) {
+    EXPECT_EQ(1, timer->stats().jitter.count());
+    timer->Stop();
+  }
+}
+
 TEST(TimerTest, sim_mode) {
   auto count = 0;
 
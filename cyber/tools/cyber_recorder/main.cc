@@ -33,16 +33,18 @@
 using apollo::cyber::common::GetFileName;
 using apollo::cyber::common::StringToUnixSeconds;
 using apollo::cyber::common::UnixSecondsToString;
+using apollo::cyber::record::ChunkCompression;
 using apollo::cyber::record::HeaderBuilder;
 using apollo::cyber::record::Info;
 using apollo::cyber::record::Player;
 using apollo::cyber::record::PlayParam;
+using apollo::cyber::record::ParseChunkCompression;
 using apollo::cyber::record::Recorder;
 using apollo::cyber::record::Recoverer;
 using apollo::cyber::record::Spliter;
 
 const char INFO_OPTIONS[] = "h";
-const char RECORD_OPTIONS[] = "o:ac:i:m:h";
+const char RECORD_OPTIONS[] = "o:ac:i:m:z:h";
 const char PLAY_OPTIONS[] = "f:ac:k:lr:b:e:s:d:p:h";
 const char SPLIT_OPTIONS[] = "f:o:c:k:b:e:h";
 const char RECOVER_OPTIONS[] = "f:o:h";
@@ -114,8 +116,9 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-l, --loop\t\t\t\tloop " << command << std::endl;
         break;
       case 'r':
-        std::cout << "\t-r, --rate <1.0>\t\t\tmultiply the " << command
-                  << " rate by FACTOR" << std::endl;
+        std::cout << "\t-r, --rate <1.0|max>\t\t\tmultiply the " << command
+                  << " rate by FACTOR, or play as fast as possible"
+                  << std::endl;
         break;
       case 'b':
         std::cout << "\t-b, --begin <2018-07-01 00:00:00>\t" << command
@@ -145,6 +148,10 @@ void DisplayUsage(const std::string& binary, const std::string& command,
         std::cout << "\t-m, --segment-size <MB>\t\t\t" << command
                   << " segmented every n megabyte(s)" << std::endl;
         break;
+      case 'z':
+        std::cout << "\t-z, --compress <lz4|zstd>\t\t" << command
+                  << " with compressed chunks" << std::endl;
+        break;
       case 'h':
         std::cout << "\t-h, --help\t\t\t\tshow help message" << std::endl;
         break;
@@ -170,7 +177,7 @@ int main(int argc, char** argv) {
   }
 
   int long_index = 0;
-  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:h";
+  const std::string short_opts = "f:c:k:o:alr:b:e:s:d:p:i:m:z:h";
   static const struct option long_opts[] = {
       {"files", required_argument, nullptr, 'f'},
       {"white-channel", required_argument, nullptr, 'c'},
@@ -186,6 +193,7 @@ int main(int argc, char** argv) {
       {"preload", required_argument, nullptr, 'p'},
       {"segment-interval", required_argument, nullptr, 'i'},
       {"segment-size", required_argument, nullptr, 'm'},
+      {"compress", required_argument, nullptr, 'z'},
       {"help", no_argument, nullptr, 'h'}};
 
   std::vector<std::string> opt_file_vec;
@@ -195,12 +203,14 @@ int main(int argc, char** argv) {
   bool opt_all = false;
   bool opt_loop = false;
   float opt_rate = 1.0f;
+  bool opt_max_rate = false;
   uint64_t opt_begin = 0;
   uint64_t opt_end = UINT64_MAX;
   uint64_t opt_start = 0;
   uint64_t opt_delay = 0;
   uint32_t opt_preload = 3;
   auto opt_header = HeaderBuilder::GetHeader();
+  ChunkCompression opt_compression = ChunkCompression::NONE;
 
   do {
     int opt =
@@ -249,6 +259,10 @@ int main(int argc, char** argv) {
         opt_loop = true;
         break;
       case 'r':
+        if (std::string(optarg) == "max") {
+          opt_max_rate = true;
+          break;
+        }
         try {
           opt_rate = std::stof(optarg);
         } catch (const std::invalid_argument& ia) {
@@ -346,6 +360,13 @@ int main(int argc, char** argv) {
           return -1;
         }
         break;
+      case 'z':
+        if (!ParseChunkCompression(optarg, &opt_compression)) {
+          std::cout << "Invalid argument: -z/--compress "
+                    << std::string(optarg) << std::endl;
+          return -1;
+        }
+        break;
       case 'h':
         DisplayUsage(binary, command);
         return 0;
@@ -393,6 +414,7 @@ int main(int argc, char** argv) {
     play_param.is_play_all_channels = opt_all || opt_white_channels.empty();
     play_param.is_loop_playback = opt_loop;
     play_param.play_rate = opt_rate;
+    play_param.is_max_rate = opt_max_rate;
     play_param.begin_time_ns = opt_begin;
     play_param.end_time_ns = opt_end;
     play_param.start_time_s = opt_start;
@@ -425,6 +447,7 @@ int main(int argc, char** argv) {
     ::apollo::cyber::Init(argv[0]);
     auto recorder = std::make_shared<Recorder>(opt_output_vec[0], opt_all,
                                                opt_white_channels, opt_header);
+    recorder->SetCompression(opt_compression);
     bool record_result = recorder->Start();
     if (record_result) {
       while (!::apollo::cyber::IsShutdown()) {
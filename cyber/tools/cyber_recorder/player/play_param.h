@@ -29,6 +29,8 @@ struct PlayParam {
   bool is_play_all_channels = false;
   bool is_loop_playback = false;
   double play_rate = 1.0;
+  // publish as fast as possible, ignoring play_rate
+  bool is_max_rate = false;
   uint64_t begin_time_ns = 0;
   uint64_t end_time_ns = UINT64_MAX;
   uint64_t start_time_s = 0;
@@ -23,6 +23,7 @@ namespace cyber {
 namespace record {
 
 std::atomic<uint64_t> PlayTask::played_msg_num_ = {0};
+std::atomic<uint64_t> PlayTask::played_bytes_ = {0};
 
 PlayTask::PlayTask(const MessagePtr& msg, const WriterPtr& writer,
                    uint64_t msg_real_time_ns, uint64_t msg_play_time_ns)
@@ -45,6 +46,7 @@ void PlayTask::Play() {
   }
 
   played_msg_num_.fetch_add(1);
+  played_bytes_.fetch_add(msg_->message.size());
 
   ADEBUG << "write message succ, played num: " << played_msg_num_.load()
          << ", real time: " << msg_real_time_ns_
@@ -41,7 +41,9 @@ class PlayTask {
 
   uint64_t msg_real_time_ns() const { return msg_real_time_ns_; }
   uint64_t msg_play_time_ns() const { return msg_play_time_ns_; }
+  size_t msg_size() const { return msg_->message.size(); }
   static uint64_t played_msg_num() { return played_msg_num_.load(); }
+  static uint64_t played_bytes() { return played_bytes_.load(); }
 
  private:
   MessagePtr msg_;
@@ -50,6 +52,7 @@ class PlayTask {
   uint64_t msg_play_time_ns_;
 
   static std::atomic<uint64_t> played_msg_num_;
+  static std::atomic<uint64_t> played_bytes_;
 };
 
 }  // namespace record
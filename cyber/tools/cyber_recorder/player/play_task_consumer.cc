@@ -25,11 +25,13 @@ namespace record {
 
 const uint64_t PlayTaskConsumer::kPauseSleepNanoSec = 100000000UL;
 const uint64_t PlayTaskConsumer::kWaitProduceSleepNanoSec = 5000000UL;
+const uint64_t PlayTaskConsumer::kMaxRateWaitProduceSleepNanoSec = 50000UL;
 const uint64_t PlayTaskConsumer::MIN_SLEEP_DURATION_NS = 200000000UL;
 
 PlayTaskConsumer::PlayTaskConsumer(const TaskBufferPtr& task_buffer,
-                                   double play_rate)
+                                   double play_rate, bool is_max_rate)
     : play_rate_(play_rate),
+      is_max_rate_(is_max_rate),
       consume_th_(nullptr),
       task_buffer_(task_buffer),
       is_stopped_(true),
@@ -72,14 +74,20 @@ void PlayTaskConsumer::ThreadFunc() {
   while (!is_stopped_.load()) {
     auto task = task_buffer_->Front();
     if (task == nullptr) {
-      std::this_thread::sleep_for(
-          std::chrono::nanoseconds(kWaitProduceSleepNanoSec));
+      std::this_thread::sleep_for(std::chrono::nanoseconds(
+          is_max_rate_ ? kMaxRateWaitProduceSleepNanoSec
+                       : kWaitProduceSleepNanoSec));
       continue;
     }
 
     uint64_t sleep_ns = 0;
 
-    if (base_msg_play_time_ns_ == 0) {
+    if (is_max_rate_) {
+      if (base_msg_play_time_ns_ == 0) {
+        base_msg_play_time_ns_ = task->msg_play_time_ns();
+        base_msg_real_time_ns_ = task->msg_real_time_ns();
+      }
+    } else if (base_msg_play_time_ns_ == 0) {
       base_msg_play_time_ns_ = task->msg_play_time_ns();
       base_msg_real_time_ns_ = task->msg_real_time_ns();
       if (base_msg_play_time_ns_ > begin_time_ns_) {
@@ -103,15 +111,18 @@ void PlayTaskConsumer::ThreadFunc() {
              << "base_real_time_ns: " << base_real_time_ns;
     }
 
-    uint64_t task_interval_ns = static_cast<uint64_t>(
-        static_cast<double>(task->msg_play_time_ns() - base_msg_play_time_ns_) /
-        play_rate_);
-    uint64_t real_time_interval_ns = Time::Now().ToNanosecond() -
-                                     base_real_time_ns -
-                                     accumulated_pause_time_ns;
-    if (task_interval_ns > real_time_interval_ns) {
-      sleep_ns = task_interval_ns - real_time_interval_ns;
-      std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_ns));
+    if (!is_max_rate_) {
+      uint64_t task_interval_ns = static_cast<uint64_t>(
+          static_cast<double>(task->msg_play_time_ns() -
+                              base_msg_play_time_ns_) /
+          play_rate_);
+      uint64_t real_time_interval_ns = Time::Now().ToNanosecond() -
+                                       base_real_time_ns -
+                                       accumulated_pause_time_ns;
+      if (task_interval_ns > real_time_interval_ns) {
+        sleep_ns = task_interval_ns - real_time_interval_ns;
+        std::this_thread::sleep_for(std::chrono::nanoseconds(sleep_ns));
+      }
     }
 
     task->Play();
@@ -34,7 +34,7 @@ class PlayTaskConsumer {
   using TaskBufferPtr = std::shared_ptr<PlayTaskBuffer>;
 
   explicit PlayTaskConsumer(const TaskBufferPtr& task_buffer,
-                            double play_rate = 1.0);
+                            double play_rate = 1.0, bool is_max_rate = false);
   virtual ~PlayTaskConsumer();
 
   void Start(uint64_t begin_time_ns);
@@ -53,6 +53,7 @@ class PlayTaskConsumer {
   void ThreadFunc();
 
   double play_rate_;
+  bool is_max_rate_;
   ThreadPtr consume_th_;
   TaskBufferPtr task_buffer_;
   std::atomic<bool> is_stopped_;
@@ -64,6 +65,7 @@ class PlayTaskConsumer {
   uint64_t last_played_msg_real_time_ns_;
   static const uint64_t kPauseSleepNanoSec;
   static const uint64_t kWaitProduceSleepNanoSec;
+  static const uint64_t kMaxRateWaitProduceSleepNanoSec;
   static const uint64_t MIN_SLEEP_DURATION_NS;
 };
 
@@ -0,0 +1,175 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/tools/cyber_recorder/player/play_task_merger.h"
+
+#include <algorithm>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+PlayTaskMerger::PlayTaskMerger(const std::vector<Segment>& segments,
+                               const std::set<std::string>& channels,
+                               const WriterMap& writers, uint64_t plus_time_ns,
+                               uint64_t lookahead_ns, size_t max_streams)
+    : segments_(segments),
+      channels_(channels),
+      writers_(writers),
+      plus_time_ns_(plus_time_ns),
+      lookahead_ns_(lookahead_ns),
+      max_streams_(max_streams),
+      streams_(segments.size()) {
+  for (size_t i = 0; i < segments_.size(); ++i) {
+    order_.push_back(i);
+  }
+  std::stable_sort(order_.begin(), order_.end(),
+                   [this](size_t lhs, size_t rhs) {
+                     return segments_[lhs].begin_time_ns <
+                            segments_[rhs].begin_time_ns;
+                   });
+}
+
+PlayTaskMerger::~PlayTaskMerger() { Stop(); }
+
+std::vector<PlayTaskMerger::Segment> PlayTaskMerger::SplitFile(
+    const std::string& file, const RecordReader& reader,
+    uint64_t begin_time_ns, uint64_t end_time_ns) {
+  const auto& header = reader.GetHeader();
+  uint64_t begin_time = std::max(begin_time_ns, header.begin_time());
+  const uint64_t end_time = std::min(end_time_ns, header.end_time());
+  std::vector<Segment> segments;
+  // the chunks up to a boundary hold all the messages until it, so a reader
+  // seeking past it skips them
+  for (uint64_t boundary : reader.GetChunkMaxEndTimes()) {
+    if (boundary >= end_time) {
+      break;
+    }
+    if (boundary < begin_time) {
+      continue;
+    }
+    segments.push_back({file, begin_time, boundary});
+    begin_time = boundary + 1;
+  }
+  if (begin_time <= end_time) {
+    segments.push_back({file, begin_time, end_time});
+  }
+  return segments;
+}
+
+bool PlayTaskMerger::Next(TaskPtr* task) {
+  while (!is_stopped_) {
+    StartStreams();
+    JoinPending();
+    if (heads_.empty()) {
+      // nothing is pending either once joined
+      if (next_ >= order_.size()) {
+        return false;
+      }
+      continue;
+    }
+    // the first task of a stream may be well after its begin time, so the
+    // segments before the head are started and joined first
+    if (next_ < order_.size() &&
+        segments_[order_[next_]].begin_time_ns <= heads_.top().time) {
+      continue;
+    }
+
+    StreamHead head = heads_.top();
+    heads_.pop();
+    *task = head.task;
+
+    auto& stream = streams_[head.index];
+    stream->PopFront();
+    TaskPtr next_task;
+    if (stream->Front(&next_task)) {
+      heads_.push({next_task->msg_real_time_ns(), head.index, next_task});
+    } else {
+      FinishStream(head.index);
+    }
+    return true;
+  }
+  return false;
+}
+
+void PlayTaskMerger::Stop() {
+  is_stopped_ = true;
+  for (auto& stream : streams_) {
+    if (stream != nullptr) {
+      stream->Stop();
+    }
+  }
+}
+
+void PlayTaskMerger::StartStreams() {
+  uint64_t frontier = 0;
+  if (!heads_.empty()) {
+    frontier = heads_.top().time;
+  } else if (!pending_.empty()) {
+    frontier = segments_[pending_.front()].begin_time_ns;
+  }
+  while (next_ < order_.size()) {
+    const size_t index = order_[next_];
+    if (num_streams_ > 0 && num_streams_ >= max_streams_ &&
+        segments_[index].begin_time_ns > frontier + lookahead_ns_) {
+      break;
+    }
+    ++next_;
+    // every segment has its own reader, a reader is not shared by threads
+    auto reader = std::make_shared<RecordReader>(segments_[index].file);
+    if (!reader->IsValid()) {
+      AERROR << "open record file failed, file: " << segments_[index].file;
+      continue;
+    }
+    streams_[index].reset(new PlayTaskStream(
+        reader, segments_[index].begin_time_ns, segments_[index].end_time_ns,
+        channels_, writers_, plus_time_ns_));
+    streams_[index]->Start();
+    ++num_streams_;
+    pending_.push_back(index);
+  }
+}
+
+void PlayTaskMerger::JoinPending() {
+  // streams which may hold the next task must join the merge first, the
+  // others are not waited for
+  auto it = pending_.begin();
+  while (it != pending_.end()) {
+    if (!heads_.empty() &&
+        segments_[*it].begin_time_ns > heads_.top().time) {
+      break;
+    }
+    TaskPtr task;
+    if (streams_[*it]->Front(&task)) {
+      heads_.push({task->msg_real_time_ns(), *it, task});
+    } else {
+      FinishStream(*it);
+    }
+    it = pending_.erase(it);
+  }
+}
+
+void PlayTaskMerger::FinishStream(size_t index) {
+  streams_[index]->Stop();
+  streams_[index] = nullptr;
+  --num_streams_;
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,130 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TOOLS_CYBER_RECORDER_PLAYER_PLAY_TASK_MERGER_H_
+#define CYBER_TOOLS_CYBER_RECORDER_PLAYER_PLAY_TASK_MERGER_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "cyber/record/record_reader.h"
+#include "cyber/tools/cyber_recorder/player/play_task_stream.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+/**
+ * @class PlayTaskMerger
+ * @brief Merges the play tasks of record segments by timestamp. Every
+ * segment is a time range of a file decoded by its own PlayTaskStream, so
+ * the files, and the chunk ranges a file is split into, are decoded in
+ * parallel while the merge keeps the global timestamp order.
+ */
+class PlayTaskMerger {
+ public:
+  using TaskPtr = std::shared_ptr<PlayTask>;
+  using WriterMap = PlayTaskStream::WriterMap;
+
+  // messages of file within [begin_time_ns, end_time_ns]
+  struct Segment {
+    std::string file;
+    uint64_t begin_time_ns;
+    uint64_t end_time_ns;
+  };
+
+  /**
+   * @param segments in file order, segments of the same file must not
+   * overlap
+   * @param writers must outlive the merger, channels without a writer are
+   * not played
+   * @param plus_time_ns added to the play time of every task, for loops
+   * @param lookahead_ns a segment beginning within this time ahead of the
+   * merge is started, so that its first tasks are decoded in time
+   * @param max_streams segments are started ahead of the lookahead as long
+   * as fewer streams are decoding
+   */
+  PlayTaskMerger(const std::vector<Segment>& segments,
+                 const std::set<std::string>& channels,
+                 const WriterMap& writers, uint64_t plus_time_ns,
+                 uint64_t lookahead_ns, size_t max_streams);
+  virtual ~PlayTaskMerger();
+
+  /**
+   * @brief Split the messages of a file within [begin_time_ns, end_time_ns]
+   * into segments at its chunk boundaries, a single segment if the file has
+   * no chunk index.
+   */
+  static std::vector<Segment> SplitFile(const std::string& file,
+                                        const RecordReader& reader,
+                                        uint64_t begin_time_ns,
+                                        uint64_t end_time_ns);
+
+  /**
+   * @brief Take the next task in timestamp order, ties in segment order.
+   *
+   * @return false once all segments are exhausted or the merger is stopped
+   */
+  bool Next(TaskPtr* task);
+
+  void Stop();
+
+ private:
+  // next task of a stream in the merge
+  struct StreamHead {
+    uint64_t time;
+    size_t index;
+    TaskPtr task;
+
+    bool operator>(const StreamHead& other) const {
+      return time > other.time || (time == other.time && index > other.index);
+    }
+  };
+
+  void StartStreams();
+  void JoinPending();
+  void FinishStream(size_t index);
+
+  std::vector<Segment> segments_;
+  // segment indices sorted by begin time
+  std::vector<size_t> order_;
+  std::set<std::string> channels_;
+  const WriterMap& writers_;
+  uint64_t plus_time_ns_;
+  uint64_t lookahead_ns_;
+  size_t max_streams_;
+
+  std::vector<std::unique_ptr<PlayTaskStream>> streams_;
+  size_t num_streams_ = 0;
+  std::priority_queue<StreamHead, std::vector<StreamHead>,
+                      std::greater<StreamHead>>
+      heads_;
+  // started streams which do not take part in the merge yet
+  std::vector<size_t> pending_;
+  size_t next_ = 0;
+  bool is_stopped_ = false;
+};
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TOOLS_CYBER_RECORDER_PLAYER_PLAY_TASK_MERGER_H_
@@ -0,0 +1,176 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/tools/cyber_recorder/player/play_task_merger.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "cyber/record/header_builder.h"
+#include "cyber/record/record_writer.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+using apollo::cyber::message::RawMessage;
+
+constexpr char kChannelName1[] = "/test/channel1";
+constexpr char kChannelName2[] = "/test/channel2";
+constexpr char kMessageType[] = "apollo.cyber.proto.Test";
+constexpr char kProtoDesc[] = "1234567890";
+constexpr char kTestFile1[] = "play_task_merger_test_1.record";
+constexpr char kTestFile2[] = "play_task_merger_test_2.record";
+constexpr uint64_t kStep = 1000000;  // 1ms
+constexpr uint64_t kLookahead = 3000000000UL;
+
+// Writes a message of channel and of size bytes every step from first to
+// last, in chunks of about ten messages.
+void WriteFile(const std::string& file, const std::string& channel,
+               uint64_t first, uint64_t last, uint64_t step,
+               size_t size = 10) {
+  RecordWriter writer(HeaderBuilder::GetHeaderWithChunkParams(10 * step, 0));
+  writer.SetSizeOfFileSegmentation(0);
+  writer.SetIntervalOfFileSegmentation(0);
+  ASSERT_TRUE(writer.Open(file));
+  writer.WriteChannel(channel, kMessageType, kProtoDesc);
+  int i = 0;
+  for (uint64_t time = first; time <= last; time += step, ++i) {
+    auto msg = std::make_shared<RawMessage>(std::string(size, 'x'));
+    writer.WriteMessage(channel, msg, time);
+    if (i % 10 == 0) {
+      // leave the flush thread some time so that chunks are not merged
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  writer.Close();
+}
+
+std::vector<PlayTaskMerger::Segment> Split(const std::string& file,
+                                           uint64_t begin_time,
+                                           uint64_t end_time) {
+  RecordReader reader(file);
+  EXPECT_TRUE(reader.IsValid());
+  return PlayTaskMerger::SplitFile(file, reader, begin_time, end_time);
+}
+
+class PlayTaskMergerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    // tasks are not played, the writers are only looked up
+    writers_[kChannelName1] = nullptr;
+    writers_[kChannelName2] = nullptr;
+  }
+
+  void TearDown() override {
+    std::remove(kTestFile1);
+    std::remove(kTestFile2);
+  }
+
+  std::vector<std::shared_ptr<PlayTask>> MergeAll(
+      const std::vector<PlayTaskMerger::Segment>& segments,
+      size_t max_streams) {
+    PlayTaskMerger merger(segments, {}, writers_, 0, kLookahead,
+                          max_streams);
+    std::vector<std::shared_ptr<PlayTask>> tasks;
+    std::shared_ptr<PlayTask> task;
+    while (merger.Next(&task)) {
+      tasks.push_back(task);
+    }
+    // the end of the stream is final
+    EXPECT_FALSE(merger.Next(&task));
+    EXPECT_FALSE(merger.Next(&task));
+    return tasks;
+  }
+
+  PlayTaskMerger::WriterMap writers_;
+};
+
+TEST_F(PlayTaskMergerTest, SplitFile) {
+  WriteFile(kTestFile1, kChannelName1, 0, 199 * kStep, kStep);
+  const auto segments = Split(kTestFile1, 0, UINT64_MAX);
+  ASSERT_GT(segments.size(), 1);
+  EXPECT_EQ(0, segments.front().begin_time_ns);
+  EXPECT_EQ(199 * kStep, segments.back().end_time_ns);
+  for (size_t i = 0; i < segments.size(); ++i) {
+    EXPECT_EQ(kTestFile1, segments[i].file);
+    EXPECT_LE(segments[i].begin_time_ns, segments[i].end_time_ns);
+    if (i > 0) {
+      EXPECT_EQ(segments[i - 1].end_time_ns + 1, segments[i].begin_time_ns);
+    }
+  }
+
+  // clipped to the play range
+  const auto clipped = Split(kTestFile1, 50 * kStep, 60 * kStep);
+  ASSERT_FALSE(clipped.empty());
+  EXPECT_EQ(50 * kStep, clipped.front().begin_time_ns);
+  EXPECT_EQ(60 * kStep, clipped.back().end_time_ns);
+  EXPECT_TRUE(Split(kTestFile1, 300 * kStep, UINT64_MAX).empty());
+}
+
+TEST_F(PlayTaskMergerTest, SplitFileInOrder) {
+  WriteFile(kTestFile1, kChannelName1, 0, 199 * kStep, kStep);
+  const auto segments = Split(kTestFile1, 0, UINT64_MAX);
+  for (size_t max_streams : {1, 4}) {
+    const auto tasks = MergeAll(segments, max_streams);
+    // every message once, in order
+    ASSERT_EQ(200, tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      EXPECT_EQ(i * kStep, tasks[i]->msg_real_time_ns());
+    }
+  }
+}
+
+TEST_F(PlayTaskMergerTest, MergeOrder) {
+  // interleaved files told apart by their message size, with the same
+  // timestamp every 6ms
+  WriteFile(kTestFile1, kChannelName1, 0, 299 * 2 * kStep, 2 * kStep, 10);
+  WriteFile(kTestFile2, kChannelName2, kStep, kStep + 199 * 3 * kStep,
+            3 * kStep, 20);
+  auto segments = Split(kTestFile1, 0, UINT64_MAX);
+  const auto segments2 = Split(kTestFile2, 0, UINT64_MAX);
+  segments.insert(segments.end(), segments2.begin(), segments2.end());
+
+  const auto tasks = MergeAll(segments, 2);
+  ASSERT_EQ(500, tasks.size());
+  size_t num_ties = 0;
+  for (size_t i = 1; i < tasks.size(); ++i) {
+    const uint64_t prev_time = tasks[i - 1]->msg_real_time_ns();
+    const uint64_t time = tasks[i]->msg_real_time_ns();
+    ASSERT_LE(prev_time, time);
+    if (prev_time == time) {
+      // ties are in segment order, the first file first
+      EXPECT_EQ(10, tasks[i - 1]->msg_size());
+      EXPECT_EQ(20, tasks[i]->msg_size());
+      ++num_ties;
+    }
+  }
+  EXPECT_EQ(100, num_ties);
+}
+
+TEST_F(PlayTaskMergerTest, Empty) {
+  const auto tasks = MergeAll({}, 4);
+  EXPECT_TRUE(tasks.empty());
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
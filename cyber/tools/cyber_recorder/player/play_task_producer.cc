@@ -16,13 +16,14 @@
 
 #include "cyber/tools/cyber_recorder/player/play_task_producer.h"
 
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 #include "cyber/common/log.h"
 #include "cyber/common/time_conversion.h"
 #include "cyber/cyber.h"
 #include "cyber/message/protobuf_factory.h"
-#include "cyber/record/record_viewer.h"
 
 namespace apollo {
 namespace cyber {
@@ -31,6 +32,8 @@ namespace record {
 const uint32_t PlayTaskProducer::kMinTaskBufferSize = 500;
 const uint32_t PlayTaskProducer::kPreloadTimeSec = 3;
 const uint64_t PlayTaskProducer::kSleepIntervalNanoSec = 1000000;
+const uint64_t PlayTaskProducer::kMaxRateSleepNanoSec = 50000;
+const size_t PlayTaskProducer::kMaxDecodeStreams = 4;
 
 PlayTaskProducer::PlayTaskProducer(const TaskBufferPtr& task_buffer,
                                    const PlayParam& play_param)
@@ -104,6 +107,7 @@ bool PlayTaskProducer::ReadRecordInfo() {
     }
 
     record_readers_.emplace_back(record_reader);
+    record_files_.emplace_back(file);
 
     auto channel_list = record_reader->GetChannelList();
     // loop each channel info
@@ -236,37 +240,15 @@ void PlayTaskProducer::ThreadFunc() {
     preload_size = kMinTaskBufferSize;
   }
 
-  auto record_viewer = std::make_shared<RecordViewer>(
-      record_readers_, play_param_.begin_time_ns, play_param_.end_time_ns,
-      play_param_.channels_to_play);
+  // in max rate mode the consumer drains the buffer as fast as it can
+  uint64_t wait_time_ns = play_param_.is_max_rate
+                              ? kMaxRateSleepNanoSec
+                              : avg_interval_time_ns;
 
   uint32_t loop_num = 0;
   while (!is_stopped_.load()) {
     uint64_t plus_time_ns = loop_num * loop_time_ns;
-    auto itr = record_viewer->begin();
-    auto itr_end = record_viewer->end();
-
-    while (itr != itr_end && !is_stopped_.load()) {
-      while (!is_stopped_.load() && task_buffer_->Size() > preload_size) {
-        std::this_thread::sleep_for(
-            std::chrono::nanoseconds(avg_interval_time_ns));
-      }
-      for (; itr != itr_end && !is_stopped_.load(); ++itr) {
-        if (task_buffer_->Size() > preload_size) {
-          break;
-        }
-
-        auto search = writers_.find(itr->channel_name);
-        if (search == writers_.end()) {
-          continue;
-        }
-
-        auto raw_msg = std::make_shared<message::RawMessage>(itr->content);
-        auto task = std::make_shared<PlayTask>(
-            raw_msg, search->second, itr->time, itr->time + plus_time_ns);
-        task_buffer_->Push(task);
-      }
-    }
+    PlayOnce(plus_time_ns, preload_size, wait_time_ns);
 
     if (!play_param_.is_loop_playback) {
       is_stopped_.store(true);
@@ -276,6 +258,34 @@ void PlayTaskProducer::ThreadFunc() {
   }
 }
 
+void PlayTaskProducer::PlayOnce(uint64_t plus_time_ns, uint32_t preload_size,
+                                uint64_t wait_time_ns) {
+  // every file is split at its chunk boundaries, the ranges are decoded in
+  // parallel and merged by timestamp
+  std::vector<PlayTaskMerger::Segment> segments;
+  for (size_t i = 0; i < record_readers_.size(); ++i) {
+    auto file_segments = PlayTaskMerger::SplitFile(
+        record_files_[i], *record_readers_[i], play_param_.begin_time_ns,
+        play_param_.end_time_ns);
+    segments.insert(segments.end(), file_segments.begin(),
+                    file_segments.end());
+  }
+  const uint64_t lookahead_ns =
+      static_cast<uint64_t>(play_param_.preload_time_s) * 1000000000UL;
+  const size_t max_streams = std::min<size_t>(
+      std::max(std::thread::hardware_concurrency(), 1U), kMaxDecodeStreams);
+  PlayTaskMerger merger(segments, play_param_.channels_to_play, writers_,
+                        plus_time_ns, lookahead_ns, max_streams);
+
+  std::shared_ptr<PlayTask> task;
+  while (!is_stopped_.load() && merger.Next(&task)) {
+    while (!is_stopped_.load() && task_buffer_->Size() > preload_size) {
+      std::this_thread::sleep_for(std::chrono::nanoseconds(wait_time_ns));
+    }
+    task_buffer_->Push(task);
+  }
+}
+
 }  // namespace record
 }  // namespace cyber
 }  // namespace apollo
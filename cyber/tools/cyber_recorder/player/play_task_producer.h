@@ -33,6 +33,7 @@
 #include "cyber/record/record_reader.h"
 #include "cyber/tools/cyber_recorder/player/play_param.h"
 #include "cyber/tools/cyber_recorder/player/play_task_buffer.h"
+#include "cyber/tools/cyber_recorder/player/play_task_merger.h"
 
 namespace apollo {
 namespace cyber {
@@ -64,6 +65,8 @@ class PlayTaskProducer {
   bool UpdatePlayParam();
   bool CreateWriters();
   void ThreadFunc();
+  void PlayOnce(uint64_t plus_time_ns, uint32_t preload_size,
+                uint64_t wait_time_ns);
 
   PlayParam play_param_;
   TaskBufferPtr task_buffer_;
@@ -76,6 +79,7 @@ class PlayTaskProducer {
   WriterMap writers_;
   MessageTypeMap msg_types_;
   std::vector<RecordReaderPtr> record_readers_;
+  std::vector<std::string> record_files_;
 
   uint64_t earliest_begin_time_;
   uint64_t latest_end_time_;
@@ -84,6 +88,9 @@ class PlayTaskProducer {
   static const uint32_t kMinTaskBufferSize;
   static const uint32_t kPreloadTimeSec;
   static const uint64_t kSleepIntervalNanoSec;
+  static const uint64_t kMaxRateSleepNanoSec;
+  // decoding threads started ahead of the preload time
+  static const size_t kMaxDecodeStreams;
 };
 
 }  // namespace record
@@ -0,0 +1,115 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/tools/cyber_recorder/player/play_task_stream.h"
+
+#include "cyber/common/log.h"
+#include "cyber/record/record_viewer.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+const size_t PlayTaskStream::kCapacity = 256;
+const size_t PlayTaskStream::kCapacityBytes = 64UL * 1024 * 1024;
+
+PlayTaskStream::PlayTaskStream(const RecordReaderPtr& reader,
+                               uint64_t begin_time_ns, uint64_t end_time_ns,
+                               const std::set<std::string>& channels,
+                               const WriterMap& writers, uint64_t plus_time_ns)
+    : reader_(reader),
+      begin_time_ns_(begin_time_ns),
+      end_time_ns_(end_time_ns),
+      channels_(channels),
+      writers_(writers),
+      plus_time_ns_(plus_time_ns) {}
+
+PlayTaskStream::~PlayTaskStream() { Stop(); }
+
+void PlayTaskStream::Start() {
+  if (!is_stopped_.exchange(false)) {
+    return;
+  }
+  decode_th_.reset(new std::thread(&PlayTaskStream::ThreadFunc, this));
+}
+
+void PlayTaskStream::Stop() {
+  if (is_stopped_.exchange(true)) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_all();
+  }
+  if (decode_th_ != nullptr && decode_th_->joinable()) {
+    decode_th_->join();
+    decode_th_ = nullptr;
+  }
+}
+
+bool PlayTaskStream::Front(TaskPtr* task) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [this] {
+    return !tasks_.empty() || is_finished_ || is_stopped_.load();
+  });
+  if (tasks_.empty() || is_stopped_.load()) {
+    return false;
+  }
+  *task = tasks_.front();
+  return true;
+}
+
+void PlayTaskStream::PopFront() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!tasks_.empty()) {
+    queued_bytes_ -= tasks_.front()->msg_size();
+    tasks_.pop_front();
+    cv_.notify_all();
+  }
+}
+
+void PlayTaskStream::ThreadFunc() {
+  // a viewer over a single reader yields the messages in timestamp order
+  RecordViewer viewer(reader_, begin_time_ns_, end_time_ns_, channels_);
+  for (auto itr = viewer.begin(), itr_end = viewer.end();
+       itr != itr_end && !is_stopped_.load(); ++itr) {
+    auto search = writers_.find(itr->channel_name);
+    if (search == writers_.end()) {
+      continue;
+    }
+    auto raw_msg = std::make_shared<message::RawMessage>(itr->content);
+    auto task = std::make_shared<PlayTask>(raw_msg, search->second, itr->time,
+                                           itr->time + plus_time_ns_);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] {
+      return tasks_.empty() ||
+             (tasks_.size() < kCapacity && queued_bytes_ < kCapacityBytes) ||
+             is_stopped_.load();
+    });
+    queued_bytes_ += task->msg_size();
+    tasks_.push_back(task);
+    cv_.notify_all();
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  is_finished_ = true;
+  cv_.notify_all();
+}
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,101 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TOOLS_CYBER_RECORDER_PLAYER_PLAY_TASK_STREAM_H_
+#define CYBER_TOOLS_CYBER_RECORDER_PLAYER_PLAY_TASK_STREAM_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "cyber/message/raw_message.h"
+#include "cyber/node/writer.h"
+#include "cyber/record/record_reader.h"
+#include "cyber/tools/cyber_recorder/player/play_task.h"
+
+namespace apollo {
+namespace cyber {
+namespace record {
+
+/**
+ * @class PlayTaskStream
+ * @brief Decodes the play tasks of a time range of one record file on its
+ * own thread, in timestamp order, into a bounded queue. PlayTaskMerger
+ * merges the streams by timestamp.
+ */
+class PlayTaskStream {
+ public:
+  using TaskPtr = std::shared_ptr<PlayTask>;
+  using RecordReaderPtr = std::shared_ptr<RecordReader>;
+  using WriterPtr = std::shared_ptr<Writer<message::RawMessage>>;
+  using WriterMap = std::unordered_map<std::string, WriterPtr>;
+
+  /**
+   * @param writers must outlive the stream, channels without a writer are
+   * not played
+   * @param plus_time_ns added to the play time of every task, for loops
+   */
+  PlayTaskStream(const RecordReaderPtr& reader, uint64_t begin_time_ns,
+                 uint64_t end_time_ns, const std::set<std::string>& channels,
+                 const WriterMap& writers, uint64_t plus_time_ns);
+  virtual ~PlayTaskStream();
+
+  void Start();
+  void Stop();
+
+  /**
+   * @brief Wait for the next task of the stream.
+   *
+   * @return false once the stream is exhausted or stopped
+   */
+  bool Front(TaskPtr* task);
+  void PopFront();
+
+ private:
+  void ThreadFunc();
+
+  RecordReaderPtr reader_;
+  uint64_t begin_time_ns_;
+  uint64_t end_time_ns_;
+  std::set<std::string> channels_;
+  const WriterMap& writers_;
+  uint64_t plus_time_ns_;
+
+  std::deque<TaskPtr> tasks_;
+  size_t queued_bytes_ = 0;
+  bool is_finished_ = false;
+  std::atomic<bool> is_stopped_ = {true};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unique_ptr<std::thread> decode_th_;
+
+  // decoded tasks kept ahead of the merge, whichever limit is hit first
+  static const size_t kCapacity;
+  static const size_t kCapacityBytes;
+};
+
+}  // namespace record
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TOOLS_CYBER_RECORDER_PLAYER_PLAY_TASK_STREAM_H_
@@ -18,7 +18,10 @@
 
 #include <termios.h>
 
+#include <iomanip>
+
 #include "cyber/init.h"
+#include "cyber/time/time.h"
 
 namespace apollo {
 namespace cyber {
@@ -33,7 +36,8 @@ Player::Player(const PlayParam& play_param)
       producer_(nullptr),
       task_buffer_(nullptr) {
   task_buffer_ = std::make_shared<PlayTaskBuffer>();
-  consumer_.reset(new PlayTaskConsumer(task_buffer_, play_param.play_rate));
+  consumer_.reset(new PlayTaskConsumer(task_buffer_, play_param.play_rate,
+                                       play_param.is_max_rate));
   producer_.reset(new PlayTaskProducer(task_buffer_, play_param));
 }
 
@@ -112,7 +116,8 @@ bool Player::Start() {
             << std::endl;
   producer_->Start();
 
-  auto preload_sec = play_param.preload_time_s;
+  // the producer keeps ahead of an unthrottled consumer on its own
+  auto preload_sec = play_param.is_max_rate ? 0 : play_param.preload_time_s;
   while (preload_sec > 0 && !is_stopped_.load() && apollo::cyber::OK()) {
     std::this_thread::sleep_for(std::chrono::seconds(1));
     --preload_sec;
@@ -124,6 +129,7 @@ bool Player::Start() {
     --delay_sec;
   }
 
+  uint64_t start_real_time_ns = Time::Now().ToNanosecond();
   consumer_->Start(play_param.begin_time_ns);
 
   std::ios::fmtflags before(std::cout.flags());
@@ -175,6 +181,18 @@ bool Player::Start() {
   }
 
   std::cout << "\nplay finished." << std::endl;
+  if (play_param.is_max_rate) {
+    double elapsed_s =
+        static_cast<double>(Time::Now().ToNanosecond() - start_real_time_ns) /
+        1e9;
+    double played_msg_num = static_cast<double>(PlayTask::played_msg_num());
+    double played_mb =
+        static_cast<double>(PlayTask::played_bytes()) / 1024.0 / 1024.0;
+    std::cout << std::setprecision(3) << "played " << PlayTask::played_msg_num()
+              << " messages, " << played_mb << " MB in " << elapsed_s
+              << " s, " << played_msg_num / elapsed_s << " msg/s, "
+              << played_mb / elapsed_s << " MB/s" << std::endl;
+  }
   std::cout.flags(before);
   return true;
 }
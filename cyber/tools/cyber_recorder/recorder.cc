@@ -40,6 +40,7 @@ Recorder::~Recorder() { Stop(); }
 
 bool Recorder::Start() {
   writer_.reset(new RecordWriter(header_));
+  writer_->SetCompression(compression_);
   if (!writer_->Open(output_)) {
     AERROR << "Datafile open file error.";
     return false;
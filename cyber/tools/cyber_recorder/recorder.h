@@ -54,6 +54,9 @@ class Recorder : public std::enable_shared_from_this<Recorder> {
   ~Recorder();
   bool Start();
   bool Stop();
+  void SetCompression(ChunkCompression compression) {
+    compression_ = compression;
+  }
 
  private:
   bool is_started_ = false;
@@ -66,6 +69,7 @@ class Recorder : public std::enable_shared_from_this<Recorder> {
   bool all_channels_ = true;
   std::vector<std::string> channel_vec_;
   proto::Header header_;
+  ChunkCompression compression_ = ChunkCompression::NONE;
   std::unordered_map<std::string, std::shared_ptr<ReaderBase>>
       channel_reader_map_;
   uint64_t message_count_;
@@ -15,6 +15,12 @@
  *****************************************************************************/
 
 #include "cyber/transport/dispatcher/shm_dispatcher.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+#include "cyber/common/environment.h"
 #include "cyber/common/global_data.h"
 #include "cyber/common/util.h"
 #include "cyber/scheduler/scheduler_factory.h"
@@ -26,7 +32,9 @@ namespace transport {
 
 using common::GlobalData;
 
-ShmDispatcher::ShmDispatcher() : host_id_(0) { Init(); }
+ShmDispatcher::ShmDispatcher() : host_id_(0), futex_notifier_(nullptr) {
+  Init();
+}
 
 ShmDispatcher::~ShmDispatcher() { Shutdown(); }
 
@@ -35,8 +43,10 @@ void ShmDispatcher::Shutdown() {
     return;
   }
 
-  if (thread_.joinable()) {
-    thread_.join();
+  for (auto& thread : threads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
   }
 
   {
@@ -60,14 +70,24 @@ void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
   ADEBUG << "Reading sharedmem message: "
          << GlobalData::GetChannelById(channel_id)
          << " from block: " << block_index;
-  auto rb = std::make_shared<ReadableBlock>();
-  rb->index = block_index;
-  if (!segments_[channel_id]->AcquireBlockToRead(rb.get())) {
+  auto segment = segments_.at(channel_id);
+  ReadableBlock* raw_rb = new ReadableBlock();
+  raw_rb->index = block_index;
+  if (!segment->AcquireBlockToRead(raw_rb)) {
     AWARN << "fail to acquire block, channel: "
           << GlobalData::GetChannelById(channel_id)
           << " index: " << block_index;
+    delete raw_rb;
     return;
   }
+  // The read lock lives as long as the block handle, so listeners that borrow
+  // the payload (see message::BorrowFromArray) keep it locked until they drop
+  // the message. The handle also keeps the block mapped if the segment is
+  // remapped meanwhile, the lock is then released in the old mapping.
+  std::shared_ptr<ReadableBlock> rb(raw_rb, [segment](ReadableBlock* block) {
+    segment->ReleaseReadBlock(*block);
+    delete block;
+  });
 
   MessageInfo msg_info;
   const char* msg_info_addr =
@@ -79,7 +99,6 @@ void ShmDispatcher::ReadMessage(uint64_t channel_id, uint32_t block_index) {
     AERROR << "error msg info of channel:"
            << GlobalData::GetChannelById(channel_id);
   }
-  segments_[channel_id]->ReleaseReadBlock(*rb);
 }
 
 void ShmDispatcher::OnMessage(uint64_t channel_id,
@@ -99,10 +118,16 @@ void ShmDispatcher::OnMessage(uint64_t channel_id,
   }
 }
 
-void ShmDispatcher::ThreadFunc() {
+void ShmDispatcher::ThreadFunc(uint32_t group, uint32_t group_num) {
   ReadableInfo readable_info;
   while (!is_shutdown_.load()) {
-    if (!notifier_->Listen(100, &readable_info)) {
+    bool result = false;
+    if (group_num > 1) {
+      result = futex_notifier_->Listen(100, group, group_num, &readable_info);
+    } else {
+      result = notifier_->Listen(100, &readable_info);
+    }
+    if (!result) {
       ADEBUG << "listen failed.";
       continue;
     }
@@ -120,11 +145,9 @@ void ShmDispatcher::ThreadFunc() {
       if (segments_.count(channel_id) == 0) {
         continue;
       }
-      // check block index
-      if (previous_indexes_.count(channel_id) == 0) {
-        previous_indexes_[channel_id] = UINT32_MAX;
-      }
-      uint32_t& previous_index = previous_indexes_[channel_id];
+      // check block index, the entry is added along with the segment and
+      // only touched by the thread owning the channel's group
+      uint32_t& previous_index = previous_indexes_.at(channel_id);
       if (block_index != 0 && previous_index != UINT32_MAX) {
         if (block_index == previous_index) {
           ADEBUG << "Receive SAME index " << block_index << " of channel "
@@ -147,8 +170,25 @@ void ShmDispatcher::ThreadFunc() {
 bool ShmDispatcher::Init() {
   host_id_ = common::Hash(GlobalData::Instance()->HostIp());
   notifier_ = NotifierFactory::CreateNotifier();
-  thread_ = std::thread(&ShmDispatcher::ThreadFunc, this);
-  scheduler::Instance()->SetInnerThreadAttr("shm_disp", &thread_);
+
+  // The futex notifier keeps channels in separate rings, so their dispatch
+  // can be spread over several threads (CYBER_SHM_DISPATCH_THREADS).
+  uint32_t group_num = 1;
+  futex_notifier_ = dynamic_cast<FutexNotifier*>(notifier_);
+  if (futex_notifier_ != nullptr) {
+    int thread_num = std::atoi(
+        common::GetEnv("CYBER_SHM_DISPATCH_THREADS", "1").c_str());
+    group_num = static_cast<uint32_t>(std::max(thread_num, 1));
+    group_num = std::min(group_num, FutexNotifier::kRingNum);
+  }
+
+  threads_.reserve(group_num);
+  for (uint32_t group = 0; group < group_num; ++group) {
+    threads_.emplace_back(&ShmDispatcher::ThreadFunc, this, group, group_num);
+    std::string name = group_num > 1 ? "shm_disp_" + std::to_string(group)
+                                     : std::string("shm_disp");
+    scheduler::Instance()->SetInnerThreadAttr(name, &threads_.back());
+  }
   return true;
 }
 
@@ -22,6 +22,7 @@
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "cyber/base/atomic_rw_lock.h"
 #include "cyber/common/global_data.h"
@@ -29,6 +30,7 @@
 #include "cyber/common/macros.h"
 #include "cyber/message/message_traits.h"
 #include "cyber/transport/dispatcher/dispatcher.h"
+#include "cyber/transport/shm/futex_notifier.h"
 #include "cyber/transport/shm/notifier_factory.h"
 #include "cyber/transport/shm/segment_factory.h"
 
@@ -65,15 +67,17 @@ class ShmDispatcher : public Dispatcher {
   void ReadMessage(uint64_t channel_id, uint32_t block_index);
   void OnMessage(uint64_t channel_id, const std::shared_ptr<ReadableBlock>& rb,
                  const MessageInfo& msg_info);
-  void ThreadFunc();
+  void ThreadFunc(uint32_t group, uint32_t group_num);
   bool Init();
 
   uint64_t host_id_;
   SegmentContainer segments_;
   std::unordered_map<uint64_t, uint32_t> previous_indexes_;
   AtomicRWLock segments_lock_;
-  std::thread thread_;
+  std::vector<std::thread> threads_;
   NotifierPtr notifier_;
+  // set when the notifier can split channels into groups, one thread each
+  FutexNotifier* futex_notifier_;
 
   DECLARE_SINGLETON(ShmDispatcher)
 };
@@ -85,8 +89,8 @@ void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
   auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
                                      const MessageInfo& msg_info) {
     auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+    RETURN_IF(!message::BorrowFromArray(
+        rb->buf, static_cast<int>(rb->block->msg_size()), rb, msg.get()));
     listener(msg, msg_info);
   };
 
@@ -102,8 +106,8 @@ void ShmDispatcher::AddListener(const RoleAttributes& self_attr,
   auto listener_adapter = [listener](const std::shared_ptr<ReadableBlock>& rb,
                                      const MessageInfo& msg_info) {
     auto msg = std::make_shared<MessageT>();
-    RETURN_IF(!message::ParseFromArray(
-        rb->buf, static_cast<int>(rb->block->msg_size()), msg.get()));
+    RETURN_IF(!message::BorrowFromArray(
+        rb->buf, static_cast<int>(rb->block->msg_size()), rb, msg.get()));
     listener(msg, msg_info);
   };
 
@@ -24,8 +24,11 @@
 #include "cyber/common/util.h"
 #include "cyber/init.h"
 #include "cyber/message/raw_message.h"
+#include "cyber/message/raw_message_view.h"
 #include "cyber/proto/unit_test.pb.h"
 #include "cyber/transport/common/identity.h"
+#include "cyber/transport/message/loaned_message.h"
+#include "cyber/transport/shm/segment_factory.h"
 #include "cyber/transport/transport.h"
 
 namespace apollo {
@@ -95,6 +98,90 @@ TEST(ShmDispatcherTest, on_message) {
   EXPECT_EQ(recv_msg->message, send_msg->message);
 }
 
+TEST(ShmDispatcherTest, on_loaned_message) {
+  auto dispatcher = ShmDispatcher::Instance();
+
+  RoleAttributes oppo_attr;
+  oppo_attr.set_host_name(common::GlobalData::Instance()->HostName());
+  oppo_attr.set_host_ip(common::GlobalData::Instance()->HostIp());
+  oppo_attr.set_channel_name("on_loaned_message");
+  oppo_attr.set_channel_id(common::Hash("on_loaned_message"));
+  Identity oppo_id;
+  oppo_attr.set_id(oppo_id.HashValue());
+
+  auto transmitter =
+      Transport::Instance()->CreateTransmitter<message::RawMessage>(
+          oppo_attr, proto::OptionalMode::SHM);
+  EXPECT_NE(transmitter, nullptr);
+
+  RoleAttributes self_attr;
+  self_attr.set_channel_name("on_loaned_message");
+  self_attr.set_channel_id(common::Hash("on_loaned_message"));
+  Identity self_id;
+  self_attr.set_id(self_id.HashValue());
+
+  std::shared_ptr<message::RawMessageView> recv_msg = nullptr;
+  dispatcher->AddListener<message::RawMessageView>(
+      self_attr,
+      [&recv_msg](const std::shared_ptr<message::RawMessageView>& msg,
+                  const MessageInfo& msg_info) {
+        (void)msg_info;
+        recv_msg = msg;
+      });
+
+  const std::string payload = "loaned_message";
+  WritableBlock block;
+  ASSERT_TRUE(transmitter->AcquireLoan(payload.size(), &block));
+  LoanedMessage<message::RawMessage> loan(transmitter, block, payload.size());
+  EXPECT_TRUE(loan.IsValid());
+  EXPECT_FALSE(loan.set_size(payload.size() + 1));
+  memcpy(loan.data(), payload.data(), payload.size());
+  EXPECT_TRUE(loan.set_size(payload.size()));
+  EXPECT_TRUE(loan.Publish());
+  EXPECT_FALSE(loan.IsValid());
+
+  sleep(1);
+  ASSERT_NE(recv_msg, nullptr);
+  EXPECT_TRUE(recv_msg->is_borrowed());
+  EXPECT_EQ(std::string(recv_msg->data(), recv_msg->size()), payload);
+  recv_msg = nullptr;
+}
+
+TEST(ShmDispatcherTest, loan_released_when_disabled) {
+  RoleAttributes attr;
+  attr.set_host_name(common::GlobalData::Instance()->HostName());
+  attr.set_host_ip(common::GlobalData::Instance()->HostIp());
+  attr.set_channel_name("loan_released_when_disabled");
+  attr.set_channel_id(common::Hash("loan_released_when_disabled"));
+  Identity id;
+  attr.set_id(id.HashValue());
+
+  auto transmitter =
+      Transport::Instance()->CreateTransmitter<message::RawMessage>(
+          attr, proto::OptionalMode::SHM);
+  ASSERT_NE(transmitter, nullptr);
+
+  const std::string payload = "loaned_message";
+  WritableBlock block;
+  ASSERT_TRUE(transmitter->AcquireLoan(payload.size(), &block));
+  LoanedMessage<message::RawMessage> loan(transmitter, block, payload.size());
+  ASSERT_TRUE(loan.set_size(payload.size()));
+
+  // a second segment keeps the shared memory once the transmitter lets go
+  auto segment = SegmentFactory::CreateSegment(attr.channel_id());
+  ReadableBlock readable;
+  readable.index = block.index;
+  EXPECT_FALSE(segment->AcquireBlockToRead(&readable));
+
+  transmitter->Disable();
+  EXPECT_FALSE(loan.Publish());
+  EXPECT_FALSE(loan.IsValid());
+
+  // the write lock is gone even though the transmitter has no segment
+  ASSERT_TRUE(segment->AcquireBlockToRead(&readable));
+  segment->ReleaseReadBlock(readable);
+}
+
 TEST(ShmDispatcherTest, shutdown) {
   auto dispatcher = ShmDispatcher::Instance();
   dispatcher->Shutdown();
@@ -0,0 +1,135 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_MESSAGE_LOANED_MESSAGE_H_
+#define CYBER_TRANSPORT_MESSAGE_LOANED_MESSAGE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "cyber/transport/shm/segment.h"
+#include "cyber/transport/transmitter/transmitter.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class LoanedMessage
+ * @brief A write-locked shared memory block borrowed from a transmitter.
+ * The payload is built in place (raw bytes of MessageT's wire format, or a
+ * trivially copyable struct) and published without a serialization step.
+ * An unpublished loan is handed back to the segment on destruction.
+ */
+template <typename MessageT>
+class LoanedMessage {
+ public:
+  using TransmitterPtr = std::shared_ptr<Transmitter<MessageT>>;
+
+  LoanedMessage() = default;
+  LoanedMessage(const TransmitterPtr& transmitter, const WritableBlock& block,
+                std::size_t capacity)
+      : transmitter_(transmitter), block_(block), capacity_(capacity) {}
+  ~LoanedMessage() { Release(); }
+
+  LoanedMessage(const LoanedMessage&) = delete;
+  LoanedMessage& operator=(const LoanedMessage&) = delete;
+
+  LoanedMessage(LoanedMessage&& other) { *this = std::move(other); }
+  LoanedMessage& operator=(LoanedMessage&& other) {
+    if (this != &other) {
+      Release();
+      transmitter_ = std::move(other.transmitter_);
+      block_ = other.block_;
+      capacity_ = other.capacity_;
+      size_ = other.size_;
+      other.transmitter_ = nullptr;
+      other.block_ = WritableBlock();
+    }
+    return *this;
+  }
+
+  bool IsValid() const {
+    return transmitter_ != nullptr && block_.buf != nullptr;
+  }
+
+  uint8_t* data() { return block_.buf; }
+  std::size_t capacity() const { return capacity_; }
+
+  std::size_t size() const { return size_; }
+  bool set_size(std::size_t size) {
+    if (size > capacity_) {
+      return false;
+    }
+    size_ = size;
+    return true;
+  }
+
+  /**
+   * @brief Construct a fixed-layout payload directly inside the block and
+   * set the payload size to sizeof(T).
+   *
+   * @return nullptr if the loan is invalid or too small for T
+   */
+  template <typename T, typename... Args>
+  T* Construct(Args&&... args) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable types can live in shared memory");
+    if (!IsValid() || sizeof(T) > capacity_) {
+      return nullptr;
+    }
+    size_ = sizeof(T);
+    return new (block_.buf) T(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Publish the payload to all readers. The loan is consumed whatever
+   * the result.
+   */
+  bool Publish() {
+    if (!IsValid()) {
+      return false;
+    }
+    bool result = transmitter_->TransmitLoan(block_, size_);
+    transmitter_ = nullptr;
+    block_ = WritableBlock();
+    return result;
+  }
+
+ private:
+  void Release() {
+    if (IsValid()) {
+      transmitter_->ReleaseLoan(block_);
+    }
+    transmitter_ = nullptr;
+    block_ = WritableBlock();
+  }
+
+  TransmitterPtr transmitter_ = nullptr;
+  WritableBlock block_;
+  std::size_t capacity_ = 0;
+  std::size_t size_ = 0;
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_MESSAGE_LOANED_MESSAGE_H_
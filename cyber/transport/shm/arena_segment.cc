@@ -0,0 +1,422 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/arena_segment.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+#include "cyber/transport/shm/block.h"
+#include "cyber/transport/shm/shm_conf.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+const uint32_t ArenaSegment::kMaxArenaNum;
+const uint32_t ArenaSegment::kArenaIndexShift;
+
+namespace {
+
+const uint32_t kBlockIndexMask = (1u << ArenaSegment::kArenaIndexShift) - 1;
+const uint64_t kPageSize = 4096;
+
+// States of an arena slot in ArenaInfo::ready.
+const uint32_t kArenaCreating = 0;
+const uint32_t kArenaReady = 1;
+const uint32_t kArenaFailed = 2;
+
+uint64_t AlignUp(uint64_t size, uint64_t align) {
+  return (size + align - 1) / align * align;
+}
+
+}  // namespace
+
+ArenaSegment::ArenaSegment(uint64_t channel_id)
+    : Segment(channel_id), header_size_(0), table_(nullptr) {
+  shm_name_ = std::to_string(channel_id) + ".arena";
+  header_size_ = AlignUp(sizeof(State) + sizeof(ArenaTable), kPageSize);
+}
+
+ArenaSegment::~ArenaSegment() {
+  Destroy();
+  Reset();
+}
+
+uint32_t ArenaSegment::arena_num() {
+  if (table_ == nullptr) {
+    return 0;
+  }
+  return table_->arena_num.load();
+}
+
+bool ArenaSegment::AcquireBlockToWrite(std::size_t msg_size,
+                                       WritableBlock* writable_block) {
+  RETURN_VAL_IF_NULL(writable_block, false);
+  if (!init_ && !OpenOrCreate()) {
+    AERROR << "create shm failed, can't write now.";
+    return false;
+  }
+
+  uint32_t arena_index = 0;
+  if (!FindArena(msg_size, &arena_index) &&
+      !AppendArena(msg_size, &arena_index)) {
+    AERROR << "no arena for msg_size: " << msg_size;
+    return false;
+  }
+  if (!MapArena(arena_index, false)) {
+    return false;
+  }
+
+  Arena& arena = arenas_[arena_index];
+  ArenaInfo& info = table_->arenas[arena_index];
+  uint32_t block_index = 0;
+  bool locked = false;
+  for (uint32_t i = 0; i < kMaxWriteLockRounds * arena.block_num; ++i) {
+    block_index = info.seq.fetch_add(1) % arena.block_num;
+    if (arena.blocks[block_index].TryLockForWrite()) {
+      locked = true;
+      break;
+    }
+  }
+  if (!locked) {
+    AERROR << "all " << arena.block_num << " blocks of arena " << arena_index
+           << " are locked by readers, can't write now.";
+    return false;
+  }
+
+  writable_block->index = (arena_index << kArenaIndexShift) | block_index;
+  writable_block->block = &arena.blocks[block_index];
+  writable_block->buf = arena.bufs + block_index * arena.block_buf_size;
+  writable_block->mapping = arena.mapping;
+  writable_block->generation = generation_.load();
+  return true;
+}
+
+bool ArenaSegment::AcquireBlockToRead(ReadableBlock* readable_block) {
+  RETURN_VAL_IF_NULL(readable_block, false);
+  if (!init_ && !OpenOnly()) {
+    AERROR << "failed to open shared memory, can't read now.";
+    return false;
+  }
+
+  uint32_t arena_index = readable_block->index >> kArenaIndexShift;
+  if (arena_index >= arena_num() || !MapArena(arena_index, false)) {
+    AERROR << "invalid block_index[" << readable_block->index << "].";
+    return false;
+  }
+
+  Block* block = nullptr;
+  uint8_t* buf = nullptr;
+  if (!GetBlock(readable_block->index, &block, &buf)) {
+    AERROR << "invalid block_index[" << readable_block->index << "].";
+    return false;
+  }
+  if (!block->TryLockForRead()) {
+    return false;
+  }
+  readable_block->block = block;
+  readable_block->buf = buf;
+  readable_block->mapping = arenas_[arena_index].mapping;
+  readable_block->generation = generation_.load();
+  return true;
+}
+
+bool ArenaSegment::OpenOrCreate() {
+  if (init_) {
+    return true;
+  }
+
+  int fd = shm_open(shm_name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+  if (fd < 0) {
+    if (EEXIST == errno) {
+      ADEBUG << "shm already exist, open only.";
+      return OpenOnly();
+    }
+    AERROR << "create shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  if (ftruncate(fd, header_size_) < 0) {
+    AERROR << "ftruncate failed: " << strerror(errno);
+    close(fd);
+    shm_unlink(shm_name_.c_str());
+    return false;
+  }
+
+  managed_shm_ = mmap(nullptr, header_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  close(fd);
+  if (managed_shm_ == MAP_FAILED) {
+    AERROR << "attach shm failed:" << strerror(errno);
+    managed_shm_ = nullptr;
+    shm_unlink(shm_name_.c_str());
+    return false;
+  }
+
+  state_ = new (managed_shm_) State(conf_.ceiling_msg_size());
+  table_ = new (static_cast<char*>(managed_shm_) + sizeof(State)) ArenaTable();
+
+  state_->IncreaseReferenceCounts();
+  uint64_t header_size = header_size_;
+  mapping_.reset(managed_shm_,
+                 [header_size](void* addr) { munmap(addr, header_size); });
+  init_ = true;
+  return true;
+}
+
+bool ArenaSegment::OpenOnly() {
+  if (init_) {
+    return true;
+  }
+
+  int fd = shm_open(shm_name_.c_str(), O_RDWR, 0644);
+  if (fd == -1) {
+    AERROR << "get shm failed: " << strerror(errno);
+    return false;
+  }
+
+  managed_shm_ = mmap(nullptr, header_size_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+  close(fd);
+  if (managed_shm_ == MAP_FAILED) {
+    AERROR << "attach shm failed: " << strerror(errno);
+    managed_shm_ = nullptr;
+    return false;
+  }
+
+  state_ = reinterpret_cast<State*>(managed_shm_);
+  table_ = reinterpret_cast<ArenaTable*>(static_cast<char*>(managed_shm_) +
+                                         sizeof(State));
+
+  state_->IncreaseReferenceCounts();
+  uint64_t header_size = header_size_;
+  mapping_.reset(managed_shm_,
+                 [header_size](void* addr) { munmap(addr, header_size); });
+  init_ = true;
+  ADEBUG << "open only true.";
+  return true;
+}
+
+bool ArenaSegment::Remove() {
+  for (uint32_t i = 0; i < kMaxArenaNum; ++i) {
+    shm_unlink(ArenaName(i).c_str());
+  }
+  if (shm_unlink(shm_name_.c_str()) < 0) {
+    AERROR << "shm_unlink failed: " << strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+void ArenaSegment::Reset() {
+  std::lock_guard<std::mutex> lg(arenas_lock_);
+  // the memory is unmapped once the blocks still held are released too
+  for (auto& arena : arenas_) {
+    arena.mapped.store(false);
+    arena.mapping = nullptr;
+    arena.shm = nullptr;
+    arena.blocks = nullptr;
+    arena.bufs = nullptr;
+  }
+  state_ = nullptr;
+  table_ = nullptr;
+  managed_shm_ = nullptr;
+  mapping_ = nullptr;
+}
+
+bool ArenaSegment::FindArena(std::size_t msg_size, uint32_t* arena_index) {
+  bool found = false;
+  uint64_t best_ceiling = UINT64_MAX;
+  for (uint32_t i = 0; i < arena_num(); ++i) {
+    const ArenaInfo& info = table_->arenas[i];
+    if (info.ready.load(std::memory_order_acquire) != kArenaReady) {
+      continue;
+    }
+    if (info.ceiling_msg_size >= msg_size &&
+        info.ceiling_msg_size < best_ceiling) {
+      best_ceiling = info.ceiling_msg_size;
+      *arena_index = i;
+      found = true;
+    }
+  }
+  return found;
+}
+
+bool ArenaSegment::AppendArena(std::size_t msg_size, uint32_t* arena_index) {
+  // Size classes follow ShmConf; messages beyond the largest class get an
+  // arena of their own, at least twice as large as the largest one so far,
+  // so that slowly growing messages do not use up the slots.
+  ShmConf conf(msg_size);
+  uint64_t ceiling_msg_size = conf.ceiling_msg_size();
+  uint64_t info_size = conf.block_buf_size() - conf.ceiling_msg_size();
+  if (ceiling_msg_size < msg_size) {
+    uint64_t largest_ceiling = 0;
+    for (uint32_t i = 0; i < arena_num(); ++i) {
+      const ArenaInfo& info = table_->arenas[i];
+      if (info.ready.load(std::memory_order_acquire) == kArenaReady) {
+        largest_ceiling = std::max(largest_ceiling, info.ceiling_msg_size);
+      }
+    }
+    ceiling_msg_size =
+        std::max(AlignUp(msg_size, kPageSize), 2 * largest_ceiling);
+  }
+
+  uint32_t index = 0;
+  if (!ClaimArena(&index)) {
+    AERROR << "too many arenas, max: " << kMaxArenaNum;
+    return false;
+  }
+
+  ArenaInfo& info = table_->arenas[index];
+  info.block_num = conf.block_num();
+  info.ceiling_msg_size = ceiling_msg_size;
+  info.block_buf_size = ceiling_msg_size + info_size;
+  if (!MapArena(index, true)) {
+    // hands the slot over to the next append
+    info.ready.store(kArenaFailed, std::memory_order_release);
+    return false;
+  }
+  info.ready.store(kArenaReady, std::memory_order_release);
+
+  AINFO << "channel " << channel_id_ << " appends arena " << index
+        << " for msg_size: " << msg_size << ", ceiling: " << ceiling_msg_size
+        << ", block num: " << info.block_num;
+  *arena_index = index;
+  return true;
+}
+
+bool ArenaSegment::ClaimArena(uint32_t* arena_index) {
+  // a slot whose creation failed is taken again first
+  for (uint32_t i = 0; i < arena_num(); ++i) {
+    uint32_t expected = kArenaFailed;
+    if (table_->arenas[i].ready.compare_exchange_strong(expected,
+                                                         kArenaCreating)) {
+      *arena_index = i;
+      return true;
+    }
+  }
+  // the count never goes past the cap, so every slot below it is claimed
+  uint32_t num = table_->arena_num.load();
+  do {
+    if (num >= kMaxArenaNum) {
+      return false;
+    }
+  } while (!table_->arena_num.compare_exchange_weak(num, num + 1));
+  *arena_index = num;
+  return true;
+}
+
+bool ArenaSegment::MapArena(uint32_t arena_index, bool create) {
+  Arena& arena = arenas_[arena_index];
+  if (arena.mapped.load(std::memory_order_acquire)) {
+    return true;
+  }
+
+  std::lock_guard<std::mutex> lg(arenas_lock_);
+  if (arena.mapped.load(std::memory_order_acquire)) {
+    return true;
+  }
+
+  const ArenaInfo& info = table_->arenas[arena_index];
+  if (!create &&
+      info.ready.load(std::memory_order_acquire) != kArenaReady) {
+    AERROR << "arena " << arena_index << " is not ready.";
+    return false;
+  }
+  uint64_t shm_size =
+      AlignUp(info.block_num * sizeof(Block), kPageSize) +
+      info.block_num * info.block_buf_size;
+
+  std::string name = ArenaName(arena_index);
+  int fd = -1;
+  if (create) {
+    // a stale object may be left by a crashed process
+    shm_unlink(name.c_str());
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd >= 0 && ftruncate(fd, shm_size) < 0) {
+      AERROR << "ftruncate failed: " << strerror(errno);
+      close(fd);
+      shm_unlink(name.c_str());
+      return false;
+    }
+  } else {
+    fd = shm_open(name.c_str(), O_RDWR, 0644);
+  }
+  if (fd < 0) {
+    AERROR << "open arena " << name << " failed: " << strerror(errno);
+    return false;
+  }
+
+  void* shm =
+      mmap(nullptr, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (shm == MAP_FAILED) {
+    AERROR << "attach arena " << name << " failed: " << strerror(errno);
+    if (create) {
+      shm_unlink(name.c_str());
+    }
+    return false;
+  }
+
+  arena.mapping.reset(shm,
+                      [shm_size](void* addr) { munmap(addr, shm_size); });
+  arena.shm = shm;
+  arena.shm_size = shm_size;
+  arena.block_num = info.block_num;
+  arena.block_buf_size = info.block_buf_size;
+  if (create) {
+    PrepareMemory(shm, shm_size, true);
+    arena.blocks = new (shm) Block[info.block_num];
+  } else {
+    arena.blocks = reinterpret_cast<Block*>(shm);
+  }
+  arena.bufs = static_cast<uint8_t*>(shm) +
+               AlignUp(info.block_num * sizeof(Block), kPageSize);
+  arena.mapped.store(true, std::memory_order_release);
+  return true;
+}
+
+bool ArenaSegment::GetBlock(uint32_t index, Block** block, uint8_t** buf) {
+  uint32_t arena_index = index >> kArenaIndexShift;
+  uint32_t block_index = index & kBlockIndexMask;
+  if (arena_index >= kMaxArenaNum) {
+    return false;
+  }
+  Arena& arena = arenas_[arena_index];
+  if (!arena.mapped.load(std::memory_order_acquire) ||
+      block_index >= arena.block_num) {
+    return false;
+  }
+  *block = &arena.blocks[block_index];
+  *buf = arena.bufs + block_index * arena.block_buf_size;
+  return true;
+}
+
+std::string ArenaSegment::ArenaName(uint32_t arena_index) const {
+  return shm_name_ + "." + std::to_string(arena_index);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,111 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_ARENA_SEGMENT_H_
+#define CYBER_TRANSPORT_SHM_ARENA_SEGMENT_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "cyber/transport/shm/segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class ArenaSegment
+ * @brief A segment made of several size-classed block pools (arenas), each
+ * backed by its own POSIX shared memory object. A writer picks the smallest
+ * arena whose blocks fit the message; when none fits, a new arena sized from
+ * ShmConf is appended. Existing arenas are never remapped, so readers are not
+ * disturbed when a larger message shows up.
+ *
+ * The block index carried by ReadableInfo encodes the arena in its high bits.
+ */
+class ArenaSegment : public Segment {
+ public:
+  explicit ArenaSegment(uint64_t channel_id);
+  virtual ~ArenaSegment();
+
+  static const char* Type() { return "arena"; }
+
+  bool AcquireBlockToWrite(std::size_t msg_size,
+                           WritableBlock* writable_block) override;
+
+  bool AcquireBlockToRead(ReadableBlock* readable_block) override;
+
+  uint32_t arena_num();
+
+  static const uint32_t kMaxArenaNum = 16;
+  static const uint32_t kArenaIndexShift = 24;
+
+ private:
+  // Shared by all processes, placed right after State in the header object.
+  struct ArenaInfo {
+    // creating, ready or failed, see arena_segment.cc
+    std::atomic<uint32_t> ready = {0};
+    std::atomic<uint32_t> seq = {0};
+    uint32_t block_num = 0;
+    uint64_t ceiling_msg_size = 0;
+    uint64_t block_buf_size = 0;
+  };
+
+  struct ArenaTable {
+    std::atomic<uint32_t> arena_num = {0};
+    ArenaInfo arenas[kMaxArenaNum];
+  };
+
+  // Local mapping of one arena, published through `mapped`.
+  struct Arena {
+    std::atomic<bool> mapped = {false};
+    // unmaps shm once the segment is reset and its blocks are released
+    std::shared_ptr<void> mapping = nullptr;
+    void* shm = nullptr;
+    uint64_t shm_size = 0;
+    Block* blocks = nullptr;
+    uint8_t* bufs = nullptr;
+    uint32_t block_num = 0;
+    uint64_t block_buf_size = 0;
+  };
+
+  void Reset() override;
+  bool Remove() override;
+  bool OpenOnly() override;
+  bool OpenOrCreate() override;
+
+  bool FindArena(std::size_t msg_size, uint32_t* arena_index);
+  bool AppendArena(std::size_t msg_size, uint32_t* arena_index);
+  bool ClaimArena(uint32_t* arena_index);
+  bool MapArena(uint32_t arena_index, bool create);
+  bool GetBlock(uint32_t index, Block** block, uint8_t** buf);
+  std::string ArenaName(uint32_t arena_index) const;
+
+  std::string shm_name_;
+  uint64_t header_size_;
+  ArenaTable* table_;
+  std::mutex arenas_lock_;
+  Arena arenas_[kMaxArenaNum];
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_ARENA_SEGMENT_H_
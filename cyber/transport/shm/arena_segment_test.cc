@@ -0,0 +1,136 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/arena_segment.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+uint64_t TestChannelId(uint64_t seed) {
+  return (static_cast<uint64_t>(getpid()) << 16) + seed;
+}
+
+bool WriteString(ArenaSegment* segment, const std::string& str,
+                 uint32_t* index) {
+  WritableBlock wb;
+  if (!segment->AcquireBlockToWrite(str.size(), &wb)) {
+    return false;
+  }
+  memcpy(wb.buf, str.data(), str.size());
+  wb.block->set_msg_size(str.size());
+  segment->ReleaseWrittenBlock(wb);
+  *index = wb.index;
+  return true;
+}
+
+std::string ReadString(ArenaSegment* segment, uint32_t index) {
+  ReadableBlock rb;
+  rb.index = index;
+  if (!segment->AcquireBlockToRead(&rb)) {
+    return "";
+  }
+  std::string str(reinterpret_cast<char*>(rb.buf), rb.block->msg_size());
+  segment->ReleaseReadBlock(rb);
+  return str;
+}
+
+TEST(ArenaSegmentTest, write_read) {
+  uint64_t channel_id = TestChannelId(1);
+  ArenaSegment writer(channel_id);
+  ArenaSegment reader(channel_id);
+
+  uint32_t index = 0;
+  EXPECT_TRUE(WriteString(&writer, "arena", &index));
+  EXPECT_EQ(index >> ArenaSegment::kArenaIndexShift, 0);
+  EXPECT_EQ(writer.arena_num(), 1);
+  EXPECT_EQ(ReadString(&reader, index), "arena");
+}
+
+TEST(ArenaSegmentTest, append_arena) {
+  uint64_t channel_id = TestChannelId(2);
+  ArenaSegment writer(channel_id);
+  ArenaSegment reader(channel_id);
+
+  uint32_t small_index = 0;
+  EXPECT_TRUE(WriteString(&writer, "small", &small_index));
+
+  // hold a read lock on the small block while a large message arrives
+  ReadableBlock rb;
+  rb.index = small_index;
+  ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+  uint8_t* small_buf = rb.buf;
+
+  std::string large(200 * 1024, 'x');
+  uint32_t large_index = 0;
+  EXPECT_TRUE(WriteString(&writer, large, &large_index));
+  EXPECT_EQ(writer.arena_num(), 2);
+  EXPECT_EQ(large_index >> ArenaSegment::kArenaIndexShift, 1);
+  EXPECT_EQ(ReadString(&reader, large_index), large);
+
+  // the small arena was not remapped
+  EXPECT_EQ(rb.buf, small_buf);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(rb.buf), 5), "small");
+  reader.ReleaseReadBlock(rb);
+
+  // small messages keep using the small arena
+  EXPECT_TRUE(WriteString(&writer, "again", &small_index));
+  EXPECT_EQ(small_index >> ArenaSegment::kArenaIndexShift, 0);
+  EXPECT_EQ(writer.arena_num(), 2);
+}
+
+TEST(ArenaSegmentTest, invalid_index) {
+  uint64_t channel_id = TestChannelId(3);
+  ArenaSegment writer(channel_id);
+  uint32_t index = 0;
+  EXPECT_TRUE(WriteString(&writer, "arena", &index));
+
+  ArenaSegment reader(channel_id);
+  ReadableBlock rb;
+  rb.index = 5 << ArenaSegment::kArenaIndexShift;
+  EXPECT_FALSE(reader.AcquireBlockToRead(&rb));
+}
+
+TEST(ArenaSegmentTest, release_through_block_mapping) {
+  uint64_t channel_id = TestChannelId(4);
+  ArenaSegment writer(channel_id);
+  ArenaSegment reader(channel_id);
+  WritableBlock wb;
+  ASSERT_TRUE(writer.AcquireBlockToWrite(5, &wb));
+  ReadableBlock rb;
+  rb.index = wb.index;
+  EXPECT_FALSE(reader.AcquireBlockToRead(&rb));
+
+  // a segment that never mapped the arena, e.g. the one of a transmitter
+  // enabled again, still releases the block in the memory it was taken in
+  ArenaSegment other(channel_id);
+  other.ReleaseWrittenBlock(wb);
+  ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+  other.ReleaseReadBlock(rb);
+  wb = WritableBlock();
+  EXPECT_TRUE(writer.AcquireBlockToWrite(5, &wb));
+  writer.ReleaseWrittenBlock(wb);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -26,6 +26,7 @@ namespace transport {
 
 class Block {
   friend class Segment;
+  friend class ArenaSegment;
 
  public:
   Block();
@@ -0,0 +1,291 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/futex_notifier.h"
+
+#include <linux/futex.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <thread>
+
+#include "cyber/common/log.h"
+#include "cyber/common/util.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+using common::Hash;
+
+const uint32_t FutexNotifier::kRingNum;
+const uint32_t FutexNotifier::kRingLength;
+
+namespace {
+
+const uint64_t kSlotBusy = UINT64_MAX;
+
+int Futex(std::atomic<uint32_t>* addr, int op, uint32_t val,
+          const struct timespec* timeout) {
+  return static_cast<int>(syscall(SYS_futex, reinterpret_cast<int*>(addr), op,
+                                  val, timeout, nullptr, 0));
+}
+
+}  // namespace
+
+FutexNotifier::FutexNotifier() {
+  key_ =
+      static_cast<key_t>(Hash("/apollo/cyber/transport/shm/futex_notifier"));
+  ADEBUG << "futex notifier key: " << key_;
+  shm_size_ = sizeof(Indicator);
+
+  if (!Init()) {
+    AERROR << "fail to init futex notifier.";
+    is_shutdown_.store(true);
+    return;
+  }
+  for (uint32_t i = 0; i < kRingNum; ++i) {
+    next_seqs_[i] = indicator_->rings[i].next_seq.load();
+  }
+}
+
+FutexNotifier::~FutexNotifier() { Shutdown(); }
+
+void FutexNotifier::Shutdown() {
+  if (is_shutdown_.exchange(true)) {
+    return;
+  }
+
+  // wake our own listeners so that they can observe the shutdown
+  Wake();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  Reset();
+}
+
+bool FutexNotifier::Notify(const ReadableInfo& info) {
+  if (is_shutdown_.load()) {
+    ADEBUG << "notifier is shutdown.";
+    return false;
+  }
+
+  Ring& ring = indicator_->rings[RingIndex(info.channel_id())];
+  uint64_t seq = ring.next_seq.fetch_add(1);
+  Slot& slot = ring.slots[seq % kRingLength];
+  slot.seq.store(kSlotBusy, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.host_id.store(info.host_id(), std::memory_order_relaxed);
+  slot.channel_id.store(info.channel_id(), std::memory_order_relaxed);
+  slot.block_index.store(info.block_index(), std::memory_order_relaxed);
+  slot.seq.store(seq + 1, std::memory_order_release);
+
+  indicator_->futex.fetch_add(1);
+  if (indicator_->waiters.load() > 0) {
+    Wake();
+  }
+  return true;
+}
+
+bool FutexNotifier::Listen(int timeout_ms, ReadableInfo* info) {
+  return Listen(timeout_ms, 0, 1, info);
+}
+
+bool FutexNotifier::Listen(int timeout_ms, uint32_t group, uint32_t group_num,
+                           ReadableInfo* info) {
+  if (info == nullptr) {
+    AERROR << "info nullptr.";
+    return false;
+  }
+
+  if (group_num == 0 || group_num > kRingNum || group >= group_num) {
+    AERROR << "invalid group " << group << " of " << group_num;
+    return false;
+  }
+
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(timeout_ms);
+  while (!is_shutdown_.load()) {
+    uint32_t futex_value = indicator_->futex.load();
+    for (uint32_t ring = group; ring < kRingNum; ring += group_num) {
+      if (TryRead(ring, info)) {
+        return true;
+      }
+    }
+
+    auto remain = std::chrono::duration_cast<std::chrono::microseconds>(
+                      deadline - std::chrono::steady_clock::now())
+                      .count();
+    if (remain <= 0) {
+      return false;
+    }
+    Wait(futex_value, static_cast<int>(remain));
+  }
+  return false;
+}
+
+bool FutexNotifier::TryRead(uint32_t ring_index, ReadableInfo* info) {
+  Ring& ring = indicator_->rings[ring_index];
+  uint64_t& next_seq = next_seqs_[ring_index];
+  while (1) {
+    uint64_t head = ring.next_seq.load(std::memory_order_acquire);
+    if (next_seq == head) {
+      return false;
+    }
+    if (head - next_seq > kRingLength) {
+      AWARN << "ring " << ring_index << " overrun, skip "
+            << head - next_seq - kRingLength << " notifications.";
+      next_seq = head - kRingLength;
+    }
+
+    Slot& slot = ring.slots[next_seq % kRingLength];
+    uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq == kSlotBusy || seq < next_seq + 1) {
+      ADEBUG << "seq[" << next_seq << "] is writing, can not read now.";
+      return false;
+    }
+    if (seq > next_seq + 1) {
+      // the slot was reused by a later lap, catch up with the writers
+      next_seq = seq - 1;
+      continue;
+    }
+
+    uint64_t host_id = slot.host_id.load(std::memory_order_relaxed);
+    uint64_t channel_id = slot.channel_id.load(std::memory_order_relaxed);
+    uint32_t block_index = slot.block_index.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq) {
+      continue;
+    }
+
+    info->set_host_id(host_id);
+    info->set_channel_id(channel_id);
+    info->set_block_index(block_index);
+    ++next_seq;
+    return true;
+  }
+}
+
+void FutexNotifier::Wait(uint32_t futex_value, int timeout_us) {
+  struct timespec timeout;
+  timeout.tv_sec = timeout_us / 1000000;
+  timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+  indicator_->waiters.fetch_add(1);
+  Futex(&indicator_->futex, FUTEX_WAIT, futex_value, &timeout);
+  indicator_->waiters.fetch_sub(1);
+}
+
+void FutexNotifier::Wake() {
+  if (indicator_ == nullptr) {
+    return;
+  }
+  Futex(&indicator_->futex, FUTEX_WAKE, INT_MAX, nullptr);
+}
+
+bool FutexNotifier::Init() { return OpenOrCreate(); }
+
+bool FutexNotifier::OpenOrCreate() {
+  // create managed_shm_
+  int retry = 0;
+  int shmid = 0;
+  while (retry < 2) {
+    shmid = shmget(key_, shm_size_, 0644 | IPC_CREAT | IPC_EXCL);
+    if (shmid != -1) {
+      break;
+    }
+
+    if (EINVAL == errno) {
+      AINFO << "need larger space, recreate.";
+      Reset();
+      Remove();
+      ++retry;
+    } else if (EEXIST == errno) {
+      ADEBUG << "shm already exist, open only.";
+      return OpenOnly();
+    } else {
+      break;
+    }
+  }
+
+  if (shmid == -1) {
+    AERROR << "create shm failed, error code: " << strerror(errno);
+    return false;
+  }
+
+  // attach managed_shm_
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed.";
+    managed_shm_ = nullptr;
+    shmctl(shmid, IPC_RMID, 0);
+    return false;
+  }
+
+  // create indicator_
+  indicator_ = new (managed_shm_) Indicator();
+
+  ADEBUG << "open or create true.";
+  return true;
+}
+
+bool FutexNotifier::OpenOnly() {
+  // get managed_shm_
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1) {
+    AERROR << "get shm failed, error: " << strerror(errno);
+    return false;
+  }
+
+  // attach managed_shm_
+  managed_shm_ = shmat(shmid, nullptr, 0);
+  if (managed_shm_ == reinterpret_cast<void*>(-1)) {
+    AERROR << "attach shm failed, error: " << strerror(errno);
+    managed_shm_ = nullptr;
+    return false;
+  }
+
+  // get indicator_
+  indicator_ = reinterpret_cast<Indicator*>(managed_shm_);
+
+  ADEBUG << "open true.";
+  return true;
+}
+
+bool FutexNotifier::Remove() {
+  int shmid = shmget(key_, 0, 0644);
+  if (shmid == -1 || shmctl(shmid, IPC_RMID, 0) == -1) {
+    AERROR << "remove shm failed, error code: " << strerror(errno);
+    return false;
+  }
+  ADEBUG << "remove success.";
+
+  return true;
+}
+
+void FutexNotifier::Reset() {
+  indicator_ = nullptr;
+  if (managed_shm_ != nullptr) {
+    shmdt(managed_shm_);
+    managed_shm_ = nullptr;
+  }
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#ifndef CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
+#define CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
+
+#include <sys/types.h>
+#include <atomic>
+#include <cstdint>
+
+#include "cyber/common/macros.h"
+#include "cyber/transport/shm/notifier_base.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+/**
+ * @class FutexNotifier
+ * @brief Host-wide notifier made of kRingNum lock-free rings in shared memory.
+ * Any number of writers publish into the ring selected by the channel id, and
+ * every process reads all rings it listens on with its own cursors, so the
+ * rings are multi-producer / multi-consumer without any lock. Idle listeners
+ * sleep on a shared futex instead of polling, and writers only pay for the
+ * wake-up syscall when somebody is actually sleeping.
+ *
+ * Channels are split into groups by ring, which lets a dispatcher run one
+ * listening thread per group (see Listen with a group).
+ */
+class FutexNotifier : public NotifierBase {
+ public:
+  static const uint32_t kRingNum = 8;
+  static const uint32_t kRingLength = 4096;
+
+ private:
+  struct Slot {
+    // sequence number + 1 of the published entry, kSlotBusy while written
+    std::atomic<uint64_t> seq = {0};
+    std::atomic<uint64_t> host_id = {0};
+    std::atomic<uint64_t> channel_id = {0};
+    std::atomic<uint32_t> block_index = {0};
+  };
+
+  struct Ring {
+    alignas(64) std::atomic<uint64_t> next_seq = {0};
+    Slot slots[kRingLength];
+  };
+
+  struct Indicator {
+    alignas(64) std::atomic<uint32_t> futex = {0};
+    alignas(64) std::atomic<uint32_t> waiters = {0};
+    Ring rings[kRingNum];
+  };
+
+ public:
+  virtual ~FutexNotifier();
+
+  void Shutdown() override;
+  bool Notify(const ReadableInfo& info) override;
+  bool Listen(int timeout_ms, ReadableInfo* info) override;
+
+  /**
+   * @brief Listen only on the rings of one channel group. Groups must be
+   * listened on by a single thread each, as the cursors are not shared.
+   *
+   * @param group index of the group, in [0, group_num)
+   * @param group_num total number of groups, at most kRingNum
+   */
+  bool Listen(int timeout_ms, uint32_t group, uint32_t group_num,
+              ReadableInfo* info);
+
+  static uint32_t RingIndex(uint64_t channel_id) {
+    return static_cast<uint32_t>(channel_id % kRingNum);
+  }
+
+  static const char* Type() { return "futex"; }
+
+ private:
+  bool Init();
+  bool OpenOrCreate();
+  bool OpenOnly();
+  bool Remove();
+  void Reset();
+
+  bool TryRead(uint32_t ring_index, ReadableInfo* info);
+  void Wait(uint32_t futex_value, int timeout_us);
+  void Wake();
+
+  key_t key_ = 0;
+  void* managed_shm_ = nullptr;
+  size_t shm_size_ = 0;
+  Indicator* indicator_ = nullptr;
+  uint64_t next_seqs_[kRingNum] = {0};
+  std::atomic<bool> is_shutdown_ = {false};
+
+  DECLARE_SINGLETON(FutexNotifier)
+};
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+#endif  // CYBER_TRANSPORT_SHM_FUTEX_NOTIFIER_H_
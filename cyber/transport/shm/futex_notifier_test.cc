@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/futex_notifier.h"
+
+#include <thread>
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+TEST(FutexNotifierTest, constructor) {
+  auto notifier = FutexNotifier::Instance();
+  EXPECT_NE(notifier, nullptr);
+}
+
+TEST(FutexNotifierTest, notify_listen) {
+  auto notifier = FutexNotifier::Instance();
+  ReadableInfo readable_info;
+  while (notifier->Listen(10, &readable_info)) {
+  }
+  EXPECT_FALSE(notifier->Listen(10, &readable_info));
+  EXPECT_TRUE(notifier->Notify(ReadableInfo(1, 2, 3)));
+  EXPECT_TRUE(notifier->Listen(10, &readable_info));
+  EXPECT_EQ(readable_info.host_id(), 1);
+  EXPECT_EQ(readable_info.block_index(), 2);
+  EXPECT_EQ(readable_info.channel_id(), 3);
+  EXPECT_FALSE(notifier->Listen(10, &readable_info));
+  EXPECT_TRUE(notifier->Notify(readable_info));
+  EXPECT_TRUE(notifier->Notify(readable_info));
+  EXPECT_TRUE(notifier->Listen(10, &readable_info));
+  EXPECT_TRUE(notifier->Listen(10, &readable_info));
+  EXPECT_FALSE(notifier->Listen(10, &readable_info));
+}
+
+TEST(FutexNotifierTest, listen_group) {
+  auto notifier = FutexNotifier::Instance();
+  ReadableInfo readable_info;
+  while (notifier->Listen(10, &readable_info)) {
+  }
+
+  const uint32_t group_num = 2;
+  uint64_t channel_id = 5;
+  uint32_t group = FutexNotifier::RingIndex(channel_id) % group_num;
+  EXPECT_TRUE(notifier->Notify(ReadableInfo(1, 0, channel_id)));
+  EXPECT_FALSE(notifier->Listen(10, 1 - group, group_num, &readable_info));
+  EXPECT_TRUE(notifier->Listen(10, group, group_num, &readable_info));
+  EXPECT_EQ(readable_info.channel_id(), channel_id);
+  EXPECT_FALSE(notifier->Listen(10, group, 0, &readable_info));
+}
+
+TEST(FutexNotifierTest, wake_up) {
+  auto notifier = FutexNotifier::Instance();
+  ReadableInfo readable_info;
+  while (notifier->Listen(10, &readable_info)) {
+  }
+
+  std::thread writer([notifier]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    notifier->Notify(ReadableInfo(1, 7, 9));
+  });
+  EXPECT_TRUE(notifier->Listen(1000, &readable_info));
+  EXPECT_EQ(readable_info.block_index(), 7);
+  writer.join();
+}
+
+TEST(FutexNotifierTest, shutdown) {
+  auto notifier = FutexNotifier::Instance();
+  notifier->Shutdown();
+  ReadableInfo readable_info;
+  EXPECT_FALSE(notifier->Notify(readable_info));
+  EXPECT_FALSE(notifier->Listen(100, &readable_info));
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares the shared memory notifiers. The multicast notifier is left out,
+// its cost is dominated by the UDP socket round trip.
+//
+// bazel run //cyber/transport:notifier_benchmark
+
+#include <atomic>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/transport/shm/condition_notifier.h"
+#include "cyber/transport/shm/futex_notifier.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+template <typename Notifier>
+void Drain(Notifier* notifier) {
+  ReadableInfo info;
+  while (notifier->Listen(0, &info)) {
+  }
+}
+
+// Notify and read back on the same thread: the raw ring cost.
+template <typename Notifier>
+void BM_NotifyListen(benchmark::State& state) {
+  auto notifier = Notifier::Instance();
+  Drain(notifier);
+  ReadableInfo info(1, 0, 2);
+  for (auto _ : state) {
+    notifier->Notify(info);
+    notifier->Listen(100, &info);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_NotifyListen, ConditionNotifier);
+BENCHMARK_TEMPLATE(BM_NotifyListen, FutexNotifier);
+
+// Concurrent writers on different channels, nobody listening.
+template <typename Notifier>
+void BM_Notify(benchmark::State& state) {
+  auto notifier = Notifier::Instance();
+  ReadableInfo info(1, 0, state.thread_index());
+  for (auto _ : state) {
+    notifier->Notify(info);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Notify, ConditionNotifier)->ThreadRange(1, 8);
+BENCHMARK_TEMPLATE(BM_Notify, FutexNotifier)->ThreadRange(1, 8);
+
+// Wake-up latency of an idle listener thread: each iteration notifies and
+// waits until the listener has seen the notification.
+template <typename Notifier>
+void BM_WakeUpLatency(benchmark::State& state) {
+  auto notifier = Notifier::Instance();
+  Drain(notifier);
+  std::atomic<uint64_t> received = {0};
+  std::atomic<bool> stop = {false};
+  std::thread listener([&]() {
+    ReadableInfo info;
+    while (!stop.load()) {
+      if (notifier->Listen(100, &info)) {
+        received.fetch_add(1);
+      }
+    }
+  });
+
+  uint64_t sent = 0;
+  for (auto _ : state) {
+    notifier->Notify(ReadableInfo(1, 0, 3));
+    ++sent;
+    while (received.load() < sent) {
+    }
+  }
+  stop.store(true);
+  listener.join();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_WakeUpLatency, ConditionNotifier)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_WakeUpLatency, FutexNotifier)->UseRealTime();
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -19,6 +19,8 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
 
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
@@ -30,10 +32,59 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+namespace {
+
+// from linux/magic.h
+constexpr int64_t kHugetlbfsMagic = 0x958458f6;
+
+}  // namespace
+
 PosixSegment::PosixSegment(uint64_t channel_id) : Segment(channel_id) {
   shm_name_ = std::to_string(channel_id);
 }
 
+std::string PosixSegment::HugetlbfsPath() const {
+  return conf_.segment_options().hugetlbfs_dir + "/cyber_shm_" + shm_name_;
+}
+
+void* PosixSegment::MapHugetlbfsFile(uint64_t* size) {
+  // a file left by a writer which crashed is reused, the shm object having
+  // been created by this writer
+  std::string path = HugetlbfsPath();
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    AWARN << "create " << path
+          << " failed, use normal pages: " << strerror(errno);
+    return nullptr;
+  }
+  struct statfs fs_attr;
+  if (fstatfs(fd, &fs_attr) < 0 || fs_attr.f_type != kHugetlbfsMagic) {
+    AWARN << conf_.segment_options().hugetlbfs_dir
+          << " is no hugetlbfs mount, use normal pages.";
+    close(fd);
+    unlink(path.c_str());
+    return nullptr;
+  }
+  // hugetlbfs maps whole huge pages only, and reserves them at mmap
+  uint64_t page_size = fs_attr.f_bsize;
+  uint64_t huge_size = (*size + page_size - 1) / page_size * page_size;
+  void* addr = MAP_FAILED;
+  if (ftruncate(fd, huge_size) == 0) {
+    addr = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd,
+                0);
+  }
+  if (addr == MAP_FAILED) {
+    AWARN << "map " << path << " failed, use normal pages: "
+          << strerror(errno);
+    close(fd);
+    unlink(path.c_str());
+    return nullptr;
+  }
+  close(fd);
+  *size = huge_size;
+  return addr;
+}
+
 PosixSegment::~PosixSegment() { Destroy(); }
 
 bool PosixSegment::OpenOrCreate() {
@@ -41,7 +92,10 @@ bool PosixSegment::OpenOrCreate() {
     return true;
   }
 
-  // create managed_shm_
+  // create managed_shm_, the shm object is created whatever the backing so
+  // that a writer with other options opens this segment rather than making
+  // its own
+  uint64_t shm_size = conf_.managed_shm_size();
   int fd = shm_open(shm_name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
   if (fd < 0) {
     if (EEXIST == errno) {
@@ -52,32 +106,45 @@ bool PosixSegment::OpenOrCreate() {
       return false;
     }
   }
-
-  if (ftruncate(fd, conf_.managed_shm_size()) < 0) {
-    AERROR << "ftruncate failed: " << strerror(errno);
-    close(fd);
-    return false;
+  huge_file_ = false;
+  managed_shm_ = nullptr;
+  if (conf_.segment_options().huge_pages) {
+    // the shm object stays empty, which points the readers to hugetlbfs
+    managed_shm_ = MapHugetlbfsFile(&shm_size);
+    huge_file_ = managed_shm_ != nullptr;
   }
 
-  // attach managed_shm_
-  managed_shm_ = mmap(nullptr, conf_.managed_shm_size(), PROT_READ | PROT_WRITE,
-                      MAP_SHARED, fd, 0);
-  if (managed_shm_ == MAP_FAILED) {
-    AERROR << "attach shm failed:" << strerror(errno);
-    close(fd);
-    shm_unlink(shm_name_.c_str());
-    return false;
+  if (!huge_file_) {
+    if (ftruncate(fd, shm_size) < 0) {
+      AERROR << "ftruncate failed: " << strerror(errno);
+      close(fd);
+      Remove();
+      return false;
+    }
+
+    // attach managed_shm_
+    managed_shm_ =
+        mmap(nullptr, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (managed_shm_ == MAP_FAILED) {
+      AERROR << "attach shm failed:" << strerror(errno);
+      managed_shm_ = nullptr;
+      close(fd);
+      Remove();
+      return false;
+    }
   }
+  mapped_size_ = shm_size;
 
   close(fd);
+  PrepareMemory(managed_shm_, shm_size, !huge_file_);
 
   // create field state_
   state_ = new (managed_shm_) State(conf_.ceiling_msg_size());
   if (state_ == nullptr) {
     AERROR << "create state failed.";
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
-    shm_unlink(shm_name_.c_str());
+    Remove();
     return false;
   }
 
@@ -90,9 +157,9 @@ bool PosixSegment::OpenOrCreate() {
     AERROR << "create blocks failed.";
     state_->~State();
     state_ = nullptr;
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
-    shm_unlink(shm_name_.c_str());
+    Remove();
     return false;
   }
 
@@ -121,13 +188,16 @@ bool PosixSegment::OpenOrCreate() {
       std::lock_guard<std::mutex> lg(block_buf_lock_);
       block_buf_addrs_.clear();
     }
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
-    shm_unlink(shm_name_.c_str());
+    Remove();
     return false;
   }
 
   state_->IncreaseReferenceCounts();
+  uint64_t mapped_size = mapped_size_;
+  mapping_.reset(managed_shm_,
+                 [mapped_size](void* addr) { munmap(addr, mapped_size); });
   init_ = true;
   return true;
 }
@@ -151,21 +221,41 @@ bool PosixSegment::OpenOnly() {
     return false;
   }
 
+  huge_file_ = false;
+  if (file_attr.st_size == 0) {
+    // created on hugetlbfs by a writer with huge pages
+    close(fd);
+    std::string path = HugetlbfsPath();
+    fd = open(path.c_str(), O_RDWR);
+    if (fd == -1) {
+      AERROR << "get shm " << path << " failed: " << strerror(errno);
+      return false;
+    }
+    if (fstat(fd, &file_attr) < 0 || file_attr.st_size == 0) {
+      AERROR << "shm " << path << " is not ready.";
+      close(fd);
+      return false;
+    }
+    huge_file_ = true;
+  }
+
   // attach managed_shm_
   managed_shm_ = mmap(nullptr, file_attr.st_size, PROT_READ | PROT_WRITE,
                       MAP_SHARED, fd, 0);
   if (managed_shm_ == MAP_FAILED) {
     AERROR << "attach shm failed: " << strerror(errno);
+    managed_shm_ = nullptr;
     close(fd);
     return false;
   }
+  mapped_size_ = file_attr.st_size;
 
   close(fd);
   // get field state_
   state_ = reinterpret_cast<State*>(managed_shm_);
   if (state_ == nullptr) {
     AERROR << "get state failed.";
-    munmap(managed_shm_, file_attr.st_size);
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
     return false;
   }
@@ -178,7 +268,7 @@ bool PosixSegment::OpenOnly() {
   if (blocks_ == nullptr) {
     AERROR << "get blocks failed.";
     state_ = nullptr;
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
     return false;
   }
@@ -203,24 +293,32 @@ bool PosixSegment::OpenOnly() {
       std::lock_guard<std::mutex> lg(block_buf_lock_);
       block_buf_addrs_.clear();
     }
-    munmap(managed_shm_, conf_.managed_shm_size());
+    munmap(managed_shm_, mapped_size_);
     managed_shm_ = nullptr;
-    shm_unlink(shm_name_.c_str());
+    Remove();
     return false;
   }
 
   state_->IncreaseReferenceCounts();
+  uint64_t mapped_size = mapped_size_;
+  mapping_.reset(managed_shm_,
+                 [mapped_size](void* addr) { munmap(addr, mapped_size); });
   init_ = true;
   ADEBUG << "open only true.";
   return true;
 }
 
 bool PosixSegment::Remove() {
+  bool result = true;
+  if (huge_file_ && unlink(HugetlbfsPath().c_str()) < 0) {
+    AERROR << "unlink " << HugetlbfsPath() << " failed: " << strerror(errno);
+    result = false;
+  }
   if (shm_unlink(shm_name_.c_str()) < 0) {
     AERROR << "shm_unlink failed: " << strerror(errno);
-    return false;
+    result = false;
   }
-  return true;
+  return result;
 }
 
 void PosixSegment::Reset() {
@@ -230,11 +328,9 @@ void PosixSegment::Reset() {
     std::lock_guard<std::mutex> lg(block_buf_lock_);
     block_buf_addrs_.clear();
   }
-  if (managed_shm_ != nullptr) {
-    munmap(managed_shm_, conf_.managed_shm_size());
-    managed_shm_ = nullptr;
-    return;
-  }
+  // unmapped once the blocks still held are released too
+  managed_shm_ = nullptr;
+  mapping_ = nullptr;
 }
 
 }  // namespace transport
@@ -38,7 +38,17 @@ class PosixSegment : public Segment {
   bool OpenOnly() override;
   bool OpenOrCreate() override;
 
+  // Creates and maps the segment file on hugetlbfs, rounding size up to its
+  // page size. nullptr if there is no hugetlbfs or no huge page left.
+  void* MapHugetlbfsFile(uint64_t* size);
+  std::string HugetlbfsPath() const;
+
   std::string shm_name_;
+  // Whether the segment is a file of hugetlbfs rather than the shm object.
+  // The shm object is created either way, so that all writers of a channel
+  // agree on a single segment, and left empty for a hugetlbfs segment.
+  bool huge_file_ = false;
+  uint64_t mapped_size_ = 0;
 };
 
 }  // namespace transport
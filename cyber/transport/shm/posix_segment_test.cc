@@ -0,0 +1,197 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/posix_segment.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+uint64_t TestChannelId(uint64_t seed) {
+  return (static_cast<uint64_t>(getpid()) << 16) + seed;
+}
+
+class OptionSegment : public PosixSegment {
+ public:
+  OptionSegment(uint64_t channel_id, const SegmentOptions& options)
+      : PosixSegment(channel_id) {
+    conf_.set_segment_options(options);
+  }
+};
+
+// Size of the shm object of the channel, -1 if there is none.
+int64_t ShmObjectSize(uint64_t channel_id) {
+  int fd = shm_open(std::to_string(channel_id).c_str(), O_RDONLY, 0644);
+  if (fd < 0) {
+    return -1;
+  }
+  struct stat file_attr;
+  int64_t size = fstat(fd, &file_attr) == 0 ? file_attr.st_size : -1;
+  close(fd);
+  return size;
+}
+
+bool WriteString(Segment* segment, const std::string& str, uint32_t* index) {
+  WritableBlock wb;
+  if (!segment->AcquireBlockToWrite(str.size(), &wb)) {
+    return false;
+  }
+  memcpy(wb.buf, str.data(), str.size());
+  wb.block->set_msg_size(str.size());
+  segment->ReleaseWrittenBlock(wb);
+  *index = wb.index;
+  return true;
+}
+
+TEST(PosixSegmentTest, held_blocks_survive_recreate) {
+  uint64_t channel_id = TestChannelId(1);
+  PosixSegment writer(channel_id);
+  PosixSegment reader(channel_id);
+
+  uint32_t small_index = 0;
+  ASSERT_TRUE(WriteString(&writer, "small", &small_index));
+  ReadableBlock rb;
+  rb.index = small_index;
+  ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+  WritableBlock loan;
+  ASSERT_TRUE(writer.AcquireBlockToWrite(5, &loan));
+  EXPECT_TRUE(writer.IsCurrent(loan));
+
+  // too large for the segment, the writer recreates it and the reader
+  // remaps on its next read
+  std::string large(200 * 1024, 'x');
+  uint32_t large_index = 0;
+  ASSERT_TRUE(WriteString(&writer, large, &large_index));
+  ReadableBlock large_rb;
+  large_rb.index = large_index;
+  ASSERT_TRUE(reader.AcquireBlockToRead(&large_rb));
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(large_rb.buf),
+                        large_rb.block->msg_size()),
+            large);
+  reader.ReleaseReadBlock(large_rb);
+
+  // the blocks taken before are still mapped
+  EXPECT_FALSE(writer.IsCurrent(loan));
+  memcpy(loan.buf, "loan", 4);
+  writer.ReleaseWrittenBlock(loan);
+  EXPECT_EQ(std::string(reinterpret_cast<char*>(rb.buf), 5), "small");
+  reader.ReleaseReadBlock(rb);
+}
+
+TEST(PosixSegmentTest, write_fails_when_readers_hold_all_blocks) {
+  uint64_t channel_id = TestChannelId(2);
+  PosixSegment writer(channel_id);
+  PosixSegment reader(channel_id);
+
+  const uint32_t block_num = ShmConf(5).block_num();
+  std::vector<ReadableBlock> held(block_num);
+  for (auto& rb : held) {
+    ASSERT_TRUE(WriteString(&writer, "block", &rb.index));
+    ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+  }
+  uint32_t index = 0;
+  EXPECT_FALSE(WriteString(&writer, "block", &index));
+
+  reader.ReleaseReadBlock(held.back());
+  EXPECT_TRUE(WriteString(&writer, "block", &index));
+  EXPECT_EQ(held.back().index, index);
+  held.pop_back();
+  for (const auto& rb : held) {
+    reader.ReleaseReadBlock(rb);
+  }
+}
+
+TEST(PosixSegmentTest, writers_with_other_options_share_segment) {
+  SegmentOptions huge_pages;
+  huge_pages.huge_pages = true;
+  for (bool huge_pages_first : {true, false}) {
+    uint64_t channel_id = TestChannelId(huge_pages_first ? 3 : 4);
+    OptionSegment huge_writer(channel_id, huge_pages);
+    OptionSegment writer(channel_id, SegmentOptions());
+    PosixSegment reader(channel_id);
+
+    // whichever creates the segment, the other one writes to it as well
+    Segment* first = huge_pages_first ? &huge_writer : &writer;
+    Segment* second = huge_pages_first ? &writer : &huge_writer;
+    uint32_t first_index = 0;
+    uint32_t second_index = 0;
+    ASSERT_TRUE(WriteString(first, "first", &first_index));
+    ASSERT_TRUE(WriteString(second, "second", &second_index));
+    ASSERT_NE(first_index, second_index);
+
+    ReadableBlock rb;
+    rb.index = first_index;
+    ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(rb.buf), 5), "first");
+    reader.ReleaseReadBlock(rb);
+    rb.index = second_index;
+    ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+    EXPECT_EQ(std::string(reinterpret_cast<char*>(rb.buf), 6), "second");
+    reader.ReleaseReadBlock(rb);
+  }
+}
+
+TEST(PosixSegmentTest, huge_pages_fall_back_to_normal_pages) {
+  char dir[] = "/tmp/posix_segment_test_XXXXXX";
+  ASSERT_NE(mkdtemp(dir), nullptr);
+  SegmentOptions not_hugetlbfs;
+  not_hugetlbfs.huge_pages = true;
+  not_hugetlbfs.hugetlbfs_dir = dir;
+  SegmentOptions no_dir;
+  no_dir.huge_pages = true;
+  no_dir.hugetlbfs_dir = std::string(dir) + "/missing";
+
+  uint64_t seed = 5;
+  for (const auto& options : {not_hugetlbfs, no_dir}) {
+    uint64_t channel_id = TestChannelId(seed++);
+    {
+      OptionSegment writer(channel_id, options);
+      PosixSegment reader(channel_id);
+      uint32_t index = 0;
+      ASSERT_TRUE(WriteString(&writer, "normal", &index));
+
+      // the shm object holds the segment, nothing is left in the directory
+      EXPECT_GT(ShmObjectSize(channel_id), 0);
+      std::string huge_file =
+          options.hugetlbfs_dir + "/cyber_shm_" + std::to_string(channel_id);
+      EXPECT_NE(access(huge_file.c_str(), F_OK), 0);
+
+      ReadableBlock rb;
+      rb.index = index;
+      ASSERT_TRUE(reader.AcquireBlockToRead(&rb));
+      EXPECT_EQ(std::string(reinterpret_cast<char*>(rb.buf), 6), "normal");
+      reader.ReleaseReadBlock(rb);
+    }
+    // removed with the last user
+    EXPECT_EQ(ShmObjectSize(channel_id), -1);
+  }
+  rmdir(dir);
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
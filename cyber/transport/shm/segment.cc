@@ -16,6 +16,18 @@
 
 #include "cyber/transport/shm/segment.h"
 
+#include <dirent.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
 #include "cyber/common/log.h"
 #include "cyber/common/util.h"
 #include "cyber/transport/shm/shm_conf.h"
@@ -24,6 +36,67 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+const uint32_t Segment::kMaxWriteLockRounds;
+
+namespace {
+
+// from linux/mempolicy.h
+constexpr int kMpolPreferred = 1;
+
+int NumaNodeOfCpu(int cpu) {
+  std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+  DIR* dir = opendir(path.c_str());
+  if (dir == nullptr) {
+    return -1;
+  }
+  int node = -1;
+  while (struct dirent* entry = readdir(dir)) {
+    if (std::strncmp(entry->d_name, "node", 4) == 0) {
+      node = std::atoi(entry->d_name + 4);
+      break;
+    }
+  }
+  closedir(dir);
+  return node;
+}
+
+// The node of all the cpus the calling thread may run on, -1 if they span
+// several nodes.
+int NumaNodeOfThread() {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+    return -1;
+  }
+  int node = -1;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (!CPU_ISSET(cpu, &set)) {
+      continue;
+    }
+    int cpu_node = NumaNodeOfCpu(cpu);
+    if (cpu_node < 0 || (node >= 0 && cpu_node != node)) {
+      return -1;
+    }
+    node = cpu_node;
+  }
+  return node;
+}
+
+// Whether tmpfs backs memory advised with MADV_HUGEPAGE by huge pages.
+bool ShmemHugePagesAdvisable() {
+  static const bool advisable = []() {
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/shmem_enabled");
+    std::string modes;
+    std::getline(file, modes);
+    return modes.find("[advise]") != std::string::npos ||
+           modes.find("[always]") != std::string::npos ||
+           modes.find("[within_size]") != std::string::npos;
+  }();
+  return advisable;
+}
+
+}  // namespace
+
 Segment::Segment(uint64_t channel_id)
     : init_(false),
       conf_(),
@@ -34,6 +107,47 @@ Segment::Segment(uint64_t channel_id)
       block_buf_lock_(),
       block_buf_addrs_() {}
 
+void Segment::PrepareMemory(void* addr, uint64_t size,
+                            bool advise_huge_pages) {
+  const SegmentOptions& options = conf_.segment_options();
+  if (options.huge_pages && advise_huge_pages) {
+    if (!ShmemHugePagesAdvisable()) {
+      AWARN_EVERY(100) << "shm uses normal pages, transparent huge pages "
+                          "of shmem are disabled, see /sys/kernel/mm/"
+                          "transparent_hugepage/shmem_enabled.";
+    } else if (madvise(addr, size, MADV_HUGEPAGE) != 0) {
+      AWARN << "madvise huge pages failed: " << strerror(errno);
+    }
+  }
+
+  int node = options.numa_auto ? NumaNodeOfThread() : options.numa_node;
+  if (node >= 0) {
+    // preferred rather than bound, so that a full node does not fail writes
+    unsigned long nodemask[16] = {0};  // NOLINT
+    constexpr int kBitsPerMask = 8 * sizeof(nodemask[0]);
+    if (node < 16 * kBitsPerMask) {
+      nodemask[node / kBitsPerMask] = 1UL << (node % kBitsPerMask);
+      if (syscall(SYS_mbind, addr, size, kMpolPreferred, nodemask,
+                  16 * kBitsPerMask, 0) != 0) {
+        AWARN << "bind shm to numa node " << node
+              << " failed: " << strerror(errno);
+      }
+    }
+  } else if (options.numa_auto) {
+    ADEBUG << "writer cpus span several numa nodes, shm is not bound.";
+  }
+
+  if (options.populate) {
+    // the pages are zero already; writing them faults them in with the
+    // policy above, which MAP_POPULATE at mmap time would not
+    const long page_size = sysconf(_SC_PAGESIZE);  // NOLINT
+    auto begin = static_cast<volatile char*>(addr);
+    for (uint64_t offset = 0; offset < size; offset += page_size) {
+      begin[offset] = 0;
+    }
+  }
+}
+
 bool Segment::AcquireBlockToWrite(std::size_t msg_size,
                                   WritableBlock* writable_block) {
   RETURN_VAL_IF_NULL(writable_block, false);
@@ -59,19 +173,30 @@ bool Segment::AcquireBlockToWrite(std::size_t msg_size,
     return false;
   }
 
-  uint32_t index = GetNextWritableBlockIndex();
+  uint32_t index = 0;
+  if (!GetNextWritableBlockIndex(&index)) {
+    AERROR << "all " << conf_.block_num()
+           << " blocks are locked by readers, can't write now.";
+    return false;
+  }
   writable_block->index = index;
   writable_block->block = &blocks_[index];
   writable_block->buf = block_buf_addrs_[index];
+  writable_block->mapping = mapping_;
+  writable_block->generation = generation_.load();
   return true;
 }
 
 void Segment::ReleaseWrittenBlock(const WritableBlock& writable_block) {
-  auto index = writable_block.index;
-  if (index >= conf_.block_num()) {
+  ReleaseWriteLock(writable_block);
+}
+
+void Segment::ReleaseWriteLock(const WritableBlock& writable_block) {
+  // the block may belong to a mapping replaced since, kept by the handle
+  if (writable_block.block == nullptr) {
     return;
   }
-  blocks_[index].ReleaseWriteLock();
+  writable_block.block->ReleaseWriteLock();
 }
 
 bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
@@ -102,15 +227,17 @@ bool Segment::AcquireBlockToRead(ReadableBlock* readable_block) {
   }
   readable_block->block = blocks_ + index;
   readable_block->buf = block_buf_addrs_[index];
+  readable_block->mapping = mapping_;
+  readable_block->generation = generation_.load();
   return true;
 }
 
 void Segment::ReleaseReadBlock(const ReadableBlock& readable_block) {
-  auto index = readable_block.index;
-  if (index >= conf_.block_num()) {
+  // the block may belong to a mapping replaced since, kept by the handle
+  if (readable_block.block == nullptr) {
     return;
   }
-  blocks_[index].ReleaseReadLock();
+  readable_block.block->ReleaseReadLock();
 }
 
 bool Segment::Destroy() {
@@ -135,6 +262,7 @@ bool Segment::Destroy() {
 
 bool Segment::Remap() {
   init_ = false;
+  generation_.fetch_add(1);
   ADEBUG << "before reset.";
   Reset();
   ADEBUG << "after reset.";
@@ -143,6 +271,7 @@ bool Segment::Remap() {
 
 bool Segment::Recreate(const uint64_t& msg_size) {
   init_ = false;
+  generation_.fetch_add(1);
   state_->set_need_remap(true);
   Reset();
   Remove();
@@ -150,15 +279,16 @@ bool Segment::Recreate(const uint64_t& msg_size) {
   return OpenOrCreate();
 }
 
-uint32_t Segment::GetNextWritableBlockIndex() {
+bool Segment::GetNextWritableBlockIndex(uint32_t* index) {
   const auto block_num = conf_.block_num();
-  while (1) {
+  for (uint32_t i = 0; i < kMaxWriteLockRounds * block_num; ++i) {
     uint32_t try_idx = state_->FetchAddSeq(1) % block_num;
     if (blocks_[try_idx].TryLockForWrite()) {
-      return try_idx;
+      *index = try_idx;
+      return true;
     }
   }
-  return 0;
+  return false;
 }
 
 }  // namespace transport
@@ -17,6 +17,7 @@
 #ifndef CYBER_TRANSPORT_SHM_SEGMENT_H_
 #define CYBER_TRANSPORT_SHM_SEGMENT_H_
 
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -37,6 +38,10 @@ struct WritableBlock {
   uint32_t index = 0;
   Block* block = nullptr;
   uint8_t* buf = nullptr;
+  // Keeps block and buf mapped while the block is held, even if the segment
+  // is remapped in the meantime.
+  std::shared_ptr<void> mapping = nullptr;
+  uint64_t generation = 0;
 };
 using ReadableBlock = WritableBlock;
 
@@ -45,11 +50,30 @@ class Segment {
   explicit Segment(uint64_t channel_id);
   virtual ~Segment() {}
 
-  bool AcquireBlockToWrite(std::size_t msg_size, WritableBlock* writable_block);
-  void ReleaseWrittenBlock(const WritableBlock& writable_block);
+  // Fails if no block can be write-locked, i.e. readers hold all of them.
+  virtual bool AcquireBlockToWrite(std::size_t msg_size,
+                                   WritableBlock* writable_block);
+  virtual void ReleaseWrittenBlock(const WritableBlock& writable_block);
+  // Releases a write lock in the mapping held by the block, which works even
+  // once the segment it was acquired from is gone.
+  static void ReleaseWriteLock(const WritableBlock& writable_block);
 
-  bool AcquireBlockToRead(ReadableBlock* readable_block);
-  void ReleaseReadBlock(const ReadableBlock& readable_block);
+  virtual bool AcquireBlockToRead(ReadableBlock* readable_block);
+  virtual void ReleaseReadBlock(const ReadableBlock& readable_block);
+
+  // Bumped every time the blocks are remapped. Read locks taken under an
+  // older generation refer to a mapping that no longer exists.
+  uint64_t generation() const { return generation_.load(); }
+
+  // Whether the block belongs to the current mapping, so that its index
+  // means the same to the readers.
+  bool IsCurrent(const WritableBlock& block) const {
+    return block.generation == generation_.load();
+  }
+
+  // Rounds over all the blocks a writer tries before giving up on
+  // write-locking one.
+  static const uint32_t kMaxWriteLockRounds = 2;
 
  protected:
   virtual bool Destroy();
@@ -58,6 +82,11 @@ class Segment {
   virtual bool OpenOnly() = 0;
   virtual bool OpenOrCreate() = 0;
 
+  // Applies conf_.segment_options() to memory just created and mapped,
+  // before anything is written to it. advise_huge_pages is false when the
+  // memory already is backed by huge pages.
+  void PrepareMemory(void* addr, uint64_t size, bool advise_huge_pages);
+
   bool init_;
   ShmConf conf_;
   uint64_t channel_id_;
@@ -67,11 +96,15 @@ class Segment {
   void* managed_shm_;
   std::mutex block_buf_lock_;
   std::unordered_map<uint32_t, uint8_t*> block_buf_addrs_;
+  std::atomic<uint64_t> generation_ = {0};
+  // Unmaps managed_shm_ once the segment is reset and the blocks acquired
+  // before are released.
+  std::shared_ptr<void> mapping_ = nullptr;
 
  private:
   bool Remap();
   bool Recreate(const uint64_t& msg_size);
-  uint32_t GetNextWritableBlockIndex();
+  bool GetNextWritableBlockIndex(uint32_t* index);
 };
 
 }  // namespace transport
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares the backing options of the shared memory segments across message
+// sizes: writing and reading a message through warm pages, where huge pages
+// save TLB misses, and the first pass through a new segment, where the pages
+// are faulted in unless they were populated at creation.
+//
+// Huge pages need reserved pages for XSI segments, e.g.
+// echo 64 > /proc/sys/vm/nr_hugepages, and shmem_enabled set to advise for
+// POSIX ones. Numa binding only shows on machines with several nodes.
+//
+// bazel run //cyber/transport:segment_benchmark
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/transport/shm/posix_segment.h"
+#include "cyber/transport/shm/xsi_segment.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+template <typename SegmentT>
+class OptionSegment : public SegmentT {
+ public:
+  OptionSegment(uint64_t channel_id, const SegmentOptions& options)
+      : SegmentT(channel_id) {
+    this->conf_.set_segment_options(options);
+  }
+
+  uint32_t block_num() { return this->conf_.block_num(); }
+};
+
+std::vector<std::pair<std::string, SegmentOptions>> Options() {
+  std::vector<std::pair<std::string, SegmentOptions>> options(4);
+  options[0].first = "default";
+  options[1].first = "populate";
+  options[1].second.populate = true;
+  options[2].first = "huge_pages";
+  options[2].second.huge_pages = true;
+  options[3].first = "huge_pages+populate+numa";
+  options[3].second.huge_pages = true;
+  options[3].second.populate = true;
+  options[3].second.numa_auto = true;
+  return options;
+}
+
+uint64_t NextChannelId() {
+  static std::atomic<uint64_t> channel_id = {0x5e600000};
+  return channel_id.fetch_add(1);
+}
+
+template <typename SegmentT>
+bool WriteAndRead(SegmentT* segment, const std::string& msg,
+                  std::string* recv) {
+  WritableBlock wb;
+  if (!segment->AcquireBlockToWrite(msg.size(), &wb)) {
+    return false;
+  }
+  std::memcpy(wb.buf, msg.data(), msg.size());
+  wb.block->set_msg_size(msg.size());
+  segment->ReleaseWrittenBlock(wb);
+
+  ReadableBlock rb;
+  rb.index = wb.index;
+  if (!segment->AcquireBlockToRead(&rb)) {
+    return false;
+  }
+  recv->assign(reinterpret_cast<const char*>(rb.buf), rb.block->msg_size());
+  segment->ReleaseReadBlock(rb);
+  return true;
+}
+
+template <typename SegmentT>
+void BM_WriteRead(benchmark::State& state) {
+  auto option = Options()[state.range(1)];
+  OptionSegment<SegmentT> segment(NextChannelId(), option.second);
+  std::string msg(state.range(0), 'm');
+  std::string recv;
+  recv.reserve(msg.size());
+  if (!WriteAndRead(&segment, msg, &recv)) {
+    state.SkipWithError("segment unavailable");
+    return;
+  }
+  for (auto _ : state) {
+    WriteAndRead(&segment, msg, &recv);
+    benchmark::DoNotOptimize(recv.data());
+  }
+  state.SetBytesProcessed(state.iterations() * msg.size());
+  state.SetLabel(option.first);
+}
+
+// Creates a segment for the size, then times one message through every
+// block of it.
+template <typename SegmentT>
+void BM_FirstPass(benchmark::State& state) {
+  auto option = Options()[state.range(1)];
+  std::string msg(state.range(0), 'm');
+  std::string recv;
+  recv.reserve(msg.size());
+  uint64_t messages = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::unique_ptr<OptionSegment<SegmentT>> segment(
+        new OptionSegment<SegmentT>(NextChannelId(), option.second));
+    WritableBlock wb;
+    if (!segment->AcquireBlockToWrite(msg.size(), &wb)) {
+      state.SkipWithError("segment unavailable");
+      return;
+    }
+    segment->ReleaseWrittenBlock(wb);
+    uint32_t block_num = segment->block_num();
+    state.ResumeTiming();
+
+    for (uint32_t i = 1; i < block_num; ++i) {
+      WriteAndRead(segment.get(), msg, &recv);
+    }
+    messages += block_num - 1;
+
+    state.PauseTiming();
+    segment.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(messages);
+  state.SetBytesProcessed(messages * msg.size());
+  state.SetLabel(option.first);
+}
+
+void Args(benchmark::internal::Benchmark* b) {
+  for (int64_t size : {1 << 10, 64 << 10, 1 << 20, 8 << 20}) {
+    for (int64_t option = 0; option < 4; ++option) {
+      b->Args({size, option});
+    }
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_WriteRead, XsiSegment)->Apply(Args);
+BENCHMARK_TEMPLATE(BM_WriteRead, PosixSegment)->Apply(Args);
+BENCHMARK_TEMPLATE(BM_FirstPass, XsiSegment)->Apply(Args);
+BENCHMARK_TEMPLATE(BM_FirstPass, PosixSegment)->Apply(Args);
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -21,6 +21,7 @@
 
 #include "cyber/common/global_data.h"
 #include "cyber/common/log.h"
+#include "cyber/transport/shm/arena_segment.h"
 #include "cyber/transport/shm/posix_segment.h"
 #include "cyber/transport/shm/xsi_segment.h"
 
@@ -45,6 +46,10 @@ auto SegmentFactory::CreateSegment(uint64_t channel_id) -> SegmentPtr {
     return std::make_shared<PosixSegment>(channel_id);
   }
 
+  if (segment_type == ArenaSegment::Type()) {
+    return std::make_shared<ArenaSegment>(channel_id);
+  }
+
   return std::make_shared<XsiSegment>(channel_id);
 }
 
@@ -15,12 +15,59 @@
  *****************************************************************************/
 
 #include "cyber/transport/shm/shm_conf.h"
+
+#include <cstdlib>
+
 #include "cyber/common/log.h"
 
 namespace apollo {
 namespace cyber {
 namespace transport {
 
+namespace {
+
+bool EnvEnabled(const char* name) {
+  const char* value = std::getenv(name);
+  return value != nullptr && std::string(value) == "1";
+}
+
+}  // namespace
+
+SegmentOptions SegmentOptions::LoadFromEnv() {
+  SegmentOptions options;
+  options.huge_pages = EnvEnabled("CYBER_SHM_HUGE_PAGES");
+  options.populate = EnvEnabled("CYBER_SHM_POPULATE");
+  const char* hugetlbfs_dir = std::getenv("CYBER_SHM_HUGETLBFS_DIR");
+  if (hugetlbfs_dir != nullptr) {
+    options.hugetlbfs_dir = hugetlbfs_dir;
+  }
+  const char* numa_node = std::getenv("CYBER_SHM_NUMA_NODE");
+  if (numa_node != nullptr) {
+    if (std::string(numa_node) == "auto") {
+      options.numa_auto = true;
+    } else {
+      char* end = nullptr;
+      long node = std::strtol(numa_node, &end, 10);  // NOLINT
+      if (end != numa_node && *end == '\0' && node >= 0) {
+        options.numa_node = static_cast<int>(node);
+      } else {
+        AWARN << "ignore invalid CYBER_SHM_NUMA_NODE[" << numa_node << "]";
+      }
+    }
+  }
+  AINFO_IF(options.huge_pages || options.populate || numa_node != nullptr)
+      << "shm segments huge_pages[" << options.huge_pages << "] populate["
+      << options.populate << "] numa_node["
+      << (options.numa_auto ? "auto" : std::to_string(options.numa_node))
+      << "]";
+  return options;
+}
+
+const SegmentOptions& SegmentOptions::FromEnv() {
+  static const SegmentOptions options = LoadFromEnv();
+  return options;
+}
+
 ShmConf::ShmConf() { Update(MESSAGE_SIZE_16K); }
 
 ShmConf::ShmConf(const uint64_t& real_msg_size) { Update(real_msg_size); }
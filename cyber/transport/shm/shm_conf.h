@@ -24,6 +24,35 @@ namespace apollo {
 namespace cyber {
 namespace transport {
 
+/**
+ * @brief Backing of the segments a process creates, read once from the
+ * environment. Processes opening an existing segment map it as it was
+ * created, so the options only need to be set for the writers.
+ */
+struct SegmentOptions {
+  // CYBER_SHM_HUGE_PAGES=1: XSI segments are created with SHM_HUGETLB and
+  // POSIX segments as files of the hugetlbfs mount hugetlbfs_dir. Without
+  // huge pages reserved, and for arena segments, the memory is advised to
+  // use the transparent huge pages of tmpfs instead.
+  bool huge_pages = false;
+  // CYBER_SHM_HUGETLBFS_DIR, /dev/hugepages by default. Readers look up
+  // POSIX segments there too, so it must be the same for all processes.
+  std::string hugetlbfs_dir = "/dev/hugepages";
+  // CYBER_SHM_POPULATE=1: fault all pages in at creation, instead of on the
+  // first messages
+  bool populate = false;
+  // CYBER_SHM_NUMA_NODE=<node>: prefer the memory of that node.
+  // CYBER_SHM_NUMA_NODE=auto: prefer the node of the cpus the creating
+  // writer runs on, i.e. of its processor group.
+  int numa_node = -1;
+  bool numa_auto = false;
+
+  // Read once, on first use.
+  static const SegmentOptions& FromEnv();
+  // Read the environment as it is now.
+  static SegmentOptions LoadFromEnv();
+};
+
 class ShmConf {
  public:
   ShmConf();
@@ -37,6 +66,11 @@ class ShmConf {
   const uint32_t& block_num() { return block_num_; }
   const uint64_t& managed_shm_size() { return managed_shm_size_; }
 
+  const SegmentOptions& segment_options() const { return segment_options_; }
+  void set_segment_options(const SegmentOptions& options) {
+    segment_options_ = options;
+  }
+
  private:
   uint64_t GetCeilingMessageSize(const uint64_t& real_msg_size);
   uint64_t GetBlockBufSize(const uint64_t& ceiling_msg_size);
@@ -46,6 +80,7 @@ class ShmConf {
   uint64_t block_buf_size_;
   uint32_t block_num_;
   uint64_t managed_shm_size_;
+  SegmentOptions segment_options_ = SegmentOptions::FromEnv();
 
   // Extra size, Byte
   static const uint64_t EXTRA_SIZE;
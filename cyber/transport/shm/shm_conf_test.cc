@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "cyber/transport/shm/shm_conf.h"
+
+#include <cstdlib>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace cyber {
+namespace transport {
+
+void ClearSegmentEnv() {
+  unsetenv("CYBER_SHM_HUGE_PAGES");
+  unsetenv("CYBER_SHM_HUGETLBFS_DIR");
+  unsetenv("CYBER_SHM_POPULATE");
+  unsetenv("CYBER_SHM_NUMA_NODE");
+}
+
+TEST(SegmentOptionsTest, defaults) {
+  ClearSegmentEnv();
+  SegmentOptions options = SegmentOptions::LoadFromEnv();
+  EXPECT_FALSE(options.huge_pages);
+  EXPECT_EQ(options.hugetlbfs_dir, "/dev/hugepages");
+  EXPECT_FALSE(options.populate);
+  EXPECT_EQ(options.numa_node, -1);
+  EXPECT_FALSE(options.numa_auto);
+}
+
+TEST(SegmentOptionsTest, from_env) {
+  ClearSegmentEnv();
+  setenv("CYBER_SHM_HUGE_PAGES", "1", 1);
+  setenv("CYBER_SHM_HUGETLBFS_DIR", "/mnt/huge", 1);
+  setenv("CYBER_SHM_POPULATE", "1", 1);
+  setenv("CYBER_SHM_NUMA_NODE", "1", 1);
+  SegmentOptions options = SegmentOptions::LoadFromEnv();
+  EXPECT_TRUE(options.huge_pages);
+  EXPECT_EQ(options.hugetlbfs_dir, "/mnt/huge");
+  EXPECT_TRUE(options.populate);
+  EXPECT_EQ(options.numa_node, 1);
+  EXPECT_FALSE(options.numa_auto);
+
+  setenv("CYBER_SHM_NUMA_NODE", "auto", 1);
+  options = SegmentOptions::LoadFromEnv();
+  EXPECT_EQ(options.numa_node, -1);
+  EXPECT_TRUE(options.numa_auto);
+  ClearSegmentEnv();
+}
+
+TEST(SegmentOptionsTest, invalid_values) {
+  ClearSegmentEnv();
+  // only 1 enables a switch
+  setenv("CYBER_SHM_HUGE_PAGES", "true", 1);
+  setenv("CYBER_SHM_POPULATE", "0", 1);
+  for (const char* node : {"", "x", "1x", "-1"}) {
+    setenv("CYBER_SHM_NUMA_NODE", node, 1);
+    SegmentOptions options = SegmentOptions::LoadFromEnv();
+    EXPECT_FALSE(options.huge_pages);
+    EXPECT_FALSE(options.populate);
+    EXPECT_EQ(options.numa_node, -1) << node;
+    EXPECT_FALSE(options.numa_auto) << node;
+  }
+  ClearSegmentEnv();
+}
+
+}  // namespace transport
+}  // namespace cyber
+}  // namespace apollo
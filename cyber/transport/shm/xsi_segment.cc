@@ -43,13 +43,18 @@ bool XsiSegment::OpenOrCreate() {
   // create managed_shm_
   int retry = 0;
   int shmid = 0;
+  bool huge_pages = conf_.segment_options().huge_pages;
   while (retry < 2) {
-    shmid = shmget(key_, conf_.managed_shm_size(), 0644 | IPC_CREAT | IPC_EXCL);
+    int shm_flag = 0644 | IPC_CREAT | IPC_EXCL | (huge_pages ? SHM_HUGETLB : 0);
+    shmid = shmget(key_, conf_.managed_shm_size(), shm_flag);
     if (shmid != -1) {
       break;
     }
 
-    if (EINVAL == errno) {
+    if (huge_pages && (ENOMEM == errno || EPERM == errno)) {
+      AWARN << "no huge pages for shm, use normal pages: " << strerror(errno);
+      huge_pages = false;
+    } else if (EINVAL == errno) {
       AINFO << "need larger space, recreate.";
       Reset();
       Remove();
@@ -74,6 +79,7 @@ bool XsiSegment::OpenOrCreate() {
     shmctl(shmid, IPC_RMID, 0);
     return false;
   }
+  PrepareMemory(managed_shm_, conf_.managed_shm_size(), !huge_pages);
 
   // create field state_
   state_ = new (managed_shm_) State(conf_.ceiling_msg_size());
@@ -128,6 +134,7 @@ bool XsiSegment::OpenOrCreate() {
   }
 
   state_->IncreaseReferenceCounts();
+  mapping_.reset(managed_shm_, [](void* addr) { shmdt(addr); });
   init_ = true;
   ADEBUG << "open or create true.";
   return true;
@@ -204,6 +211,7 @@ bool XsiSegment::OpenOnly() {
   }
 
   state_->IncreaseReferenceCounts();
+  mapping_.reset(managed_shm_, [](void* addr) { shmdt(addr); });
   init_ = true;
   ADEBUG << "open only true.";
   return true;
@@ -226,11 +234,9 @@ void XsiSegment::Reset() {
     std::lock_guard<std::mutex> _g(block_buf_lock_);
     block_buf_addrs_.clear();
   }
-  if (managed_shm_ != nullptr) {
-    shmdt(managed_shm_);
-    managed_shm_ = nullptr;
-    return;
-  }
+  // detached once the blocks still held are released too
+  managed_shm_ = nullptr;
+  mapping_ = nullptr;
 }
 
 }  // namespace transport
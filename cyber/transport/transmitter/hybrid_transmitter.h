@@ -71,6 +71,12 @@ class HybridTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  bool AcquireLoan(std::size_t msg_size, WritableBlock* loan) override;
+  using Transmitter<M>::TransmitLoan;
+  bool TransmitLoan(const WritableBlock& loan, std::size_t msg_size,
+                    const MessageInfo& msg_info) override;
+  void ReleaseLoan(const WritableBlock& loan) override;
+
  private:
   void InitMode();
   void ObtainConfig();
@@ -171,6 +177,76 @@ bool HybridTransmitter<M>::Transmit(const MessagePtr& msg,
   return true;
 }
 
+template <typename M>
+bool HybridTransmitter<M>::AcquireLoan(std::size_t msg_size,
+                                       WritableBlock* loan) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = transmitters_.find(OptionalMode::SHM);
+  if (itr == transmitters_.end()) {
+    ADEBUG << "no shm transmitter to loan from.";
+    return false;
+  }
+  return itr->second->AcquireLoan(msg_size, loan);
+}
+
+template <typename M>
+bool HybridTransmitter<M>::TransmitLoan(const WritableBlock& loan,
+                                        std::size_t msg_size,
+                                        const MessageInfo& msg_info) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto shm = transmitters_.find(OptionalMode::SHM);
+  if (shm == transmitters_.end()) {
+    // the transmitter lending it is gone, the loan still holds its mapping
+    Segment::ReleaseWriteLock(loan);
+    return false;
+  }
+
+  // Peers that are not reached through shared memory, and the history kept
+  // for late joiners, still need a message object. It is parsed from the
+  // block before it is published, since other writers of the channel may
+  // reuse the block afterwards.
+  bool need_copy = this->attr_.qos_profile().durability() ==
+                   QosDurabilityPolicy::DURABILITY_TRANSIENT_LOCAL;
+  for (auto& item : receivers_) {
+    if (item.first != OptionalMode::SHM && !item.second.empty()) {
+      need_copy = true;
+    }
+  }
+
+  MessagePtr msg = nullptr;
+  if (need_copy) {
+    msg = std::make_shared<M>();
+    if (!message::ParseFromArray(loan.buf, static_cast<int>(msg_size),
+                                 msg.get())) {
+      AERROR << "parse loaned message failed.";
+      shm->second->ReleaseLoan(loan);
+      return false;
+    }
+    history_->Add(msg, msg_info);
+  }
+
+  bool result = shm->second->TransmitLoan(loan, msg_size, msg_info);
+  if (msg != nullptr) {
+    for (auto& item : transmitters_) {
+      if (item.first != OptionalMode::SHM) {
+        item.second->Transmit(msg, msg_info);
+      }
+    }
+  }
+  return result;
+}
+
+template <typename M>
+void HybridTransmitter<M>::ReleaseLoan(const WritableBlock& loan) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr = transmitters_.find(OptionalMode::SHM);
+  if (itr != transmitters_.end()) {
+    itr->second->ReleaseLoan(loan);
+  } else {
+    Segment::ReleaseWriteLock(loan);
+  }
+}
+
 template <typename M>
 void HybridTransmitter<M>::InitMode() {
   mode_ = std::make_shared<proto::CommunicationMode>();
@@ -48,8 +48,16 @@ class ShmTransmitter : public Transmitter<M> {
 
   bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) override;
 
+  bool AcquireLoan(std::size_t msg_size, WritableBlock* loan) override;
+  using Transmitter<M>::TransmitLoan;
+  bool TransmitLoan(const WritableBlock& loan, std::size_t msg_size,
+                    const MessageInfo& msg_info) override;
+  void ReleaseLoan(const WritableBlock& loan) override;
+
  private:
   bool Transmit(const M& msg, const MessageInfo& msg_info);
+  bool Commit(const WritableBlock& wb, std::size_t msg_size,
+              const MessageInfo& msg_info);
 
   SegmentPtr segment_;
   uint64_t channel_id_;
@@ -117,6 +125,63 @@ bool ShmTransmitter<M>::Transmit(const M& msg, const MessageInfo& msg_info) {
     segment_->ReleaseWrittenBlock(wb);
     return false;
   }
+  return Commit(wb, msg_size, msg_info);
+}
+
+template <typename M>
+bool ShmTransmitter<M>::AcquireLoan(std::size_t msg_size,
+                                    WritableBlock* loan) {
+  RETURN_VAL_IF_NULL(loan, false);
+  if (!this->enabled_) {
+    ADEBUG << "not enable.";
+    return false;
+  }
+
+  if (!segment_->AcquireBlockToWrite(msg_size, loan)) {
+    AERROR << "acquire block failed.";
+    return false;
+  }
+  return true;
+}
+
+template <typename M>
+bool ShmTransmitter<M>::TransmitLoan(const WritableBlock& loan,
+                                     std::size_t msg_size,
+                                     const MessageInfo& msg_info) {
+  if (!this->enabled_) {
+    ADEBUG << "not enable.";
+    ReleaseLoan(loan);
+    return false;
+  }
+  if (!segment_->IsCurrent(loan)) {
+    // The segment was remapped while the loan was out, so readers would
+    // look for its index in the new mapping. Publish a copy instead.
+    WritableBlock wb;
+    if (!segment_->AcquireBlockToWrite(msg_size, &wb)) {
+      AERROR << "acquire block failed.";
+      segment_->ReleaseWrittenBlock(loan);
+      return false;
+    }
+    std::memcpy(wb.buf, loan.buf, msg_size);
+    segment_->ReleaseWrittenBlock(loan);
+    return Commit(wb, msg_size, msg_info);
+  }
+  return Commit(loan, msg_size, msg_info);
+}
+
+template <typename M>
+void ShmTransmitter<M>::ReleaseLoan(const WritableBlock& loan) {
+  if (segment_ != nullptr) {
+    segment_->ReleaseWrittenBlock(loan);
+  } else {
+    // disabled while the loan was out, the loan still holds its mapping
+    Segment::ReleaseWriteLock(loan);
+  }
+}
+
+template <typename M>
+bool ShmTransmitter<M>::Commit(const WritableBlock& wb, std::size_t msg_size,
+                               const MessageInfo& msg_info) {
   wb.block->set_msg_size(msg_size);
 
   char* msg_info_addr = reinterpret_cast<char*>(wb.buf) + msg_size;
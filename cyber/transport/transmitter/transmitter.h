@@ -24,6 +24,7 @@
 #include "cyber/event/perf_event_cache.h"
 #include "cyber/transport/common/endpoint.h"
 #include "cyber/transport/message/message_info.h"
+#include "cyber/transport/shm/segment.h"
 
 namespace apollo {
 namespace cyber {
@@ -49,6 +50,15 @@ class Transmitter : public Endpoint {
   virtual bool Transmit(const MessagePtr& msg);
   virtual bool Transmit(const MessagePtr& msg, const MessageInfo& msg_info) = 0;
 
+  // Zero-copy path: the caller fills `loan->buf` in place with the serialized
+  // payload and then either transmits or releases the loan. Only transmitters
+  // backed by shared memory support it; the others keep the defaults below.
+  virtual bool AcquireLoan(std::size_t msg_size, WritableBlock* loan);
+  virtual bool TransmitLoan(const WritableBlock& loan, std::size_t msg_size);
+  virtual bool TransmitLoan(const WritableBlock& loan, std::size_t msg_size,
+                            const MessageInfo& msg_info);
+  virtual void ReleaseLoan(const WritableBlock& loan);
+
   uint64_t NextSeqNum() { return ++seq_num_; }
 
   uint64_t seq_num() const { return seq_num_; }
@@ -76,6 +86,37 @@ bool Transmitter<M>::Transmit(const MessagePtr& msg) {
   return Transmit(msg, msg_info_);
 }
 
+template <typename M>
+bool Transmitter<M>::AcquireLoan(std::size_t msg_size, WritableBlock* loan) {
+  (void)msg_size;
+  (void)loan;
+  return false;
+}
+
+template <typename M>
+bool Transmitter<M>::TransmitLoan(const WritableBlock& loan,
+                                  std::size_t msg_size) {
+  msg_info_.set_seq_num(NextSeqNum());
+  PerfEventCache::Instance()->AddTransportEvent(
+      TransPerf::TRANSMIT_BEGIN, attr_.channel_id(), msg_info_.seq_num());
+  return TransmitLoan(loan, msg_size, msg_info_);
+}
+
+template <typename M>
+bool Transmitter<M>::TransmitLoan(const WritableBlock& loan,
+                                  std::size_t msg_size,
+                                  const MessageInfo& msg_info) {
+  (void)loan;
+  (void)msg_size;
+  (void)msg_info;
+  return false;
+}
+
+template <typename M>
+void Transmitter<M>::ReleaseLoan(const WritableBlock& loan) {
+  (void)loan;
+}
+
 template <typename M>
 void Transmitter<M>::Enable(const RoleAttributes& opposite_attr) {
   (void)opposite_attr;
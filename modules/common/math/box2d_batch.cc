@@ -0,0 +1,373 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/box2d_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace apollo {
+namespace common {
+namespace math {
+namespace {
+
+// The instruction sets share one interface so that every kernel is written
+// once. The operations are those of the scalar Box2d code, without fused
+// multiply-add, so overlap results match it bit for bit.
+struct ScalarPack {
+  using Value = double;
+  using Mask = bool;
+  static constexpr size_t kWidth = 1;
+
+  static Value Load(const double *p) { return *p; }
+  static void Store(double *p, const Value v) { *p = v; }
+  static Value Set(const double x) { return x; }
+  static Value Add(const Value a, const Value b) { return a + b; }
+  static Value Sub(const Value a, const Value b) { return a - b; }
+  static Value Mul(const Value a, const Value b) { return a * b; }
+  static Value Abs(const Value a) { return std::abs(a); }
+  static Value Min(const Value a, const Value b) { return std::min(a, b); }
+  static Value Max(const Value a, const Value b) { return std::max(a, b); }
+  static Value Sqrt(const Value a) { return std::sqrt(a); }
+  static Mask Less(const Value a, const Value b) { return a < b; }
+  static Mask LessEq(const Value a, const Value b) { return a <= b; }
+  static Mask And(const Mask a, const Mask b) { return a && b; }
+  static Mask Or(const Mask a, const Mask b) { return a || b; }
+  static Mask AndNot(const Mask a, const Mask b) { return !a && b; }
+  static Value Select(const Mask m, const Value a, const Value b) {
+    return m ? a : b;
+  }
+  static int MoveMask(const Mask m) { return m ? 1 : 0; }
+};
+
+#if defined(__AVX2__)
+struct SimdPack {
+  using Value = __m256d;
+  using Mask = __m256d;
+  static constexpr size_t kWidth = 4;
+
+  static Value Load(const double *p) { return _mm256_loadu_pd(p); }
+  static void Store(double *p, const Value v) { _mm256_storeu_pd(p, v); }
+  static Value Set(const double x) { return _mm256_set1_pd(x); }
+  static Value Add(const Value a, const Value b) { return _mm256_add_pd(a, b); }
+  static Value Sub(const Value a, const Value b) { return _mm256_sub_pd(a, b); }
+  static Value Mul(const Value a, const Value b) { return _mm256_mul_pd(a, b); }
+  static Value Abs(const Value a) {
+    return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a);
+  }
+  static Value Min(const Value a, const Value b) { return _mm256_min_pd(a, b); }
+  static Value Max(const Value a, const Value b) { return _mm256_max_pd(a, b); }
+  static Value Sqrt(const Value a) { return _mm256_sqrt_pd(a); }
+  static Mask Less(const Value a, const Value b) {
+    return _mm256_cmp_pd(a, b, _CMP_LT_OQ);
+  }
+  static Mask LessEq(const Value a, const Value b) {
+    return _mm256_cmp_pd(a, b, _CMP_LE_OQ);
+  }
+  static Mask And(const Mask a, const Mask b) { return _mm256_and_pd(a, b); }
+  static Mask Or(const Mask a, const Mask b) { return _mm256_or_pd(a, b); }
+  static Mask AndNot(const Mask a, const Mask b) {
+    return _mm256_andnot_pd(a, b);
+  }
+  static Value Select(const Mask m, const Value a, const Value b) {
+    return _mm256_blendv_pd(b, a, m);
+  }
+  static int MoveMask(const Mask m) { return _mm256_movemask_pd(m); }
+};
+constexpr char kInstructionSet[] = "avx2";
+#elif defined(__SSE2__)
+struct SimdPack {
+  using Value = __m128d;
+  using Mask = __m128d;
+  static constexpr size_t kWidth = 2;
+
+  static Value Load(const double *p) { return _mm_loadu_pd(p); }
+  static void Store(double *p, const Value v) { _mm_storeu_pd(p, v); }
+  static Value Set(const double x) { return _mm_set1_pd(x); }
+  static Value Add(const Value a, const Value b) { return _mm_add_pd(a, b); }
+  static Value Sub(const Value a, const Value b) { return _mm_sub_pd(a, b); }
+  static Value Mul(const Value a, const Value b) { return _mm_mul_pd(a, b); }
+  static Value Abs(const Value a) {
+    return _mm_andnot_pd(_mm_set1_pd(-0.0), a);
+  }
+  static Value Min(const Value a, const Value b) { return _mm_min_pd(a, b); }
+  static Value Max(const Value a, const Value b) { return _mm_max_pd(a, b); }
+  static Value Sqrt(const Value a) { return _mm_sqrt_pd(a); }
+  static Mask Less(const Value a, const Value b) { return _mm_cmplt_pd(a, b); }
+  static Mask LessEq(const Value a, const Value b) {
+    return _mm_cmple_pd(a, b);
+  }
+  static Mask And(const Mask a, const Mask b) { return _mm_and_pd(a, b); }
+  static Mask Or(const Mask a, const Mask b) { return _mm_or_pd(a, b); }
+  static Mask AndNot(const Mask a, const Mask b) { return _mm_andnot_pd(a, b); }
+  static Value Select(const Mask m, const Value a, const Value b) {
+    return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+  }
+  static int MoveMask(const Mask m) { return _mm_movemask_pd(m); }
+};
+constexpr char kInstructionSet[] = "sse2";
+#else
+using SimdPack = ScalarPack;
+constexpr char kInstructionSet[] = "scalar";
+#endif
+
+// Box2d::DistanceTo(const Vec2d &) of the boxes given by center, heading and
+// half sizes.
+template <typename Pack, typename Value = typename Pack::Value>
+Value PointDistance(const Value point_x, const Value point_y,
+                    const Value center_x, const Value center_y,
+                    const Value cos_heading, const Value sin_heading,
+                    const Value half_length, const Value half_width) {
+  const Value x0 = Pack::Sub(point_x, center_x);
+  const Value y0 = Pack::Sub(point_y, center_y);
+  const Value dx = Pack::Sub(Pack::Abs(Pack::Add(Pack::Mul(x0, cos_heading),
+                                                 Pack::Mul(y0, sin_heading))),
+                             half_length);
+  const Value dy = Pack::Sub(Pack::Abs(Pack::Sub(Pack::Mul(x0, sin_heading),
+                                                 Pack::Mul(y0, cos_heading))),
+                             half_width);
+  const Value zero = Pack::Set(0.0);
+  const Value corner_distance =
+      Pack::Sqrt(Pack::Add(Pack::Mul(dx, dx), Pack::Mul(dy, dy)));
+  return Pack::Select(
+      Pack::LessEq(dx, zero), Pack::Max(zero, dy),
+      Pack::Select(Pack::LessEq(dy, zero), dx, corner_distance));
+}
+
+}  // namespace
+
+Box2dBatch::Box2dBatch(const std::vector<Box2d> &boxes) {
+  for (const auto &box : boxes) {
+    Add(box);
+  }
+}
+
+void Box2dBatch::Add(const Box2d &box) {
+  center_x_.push_back(box.center_x());
+  center_y_.push_back(box.center_y());
+  cos_heading_.push_back(box.cos_heading());
+  sin_heading_.push_back(box.sin_heading());
+  half_length_.push_back(box.half_length());
+  half_width_.push_back(box.half_width());
+  dx1_.push_back(box.cos_heading() * box.half_length());
+  dy1_.push_back(box.sin_heading() * box.half_length());
+  dx2_.push_back(box.sin_heading() * box.half_width());
+  dy2_.push_back(-box.cos_heading() * box.half_width());
+  min_x_.push_back(box.min_x());
+  max_x_.push_back(box.max_x());
+  min_y_.push_back(box.min_y());
+  max_y_.push_back(box.max_y());
+  std::vector<Vec2d> corners;
+  box.GetAllCorners(&corners);
+  for (size_t k = 0; k < 4; ++k) {
+    corner_x_[k].push_back(corners[k].x());
+    corner_y_[k].push_back(corners[k].y());
+  }
+}
+
+void Box2dBatch::Clear() {
+  for (auto *column :
+       {&center_x_, &center_y_, &cos_heading_, &sin_heading_, &half_length_,
+        &half_width_, &dx1_, &dy1_, &dx2_, &dy2_, &min_x_, &max_x_, &min_y_,
+        &max_y_}) {
+    column->clear();
+  }
+  for (size_t k = 0; k < 4; ++k) {
+    corner_x_[k].clear();
+    corner_y_[k].clear();
+  }
+}
+
+const char *Box2dBatch::InstructionSet() { return kInstructionSet; }
+
+template <typename Pack>
+typename Pack::Mask Box2dBatch::OverlapAt(const Box2d &box,
+                                          const size_t i) const {
+  // Box2d::HasOverlap with this = the i-th box of the batch.
+  const auto separated = Pack::Or(
+      Pack::Or(Pack::Less(Pack::Set(box.max_x()), Pack::Load(&min_x_[i])),
+               Pack::Less(Pack::Load(&max_x_[i]), Pack::Set(box.min_x()))),
+      Pack::Or(Pack::Less(Pack::Set(box.max_y()), Pack::Load(&min_y_[i])),
+               Pack::Less(Pack::Load(&max_y_[i]), Pack::Set(box.min_y()))));
+  // most boxes of a batch are far away, skip the axis tests for them
+  if (Pack::MoveMask(separated) == (1 << Pack::kWidth) - 1) {
+    return Pack::LessEq(Pack::Set(1.0), Pack::Set(0.0));
+  }
+
+  const auto cos_heading = Pack::Load(&cos_heading_[i]);
+  const auto sin_heading = Pack::Load(&sin_heading_[i]);
+  const auto shift_x = Pack::Sub(Pack::Set(box.center_x()),
+                                 Pack::Load(&center_x_[i]));
+  const auto shift_y = Pack::Sub(Pack::Set(box.center_y()),
+                                 Pack::Load(&center_y_[i]));
+
+  const auto dx1 = Pack::Load(&dx1_[i]);
+  const auto dy1 = Pack::Load(&dy1_[i]);
+  const auto dx2 = Pack::Load(&dx2_[i]);
+  const auto dy2 = Pack::Load(&dy2_[i]);
+  const auto dx3 = Pack::Set(box.cos_heading() * box.half_length());
+  const auto dy3 = Pack::Set(box.sin_heading() * box.half_length());
+  const auto dx4 = Pack::Set(box.sin_heading() * box.half_width());
+  const auto dy4 = Pack::Set(-box.cos_heading() * box.half_width());
+  const auto box_cos_heading = Pack::Set(box.cos_heading());
+  const auto box_sin_heading = Pack::Set(box.sin_heading());
+
+  // a * c + b * s and a * s - b * c, the projections of the four axes
+  auto project_cos = [](const typename Pack::Value a,
+                        const typename Pack::Value b,
+                        const typename Pack::Value c,
+                        const typename Pack::Value s) {
+    return Pack::Abs(Pack::Add(Pack::Mul(a, c), Pack::Mul(b, s)));
+  };
+  auto project_sin = [](const typename Pack::Value a,
+                        const typename Pack::Value b,
+                        const typename Pack::Value c,
+                        const typename Pack::Value s) {
+    return Pack::Abs(Pack::Sub(Pack::Mul(a, s), Pack::Mul(b, c)));
+  };
+
+  const auto axis1 = Pack::LessEq(
+      project_cos(shift_x, shift_y, cos_heading, sin_heading),
+      Pack::Add(Pack::Add(project_cos(dx3, dy3, cos_heading, sin_heading),
+                          project_cos(dx4, dy4, cos_heading, sin_heading)),
+                Pack::Load(&half_length_[i])));
+  const auto axis2 = Pack::LessEq(
+      project_sin(shift_x, shift_y, cos_heading, sin_heading),
+      Pack::Add(Pack::Add(project_sin(dx3, dy3, cos_heading, sin_heading),
+                          project_sin(dx4, dy4, cos_heading, sin_heading)),
+                Pack::Load(&half_width_[i])));
+  const auto axis3 = Pack::LessEq(
+      project_cos(shift_x, shift_y, box_cos_heading, box_sin_heading),
+      Pack::Add(
+          Pack::Add(project_cos(dx1, dy1, box_cos_heading, box_sin_heading),
+                    project_cos(dx2, dy2, box_cos_heading, box_sin_heading)),
+          Pack::Set(box.half_length())));
+  const auto axis4 = Pack::LessEq(
+      project_sin(shift_x, shift_y, box_cos_heading, box_sin_heading),
+      Pack::Add(
+          Pack::Add(project_sin(dx1, dy1, box_cos_heading, box_sin_heading),
+                    project_sin(dx2, dy2, box_cos_heading, box_sin_heading)),
+          Pack::Set(box.half_width())));
+
+  return Pack::AndNot(separated, Pack::And(Pack::And(axis1, axis2),
+                                           Pack::And(axis3, axis4)));
+}
+
+template <typename Pack>
+typename Pack::Value Box2dBatch::DistanceAt(const Vec2d &point,
+                                            const size_t i) const {
+  return PointDistance<Pack>(
+      Pack::Set(point.x()), Pack::Set(point.y()), Pack::Load(&center_x_[i]),
+      Pack::Load(&center_y_[i]), Pack::Load(&cos_heading_[i]),
+      Pack::Load(&sin_heading_[i]), Pack::Load(&half_length_[i]),
+      Pack::Load(&half_width_[i]));
+}
+
+template <typename Pack>
+typename Pack::Value Box2dBatch::DistanceAt(
+    const Box2d &box, const std::vector<Vec2d> &box_corners,
+    const size_t i) const {
+  // Apart from overlapping, the closest points of two rectangles include a
+  // corner of one of them.
+  auto distance = Pack::Set(std::numeric_limits<double>::infinity());
+  for (size_t k = 0; k < 4; ++k) {
+    distance = Pack::Min(
+        distance,
+        PointDistance<Pack>(
+            Pack::Load(&corner_x_[k][i]), Pack::Load(&corner_y_[k][i]),
+            Pack::Set(box.center_x()), Pack::Set(box.center_y()),
+            Pack::Set(box.cos_heading()), Pack::Set(box.sin_heading()),
+            Pack::Set(box.half_length()), Pack::Set(box.half_width())));
+    distance = Pack::Min(distance,
+                         PointDistance<Pack>(
+                             Pack::Set(box_corners[k].x()),
+                             Pack::Set(box_corners[k].y()),
+                             Pack::Load(&center_x_[i]),
+                             Pack::Load(&center_y_[i]),
+                             Pack::Load(&cos_heading_[i]),
+                             Pack::Load(&sin_heading_[i]),
+                             Pack::Load(&half_length_[i]),
+                             Pack::Load(&half_width_[i])));
+  }
+  return Pack::Select(OverlapAt<Pack>(box, i), Pack::Set(0.0), distance);
+}
+
+void Box2dBatch::HasOverlap(const Box2d &box,
+                            std::vector<uint8_t> *const overlaps) const {
+  overlaps->resize(size());
+  size_t i = 0;
+  for (; i + SimdPack::kWidth <= size(); i += SimdPack::kWidth) {
+    const int mask = SimdPack::MoveMask(OverlapAt<SimdPack>(box, i));
+    for (size_t k = 0; k < SimdPack::kWidth; ++k) {
+      (*overlaps)[i + k] = static_cast<uint8_t>((mask >> k) & 1);
+    }
+  }
+  for (; i < size(); ++i) {
+    (*overlaps)[i] = OverlapAt<ScalarPack>(box, i) ? 1 : 0;
+  }
+}
+
+int Box2dBatch::FirstOverlap(const Box2d &box) const {
+  size_t i = 0;
+  for (; i + SimdPack::kWidth <= size(); i += SimdPack::kWidth) {
+    const int mask = SimdPack::MoveMask(OverlapAt<SimdPack>(box, i));
+    if (mask != 0) {
+      return static_cast<int>(i) + __builtin_ctz(mask);
+    }
+  }
+  for (; i < size(); ++i) {
+    if (OverlapAt<ScalarPack>(box, i)) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void Box2dBatch::DistanceTo(const Vec2d &point,
+                            std::vector<double> *const distances) const {
+  distances->resize(size());
+  size_t i = 0;
+  for (; i + SimdPack::kWidth <= size(); i += SimdPack::kWidth) {
+    SimdPack::Store(&(*distances)[i], DistanceAt<SimdPack>(point, i));
+  }
+  for (; i < size(); ++i) {
+    (*distances)[i] = DistanceAt<ScalarPack>(point, i);
+  }
+}
+
+void Box2dBatch::DistanceTo(const Box2d &box,
+                            std::vector<double> *const distances) const {
+  std::vector<Vec2d> box_corners;
+  box.GetAllCorners(&box_corners);
+  distances->resize(size());
+  size_t i = 0;
+  for (; i + SimdPack::kWidth <= size(); i += SimdPack::kWidth) {
+    SimdPack::Store(&(*distances)[i],
+                    DistanceAt<SimdPack>(box, box_corners, i));
+  }
+  for (; i < size(); ++i) {
+    (*distances)[i] = DistanceAt<ScalarPack>(box, box_corners, i);
+  }
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,151 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ * @brief A batch of Box2d stored as structure of arrays, for one-vs-many
+ *        overlap and distance queries with SIMD kernels.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "modules/common/math/box2d.h"
+#include "modules/common/math/vec2d.h"
+
+/**
+ * @namespace apollo::common::math
+ * @brief apollo::common::math
+ */
+namespace apollo {
+namespace common {
+namespace math {
+
+/**
+ * @class Box2dBatch
+ * @brief Many boxes tested against one box or point at a time. The kernels
+ * use AVX2 or SSE2 when the library is compiled for them and plain C++
+ * otherwise, see InstructionSet().
+ *
+ * Overlap results are exactly those of Box2d::HasOverlap. Distances equal
+ * Box2d::DistanceTo up to rounding, sqrt replaces hypot and box distances
+ * are computed from the corners instead of through Polygon2d.
+ */
+class Box2dBatch {
+ public:
+  Box2dBatch() = default;
+
+  /**
+   * @brief Constructor which takes the boxes of the batch.
+   * @param boxes The boxes, indices of results refer to this order.
+   */
+  explicit Box2dBatch(const std::vector<Box2d> &boxes);
+
+  /**
+   * @brief Appends a box to the batch.
+   * @param box The box to append.
+   */
+  void Add(const Box2d &box);
+
+  /**
+   * @brief Removes all boxes, keeping the memory.
+   */
+  void Clear();
+
+  /**
+   * @brief Getter of the number of boxes.
+   * @return The number of boxes
+   */
+  size_t size() const { return center_x_.size(); }
+
+  /**
+   * @brief Whether the batch has no box.
+   * @return True if the batch has no box
+   */
+  bool empty() const { return center_x_.empty(); }
+
+  /**
+   * @brief Tests every box of the batch for overlap with the given box.
+   * @param box The box to test against.
+   * @param overlaps Set to 1 at index i if the i-th box overlaps, else 0.
+   */
+  void HasOverlap(const Box2d &box, std::vector<uint8_t> *const overlaps) const;
+
+  /**
+   * @brief Finds the first box of the batch overlapping the given box.
+   * @param box The box to test against.
+   * @return The index of the first overlapping box, -1 if there is none
+   */
+  int FirstOverlap(const Box2d &box) const;
+
+  /**
+   * @brief Computes the distance from every box of the batch to a point.
+   * @param point The point to measure to.
+   * @param distances Set to the distance of each box, 0 inside the box.
+   */
+  void DistanceTo(const Vec2d &point,
+                  std::vector<double> *const distances) const;
+
+  /**
+   * @brief Computes the distance from every box of the batch to a box.
+   * @param box The box to measure to.
+   * @param distances Set to the distance of each box, 0 if they overlap.
+   */
+  void DistanceTo(const Box2d &box, std::vector<double> *const distances) const;
+
+  /**
+   * @brief The instruction set of the kernels: "avx2", "sse2" or "scalar".
+   */
+  static const char *InstructionSet();
+
+ private:
+  // The kernels on the boxes [i, i + Pack::kWidth), Pack is the SIMD or the
+  // scalar instruction set.
+  template <typename Pack>
+  typename Pack::Mask OverlapAt(const Box2d &box, const size_t i) const;
+  template <typename Pack>
+  typename Pack::Value DistanceAt(const Vec2d &point, const size_t i) const;
+  template <typename Pack>
+  typename Pack::Value DistanceAt(const Box2d &box,
+                                  const std::vector<Vec2d> &box_corners,
+                                  const size_t i) const;
+
+  // one column per attribute, element i belongs to the i-th box
+  std::vector<double> center_x_;
+  std::vector<double> center_y_;
+  std::vector<double> cos_heading_;
+  std::vector<double> sin_heading_;
+  std::vector<double> half_length_;
+  std::vector<double> half_width_;
+  // cos/sin_heading times half_length/half_width, as in Box2d::HasOverlap
+  std::vector<double> dx1_;
+  std::vector<double> dy1_;
+  std::vector<double> dx2_;
+  std::vector<double> dy2_;
+  std::vector<double> min_x_;
+  std::vector<double> max_x_;
+  std::vector<double> min_y_;
+  std::vector<double> max_y_;
+  // the corners in the order of Box2d::GetAllCorners
+  std::vector<double> corner_x_[4];
+  std::vector<double> corner_y_[4];
+};
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares the Box2dBatch kernels with the scalar Box2d calls they replace,
+// one query box or point against N boxes spread over a parking lot sized
+// area, so that some of them overlap the query.
+//
+// bazel run //modules/common/math:box2d_batch_benchmark
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/math/box2d.h"
+#include "modules/common/math/box2d_batch.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+std::vector<Box2d> Boxes(const int num_boxes) {
+  std::mt19937 gen(num_boxes);
+  std::uniform_real_distribution<double> position(-30.0, 30.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::uniform_real_distribution<double> size(1.0, 6.0);
+  std::vector<Box2d> boxes;
+  for (int i = 0; i < num_boxes; ++i) {
+    boxes.emplace_back(Vec2d(position(gen), position(gen)), heading(gen),
+                       size(gen), size(gen));
+  }
+  return boxes;
+}
+
+const Box2d &QueryBox() {
+  static const Box2d box(Vec2d(1.0, -2.0), 0.3, 4.9, 2.1);
+  return box;
+}
+
+void BM_ScalarHasOverlap(benchmark::State &state) {  // NOLINT
+  const std::vector<Box2d> boxes = Boxes(static_cast<int>(state.range(0)));
+  std::vector<uint8_t> overlaps(boxes.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      overlaps[i] = boxes[i].HasOverlap(QueryBox());
+    }
+    benchmark::DoNotOptimize(overlaps.data());
+  }
+  state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_ScalarHasOverlap)->Arg(64)->Arg(1024);
+
+void BM_BatchHasOverlap(benchmark::State &state) {  // NOLINT
+  const Box2dBatch batch(Boxes(static_cast<int>(state.range(0))));
+  std::vector<uint8_t> overlaps;
+  for (auto _ : state) {
+    batch.HasOverlap(QueryBox(), &overlaps);
+    benchmark::DoNotOptimize(overlaps.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batch.size());
+  state.SetLabel(Box2dBatch::InstructionSet());
+}
+BENCHMARK(BM_BatchHasOverlap)->Arg(64)->Arg(1024);
+
+void BM_ScalarPointDistance(benchmark::State &state) {  // NOLINT
+  const std::vector<Box2d> boxes = Boxes(static_cast<int>(state.range(0)));
+  std::vector<double> distances(boxes.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      distances[i] = boxes[i].DistanceTo(QueryBox().center());
+    }
+    benchmark::DoNotOptimize(distances.data());
+  }
+  state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_ScalarPointDistance)->Arg(64)->Arg(1024);
+
+void BM_BatchPointDistance(benchmark::State &state) {  // NOLINT
+  const Box2dBatch batch(Boxes(static_cast<int>(state.range(0))));
+  std::vector<double> distances;
+  for (auto _ : state) {
+    batch.DistanceTo(QueryBox().center(), &distances);
+    benchmark::DoNotOptimize(distances.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batch.size());
+  state.SetLabel(Box2dBatch::InstructionSet());
+}
+BENCHMARK(BM_BatchPointDistance)->Arg(64)->Arg(1024);
+
+void BM_ScalarBoxDistance(benchmark::State &state) {  // NOLINT
+  const std::vector<Box2d> boxes = Boxes(static_cast<int>(state.range(0)));
+  std::vector<double> distances(boxes.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      distances[i] = boxes[i].DistanceTo(QueryBox());
+    }
+    benchmark::DoNotOptimize(distances.data());
+  }
+  state.SetItemsProcessed(state.iterations() * boxes.size());
+}
+BENCHMARK(BM_ScalarBoxDistance)->Arg(64)->Arg(1024);
+
+void BM_BatchBoxDistance(benchmark::State &state) {  // NOLINT
+  const Box2dBatch batch(Boxes(static_cast<int>(state.range(0))));
+  std::vector<double> distances;
+  for (auto _ : state) {
+    batch.DistanceTo(QueryBox(), &distances);
+    benchmark::DoNotOptimize(distances.data());
+  }
+  state.SetItemsProcessed(state.iterations() * batch.size());
+  state.SetLabel(Box2dBatch::InstructionSet());
+}
+BENCHMARK(BM_BatchBoxDistance)->Arg(64)->Arg(1024);
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
+
+BENCHMARK_MAIN();
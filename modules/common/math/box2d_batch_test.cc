@@ -0,0 +1,112 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/common/math/box2d_batch.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace common {
+namespace math {
+
+namespace {
+
+std::vector<Box2d> RandomBoxes(const int num_boxes, std::mt19937 *gen) {
+  std::uniform_real_distribution<double> position(-20.0, 20.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::uniform_real_distribution<double> size(0.1, 8.0);
+  std::vector<Box2d> boxes;
+  for (int i = 0; i < num_boxes; ++i) {
+    boxes.emplace_back(Vec2d(position(*gen), position(*gen)), heading(*gen),
+                       size(*gen), size(*gen));
+  }
+  return boxes;
+}
+
+}  // namespace
+
+TEST(Box2dBatchTest, HasOverlap) {
+  std::mt19937 gen(0);
+  // an odd size to cover the tail after the SIMD lanes
+  const std::vector<Box2d> boxes = RandomBoxes(103, &gen);
+  const Box2dBatch batch(boxes);
+  ASSERT_EQ(boxes.size(), batch.size());
+
+  std::vector<uint8_t> overlaps;
+  int num_overlaps = 0;
+  for (const auto &box : RandomBoxes(200, &gen)) {
+    batch.HasOverlap(box, &overlaps);
+    ASSERT_EQ(boxes.size(), overlaps.size());
+    int first_overlap = -1;
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      EXPECT_EQ(boxes[i].HasOverlap(box), overlaps[i] != 0);
+      if (overlaps[i] != 0 && first_overlap < 0) {
+        first_overlap = static_cast<int>(i);
+      }
+      num_overlaps += overlaps[i];
+    }
+    EXPECT_EQ(first_overlap, batch.FirstOverlap(box));
+  }
+  EXPECT_GT(num_overlaps, 0);
+}
+
+TEST(Box2dBatchTest, TouchingBoxes) {
+  // boxes sharing an edge overlap, as in Box2d::HasOverlap
+  const Box2d box(Vec2d(0.0, 0.0), 0.0, 2.0, 2.0);
+  Box2dBatch batch;
+  batch.Add(Box2d(Vec2d(2.0, 0.0), 0.0, 2.0, 2.0));
+  batch.Add(Box2d(Vec2d(2.1, 0.0), 0.0, 2.0, 2.0));
+  std::vector<uint8_t> overlaps;
+  batch.HasOverlap(box, &overlaps);
+  EXPECT_EQ(1, overlaps[0]);
+  EXPECT_EQ(0, overlaps[1]);
+  EXPECT_EQ(0, batch.FirstOverlap(box));
+
+  batch.Clear();
+  EXPECT_TRUE(batch.empty());
+  EXPECT_EQ(-1, batch.FirstOverlap(box));
+}
+
+TEST(Box2dBatchTest, DistanceTo) {
+  std::mt19937 gen(1);
+  const std::vector<Box2d> boxes = RandomBoxes(37, &gen);
+  const Box2dBatch batch(boxes);
+
+  std::uniform_real_distribution<double> position(-30.0, 30.0);
+  std::vector<double> distances;
+  for (int k = 0; k < 200; ++k) {
+    const Vec2d point(position(gen), position(gen));
+    batch.DistanceTo(point, &distances);
+    ASSERT_EQ(boxes.size(), distances.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      EXPECT_NEAR(boxes[i].DistanceTo(point), distances[i], 1e-9);
+    }
+  }
+
+  for (const auto &box : RandomBoxes(100, &gen)) {
+    batch.DistanceTo(box, &distances);
+    ASSERT_EQ(boxes.size(), distances.size());
+    for (size_t i = 0; i < boxes.size(); ++i) {
+      EXPECT_NEAR(boxes[i].DistanceTo(box), distances[i], 1e-9);
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace common
+}  // namespace apollo
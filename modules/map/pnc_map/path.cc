@@ -388,6 +388,7 @@ void Path::InitPoints() {
   CHECK_EQ(accumulated_s_.size(), num_points_);
   CHECK_EQ(unit_directions_.size(), num_points_);
   CHECK_EQ(segments_.size(), num_segments_);
+  projection_index_ = PathProjectionIndex(segments_);
 }
 
 void Path::InitLaneSegments() {
@@ -755,28 +756,8 @@ bool Path::GetProjectionWithHueristicParams(const Vec2d& point,
     }
   }
   *min_distance = std::sqrt(*min_distance);
-  const auto& nearest_seg = segments_[min_index];
-  const auto prod = nearest_seg.ProductOntoUnit(point);
-  const auto proj = nearest_seg.ProjectOntoUnit(point);
-  if (min_index == 0) {
-    *accumulate_s = std::min(proj, nearest_seg.length());
-    if (proj < 0) {
-      *lateral = prod;
-    } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
-    }
-  } else if (min_index == num_segments_ - 1) {
-    *accumulate_s = accumulated_s_[min_index] + std::max(0.0, proj);
-    if (proj > 0) {
-      *lateral = prod;
-    } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
-    }
-  } else {
-    *accumulate_s = accumulated_s_[min_index] +
-                    std::max(0.0, std::min(proj, nearest_seg.length()));
-    *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
-  }
+  GetProjectionOntoSegment(point, min_index, *min_distance, accumulate_s,
+                           lateral);
   return true;
 }
 
@@ -794,39 +775,73 @@ bool Path::GetProjection(const Vec2d& point, double* accumulate_s,
                                         min_distance);
   }
   CHECK_GE(num_points_, 2);
-  *min_distance = std::numeric_limits<double>::infinity();
-  int min_index = 0;
-  for (int i = 0; i < num_segments_; ++i) {
-    const double distance = segments_[i].DistanceSquareTo(point);
-    if (distance < *min_distance) {
-      min_index = i;
-      *min_distance = distance;
+  const int min_index =
+      projection_index_.GetNearestSegment(point, -1, min_distance);
+  *min_distance = std::sqrt(*min_distance);
+  GetProjectionOntoSegment(point, min_index, *min_distance, accumulate_s,
+                           lateral);
+  return true;
+}
+
+bool Path::GetProjections(const std::vector<Vec2d>& points,
+                          std::vector<double>* accumulate_s,
+                          std::vector<double>* lateral) const {
+  if (segments_.empty()) {
+    return false;
+  }
+  if (accumulate_s == nullptr || lateral == nullptr) {
+    return false;
+  }
+  accumulate_s->resize(points.size());
+  lateral->resize(points.size());
+  double min_distance = 0.0;
+  if (use_path_approximation_) {
+    for (size_t i = 0; i < points.size(); ++i) {
+      if (!approximation_.GetProjection(*this, points[i], &(*accumulate_s)[i],
+                                        &(*lateral)[i], &min_distance)) {
+        return false;
+      }
     }
+    return true;
   }
-  *min_distance = std::sqrt(*min_distance);
-  const auto& nearest_seg = segments_[min_index];
+  // the segment nearest to the previous point bounds the search
+  int min_index = -1;
+  for (size_t i = 0; i < points.size(); ++i) {
+    min_index = projection_index_.GetNearestSegment(points[i], min_index,
+                                                    &min_distance);
+    GetProjectionOntoSegment(points[i], min_index, std::sqrt(min_distance),
+                             &(*accumulate_s)[i], &(*lateral)[i]);
+  }
+  return true;
+}
+
+void Path::GetProjectionOntoSegment(const Vec2d& point,
+                                    const int segment_index,
+                                    const double min_distance,
+                                    double* accumulate_s,
+                                    double* lateral) const {
+  const auto& nearest_seg = segments_[segment_index];
   const auto prod = nearest_seg.ProductOntoUnit(point);
   const auto proj = nearest_seg.ProjectOntoUnit(point);
-  if (min_index == 0) {
+  if (segment_index == 0) {
     *accumulate_s = std::min(proj, nearest_seg.length());
     if (proj < 0) {
       *lateral = prod;
     } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+      *lateral = (prod > 0.0 ? 1 : -1) * min_distance;
     }
-  } else if (min_index == num_segments_ - 1) {
-    *accumulate_s = accumulated_s_[min_index] + std::max(0.0, proj);
+  } else if (segment_index == num_segments_ - 1) {
+    *accumulate_s = accumulated_s_[segment_index] + std::max(0.0, proj);
     if (proj > 0) {
       *lateral = prod;
     } else {
-      *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+      *lateral = (prod > 0.0 ? 1 : -1) * min_distance;
     }
   } else {
-    *accumulate_s = accumulated_s_[min_index] +
+    *accumulate_s = accumulated_s_[segment_index] +
                     std::max(0.0, std::min(proj, nearest_seg.length()));
-    *lateral = (prod > 0.0 ? 1 : -1) * *min_distance;
+    *lateral = (prod > 0.0 ? 1 : -1) * min_distance;
   }
-  return true;
 }
 
 bool Path::GetHeadingAlongPath(const Vec2d& point, double* heading) const {
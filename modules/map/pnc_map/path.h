@@ -29,6 +29,7 @@
 #include "modules/map/hdmap/hdmap.h"
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/map/hdmap/hdmap_util.h"
+#include "modules/map/pnc_map/path_projection_index.h"
 
 namespace apollo {
 namespace hdmap {
@@ -260,6 +261,11 @@ class Path {
                      double* lateral) const;
   bool GetProjection(const common::math::Vec2d& point, double* accumulate_s,
                      double* lateral, double* distance) const;
+  // Projects many points at once, as GetProjection. Neighbouring points
+  // are cheaper to project one after the other.
+  bool GetProjections(const std::vector<common::math::Vec2d>& points,
+                      std::vector<double>* accumulate_s,
+                      std::vector<double>* lateral) const;
 
   bool GetHeadingAlongPath(const common::math::Vec2d& point,
                            double* heading) const;
@@ -341,6 +347,11 @@ class Path {
 
   double GetSample(const std::vector<double>& samples, const double s) const;
 
+  void GetProjectionOntoSegment(const common::math::Vec2d& point,
+                                const int segment_index,
+                                const double min_distance,
+                                double* accumulate_s, double* lateral) const;
+
   using GetOverlapFromLaneFunc =
       std::function<const std::vector<OverlapInfoConstPtr>&(const LaneInfo&)>;
   void GetAllOverlaps(GetOverlapFromLaneFunc GetOverlaps_from_lane,
@@ -357,6 +368,7 @@ class Path {
   double length_ = 0.0;
   std::vector<double> accumulated_s_;
   std::vector<common::math::LineSegment2d> segments_;
+  PathProjectionIndex projection_index_;
   bool use_path_approximation_ = false;
   PathApproximation approximation_;
 
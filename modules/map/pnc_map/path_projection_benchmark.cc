@@ -0,0 +1,151 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+// Compares Path::GetProjection and Path::GetProjections with the linear
+// scan over the path segments they replace, on the paths along the first
+// passages of the sample routing of the Sunnyvale loop map, cut to the
+// given number of points. The points projected are the corners of boxes
+// spread within 10 m of the path, as for obstacle SL boundaries.
+//
+// bazel run //modules/map/pnc_map:path_projection_benchmark
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/file.h"
+#include "modules/map/hdmap/hdmap.h"
+#include "modules/map/hdmap/hdmap_util.h"
+#include "modules/map/pnc_map/path.h"
+#include "modules/routing/proto/routing.pb.h"
+
+namespace apollo {
+namespace hdmap {
+
+using apollo::common::math::Box2d;
+using apollo::common::math::Vec2d;
+
+const char kMapFile[] = "modules/map/data/sunnyvale_loop/base_map_test.bin";
+const char kRoutingFile[] =
+    "modules/map/pnc_map/testdata/sample_sunnyvale_loop_routing.pb.txt";
+
+const std::vector<MapPathPoint>& RoutingPathPoints() {
+  static const std::vector<MapPathPoint> points = [] {
+    static HDMap hdmap;
+    CHECK_EQ(0, hdmap.LoadMapFromFile(kMapFile));
+    routing::RoutingResponse routing;
+    CHECK(cyber::common::GetProtoFromFile(kRoutingFile, &routing));
+    std::vector<LaneSegment> lane_segments;
+    for (const auto& road : routing.road()) {
+      for (const auto& segment : road.passage(0).segment()) {
+        const auto lane = hdmap.GetLaneById(MakeMapId(segment.id()));
+        CHECK(lane != nullptr) << segment.id();
+        lane_segments.emplace_back(lane, segment.start_s(), segment.end_s());
+      }
+    }
+    return Path(std::move(lane_segments)).path_points();
+  }();
+  return points;
+}
+
+Path RoutingPath(const int num_points) {
+  const auto& points = RoutingPathPoints();
+  return Path(std::vector<MapPathPoint>(
+      points.begin(),
+      points.begin() + std::min<size_t>(num_points, points.size())));
+}
+
+std::vector<Vec2d> BoxCorners(const Path& path) {
+  std::mt19937 gen(path.num_points());
+  std::uniform_real_distribution<double> s(0.0, path.length());
+  std::uniform_real_distribution<double> l(-10.0, 10.0);
+  std::uniform_real_distribution<double> heading(-M_PI, M_PI);
+  std::vector<Vec2d> corners;
+  for (int i = 0; i < 256; ++i) {
+    const auto point = path.GetSmoothPoint(s(gen));
+    const Vec2d center =
+        point + Vec2d::CreateUnitVec2d(point.heading() + M_PI_2) * l(gen);
+    const Box2d box(center, heading(gen), 4.5, 2.0);
+    std::vector<Vec2d> box_corners;
+    box.GetAllCorners(&box_corners);
+    corners.insert(corners.end(), box_corners.begin(), box_corners.end());
+  }
+  return corners;
+}
+
+void BM_ScanProjection(benchmark::State& state) {  // NOLINT
+  const Path path = RoutingPath(static_cast<int>(state.range(0)));
+  const std::vector<Vec2d> points = BoxCorners(path);
+  std::vector<double> accumulate_s(points.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < points.size(); ++i) {
+      double min_distance = std::numeric_limits<double>::infinity();
+      int min_index = 0;
+      for (int j = 0; j < path.num_segments(); ++j) {
+        const double distance = path.segments()[j].DistanceSquareTo(points[i]);
+        if (distance < min_distance) {
+          min_index = j;
+          min_distance = distance;
+        }
+      }
+      accumulate_s[i] = path.accumulated_s()[min_index] +
+                        path.segments()[min_index].ProjectOntoUnit(points[i]);
+    }
+    benchmark::DoNotOptimize(accumulate_s.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+  state.SetLabel(std::to_string(path.num_segments()) + " segments");
+}
+BENCHMARK(BM_ScanProjection)->Arg(256)->Arg(1024)->Arg(1 << 20);
+
+void BM_GetProjection(benchmark::State& state) {  // NOLINT
+  const Path path = RoutingPath(static_cast<int>(state.range(0)));
+  const std::vector<Vec2d> points = BoxCorners(path);
+  std::vector<double> accumulate_s(points.size());
+  double lateral = 0.0;
+  for (auto _ : state) {
+    for (size_t i = 0; i < points.size(); ++i) {
+      path.GetProjection(points[i], &accumulate_s[i], &lateral);
+    }
+    benchmark::DoNotOptimize(accumulate_s.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+  state.SetLabel(std::to_string(path.num_segments()) + " segments");
+}
+BENCHMARK(BM_GetProjection)->Arg(256)->Arg(1024)->Arg(1 << 20);
+
+void BM_GetProjections(benchmark::State& state) {  // NOLINT
+  const Path path = RoutingPath(static_cast<int>(state.range(0)));
+  const std::vector<Vec2d> points = BoxCorners(path);
+  std::vector<double> accumulate_s;
+  std::vector<double> lateral;
+  for (auto _ : state) {
+    path.GetProjections(points, &accumulate_s, &lateral);
+    benchmark::DoNotOptimize(accumulate_s.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+  state.SetLabel(std::to_string(path.num_segments()) + " segments");
+}
+BENCHMARK(BM_GetProjections)->Arg(256)->Arg(1024)->Arg(1 << 20);
+
+}  // namespace hdmap
+}  // namespace apollo
+
+BENCHMARK_MAIN();
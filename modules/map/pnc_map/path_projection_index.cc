@@ -0,0 +1,231 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/map/pnc_map/path_projection_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "modules/common/math/math_utils.h"
+
+namespace apollo {
+namespace hdmap {
+
+using apollo::common::math::kMathEpsilon;
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Sqr;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+// Paths with fewer segments are scanned, it is as fast as the grid.
+const int kMinSegmentsToIndex = 16;
+const double kMinCellSize = 0.1;
+// Cell coordinates of points far off the grid are clamped to this, which
+// keeps the ring bounds valid since the grid is on the other side.
+const int kMaxCellCoordinate = 1 << 28;
+// Absorbs the rounding of a point into its cell.
+const double kRingBoundSlack = 1e-6;
+
+}  // namespace
+
+PathProjectionIndex::PathProjectionIndex(
+    const std::vector<LineSegment2d>& segments) {
+  const int num_segments = static_cast<int>(segments.size());
+  start_x_.reserve(num_segments);
+  start_y_.reserve(num_segments);
+  end_x_.reserve(num_segments);
+  end_y_.reserve(num_segments);
+  unit_x_.reserve(num_segments);
+  unit_y_.reserve(num_segments);
+  length_.reserve(num_segments);
+  double total_length = 0.0;
+  double max_x = std::numeric_limits<double>::lowest();
+  double max_y = std::numeric_limits<double>::lowest();
+  min_x_ = std::numeric_limits<double>::max();
+  min_y_ = std::numeric_limits<double>::max();
+  for (const auto& segment : segments) {
+    start_x_.push_back(segment.start().x());
+    start_y_.push_back(segment.start().y());
+    end_x_.push_back(segment.end().x());
+    end_y_.push_back(segment.end().y());
+    unit_x_.push_back(segment.unit_direction().x());
+    unit_y_.push_back(segment.unit_direction().y());
+    length_.push_back(segment.length());
+    total_length += segment.length();
+    min_x_ = std::min({min_x_, segment.start().x(), segment.end().x()});
+    min_y_ = std::min({min_y_, segment.start().y(), segment.end().y()});
+    max_x = std::max({max_x, segment.start().x(), segment.end().x()});
+    max_y = std::max({max_y, segment.start().y(), segment.end().y()});
+  }
+  if (num_segments < kMinSegmentsToIndex) {
+    return;
+  }
+
+  // About one segment per cell along the path, and no more than about four
+  // cells per segment in total however the path winds.
+  const double width = max_x - min_x_;
+  const double height = max_y - min_y_;
+  cell_size_ = std::max({total_length / num_segments,
+                         std::sqrt(width * height / (2.0 * num_segments)),
+                         kMinCellSize});
+  num_cells_x_ = static_cast<int>(width / cell_size_) + 1;
+  num_cells_y_ = static_cast<int>(height / cell_size_) + 1;
+
+  // Buckets the segments by the cells their bounding boxes overlap, first
+  // counting them then filling them in.
+  cell_begin_.assign(num_cells_x_ * num_cells_y_ + 1, 0);
+  for (int pass = 0; pass < 2; ++pass) {
+    std::vector<int> cell_end(cell_begin_.begin(), cell_begin_.end() - 1);
+    for (int i = 0; i < num_segments; ++i) {
+      const int x_begin = CellX(std::min(start_x_[i], end_x_[i]));
+      const int x_end = CellX(std::max(start_x_[i], end_x_[i]));
+      const int y_begin = CellY(std::min(start_y_[i], end_y_[i]));
+      const int y_end = CellY(std::max(start_y_[i], end_y_[i]));
+      for (int cell_y = y_begin; cell_y <= y_end; ++cell_y) {
+        for (int cell_x = x_begin; cell_x <= x_end; ++cell_x) {
+          const int cell = cell_y * num_cells_x_ + cell_x;
+          if (pass == 0) {
+            ++cell_begin_[cell + 1];
+          } else {
+            cell_segments_[cell_end[cell]++] = i;
+          }
+        }
+      }
+    }
+    if (pass == 0) {
+      for (size_t cell = 1; cell < cell_begin_.size(); ++cell) {
+        cell_begin_[cell] += cell_begin_[cell - 1];
+      }
+      cell_segments_.resize(cell_begin_.back());
+    }
+  }
+}
+
+int PathProjectionIndex::GetNearestSegment(const Vec2d& point,
+                                           const int hint,
+                                           double* min_distance_sqr) const {
+  const int num_segments = this->num_segments();
+  if (num_segments == 0) {
+    *min_distance_sqr = std::numeric_limits<double>::infinity();
+    return -1;
+  }
+  const double x = point.x();
+  const double y = point.y();
+  int min_index = hint >= 0 && hint < num_segments ? hint : 0;
+  *min_distance_sqr = DistanceSquareTo(min_index, x, y);
+
+  if (cell_begin_.empty()) {
+    for (int i = 0; i < num_segments; ++i) {
+      UpdateNearest(i, x, y, &min_index, min_distance_sqr);
+    }
+    return min_index;
+  }
+
+  // Searches the rings of cells at Chebyshev distance ring from the cell of
+  // the point, starting from the first one on the grid, until they are
+  // farther than the nearest segment found so far.
+  const int cell_x = CellX(x);
+  const int cell_y = CellY(y);
+  const int last_x = num_cells_x_ - 1;
+  const int last_y = num_cells_y_ - 1;
+  const int first_ring = std::max({0, -cell_x, cell_x - last_x, -cell_y,
+                                   cell_y - last_y});
+  const int last_ring = std::max(
+      {cell_x, last_x - cell_x, cell_y, last_y - cell_y});
+  const auto scan_cell = [&](const int cx, const int cy) {
+    const int cell = cy * num_cells_x_ + cx;
+    for (int j = cell_begin_[cell]; j < cell_begin_[cell + 1]; ++j) {
+      UpdateNearest(cell_segments_[j], x, y, &min_index, min_distance_sqr);
+    }
+  };
+  for (int ring = first_ring; ring <= last_ring; ++ring) {
+    // the cells of the ring are at least ring - 1 cells away from the point
+    if (ring > 0 && (ring - 1) * cell_size_ >
+                        std::sqrt(*min_distance_sqr) + kRingBoundSlack) {
+      break;
+    }
+    // only the cells of the ring on the grid are visited, so all the rings
+    // together cost no more than the grid
+    const int x_begin = std::max(cell_x - ring, 0);
+    const int x_end = std::min(cell_x + ring, last_x);
+    for (const int cy : {cell_y - ring, cell_y + ring}) {
+      if (cy >= 0 && cy <= last_y) {
+        for (int cx = x_begin; cx <= x_end; ++cx) {
+          scan_cell(cx, cy);
+        }
+      }
+      if (ring == 0) {
+        break;
+      }
+    }
+    const int y_begin = std::max(cell_y - ring + 1, 0);
+    const int y_end = std::min(cell_y + ring - 1, last_y);
+    for (const int cx : {cell_x - ring, cell_x + ring}) {
+      if (ring > 0 && cx >= 0 && cx <= last_x) {
+        for (int cy = y_begin; cy <= y_end; ++cy) {
+          scan_cell(cx, cy);
+        }
+      }
+    }
+  }
+  return min_index;
+}
+
+double PathProjectionIndex::DistanceSquareTo(const int index, const double x,
+                                             const double y) const {
+  // the same arithmetic as LineSegment2d::DistanceSquareTo
+  const double x0 = x - start_x_[index];
+  const double y0 = y - start_y_[index];
+  if (length_[index] <= kMathEpsilon) {
+    return Sqr(x0) + Sqr(y0);
+  }
+  const double proj = x0 * unit_x_[index] + y0 * unit_y_[index];
+  if (proj <= 0.0) {
+    return Sqr(x0) + Sqr(y0);
+  }
+  if (proj >= length_[index]) {
+    return Sqr(x - end_x_[index]) + Sqr(y - end_y_[index]);
+  }
+  return Sqr(x0 * unit_y_[index] - y0 * unit_x_[index]);
+}
+
+void PathProjectionIndex::UpdateNearest(const int index, const double x,
+                                        const double y, int* min_index,
+                                        double* min_distance_sqr) const {
+  const double distance_sqr = DistanceSquareTo(index, x, y);
+  if (distance_sqr < *min_distance_sqr ||
+      (distance_sqr == *min_distance_sqr && index < *min_index)) {
+    *min_index = index;
+    *min_distance_sqr = distance_sqr;
+  }
+}
+
+int PathProjectionIndex::CellX(const double x) const {
+  const double cell = std::floor((x - min_x_) / cell_size_);
+  return static_cast<int>(std::max<double>(
+      -kMaxCellCoordinate, std::min<double>(cell, kMaxCellCoordinate)));
+}
+
+int PathProjectionIndex::CellY(const double y) const {
+  const double cell = std::floor((y - min_y_) / cell_size_);
+  return static_cast<int>(std::max<double>(
+      -kMaxCellCoordinate, std::min<double>(cell, kMaxCellCoordinate)));
+}
+
+}  // namespace hdmap
+}  // namespace apollo
@@ -0,0 +1,88 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#pragma once
+
+#include <vector>
+
+#include "modules/common/math/line_segment2d.h"
+#include "modules/common/math/vec2d.h"
+
+namespace apollo {
+namespace hdmap {
+
+/**
+ * @class PathProjectionIndex
+ * @brief Finds the segment of a path nearest to a point without scanning
+ * all of them. The segment endpoints and directions are kept as flat
+ * arrays, and the segments are bucketed in a uniform grid over the path,
+ * which is searched in rings of cells around the point until no closer
+ * segment can be found.
+ *
+ * The result is exactly the one of a linear scan with
+ * LineSegment2d::DistanceSquareTo keeping the first minimum.
+ */
+class PathProjectionIndex {
+ public:
+  PathProjectionIndex() = default;
+  explicit PathProjectionIndex(
+      const std::vector<common::math::LineSegment2d>& segments);
+
+  /**
+   * @brief The index of the segment nearest to point, the lowest one if
+   * several are at the same distance, or -1 if there are no segments.
+   * @param hint a segment likely near the point, e.g. the result for a
+   * neighbouring point, which bounds the search, or -1
+   * @param min_distance_sqr the squared distance to that segment
+   */
+  int GetNearestSegment(const common::math::Vec2d& point, const int hint,
+                        double* min_distance_sqr) const;
+
+  int num_segments() const { return static_cast<int>(length_.size()); }
+
+ private:
+  double DistanceSquareTo(const int index, const double x,
+                          const double y) const;
+
+  void UpdateNearest(const int index, const double x, const double y,
+                     int* min_index, double* min_distance_sqr) const;
+
+  int CellX(const double x) const;
+  int CellY(const double y) const;
+
+  std::vector<double> start_x_;
+  std::vector<double> start_y_;
+  std::vector<double> end_x_;
+  std::vector<double> end_y_;
+  std::vector<double> unit_x_;
+  std::vector<double> unit_y_;
+  std::vector<double> length_;
+
+  // Grid of num_cells_x_ * num_cells_y_ square cells from (min_x_, min_y_),
+  // with the segments whose bounding box overlaps cell i in
+  // cell_segments_[cell_begin_[i], cell_begin_[i + 1]). Empty for short
+  // paths, which are scanned.
+  double min_x_ = 0.0;
+  double min_y_ = 0.0;
+  double cell_size_ = 0.0;
+  int num_cells_x_ = 0;
+  int num_cells_y_ = 0;
+  std::vector<int> cell_begin_;
+  std::vector<int> cell_segments_;
+};
+
+}  // namespace hdmap
+}  // namespace apollo
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+#include "modules/map/pnc_map/path_projection_index.h"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace hdmap {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+namespace {
+
+int ScanNearestSegment(const std::vector<LineSegment2d>& segments,
+                       const Vec2d& point, double* min_distance_sqr) {
+  int min_index = -1;
+  *min_distance_sqr = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < segments.size(); ++i) {
+    const double distance_sqr = segments[i].DistanceSquareTo(point);
+    if (distance_sqr < *min_distance_sqr) {
+      min_index = static_cast<int>(i);
+      *min_distance_sqr = distance_sqr;
+    }
+  }
+  return min_index;
+}
+
+// A winding path in UTM like coordinates, with some repeated points.
+std::vector<LineSegment2d> RandomPath(const int num_points,
+                                      std::mt19937* gen) {
+  std::uniform_real_distribution<double> step(0.0, 2.0);
+  std::uniform_real_distribution<double> turn(-0.3, 0.3);
+  std::uniform_int_distribution<int> repeat(0, 9);
+  std::vector<LineSegment2d> segments;
+  Vec2d point(587000.0, 4140000.0);
+  double heading = 0.0;
+  for (int i = 0; i + 1 < num_points; ++i) {
+    heading += turn(*gen);
+    const double length = repeat(*gen) == 0 ? 0.0 : step(*gen);
+    const Vec2d next = point + Vec2d::CreateUnitVec2d(heading) * length;
+    segments.emplace_back(point, next);
+    point = next;
+  }
+  return segments;
+}
+
+void ExpectSameAsScan(const std::vector<LineSegment2d>& segments,
+                      const PathProjectionIndex& index, const Vec2d& point,
+                      const int hint) {
+  double expected_distance_sqr = 0.0;
+  const int expected =
+      ScanNearestSegment(segments, point, &expected_distance_sqr);
+  double distance_sqr = 0.0;
+  EXPECT_EQ(expected, index.GetNearestSegment(point, hint, &distance_sqr))
+      << point.DebugString() << " hint " << hint;
+  EXPECT_EQ(expected_distance_sqr, distance_sqr);
+}
+
+}  // namespace
+
+TEST(PathProjectionIndexTest, Empty) {
+  PathProjectionIndex index;
+  double distance_sqr = 0.0;
+  EXPECT_EQ(-1, index.GetNearestSegment(Vec2d(1.0, 2.0), -1, &distance_sqr));
+}
+
+TEST(PathProjectionIndexTest, SameAsScan) {
+  std::mt19937 gen(0);
+  for (const int num_points : {2, 10, 100, 2000}) {
+    const auto segments = RandomPath(num_points, &gen);
+    const PathProjectionIndex index(segments);
+    ASSERT_EQ(num_points - 1, index.num_segments());
+
+    std::uniform_int_distribution<int> segment(0, num_points - 2);
+    std::normal_distribution<double> offset(0.0, 5.0);
+    std::normal_distribution<double> far_offset(0.0, 1000.0);
+    int hint = -1;
+    for (int i = 0; i < 500; ++i) {
+      const auto& near = segments[segment(gen)];
+      const Vec2d point = near.start() + Vec2d(offset(gen), offset(gen));
+      ExpectSameAsScan(segments, index, point, -1);
+      // a hint anywhere only bounds the search
+      ExpectSameAsScan(segments, index, point, hint);
+      hint = segment(gen);
+      // on the points of the path, where segments are at the same distance
+      ExpectSameAsScan(segments, index, near.start(), -1);
+      ExpectSameAsScan(segments, index, near.end(), hint);
+      // off the grid
+      ExpectSameAsScan(segments, index,
+                       near.start() + Vec2d(far_offset(gen), far_offset(gen)),
+                       -1);
+    }
+    ExpectSameAsScan(segments, index, Vec2d(0.0, 0.0), -1);
+    ExpectSameAsScan(segments, index, Vec2d(1e30, -1e30), -1);
+  }
+}
+
+TEST(PathProjectionIndexTest, Loop) {
+  // a path going around the same circle twice, the first turn wins
+  std::vector<LineSegment2d> segments;
+  const int kNumPointsPerTurn = 100;
+  for (int i = 0; i < kNumPointsPerTurn; ++i) {
+    segments.emplace_back(
+        Vec2d::CreateUnitVec2d(2.0 * M_PI * i / kNumPointsPerTurn) * 50.0,
+        Vec2d::CreateUnitVec2d(2.0 * M_PI * (i + 1) / kNumPointsPerTurn) *
+            50.0);
+  }
+  for (int i = 0; i < kNumPointsPerTurn; ++i) {
+    segments.push_back(segments[i]);
+  }
+  const PathProjectionIndex index(segments);
+  double distance_sqr = 0.0;
+  for (int i = 0; i < kNumPointsPerTurn; ++i) {
+    const Vec2d point = Vec2d::CreateUnitVec2d(
+                            2.0 * M_PI * (i + 0.5) / kNumPointsPerTurn) *
+                        45.0;
+    EXPECT_EQ(i, index.GetNearestSegment(point, kNumPointsPerTurn + i,
+                                         &distance_sqr));
+    ExpectSameAsScan(segments, index, point, -1);
+  }
+  ExpectSameAsScan(segments, index, Vec2d(0.0, 0.0), -1);
+}
+
+}  // namespace hdmap
+}  // namespace apollo
@@ -22,6 +22,7 @@
 
 #include <list>
 #include <map>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -183,7 +184,8 @@ class Frame {
   const Obstacle *FindCollisionObstacle() const;
 
   /**
-   * @brief create a static virtual obstacle
+   * @brief create a static virtual obstacle. Thread safe, tasks planning
+   * different reference lines concurrently may create stop obstacles.
    */
   const Obstacle *CreateStaticVirtualObstacle(const std::string &id,
                                               const common::math::Box2d &box);
@@ -211,6 +213,8 @@ class Frame {
   const ReferenceLineInfo *drive_reference_line_info_ = nullptr;
 
   ThreadSafeIndexedObstacles obstacles_;
+  // makes the find-or-add of CreateStaticVirtualObstacle atomic
+  std::mutex virtual_obstacle_mutex_;
   std::unordered_map<std::string, const perception::TrafficLight *>
       traffic_lights_;
 
@@ -19,11 +19,22 @@
 namespace apollo {
 namespace planning {
 
+thread_local PlanningStatus* PlanningContext::thread_status_ = nullptr;
+
 PlanningContext::PlanningContext() {}
 
 void PlanningContext::Init() {}
 
-void PlanningContext::Clear() { planning_status_.Clear(); }
+void PlanningContext::Clear() { status()->Clear(); }
+
+PlanningContext::ThreadStatusScope::ThreadStatusScope(PlanningStatus* status)
+    : prev_status_(thread_status_) {
+  thread_status_ = status;
+}
+
+PlanningContext::ThreadStatusScope::~ThreadStatusScope() {
+  thread_status_ = prev_status_;
+}
 
 }  // namespace planning
 }  // namespace apollo
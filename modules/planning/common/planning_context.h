@@ -40,11 +40,32 @@ class PlanningContext {
    * please put all status info inside PlanningStatus for easy maintenance.
    * do NOT create new struct at this level.
    * */
-  const PlanningStatus& planning_status() { return planning_status_; }
-  PlanningStatus* mutable_planning_status() { return &planning_status_; }
+  const PlanningStatus& planning_status() { return *status(); }
+  PlanningStatus* mutable_planning_status() { return status(); }
+
+  /**
+   * @brief Redirects the planning status of the calling thread to a private
+   * copy while alive. Reference lines planned concurrently each run on their
+   * own copy and the stage commits the copy of the chosen line afterwards.
+   * Threads without a redirection share the global status, so they must not
+   * run concurrently with each other.
+   */
+  class ThreadStatusScope {
+   public:
+    explicit ThreadStatusScope(PlanningStatus* status);
+    ~ThreadStatusScope();
+
+   private:
+    PlanningStatus* prev_status_ = nullptr;
+  };
 
  private:
+  PlanningStatus* status() {
+    return thread_status_ != nullptr ? thread_status_ : &planning_status_;
+  }
+
   PlanningStatus planning_status_;
+  static thread_local PlanningStatus* thread_status_;
 
   // this is a singleton class
   DECLARE_SINGLETON(PlanningContext)
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/common/planning_context.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+int Counter() {
+  return PlanningContext::Instance()
+      ->planning_status()
+      .path_decider()
+      .front_static_obstacle_cycle_counter();
+}
+
+void SetCounter(const int counter) {
+  PlanningContext::Instance()
+      ->mutable_planning_status()
+      ->mutable_path_decider()
+      ->set_front_static_obstacle_cycle_counter(counter);
+}
+
+}  // namespace
+
+class PlanningContextTest : public ::testing::Test {
+ protected:
+  void SetUp() override { PlanningContext::Instance()->Clear(); }
+  void TearDown() override { PlanningContext::Instance()->Clear(); }
+};
+
+TEST_F(PlanningContextTest, ThreadStatusScope) {
+  SetCounter(1);
+  PlanningStatus status;
+  {
+    PlanningContext::ThreadStatusScope scope(&status);
+    EXPECT_EQ(0, Counter());
+    SetCounter(2);
+    EXPECT_EQ(2, Counter());
+    {
+      // nested scopes restore the outer redirection
+      PlanningStatus inner_status;
+      PlanningContext::ThreadStatusScope inner_scope(&inner_status);
+      SetCounter(3);
+      EXPECT_EQ(3, inner_status.path_decider()
+                       .front_static_obstacle_cycle_counter());
+    }
+    EXPECT_EQ(2, Counter());
+    PlanningContext::Instance()->Clear();
+    EXPECT_FALSE(status.has_path_decider());
+  }
+  EXPECT_EQ(1, Counter());
+}
+
+TEST_F(PlanningContextTest, ThreadStatusScopeIsPerThread) {
+  SetCounter(1);
+  constexpr int kNumThreads = 4;
+  std::vector<PlanningStatus> status(kNumThreads);
+  std::vector<int> seen(kNumThreads, -1);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&status, &seen, i]() {
+      PlanningContext::ThreadStatusScope scope(&status[i]);
+      for (int k = 0; k < 1000; ++k) {
+        SetCounter(Counter() + 1);
+      }
+      seen[i] = Counter();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kNumThreads; ++i) {
+    EXPECT_EQ(1000, seen[i]);
+    EXPECT_EQ(1000,
+              status[i].path_decider().front_static_obstacle_cycle_counter());
+  }
+  // threads without a scope share the global status
+  EXPECT_EQ(1, Counter());
+  std::thread([]() { EXPECT_EQ(1, Counter()); }).join();
+}
+
+}  // namespace planning
+}  // namespace apollo
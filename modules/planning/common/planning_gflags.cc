@@ -317,6 +317,16 @@ DEFINE_bool(use_multi_thread_to_add_obstacles, false,
             "use multiple thread to add obstacles.");
 DEFINE_bool(enable_multi_thread_in_dp_st_graph, false,
             "Enable multiple thread to calculation curve cost in dp_st_graph.");
+DEFINE_int32(dp_st_graph_thread_num, 3,
+             "Number of worker threads of the multi-thread dp_st_graph, which "
+             "computes the rows of a column together with the caller.");
+DEFINE_string(dp_st_graph_thread_cpuset, "",
+              "CPUs to pin the dp_st_graph worker threads to one by one, "
+              "e.g. 4-6. Empty to leave them unpinned.");
+DEFINE_bool(enable_multi_thread_in_st_boundary_mapper, false,
+            "Enable multiple thread to map obstacles onto the ST-graph.");
+DEFINE_bool(enable_parallel_reference_line_planning, false,
+            "Plan the reference lines of lane follow concurrently.");
 
 /// Lattice Planner
 DEFINE_double(numerical_epsilon, 1e-6, "Epsilon in lattice planner.");
@@ -470,6 +480,10 @@ DEFINE_bool(use_osqp_optimizer_for_reference_line, true,
             "Use OSQP optimizer for reference line optimization.");
 DEFINE_bool(enable_osqp_debug, false,
             "True to turn on OSQP verbose debug output in log.");
+DEFINE_bool(enable_piecewise_jerk_warm_start, false,
+            "Keep the OSQP workspaces of the piecewise jerk path and speed "
+            "optimizers across planning cycles, warm started from the "
+            "previous solution.");
 
 DEFINE_bool(export_chart, false, "export chart in planning");
 DEFINE_bool(enable_record_debug, true,
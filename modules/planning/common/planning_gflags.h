@@ -155,6 +155,10 @@ DECLARE_bool(enable_sqp_solver);
 /// thread pool
 DECLARE_bool(use_multi_thread_to_add_obstacles);
 DECLARE_bool(enable_multi_thread_in_dp_st_graph);
+DECLARE_int32(dp_st_graph_thread_num);
+DECLARE_string(dp_st_graph_thread_cpuset);
+DECLARE_bool(enable_multi_thread_in_st_boundary_mapper);
+DECLARE_bool(enable_parallel_reference_line_planning);
 
 DECLARE_double(numerical_epsilon);
 DECLARE_double(default_cruise_speed);
@@ -232,6 +236,7 @@ DECLARE_bool(enable_parallel_trajectory_smoothing);
 
 DECLARE_bool(use_osqp_optimizer_for_reference_line);
 DECLARE_bool(enable_osqp_debug);
+DECLARE_bool(enable_piecewise_jerk_warm_start);
 DECLARE_bool(export_chart);
 DECLARE_bool(enable_record_debug);
 
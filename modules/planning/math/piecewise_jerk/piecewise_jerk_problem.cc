@@ -16,6 +16,8 @@
 
 #include "modules/planning/math/piecewise_jerk/piecewise_jerk_problem.h"
 
+#include <chrono>
+
 #include "cyber/common/log.h"
 
 #include "modules/planning/common/planning_gflags.h"
@@ -92,23 +94,57 @@ bool PiecewiseJerkProblem::Optimize(const int max_iter) {
   OSQPSettings* settings = SolverDefaultSettings();
   settings->max_iter = max_iter;
 
-  OSQPWorkspace* osqp_work = osqp_setup(data, settings);
+  solve_info_ = PiecewiseJerkSolveInfo();
+  OSQPWorkspace* osqp_work = nullptr;
+  if (workspace_ == nullptr) {
+    const auto setup_start_time = std::chrono::steady_clock::now();
+    osqp_work = osqp_setup(data, settings);
+    solve_info_.setup_time_ms =
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - setup_start_time)
+            .count();
+  } else {
+    osqp_work = workspace_->Prepare(data, settings, &solve_info_);
+  }
+
+  // a workspace kept by the caller is only dropped when the solve fails
+  const auto cleanup = [&](const bool success) {
+    if (workspace_ == nullptr) {
+      osqp_cleanup(osqp_work);
+    } else if (!success) {
+      workspace_->Reset();
+    }
+    FreeData(data);
+    c_free(settings);
+  };
+
+  if (osqp_work == nullptr) {
+    AERROR << "OSQP setup failed";
+    cleanup(false);
+    return false;
+  }
+
+  if (workspace_ != nullptr) {
+    WarmStart(osqp_work);
+  }
 
+  const auto solve_start_time = std::chrono::steady_clock::now();
   osqp_solve(osqp_work);
+  solve_info_.solve_time_ms =
+      std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - solve_start_time)
+          .count();
+  solve_info_.iterations = static_cast<int>(osqp_work->info->iter);
 
   auto status = osqp_work->info->status_val;
 
   if (status < 0 || (status != 1 && status != 2)) {
     AERROR << "failed optimization status:\t" << osqp_work->info->status;
-    osqp_cleanup(osqp_work);
-    FreeData(data);
-    c_free(settings);
+    cleanup(false);
     return false;
   } else if (osqp_work->solution == nullptr) {
     AERROR << "The solution from OSQP is nullptr";
-    osqp_cleanup(osqp_work);
-    FreeData(data);
-    c_free(settings);
+    cleanup(false);
     return false;
   }
 
@@ -122,14 +158,42 @@ bool PiecewiseJerkProblem::Optimize(const int max_iter) {
     ddx_.at(i) =
         osqp_work->solution->x[i + 2 * num_of_knots_] / scale_factor_[2];
   }
+  if (workspace_ != nullptr) {
+    workspace_->SetSolution(delta_s_, x_, dx_, ddx_);
+  }
+
+  ADEBUG << "OSQP " << (solve_info_.reused_workspace ? "update" : "setup")
+         << ": " << solve_info_.setup_time_ms
+         << " ms, solve: " << solve_info_.solve_time_ms << " ms, "
+         << solve_info_.iterations << " iterations"
+         << (solve_info_.warm_started ? ", warm started" : "");
 
   // Cleanup
-  osqp_cleanup(osqp_work);
-  FreeData(data);
-  c_free(settings);
+  cleanup(true);
   return true;
 }
 
+void PiecewiseJerkProblem::WarmStart(OSQPWorkspace* osqp_work) {
+  if (!has_warm_start_shift_) {
+    return;
+  }
+  std::vector<double> x;
+  std::vector<double> dx;
+  std::vector<double> ddx;
+  if (!workspace_->StitchSolution(num_of_knots_, delta_s_, warm_start_shift_,
+                                  warm_start_x_from_start_, &x, &dx, &ddx)) {
+    return;
+  }
+  std::vector<c_float> primal_warm_start(3 * num_of_knots_);
+  for (size_t i = 0; i < num_of_knots_; ++i) {
+    primal_warm_start[i] = x[i] * scale_factor_[0];
+    primal_warm_start[i + num_of_knots_] = dx[i] * scale_factor_[1];
+    primal_warm_start[i + 2 * num_of_knots_] = ddx[i] * scale_factor_[2];
+  }
+  solve_info_.warm_started =
+      osqp_warm_start_x(osqp_work, primal_warm_start.data()) == 0;
+}
+
 void PiecewiseJerkProblem::CalculateAffineConstraint(
     std::vector<c_float>* A_data, std::vector<c_int>* A_indices,
     std::vector<c_int>* A_indptr, std::vector<c_float>* lower_bounds,
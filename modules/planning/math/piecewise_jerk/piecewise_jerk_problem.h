@@ -26,6 +26,8 @@
 
 #include "osqp/include/osqp.h"
 
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_workspace.h"
+
 namespace apollo {
 namespace planning {
 
@@ -93,8 +95,28 @@ class PiecewiseJerkProblem {
   void set_end_state_ref(const std::array<double, 3>& weight_end_state,
                          const std::array<double, 3>& end_state_ref);
 
+  /*
+   * @brief: Solve in a workspace kept by the caller across planning cycles,
+   * see PiecewiseJerkWorkspace. Without one, OSQP is set up from scratch.
+   */
+  void set_workspace(PiecewiseJerkWorkspace* const workspace) {
+    workspace_ = workspace;
+  }
+
+  /*
+   * @brief: Start OSQP from the last solution of the workspace moved
+   * forward by shift, see PiecewiseJerkWorkspace::StitchSolution.
+   */
+  void set_warm_start_shift(const double shift, const bool x_from_start) {
+    has_warm_start_shift_ = true;
+    warm_start_shift_ = shift;
+    warm_start_x_from_start_ = x_from_start;
+  }
+
   virtual bool Optimize(const int max_iter = 4000);
 
+  const PiecewiseJerkSolveInfo& solve_info() const { return solve_info_; }
+
   const std::vector<double>& opt_x() const { return x_; }
 
   const std::vector<double>& opt_dx() const { return dx_; }
@@ -121,6 +143,8 @@ class PiecewiseJerkProblem {
 
   void FreeData(OSQPData* data);
 
+  void WarmStart(OSQPWorkspace* osqp_work);
+
   template <typename T>
   T* CopyData(const std::vector<T>& vec) {
     T* data = new T[vec.size()];
@@ -158,6 +182,13 @@ class PiecewiseJerkProblem {
   bool has_end_state_ref_ = false;
   std::array<double, 3> weight_end_state_ = {{0.0, 0.0, 0.0}};
   std::array<double, 3> end_state_ref_;
+
+  PiecewiseJerkWorkspace* workspace_ = nullptr;
+  bool has_warm_start_shift_ = false;
+  double warm_start_shift_ = 0.0;
+  bool warm_start_x_from_start_ = false;
+
+  PiecewiseJerkSolveInfo solve_info_;
 };
 
 }  // namespace planning
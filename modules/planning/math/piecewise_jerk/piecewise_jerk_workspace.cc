@@ -0,0 +1,159 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_workspace.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+namespace {
+
+bool SamePattern(const csc* matrix, const std::vector<c_int>& indices,
+                 const std::vector<c_int>& indptr) {
+  if (static_cast<size_t>(matrix->n) + 1 != indptr.size() ||
+      !std::equal(indptr.begin(), indptr.end(), matrix->p)) {
+    return false;
+  }
+  const c_int nnz = matrix->p[matrix->n];
+  return static_cast<size_t>(nnz) == indices.size() &&
+         std::equal(indices.begin(), indices.end(), matrix->i);
+}
+
+void CopyPattern(const csc* matrix, std::vector<c_int>* indices,
+                 std::vector<c_int>* indptr) {
+  indptr->assign(matrix->p, matrix->p + matrix->n + 1);
+  indices->assign(matrix->i, matrix->i + matrix->p[matrix->n]);
+}
+
+// Value of a solution sampled delta_s apart at s, linearly interpolated and
+// held at the last knot past its end.
+double Interpolate(const std::vector<double>& values, const double delta_s,
+                   const double s) {
+  const double index = s / delta_s;
+  if (index >= static_cast<double>(values.size() - 1)) {
+    return values.back();
+  }
+  const size_t lower = static_cast<size_t>(index);
+  const double weight = index - static_cast<double>(lower);
+  return values[lower] * (1.0 - weight) + values[lower + 1] * weight;
+}
+
+}  // namespace
+
+PiecewiseJerkWorkspace::~PiecewiseJerkWorkspace() { CleanupWork(); }
+
+OSQPWorkspace* PiecewiseJerkWorkspace::Prepare(
+    OSQPData* data, OSQPSettings* settings,
+    PiecewiseJerkSolveInfo* solve_info) {
+  const auto start_time = std::chrono::steady_clock::now();
+
+  solve_info->reused_workspace = false;
+  if (work_ != nullptr && data->m == num_constraints_ &&
+      SamePattern(data->P, P_indices_, P_indptr_) &&
+      SamePattern(data->A, A_indices_, A_indptr_)) {
+    // OSQP keeps the upper triangular part of P only
+    std::vector<c_float> P_triu_data;
+    for (c_int j = 0; j < data->P->n; ++j) {
+      for (c_int k = data->P->p[j]; k < data->P->p[j + 1]; ++k) {
+        if (data->P->i[k] <= j) {
+          P_triu_data.push_back(data->P->x[k]);
+        }
+      }
+    }
+    solve_info->reused_workspace =
+        osqp_update_P_A(work_, P_triu_data.data(), OSQP_NULL,
+                        static_cast<c_int>(P_triu_data.size()), data->A->x,
+                        OSQP_NULL, data->A->p[data->A->n]) == 0 &&
+        osqp_update_lin_cost(work_, data->q) == 0 &&
+        osqp_update_bounds(work_, data->l, data->u) == 0 &&
+        osqp_update_max_iter(work_, settings->max_iter) == 0;
+    if (!solve_info->reused_workspace) {
+      AWARN << "Failed to update the OSQP workspace, set it up again.";
+    }
+  }
+
+  if (!solve_info->reused_workspace) {
+    CleanupWork();
+    work_ = osqp_setup(data, settings);
+    num_constraints_ = data->m;
+    CopyPattern(data->P, &P_indices_, &P_indptr_);
+    CopyPattern(data->A, &A_indices_, &A_indptr_);
+  }
+
+  solve_info->setup_time_ms =
+      std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - start_time)
+          .count();
+  return work_;
+}
+
+void PiecewiseJerkWorkspace::Reset() {
+  CleanupWork();
+  x_.clear();
+  dx_.clear();
+  ddx_.clear();
+}
+
+void PiecewiseJerkWorkspace::CleanupWork() {
+  if (work_ != nullptr) {
+    osqp_cleanup(work_);
+    work_ = nullptr;
+  }
+}
+
+void PiecewiseJerkWorkspace::SetSolution(const double delta_s,
+                                         const std::vector<double>& x,
+                                         const std::vector<double>& dx,
+                                         const std::vector<double>& ddx) {
+  delta_s_ = delta_s;
+  x_ = x;
+  dx_ = dx;
+  ddx_ = ddx;
+}
+
+bool PiecewiseJerkWorkspace::StitchSolution(
+    const size_t num_of_knots, const double delta_s, const double shift,
+    const bool x_from_start, std::vector<double>* x, std::vector<double>* dx,
+    std::vector<double>* ddx) const {
+  if (x_.size() < 2 || !(shift >= 0.0) ||
+      shift > delta_s_ * static_cast<double>(x_.size() - 1)) {
+    return false;
+  }
+  const double x_offset =
+      x_from_start ? Interpolate(x_, delta_s_, shift) : 0.0;
+  x->resize(num_of_knots);
+  dx->resize(num_of_knots);
+  ddx->resize(num_of_knots);
+  for (size_t i = 0; i < num_of_knots; ++i) {
+    const double s = shift + static_cast<double>(i) * delta_s;
+    (*x)[i] = Interpolate(x_, delta_s_, s) - x_offset;
+    (*dx)[i] = Interpolate(dx_, delta_s_, s);
+    (*ddx)[i] = Interpolate(ddx_, delta_s_, s);
+  }
+  return true;
+}
+
+}  // namespace planning
+}  // namespace apollo
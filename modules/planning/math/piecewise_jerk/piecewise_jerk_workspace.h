@@ -0,0 +1,117 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "osqp/include/osqp.h"
+
+namespace apollo {
+namespace planning {
+
+/*
+ * @brief: What the last Optimize() of a piecewise jerk problem did.
+ */
+struct PiecewiseJerkSolveInfo {
+  // the OSQP workspace of the previous solve was updated instead of set up
+  bool reused_workspace = false;
+  // OSQP started from the stitched previous solution
+  bool warm_started = false;
+  int iterations = 0;
+  // time of osqp_setup or of the osqp_update_* calls
+  double setup_time_ms = 0.0;
+  double solve_time_ms = 0.0;
+};
+
+/*
+ * @brief:
+ * An OSQP workspace kept alive across planning cycles by a task, together
+ * with the last solution solved in it.
+ *
+ * The kernel and constraint matrices of a piecewise jerk problem only
+ * change their values from one cycle to the next as long as the number of
+ * knots is the same. In that case the workspace is updated with
+ * osqp_update_* and the KKT factorization is reused, otherwise it is set up
+ * again. A workspace must only be used by one kind of problem, since the
+ * solver settings are taken from its first setup.
+ */
+class PiecewiseJerkWorkspace {
+ public:
+  PiecewiseJerkWorkspace() = default;
+
+  ~PiecewiseJerkWorkspace();
+
+  PiecewiseJerkWorkspace(const PiecewiseJerkWorkspace&) = delete;
+  PiecewiseJerkWorkspace& operator=(const PiecewiseJerkWorkspace&) = delete;
+
+  /*
+   * @brief: Gives the OSQP workspace for the problem in data, updated from
+   * the previous one if the sparsity patterns match, else set up anew.
+   * The workspace stays owned by this object.
+   */
+  OSQPWorkspace* Prepare(OSQPData* data, OSQPSettings* settings,
+                         PiecewiseJerkSolveInfo* solve_info);
+
+  /*
+   * @brief: Drops the OSQP workspace and the last solution.
+   */
+  void Reset();
+
+  /*
+   * @brief: Remembers the solution of a successful solve, in the unscaled
+   * variables of the problem.
+   */
+  void SetSolution(const double delta_s, const std::vector<double>& x,
+                   const std::vector<double>& dx,
+                   const std::vector<double>& ddx);
+
+  /*
+   * @brief: The last solution moved forward by shift along s and
+   * resampled on num_of_knots knots delta_s apart. With x_from_start, x is
+   * measured from the new start, as the s of a speed profile.
+   * @return false if there is no solution to stitch or shift is out of it
+   */
+  bool StitchSolution(const size_t num_of_knots, const double delta_s,
+                      const double shift, const bool x_from_start,
+                      std::vector<double>* x, std::vector<double>* dx,
+                      std::vector<double>* ddx) const;
+
+ private:
+  void CleanupWork();
+
+  OSQPWorkspace* work_ = nullptr;
+
+  // sparsity patterns the workspace was set up with
+  c_int num_constraints_ = 0;
+  std::vector<c_int> P_indices_;
+  std::vector<c_int> P_indptr_;
+  std::vector<c_int> A_indices_;
+  std::vector<c_int> A_indptr_;
+
+  double delta_s_ = 0.0;
+  std::vector<double> x_;
+  std::vector<double> dx_;
+  std::vector<double> ddx_;
+};
+
+}  // namespace planning
+}  // namespace apollo
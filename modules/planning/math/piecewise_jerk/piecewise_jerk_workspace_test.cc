@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_workspace.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+TEST(PiecewiseJerkWorkspaceTest, StitchSolution) {
+  PiecewiseJerkWorkspace workspace;
+  std::vector<double> x;
+  std::vector<double> dx;
+  std::vector<double> ddx;
+  EXPECT_FALSE(workspace.StitchSolution(3, 1.0, 0.0, false, &x, &dx, &ddx));
+
+  // x = s^2 / 2 sampled at s = 0, 1, 2, 3
+  workspace.SetSolution(1.0, {0.0, 0.5, 2.0, 4.5}, {0.0, 1.0, 2.0, 3.0},
+                        {1.0, 1.0, 1.0, 1.0});
+  EXPECT_FALSE(workspace.StitchSolution(3, 1.0, -0.5, false, &x, &dx, &ddx));
+  EXPECT_FALSE(workspace.StitchSolution(3, 1.0, 3.5, false, &x, &dx, &ddx));
+
+  ASSERT_TRUE(workspace.StitchSolution(4, 1.0, 0.5, false, &x, &dx, &ddx));
+  ASSERT_EQ(4U, x.size());
+  EXPECT_DOUBLE_EQ(0.25, x[0]);
+  EXPECT_DOUBLE_EQ(1.25, x[1]);
+  EXPECT_DOUBLE_EQ(3.25, x[2]);
+  // held at the last knot
+  EXPECT_DOUBLE_EQ(4.5, x[3]);
+  EXPECT_DOUBLE_EQ(0.5, dx[0]);
+  EXPECT_DOUBLE_EQ(3.0, dx[3]);
+  EXPECT_DOUBLE_EQ(1.0, ddx[2]);
+
+  ASSERT_TRUE(workspace.StitchSolution(2, 2.0, 1.0, true, &x, &dx, &ddx));
+  ASSERT_EQ(2U, x.size());
+  EXPECT_DOUBLE_EQ(0.0, x[0]);
+  EXPECT_DOUBLE_EQ(4.0, x[1]);
+  EXPECT_DOUBLE_EQ(1.0, dx[0]);
+  EXPECT_DOUBLE_EQ(3.0, dx[1]);
+
+  workspace.Reset();
+  EXPECT_FALSE(workspace.StitchSolution(3, 1.0, 0.0, false, &x, &dx, &ddx));
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -20,6 +20,9 @@
 
 #include "modules/planning/open_space/coarse_trajectory_generator/grid_search.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace apollo {
 namespace planning {
 
@@ -58,34 +61,34 @@ bool GridSearch::CheckConstraints(std::shared_ptr<Node2d> node) {
 
 std::vector<std::shared_ptr<Node2d>> GridSearch::GenerateNextNodes(
     std::shared_ptr<Node2d> current_node) {
-  double current_node_x = current_node->GetGridX();
-  double current_node_y = current_node->GetGridY();
+  const int current_node_x = static_cast<int>(current_node->GetGridX());
+  const int current_node_y = static_cast<int>(current_node->GetGridY());
   double current_node_path_cost = current_node->GetPathCost();
   double diagonal_distance = std::sqrt(2.0);
   std::vector<std::shared_ptr<Node2d>> next_nodes;
-  std::shared_ptr<Node2d> up =
-      std::make_shared<Node2d>(current_node_x, current_node_y + 1.0, XYbounds_);
+  std::shared_ptr<Node2d> up = MakeArenaShared<Node2d>(
+      &node_arena_, current_node_x, current_node_y + 1, XYbounds_);
   up->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> up_right = std::make_shared<Node2d>(
-      current_node_x + 1.0, current_node_y + 1.0, XYbounds_);
+  std::shared_ptr<Node2d> up_right = MakeArenaShared<Node2d>(
+      &node_arena_, current_node_x + 1, current_node_y + 1, XYbounds_);
   up_right->SetPathCost(current_node_path_cost + diagonal_distance);
-  std::shared_ptr<Node2d> right =
-      std::make_shared<Node2d>(current_node_x + 1.0, current_node_y, XYbounds_);
+  std::shared_ptr<Node2d> right = MakeArenaShared<Node2d>(
+      &node_arena_, current_node_x + 1, current_node_y, XYbounds_);
   right->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> down_right = std::make_shared<Node2d>(
-      current_node_x + 1.0, current_node_y - 1.0, XYbounds_);
+  std::shared_ptr<Node2d> down_right = MakeArenaShared<Node2d>(
+      &node_arena_, current_node_x + 1, current_node_y - 1, XYbounds_);
   down_right->SetPathCost(current_node_path_cost + diagonal_distance);
-  std::shared_ptr<Node2d> down =
-      std::make_shared<Node2d>(current_node_x, current_node_y - 1.0, XYbounds_);
+  std::shared_ptr<Node2d> down = MakeArenaShared<Node2d>(
+      &node_arena_, current_node_x, current_node_y - 1, XYbounds_);
   down->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> down_left = std::make_shared<Node2d>(
-      current_node_x - 1.0, current_node_y - 1.0, XYbounds_);
+  std::shared_ptr<Node2d> down_left = MakeArenaShared<Node2d>(
+      &node_arena_, current_node_x - 1, current_node_y - 1, XYbounds_);
   down_left->SetPathCost(current_node_path_cost + diagonal_distance);
-  std::shared_ptr<Node2d> left =
-      std::make_shared<Node2d>(current_node_x - 1.0, current_node_y, XYbounds_);
+  std::shared_ptr<Node2d> left = MakeArenaShared<Node2d>(
+      &node_arena_, current_node_x - 1, current_node_y, XYbounds_);
   left->SetPathCost(current_node_path_cost + 1.0);
-  std::shared_ptr<Node2d> up_left = std::make_shared<Node2d>(
-      current_node_x - 1.0, current_node_y + 1.0, XYbounds_);
+  std::shared_ptr<Node2d> up_left = MakeArenaShared<Node2d>(
+      &node_arena_, current_node_x - 1, current_node_y + 1, XYbounds_);
   up_left->SetPathCost(current_node_path_cost + diagonal_distance);
 
   next_nodes.emplace_back(up);
@@ -105,16 +108,17 @@ bool GridSearch::GenerateAStarPath(
     const std::vector<std::vector<common::math::LineSegment2d>>&
         obstacles_linesegments_vec,
     GridAStartResult* result) {
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
+  std::priority_queue<std::pair<uint64_t, double>,
+                      std::vector<std::pair<uint64_t, double>>, cmp>
       open_pq;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> close_set;
+  absl::flat_hash_map<uint64_t, std::shared_ptr<Node2d>> open_set;
+  absl::flat_hash_map<uint64_t, std::shared_ptr<Node2d>> close_set;
   XYbounds_ = XYbounds;
-  std::shared_ptr<Node2d> start_node =
-      std::make_shared<Node2d>(sx, sy, xy_grid_resolution_, XYbounds_);
-  std::shared_ptr<Node2d> end_node =
-      std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
+  node_arena_.Reset();
+  std::shared_ptr<Node2d> start_node = MakeArenaShared<Node2d>(
+      &node_arena_, sx, sy, xy_grid_resolution_, XYbounds_);
+  std::shared_ptr<Node2d> end_node = MakeArenaShared<Node2d>(
+      &node_arena_, ex, ey, xy_grid_resolution_, XYbounds_);
   std::shared_ptr<Node2d> final_node_ = nullptr;
   obstacles_linesegments_vec_ = obstacles_linesegments_vec;
   open_set.emplace(start_node->GetIndex(), start_node);
@@ -123,7 +127,7 @@ bool GridSearch::GenerateAStarPath(
   // Grid a star begins
   size_t explored_node_num = 0;
   while (!open_pq.empty()) {
-    std::string current_id = open_pq.top().first;
+    const uint64_t current_id = open_pq.top().first;
     open_pq.pop();
     std::shared_ptr<Node2d> current_node = open_set[current_id];
     // Check destination
@@ -166,61 +170,231 @@ bool GridSearch::GenerateDpMap(
     const double ex, const double ey, const std::vector<double>& XYbounds,
     const std::vector<std::vector<common::math::LineSegment2d>>&
         obstacles_linesegments_vec) {
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
-      open_pq;
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> open_set;
-  dp_map_ = decltype(dp_map_)();
   XYbounds_ = XYbounds;
   // XYbounds with xmin, xmax, ymin, ymax
   max_grid_y_ = std::round((XYbounds_[3] - XYbounds_[2]) / xy_grid_resolution_);
   max_grid_x_ = std::round((XYbounds_[1] - XYbounds_[0]) / xy_grid_resolution_);
-  std::shared_ptr<Node2d> end_node =
-      std::make_shared<Node2d>(ex, ey, xy_grid_resolution_, XYbounds_);
   obstacles_linesegments_vec_ = obstacles_linesegments_vec;
-  open_set.emplace(end_node->GetIndex(), end_node);
-  open_pq.emplace(end_node->GetIndex(), end_node->GetCost());
+  const int end_grid_x =
+      static_cast<int>((ex - XYbounds_[0]) / xy_grid_resolution_);
+  const int end_grid_y =
+      static_cast<int>((ey - XYbounds_[2]) / xy_grid_resolution_);
 
-  // Grid a star begins
-  size_t explored_node_num = 0;
-  while (!open_pq.empty()) {
-    const std::string current_id = open_pq.top().first;
-    open_pq.pop();
-    std::shared_ptr<Node2d> current_node = open_set[current_id];
-    dp_map_.emplace(current_node->GetIndex(), current_node);
-    std::vector<std::shared_ptr<Node2d>> next_nodes =
-        std::move(GenerateNextNodes(current_node));
-    for (auto& next_node : next_nodes) {
-      if (!CheckConstraints(next_node)) {
-        continue;
-      }
-      if (dp_map_.find(next_node->GetIndex()) != dp_map_.end()) {
-        continue;
+  std::vector<std::array<double, 4>> segments;
+  for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
+    for (const auto& linesegment : obstacle_linesegments) {
+      segments.push_back({linesegment.start().x(), linesegment.start().y(),
+                          linesegment.end().x(), linesegment.end().y()});
+    }
+  }
+  std::sort(segments.begin(), segments.end());
+
+  // the map only depends on the end cell, the grid and the obstacles
+  const bool same_grid = dp_map_valid_ && dp_XYbounds_ == XYbounds_ &&
+                         dp_end_grid_x_ == end_grid_x &&
+                         dp_end_grid_y_ == end_grid_y;
+  if (same_grid && dp_segments_ == segments) {
+    ADEBUG << "dp map reused";
+    return true;
+  }
+  if (same_grid && RepairDpMap(segments)) {
+    dp_segments_ = std::move(segments);
+    return true;
+  }
+
+  dp_map_valid_ = false;
+  dp_XYbounds_ = XYbounds_;
+  dp_grid_x_num_ = static_cast<int>(max_grid_x_) + 1;
+  dp_grid_y_num_ = static_cast<int>(max_grid_y_) + 1;
+  dp_end_grid_x_ = end_grid_x;
+  dp_end_grid_y_ = end_grid_y;
+  const int64_t end_offset = DpMapOffset(end_grid_x, end_grid_y);
+  if (end_offset < 0) {
+    AERROR << "dp map end point out of XYbounds";
+    return false;
+  }
+  const size_t cell_num = static_cast<size_t>(dp_grid_x_num_) *
+                          static_cast<size_t>(dp_grid_y_num_);
+  dp_map_.assign(cell_num, std::numeric_limits<double>::infinity());
+  dp_parent_.assign(cell_num, -1);
+  dp_blocked_.assign(cell_num, 0);
+  std::vector<int64_t> cells;
+  for (const auto& segment : segments) {
+    SegmentCells(segment, &cells);
+  }
+  for (const int64_t cell : cells) {
+    dp_blocked_[cell] = CellBlocked(cell);
+  }
+
+  DpQueue open_pq;
+  dp_map_[end_offset] = 0.0;
+  open_pq.emplace(0.0, end_offset);
+  const size_t explored_node_num = PropagateDpMap(&open_pq);
+  dp_segments_ = std::move(segments);
+  dp_map_valid_ = true;
+  ADEBUG << "explored node num is " << explored_node_num;
+  return true;
+}
+
+bool GridSearch::RepairDpMap(
+    const std::vector<std::array<double, 4>>& segments) {
+  // obstacles only affect the cells around the segments that were added or
+  // removed, every other cell keeps its blocked state
+  std::vector<std::array<double, 4>> changed_segments;
+  std::set_symmetric_difference(dp_segments_.begin(), dp_segments_.end(),
+                                segments.begin(), segments.end(),
+                                std::back_inserter(changed_segments));
+  std::vector<int64_t> cells;
+  for (const auto& segment : changed_segments) {
+    SegmentCells(segment, &cells);
+    if (cells.size() * kMaxRepairRatio > dp_map_.size()) {
+      ADEBUG << "dp map changes too much to repair";
+      return false;
+    }
+  }
+
+  std::vector<int64_t> blocked_cells;
+  std::vector<int64_t> freed_cells;
+  for (const int64_t cell : cells) {
+    const uint8_t blocked = CellBlocked(cell);
+    if (blocked == dp_blocked_[cell]) {
+      continue;
+    }
+    dp_blocked_[cell] = blocked;
+    if (blocked) {
+      blocked_cells.push_back(cell);
+    } else {
+      freed_cells.push_back(cell);
+    }
+  }
+
+  // drop the cells whose shortest path runs through a newly blocked cell,
+  // the rest of the map still holds valid costs
+  const int64_t end_offset = DpMapOffset(dp_end_grid_x_, dp_end_grid_y_);
+  std::vector<int64_t> invalid_cells;
+  std::vector<int64_t> stack = blocked_cells;
+  while (!stack.empty()) {
+    const int64_t cell = stack.back();
+    stack.pop_back();
+    if (cell == end_offset ||
+        dp_map_[cell] == std::numeric_limits<double>::infinity()) {
+      continue;
+    }
+    dp_map_[cell] = std::numeric_limits<double>::infinity();
+    dp_parent_[cell] = -1;
+    invalid_cells.push_back(cell);
+    ForEachNeighbor(cell, [&](const int64_t next, const double) {
+      if (dp_parent_[next] == cell) {
+        stack.push_back(next);
       }
-      if (open_set.find(next_node->GetIndex()) == open_set.end()) {
-        ++explored_node_num;
-        next_node->SetPreNode(current_node);
-        open_set.emplace(next_node->GetIndex(), next_node);
-        open_pq.emplace(next_node->GetIndex(), next_node->GetCost());
-      } else {
-        if (open_set[next_node->GetIndex()]->GetCost() > next_node->GetCost()) {
-          open_set[next_node->GetIndex()]->SetCost(next_node->GetCost());
-          open_set[next_node->GetIndex()]->SetPreNode(current_node);
-        }
+    });
+  }
+
+  // seed the dropped and freed cells from their settled neighbors and let
+  // the decrease spread from there
+  DpQueue open_pq;
+  invalid_cells.insert(invalid_cells.end(), freed_cells.begin(),
+                       freed_cells.end());
+  for (const int64_t cell : invalid_cells) {
+    if (dp_blocked_[cell]) {
+      continue;
+    }
+    ForEachNeighbor(cell, [&](const int64_t next, const double step) {
+      if (dp_map_[next] + step < dp_map_[cell]) {
+        dp_map_[cell] = dp_map_[next] + step;
+        dp_parent_[cell] = next;
       }
+    });
+    if (dp_map_[cell] < std::numeric_limits<double>::infinity()) {
+      open_pq.emplace(dp_map_[cell], cell);
     }
   }
-  ADEBUG << "explored node num is " << explored_node_num;
+  const size_t explored_node_num = PropagateDpMap(&open_pq);
+  ADEBUG << "dp map repaired, " << blocked_cells.size() << " cells blocked, "
+         << freed_cells.size() << " cells freed, " << explored_node_num
+         << " cells updated";
   return true;
 }
 
+size_t GridSearch::PropagateDpMap(DpQueue* open_pq) {
+  size_t explored_node_num = 0;
+  while (!open_pq->empty()) {
+    const double cost = open_pq->top().first;
+    const int64_t cell = open_pq->top().second;
+    open_pq->pop();
+    if (cost > dp_map_[cell]) {
+      continue;
+    }
+    ForEachNeighbor(cell, [&](const int64_t next, const double step) {
+      if (dp_blocked_[next] || cost + step >= dp_map_[next]) {
+        return;
+      }
+      ++explored_node_num;
+      dp_map_[next] = cost + step;
+      dp_parent_[next] = cell;
+      open_pq->emplace(cost + step, next);
+    });
+  }
+  return explored_node_num;
+}
+
+void GridSearch::SegmentCells(const std::array<double, 4>& segment,
+                              std::vector<int64_t>* cells) const {
+  // the cells CheckConstraints may find within node_radius_ of the segment
+  const int min_x = std::max(
+      0, static_cast<int>(std::floor(std::min(segment[0], segment[2]) -
+                                     node_radius_)));
+  const int max_x = std::min(
+      dp_grid_x_num_ - 1,
+      static_cast<int>(std::ceil(std::max(segment[0], segment[2]) +
+                                 node_radius_)));
+  const int min_y = std::max(
+      0, static_cast<int>(std::floor(std::min(segment[1], segment[3]) -
+                                     node_radius_)));
+  const int max_y = std::min(
+      dp_grid_y_num_ - 1,
+      static_cast<int>(std::ceil(std::max(segment[1], segment[3]) +
+                                 node_radius_)));
+  for (int x = min_x; x <= max_x; ++x) {
+    for (int y = min_y; y <= max_y; ++y) {
+      cells->push_back(DpMapOffset(x, y));
+    }
+  }
+}
+
+uint8_t GridSearch::CellBlocked(const int64_t cell) const {
+  // same test as CheckConstraints
+  const common::math::Vec2d point(
+      static_cast<double>(cell / dp_grid_y_num_),
+      static_cast<double>(cell % dp_grid_y_num_));
+  for (const auto& obstacle_linesegments : obstacles_linesegments_vec_) {
+    for (const common::math::LineSegment2d& linesegment :
+         obstacle_linesegments) {
+      if (linesegment.DistanceTo(point) < node_radius_) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+int64_t GridSearch::DpMapOffset(const int grid_x, const int grid_y) const {
+  if (grid_x < 0 || grid_x >= dp_grid_x_num_ || grid_y < 0 ||
+      grid_y >= dp_grid_y_num_) {
+    return -1;
+  }
+  return static_cast<int64_t>(grid_x) * dp_grid_y_num_ + grid_y;
+}
+
 double GridSearch::CheckDpMap(const double sx, const double sy) {
-  std::string index = Node2d::CalcIndex(sx, sy, xy_grid_resolution_, XYbounds_);
-  if (dp_map_.find(index) != dp_map_.end()) {
-    return dp_map_[index]->GetCost() * xy_grid_resolution_;
-  } else {
+  // XYbounds with xmin, xmax, ymin, ymax
+  const int64_t offset = DpMapOffset(
+      static_cast<int>((sx - dp_XYbounds_[0]) / xy_grid_resolution_),
+      static_cast<int>((sy - dp_XYbounds_[2]) / xy_grid_resolution_));
+  if (!dp_map_valid_ || offset < 0) {
     return std::numeric_limits<double>::infinity();
   }
+  return dp_map_[offset] * xy_grid_resolution_;
 }
 
 void GridSearch::LoadGridAStarResult(GridAStartResult* result) {
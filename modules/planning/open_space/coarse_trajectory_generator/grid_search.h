@@ -20,17 +20,20 @@
 
 #pragma once
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <queue>
-#include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
-#include "absl/strings/str_cat.h"
+#include "absl/container/flat_hash_map.h"
 #include "cyber/common/log.h"
 #include "modules/common/math/line_segment2d.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/node_arena.h"
 #include "modules/planning/proto/planner_open_space_config.pb.h"
 
 namespace apollo {
@@ -43,13 +46,13 @@ class Node2d {
     // XYbounds with xmin, xmax, ymin, ymax
     grid_x_ = static_cast<int>((x - XYbounds[0]) / xy_resolution);
     grid_y_ = static_cast<int>((y - XYbounds[2]) / xy_resolution);
-    index_ = ComputeStringIndex(grid_x_, grid_y_);
+    index_ = ComputeGridIndex(grid_x_, grid_y_);
   }
   Node2d(const int grid_x, const int grid_y,
          const std::vector<double>& XYbounds) {
     grid_x_ = grid_x;
     grid_y_ = grid_y;
-    index_ = ComputeStringIndex(grid_x_, grid_y_);
+    index_ = ComputeGridIndex(grid_x_, grid_y_);
   }
   void SetPathCost(const double path_cost) {
     path_cost_ = path_cost;
@@ -66,23 +69,24 @@ class Node2d {
   double GetPathCost() const { return path_cost_; }
   double GetHeuCost() const { return heuristic_; }
   double GetCost() const { return cost_; }
-  const std::string& GetIndex() const { return index_; }
+  uint64_t GetIndex() const { return index_; }
   std::shared_ptr<Node2d> GetPreNode() const { return pre_node_; }
-  static std::string CalcIndex(const double x, const double y,
-                               const double xy_resolution,
-                               const std::vector<double>& XYbounds) {
+  static uint64_t CalcIndex(const double x, const double y,
+                            const double xy_resolution,
+                            const std::vector<double>& XYbounds) {
     // XYbounds with xmin, xmax, ymin, ymax
     int grid_x = static_cast<int>((x - XYbounds[0]) / xy_resolution);
     int grid_y = static_cast<int>((y - XYbounds[2]) / xy_resolution);
-    return ComputeStringIndex(grid_x, grid_y);
+    return ComputeGridIndex(grid_x, grid_y);
   }
   bool operator==(const Node2d& right) const {
     return right.GetIndex() == index_;
   }
 
  private:
-  static std::string ComputeStringIndex(int x_grid, int y_grid) {
-    return absl::StrCat(x_grid, "_", y_grid);
+  static uint64_t ComputeGridIndex(int x_grid, int y_grid) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x_grid)) << 32) |
+           static_cast<uint64_t>(static_cast<uint32_t>(y_grid));
   }
 
  private:
@@ -91,7 +95,7 @@ class Node2d {
   double path_cost_ = 0.0;
   double heuristic_ = 0.0;
   double cost_ = 0.0;
-  std::string index_;
+  uint64_t index_ = 0;
   std::shared_ptr<Node2d> pre_node_ = nullptr;
 };
 
@@ -125,10 +129,44 @@ class GridSearch {
   bool CheckConstraints(std::shared_ptr<Node2d> node);
   void LoadGridAStarResult(GridAStartResult* result);
 
+  // (cost, cell) min-heap over dense dp map offsets
+  using DpQueue =
+      std::priority_queue<std::pair<double, int64_t>,
+                          std::vector<std::pair<double, int64_t>>,
+                          std::greater<std::pair<double, int64_t>>>;
+  // updates the cached dp map for a new obstacle set, false if the change is
+  // too large and the map should be rebuilt
+  bool RepairDpMap(const std::vector<std::array<double, 4>>& segments);
+  // Dijkstra from the queued cells, returns the number of cells updated
+  size_t PropagateDpMap(DpQueue* open_pq);
+  // appends the cells whose blocked state the segment can affect
+  void SegmentCells(const std::array<double, 4>& segment,
+                    std::vector<int64_t>* cells) const;
+  uint8_t CellBlocked(const int64_t cell) const;
+  // dense offset of a grid cell in dp_map_, -1 if outside of the map
+  int64_t DpMapOffset(const int grid_x, const int grid_y) const;
+  // calls f(neighbor_offset, step_cost) for the 8 neighbors inside the map
+  template <typename F>
+  void ForEachNeighbor(const int64_t cell, F&& f) const {
+    static const int kDx[] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static const int kDy[] = {1, 1, 0, -1, -1, -1, 0, 1};
+    static const double kDiagonal = std::sqrt(2.0);
+    const int grid_x = static_cast<int>(cell / dp_grid_y_num_);
+    const int grid_y = static_cast<int>(cell % dp_grid_y_num_);
+    for (int i = 0; i < 8; ++i) {
+      const int64_t next = DpMapOffset(grid_x + kDx[i], grid_y + kDy[i]);
+      if (next >= 0) {
+        f(next, (kDx[i] != 0 && kDy[i] != 0) ? kDiagonal : 1.0);
+      }
+    }
+  }
+
  private:
   double xy_grid_resolution_ = 0.0;
   double node_radius_ = 0.0;
   std::vector<double> XYbounds_;
+  // declared before every member holding nodes so it is destroyed last
+  NodeArena node_arena_;
   double max_grid_x_ = 0.0;
   double max_grid_y_ = 0.0;
   std::shared_ptr<Node2d> start_node_;
@@ -138,12 +176,30 @@ class GridSearch {
       obstacles_linesegments_vec_;
 
   struct cmp {
-    bool operator()(const std::pair<std::string, double>& left,
-                    const std::pair<std::string, double>& right) const {
+    bool operator()(const std::pair<uint64_t, double>& left,
+                    const std::pair<uint64_t, double>& right) const {
       return left.second >= right.second;
     }
   };
-  std::unordered_map<std::string, std::shared_ptr<Node2d>> dp_map_;
+
+  // Holonomic cost to the end node for every grid cell, row major over
+  // dp_grid_x_num_ x dp_grid_y_num_, infinity when unreachable. The map is
+  // kept across calls: it is reused while the end cell, XYbounds and the
+  // obstacles stay the same and repaired around the changed segments when
+  // only the obstacles differ.
+  static constexpr size_t kMaxRepairRatio = 4;
+  bool dp_map_valid_ = false;
+  std::vector<double> dp_XYbounds_;
+  int dp_grid_x_num_ = 0;
+  int dp_grid_y_num_ = 0;
+  int dp_end_grid_x_ = 0;
+  int dp_end_grid_y_ = 0;
+  // sorted (start x, start y, end x, end y) of the obstacle segments
+  std::vector<std::array<double, 4>> dp_segments_;
+  std::vector<double> dp_map_;
+  // neighbor each cell was reached from, -1 for the end cell and unreached
+  std::vector<int64_t> dp_parent_;
+  std::vector<uint8_t> dp_blocked_;
 };
 }  // namespace planning
 }  // namespace apollo
@@ -0,0 +1,125 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/coarse_trajectory_generator/grid_search.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+class GridSearchTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    auto* warm_start_config =
+        planner_open_space_config_.mutable_warm_start_config();
+    warm_start_config->set_grid_a_star_xy_resolution(0.5);
+    warm_start_config->set_node_radius(1.0);
+  }
+
+ protected:
+  // the dp map of a search that has seen only these obstacles
+  std::vector<double> FreshMap(
+      const std::vector<std::vector<LineSegment2d>>& obstacles) {
+    GridSearch grid_search(planner_open_space_config_);
+    EXPECT_TRUE(grid_search.GenerateDpMap(ex_, ey_, XYbounds_, obstacles));
+    return Sample(&grid_search);
+  }
+
+  std::vector<double> Sample(GridSearch* grid_search) {
+    std::vector<double> costs;
+    for (double x = XYbounds_[0]; x < XYbounds_[1]; x += 0.5) {
+      for (double y = XYbounds_[2]; y < XYbounds_[3]; y += 0.5) {
+        costs.push_back(grid_search->CheckDpMap(x + 0.25, y + 0.25));
+      }
+    }
+    return costs;
+  }
+
+  PlannerOpenSpaceConfig planner_open_space_config_;
+  std::vector<double> XYbounds_ = {-20.0, 20.0, -20.0, 20.0};
+  double ex_ = 15.0;
+  double ey_ = 2.0;
+};
+
+TEST_F(GridSearchTest, DpMapIsShortestPath) {
+  GridSearch grid_search(planner_open_space_config_);
+  ASSERT_TRUE(grid_search.GenerateDpMap(ex_, ey_, XYbounds_, {}));
+  EXPECT_DOUBLE_EQ(0.0, grid_search.CheckDpMap(ex_, ey_));
+  // 4 straight steps of 0.5
+  EXPECT_DOUBLE_EQ(2.0, grid_search.CheckDpMap(ex_ - 2.0, ey_));
+  // 4 diagonal steps
+  EXPECT_NEAR(2.0 * std::sqrt(2.0),
+              grid_search.CheckDpMap(ex_ - 2.0, ey_ - 2.0), 1e-9);
+  EXPECT_EQ(std::numeric_limits<double>::infinity(),
+            grid_search.CheckDpMap(XYbounds_[1] + 1.0, ey_));
+}
+
+TEST_F(GridSearchTest, RepairMatchesRebuild) {
+  // wall between the start area and the end cell that grows, moves and
+  // opens over the cycles
+  const std::vector<std::vector<std::vector<LineSegment2d>>> cycles = {
+      {{LineSegment2d(Vec2d(40.0, 10.0), Vec2d(40.0, 60.0))}},
+      {{LineSegment2d(Vec2d(40.0, 10.0), Vec2d(40.0, 60.0))}},
+      {{LineSegment2d(Vec2d(40.0, 5.0), Vec2d(40.0, 79.0))}},
+      {{LineSegment2d(Vec2d(41.0, 5.0), Vec2d(41.0, 79.0))},
+       {LineSegment2d(Vec2d(20.0, 20.0), Vec2d(30.0, 25.0))}},
+      {{LineSegment2d(Vec2d(41.0, 5.0), Vec2d(41.0, 30.0)),
+        LineSegment2d(Vec2d(41.0, 34.0), Vec2d(41.0, 79.0))},
+       {LineSegment2d(Vec2d(20.0, 20.0), Vec2d(30.0, 25.0))}},
+      {},
+  };
+  GridSearch grid_search(planner_open_space_config_);
+  for (size_t i = 0; i < cycles.size(); ++i) {
+    ASSERT_TRUE(grid_search.GenerateDpMap(ex_, ey_, XYbounds_, cycles[i]));
+    const std::vector<double> expected = FreshMap(cycles[i]);
+    const std::vector<double> costs = Sample(&grid_search);
+    ASSERT_EQ(expected.size(), costs.size());
+    for (size_t j = 0; j < costs.size(); ++j) {
+      if (std::isinf(expected[j])) {
+        ASSERT_TRUE(std::isinf(costs[j])) << "cycle " << i << " sample " << j;
+      } else {
+        ASSERT_NEAR(expected[j], costs[j], 1e-9)
+            << "cycle " << i << " sample " << j;
+      }
+    }
+  }
+}
+
+TEST_F(GridSearchTest, NewEndRebuilds) {
+  const std::vector<std::vector<LineSegment2d>> obstacles = {
+      {LineSegment2d(Vec2d(40.0, 10.0), Vec2d(40.0, 60.0))}};
+  GridSearch grid_search(planner_open_space_config_);
+  ASSERT_TRUE(grid_search.GenerateDpMap(ex_, ey_, XYbounds_, obstacles));
+  ex_ = -15.0;
+  ASSERT_TRUE(grid_search.GenerateDpMap(ex_, ey_, XYbounds_, obstacles));
+  EXPECT_DOUBLE_EQ(0.0, grid_search.CheckDpMap(ex_, ey_));
+  EXPECT_EQ(FreshMap(obstacles), Sample(&grid_search));
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -130,9 +130,9 @@ bool HybridAStar::ValidityCheck(std::shared_ptr<Node3d> node) {
 std::shared_ptr<Node3d> HybridAStar::LoadRSPinCS(
     const std::shared_ptr<ReedSheppPath> reeds_shepp_to_end,
     std::shared_ptr<Node3d> current_node) {
-  std::shared_ptr<Node3d> end_node = std::shared_ptr<Node3d>(new Node3d(
-      reeds_shepp_to_end->x, reeds_shepp_to_end->y, reeds_shepp_to_end->phi,
-      XYbounds_, planner_open_space_config_));
+  std::shared_ptr<Node3d> end_node = MakeArenaShared<Node3d>(
+      &node_arena_, reeds_shepp_to_end->x, reeds_shepp_to_end->y,
+      reeds_shepp_to_end->phi, XYbounds_, planner_open_space_config_);
   end_node->SetPre(current_node);
   close_set_.emplace(end_node->GetIndex(), end_node);
   return end_node;
@@ -188,9 +188,9 @@ std::shared_ptr<Node3d> HybridAStar::Next_node_generator(
       intermediate_y.back() < XYbounds_[2]) {
     return nullptr;
   }
-  std::shared_ptr<Node3d> next_node = std::shared_ptr<Node3d>(
-      new Node3d(intermediate_x, intermediate_y, intermediate_phi, XYbounds_,
-                 planner_open_space_config_));
+  std::shared_ptr<Node3d> next_node = MakeArenaShared<Node3d>(
+      &node_arena_, std::move(intermediate_x), std::move(intermediate_y),
+      std::move(intermediate_phi), XYbounds_, planner_open_space_config_);
   next_node->SetPre(current_node);
   next_node->SetDirec(traveled_distance > 0.0);
   next_node->SetSteer(steering);
@@ -637,11 +637,14 @@ bool HybridAStar::Plan(
     const std::vector<double>& XYbounds,
     const std::vector<std::vector<common::math::Vec2d>>& obstacles_vertices_vec,
     HybridAStartResult* result) {
-  // clear containers
+  // clear containers, the nodes of the last search go back to the arena
   open_set_.clear();
   close_set_.clear();
   open_pq_ = decltype(open_pq_)();
+  start_node_ = nullptr;
+  end_node_ = nullptr;
   final_node_ = nullptr;
+  node_arena_.Reset();
 
   std::vector<std::vector<common::math::LineSegment2d>>
       obstacles_linesegments_vec;
@@ -687,7 +690,7 @@ bool HybridAStar::Plan(
   double rs_time = 0.0;
   while (!open_pq_.empty()) {
     // take out the lowest cost neighboring node
-    const std::string current_id = open_pq_.top().first;
+    const uint64_t current_id = open_pq_.top().first;
     open_pq_.pop();
     std::shared_ptr<Node3d> current_node = open_set_[current_id];
     // check if an analystic curve could be connected from current
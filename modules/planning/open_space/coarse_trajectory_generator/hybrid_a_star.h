@@ -23,15 +23,15 @@
 #include <algorithm>
 #include <memory>
 #include <queue>
-#include <string>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "modules/planning/open_space/coarse_trajectory_generator/grid_search.h"
 #include "modules/planning/open_space/coarse_trajectory_generator/node3d.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/node_arena.h"
 #include "modules/planning/open_space/coarse_trajectory_generator/reeds_shepp_path.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "cyber/common/log.h"
 #include "cyber/common/macros.h"
 #include "modules/common/configs/proto/vehicle_config.pb.h"
@@ -109,6 +109,8 @@ class HybridAStar {
   double heu_rs_steer_penalty_ = 0.0;
   double heu_rs_steer_change_penalty_ = 0.0;
   std::vector<double> XYbounds_;
+  // declared before every member holding nodes so it is destroyed last
+  NodeArena node_arena_;
   std::shared_ptr<Node3d> start_node_;
   std::shared_ptr<Node3d> end_node_;
   std::shared_ptr<Node3d> final_node_;
@@ -116,16 +118,17 @@ class HybridAStar {
       obstacles_linesegments_vec_;
 
   struct cmp {
-    bool operator()(const std::pair<std::string, double>& left,
-                    const std::pair<std::string, double>& right) const {
+    bool operator()(const std::pair<uint64_t, double>& left,
+                    const std::pair<uint64_t, double>& right) const {
       return left.second >= right.second;
     }
   };
-  std::priority_queue<std::pair<std::string, double>,
-                      std::vector<std::pair<std::string, double>>, cmp>
+  std::priority_queue<std::pair<uint64_t, double>,
+                      std::vector<std::pair<uint64_t, double>>, cmp>
       open_pq_;
-  std::unordered_map<std::string, std::shared_ptr<Node3d>> open_set_;
-  std::unordered_map<std::string, std::shared_ptr<Node3d>> close_set_;
+  // keyed by Node3d::GetIndex(), the packed x-y-phi grid coordinate
+  absl::flat_hash_map<uint64_t, std::shared_ptr<Node3d>> open_set_;
+  absl::flat_hash_map<uint64_t, std::shared_ptr<Node3d>> close_set_;
   std::unique_ptr<ReedShepp> reed_shepp_generator_;
   std::unique_ptr<GridSearch> grid_a_star_heuristic_generator_;
 };
@@ -0,0 +1,149 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+// Times Hybrid A* on the scenarios of hybrid_a_star_test, the whole Plan()
+// as well as the holonomic heuristic map it builds first, with the standard
+// parking lot configuration. The heuristic map is timed built from scratch,
+// reused for an unchanged scene and repaired after an obstacle moved,
+// as between two planning cycles.
+//
+// cd modules/planning/open_space/coarse_trajectory_generator
+// bazel run :hybrid_a_star_benchmark
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "cyber/common/file.h"
+#include "modules/common/math/line_segment2d.h"
+#include "modules/common/math/vec2d.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/grid_search.h"
+#include "modules/planning/open_space/coarse_trajectory_generator/hybrid_a_star.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::math::LineSegment2d;
+using apollo::common::math::Vec2d;
+
+struct Scenario {
+  double sx;
+  double sy;
+  double sphi;
+  double ex;
+  double ey;
+  double ephi;
+  std::vector<double> XYbounds;
+  std::vector<std::vector<Vec2d>> obstacles;
+};
+
+// the scenarios of hybrid_a_star_test, in order
+const std::vector<Scenario>& Scenarios() {
+  static const std::vector<Scenario> scenarios = {
+      {-15.0, 0.0, 0.0, 15.0, 0.0, 0.0, {-50.0, 50.0, -50.0, 50.0},
+       {{Vec2d(1.0, 0.0), Vec2d(-1.0, 0.0)}}},
+  };
+  return scenarios;
+}
+
+const PlannerOpenSpaceConfig& Config() {
+  static const PlannerOpenSpaceConfig config = [] {
+    FLAGS_planner_open_space_config_filename =
+        "/apollo/modules/planning/testdata/conf/"
+        "open_space_standard_parking_lot.pb.txt";
+    PlannerOpenSpaceConfig conf;
+    CHECK(apollo::cyber::common::GetProtoFromFile(
+        FLAGS_planner_open_space_config_filename, &conf))
+        << "Failed to load open space config file "
+        << FLAGS_planner_open_space_config_filename;
+    return conf;
+  }();
+  return config;
+}
+
+void BM_HybridAStarPlan(benchmark::State& state) {  // NOLINT
+  const Scenario& scenario = Scenarios()[state.range(0)];
+  HybridAStar hybrid_a_star(Config());
+  HybridAStartResult result;
+  for (auto _ : state) {
+    if (!hybrid_a_star.Plan(scenario.sx, scenario.sy, scenario.sphi,
+                            scenario.ex, scenario.ey, scenario.ephi,
+                            scenario.XYbounds, scenario.obstacles, &result)) {
+      state.SkipWithError("Hybrid A* failed");
+      break;
+    }
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(BM_HybridAStarPlan)
+    ->DenseRange(0, 0)
+    ->Unit(benchmark::kMillisecond);
+
+std::vector<std::vector<LineSegment2d>> LineSegments(
+    const std::vector<std::vector<Vec2d>>& obstacles, const double shift) {
+  std::vector<std::vector<LineSegment2d>> obstacles_linesegments_vec;
+  for (const auto& vertices : obstacles) {
+    std::vector<LineSegment2d> linesegments;
+    for (size_t i = 0; i + 1 < vertices.size(); ++i) {
+      linesegments.emplace_back(vertices[i] + Vec2d(shift, 0.0),
+                                vertices[i + 1] + Vec2d(shift, 0.0));
+    }
+    obstacles_linesegments_vec.emplace_back(std::move(linesegments));
+  }
+  return obstacles_linesegments_vec;
+}
+
+enum DpMapMode { kRebuild = 0, kReuse = 1, kRepair = 2 };
+
+void BM_GridSearchDpMap(benchmark::State& state) {  // NOLINT
+  const Scenario& scenario = Scenarios()[state.range(0)];
+  const auto mode = static_cast<DpMapMode>(state.range(1));
+  // an obstacle moving between two cycles
+  const std::vector<std::vector<LineSegment2d>> obstacles[] = {
+      LineSegments(scenario.obstacles, 0.0),
+      LineSegments(scenario.obstacles, 2.0)};
+  std::unique_ptr<GridSearch> grid_search(new GridSearch(Config()));
+  size_t cycle = 0;
+  for (auto _ : state) {
+    if (mode == kRebuild) {
+      state.PauseTiming();
+      grid_search.reset(new GridSearch(Config()));
+      state.ResumeTiming();
+    }
+    grid_search->GenerateDpMap(
+        scenario.ex, scenario.ey, scenario.XYbounds,
+        obstacles[mode == kRepair ? cycle++ % 2 : 0]);
+    benchmark::DoNotOptimize(
+        grid_search->CheckDpMap(scenario.sx, scenario.sy));
+  }
+}
+BENCHMARK(BM_GridSearchDpMap)
+    ->Args({0, kRebuild})
+    ->Args({0, kReuse})
+    ->Args({0, kRepair})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -20,7 +20,7 @@
 
 #include "modules/planning/open_space/coarse_trajectory_generator/node3d.h"
 
-#include "absl/strings/str_cat.h"
+#include <utility>
 
 namespace apollo {
 namespace planning {
@@ -57,12 +57,12 @@ Node3d::Node3d(double x, double y, double phi,
   traversed_y_.push_back(y);
   traversed_phi_.push_back(phi);
 
-  index_ = ComputeStringIndex(x_grid_, y_grid_, phi_grid_);
+  index_ = ComputeGridIndex(x_grid_, y_grid_, phi_grid_);
 }
 
-Node3d::Node3d(const std::vector<double>& traversed_x,
-               const std::vector<double>& traversed_y,
-               const std::vector<double>& traversed_phi,
+Node3d::Node3d(std::vector<double> traversed_x,
+               std::vector<double> traversed_y,
+               std::vector<double> traversed_phi,
                const std::vector<double>& XYbounds,
                const PlannerOpenSpaceConfig& open_space_conf) {
   CHECK_EQ(XYbounds.size(), 4)
@@ -85,12 +85,12 @@ Node3d::Node3d(const std::vector<double>& traversed_x,
       (phi_ - (-M_PI)) /
       open_space_conf.warm_start_config().phi_grid_resolution());
 
-  traversed_x_ = traversed_x;
-  traversed_y_ = traversed_y;
-  traversed_phi_ = traversed_phi;
+  traversed_x_ = std::move(traversed_x);
+  traversed_y_ = std::move(traversed_y);
+  traversed_phi_ = std::move(traversed_phi);
 
-  index_ = ComputeStringIndex(x_grid_, y_grid_, phi_grid_);
-  step_size_ = traversed_x.size();
+  index_ = ComputeGridIndex(x_grid_, y_grid_, phi_grid_);
+  step_size_ = traversed_x_.size();
 }
 
 Box2d Node3d::GetBoundingBox(const common::VehicleParam& vehicle_param_,
@@ -109,8 +109,12 @@ bool Node3d::operator==(const Node3d& right) const {
   return right.GetIndex() == index_;
 }
 
-std::string Node3d::ComputeStringIndex(int x_grid, int y_grid, int phi_grid) {
-  return absl::StrCat(x_grid, "_", y_grid, "_", phi_grid);
+uint64_t Node3d::ComputeGridIndex(int x_grid, int y_grid, int phi_grid) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x_grid) & 0xFFFFFF)
+          << 40) |
+         (static_cast<uint64_t>(static_cast<uint32_t>(y_grid) & 0xFFFFFF)
+          << 16) |
+         (static_cast<uint64_t>(static_cast<uint32_t>(phi_grid) & 0xFFFF));
 }
 
 }  // namespace planning
@@ -20,8 +20,8 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
-#include <string>
 #include <vector>
 
 #include "modules/planning/proto/planner_open_space_config.pb.h"
@@ -38,9 +38,8 @@ class Node3d {
   Node3d(const double x, const double y, const double phi,
          const std::vector<double>& XYbounds,
          const PlannerOpenSpaceConfig& open_space_conf);
-  Node3d(const std::vector<double>& traversed_x,
-         const std::vector<double>& traversed_y,
-         const std::vector<double>& traversed_phi,
+  Node3d(std::vector<double> traversed_x, std::vector<double> traversed_y,
+         std::vector<double> traversed_phi,
          const std::vector<double>& XYbounds,
          const PlannerOpenSpaceConfig& open_space_conf);
   virtual ~Node3d() = default;
@@ -57,7 +56,7 @@ class Node3d {
   double GetY() const { return y_; }
   double GetPhi() const { return phi_; }
   bool operator==(const Node3d& right) const;
-  const std::string& GetIndex() const { return index_; }
+  uint64_t GetIndex() const { return index_; }
   size_t GetStepSize() const { return step_size_; }
   bool GetDirec() const { return direction_; }
   double GetSteer() const { return steering_; }
@@ -72,7 +71,9 @@ class Node3d {
   void SetSteer(double steering) { steering_ = steering; }
 
  private:
-  static std::string ComputeStringIndex(int x_grid, int y_grid, int phi_grid);
+  // packs the grid coordinates into one key, 24 bits for x and y each and 16
+  // bits for phi, which covers any XY bound the planner is configured with
+  static uint64_t ComputeGridIndex(int x_grid, int y_grid, int phi_grid);
 
  private:
   double x_ = 0.0;
@@ -85,7 +86,7 @@ class Node3d {
   int x_grid_ = 0;
   int y_grid_ = 0;
   int phi_grid_ = 0;
-  std::string index_;
+  uint64_t index_ = 0;
   double traj_cost_ = 0.0;
   double heuristic_cost_ = 0.0;
   double cost_ = 0.0;
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "cyber/common/log.h"
+
+namespace apollo {
+namespace planning {
+
+// Pool allocator for search nodes. Nodes are handed out as shared_ptr
+// through std::allocate_shared, so node and control block share one slot and
+// the searchers keep their shared_ptr based interfaces. Slots come from large
+// blocks; released slots go to a free list and are reused by the next node, so
+// the many rejected successors of an expansion do not grow the pool. Reset()
+// rewinds the blocks once every node of the previous search is released.
+class NodeArena {
+ public:
+  explicit NodeArena(size_t block_size = 256 * 1024)
+      : block_size_(block_size) {}
+  NodeArena(const NodeArena&) = delete;
+  NodeArena& operator=(const NodeArena&) = delete;
+  ~NodeArena() {
+    if (live_ != 0) {
+      AERROR << "NodeArena destroyed with " << live_ << " live allocations";
+    }
+  }
+
+  void* Allocate(size_t size, size_t align) {
+    ++live_;
+    if (slot_size_ == 0 && size >= sizeof(FreeSlot)) {
+      // the first allocation fixes the pooled size, all nodes share it
+      slot_size_ = size;
+    }
+    if (size == slot_size_ && free_list_ != nullptr) {
+      FreeSlot* slot = free_list_;
+      free_list_ = slot->next;
+      return slot;
+    }
+    if (size > block_size_) {
+      oversize_.emplace_back(new char[size + align]);
+      return Align(oversize_.back().get(), align);
+    }
+    while (true) {
+      if (block_idx_ < blocks_.size()) {
+        char* base = blocks_[block_idx_].get();
+        char* ptr = Align(base + offset_, align);
+        if (ptr + size <= base + block_size_) {
+          offset_ = static_cast<size_t>(ptr - base) + size;
+          return ptr;
+        }
+        ++block_idx_;
+        offset_ = 0;
+        continue;
+      }
+      blocks_.emplace_back(new char[block_size_]);
+    }
+  }
+
+  void Deallocate(void* ptr, size_t size) {
+    --live_;
+    if (size == slot_size_) {
+      FreeSlot* slot = static_cast<FreeSlot*>(ptr);
+      slot->next = free_list_;
+      free_list_ = slot;
+    }
+  }
+
+  // Rewinds the pool for the next search and keeps the blocks for reuse. If
+  // some node is still referenced the rewind is skipped so it stays valid.
+  void Reset() {
+    if (live_ != 0) {
+      AWARN << "NodeArena reset skipped, " << live_ << " nodes still alive";
+      return;
+    }
+    block_idx_ = 0;
+    offset_ = 0;
+    free_list_ = nullptr;
+    oversize_.clear();
+  }
+
+  size_t live() const { return live_; }
+  size_t capacity() const { return blocks_.size() * block_size_; }
+
+ private:
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  static char* Align(char* ptr, size_t align) {
+    const auto addr = reinterpret_cast<uintptr_t>(ptr);
+    return reinterpret_cast<char*>((addr + align - 1) & ~(align - 1));
+  }
+
+  size_t block_size_;
+  size_t block_idx_ = 0;
+  size_t offset_ = 0;
+  size_t live_ = 0;
+  size_t slot_size_ = 0;
+  FreeSlot* free_list_ = nullptr;
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  std::vector<std::unique_ptr<char[]>> oversize_;
+};
+
+template <typename T>
+class NodeArenaAllocator {
+ public:
+  using value_type = T;
+
+  explicit NodeArenaAllocator(NodeArena* arena) : arena_(arena) {}
+  template <typename U>
+  NodeArenaAllocator(const NodeArenaAllocator<U>& other)  // NOLINT
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* ptr, size_t n) {
+    arena_->Deallocate(ptr, n * sizeof(T));
+  }
+
+  NodeArena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const NodeArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+  template <typename U>
+  bool operator!=(const NodeArenaAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+ private:
+  NodeArena* arena_;
+};
+
+template <typename T, typename... Args>
+std::shared_ptr<T> MakeArenaShared(NodeArena* arena, Args&&... args) {
+  return std::allocate_shared<T>(NodeArenaAllocator<T>(arena),
+                                 std::forward<Args>(args)...);
+}
+
+}  // namespace planning
+}  // namespace apollo
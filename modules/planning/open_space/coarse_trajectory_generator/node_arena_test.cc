@@ -0,0 +1,82 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/*
+ * @file
+ */
+
+#include "modules/planning/open_space/coarse_trajectory_generator/node_arena.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+struct TestNode {
+  explicit TestNode(int v) : value(v) {}
+  int value = 0;
+  std::shared_ptr<TestNode> pre;
+};
+
+TEST(NodeArenaTest, ReusesReleasedSlots) {
+  NodeArena arena(1024);
+  std::shared_ptr<TestNode> first = MakeArenaShared<TestNode>(&arena, 1);
+  TestNode* first_addr = first.get();
+  EXPECT_EQ(1, first->value);
+  EXPECT_EQ(1, arena.live());
+  first.reset();
+  EXPECT_EQ(0, arena.live());
+  std::shared_ptr<TestNode> second = MakeArenaShared<TestNode>(&arena, 2);
+  EXPECT_EQ(first_addr, second.get());
+  EXPECT_EQ(2, second->value);
+}
+
+TEST(NodeArenaTest, GrowsAndResets) {
+  NodeArena arena(256);
+  std::vector<std::shared_ptr<TestNode>> nodes;
+  for (int i = 0; i < 100; ++i) {
+    nodes.push_back(MakeArenaShared<TestNode>(&arena, i));
+    if (i > 0) {
+      nodes.back()->pre = nodes[i - 1];
+    }
+  }
+  EXPECT_GT(arena.capacity(), 256);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, nodes[i]->value);
+  }
+  const size_t capacity = arena.capacity();
+
+  // a referenced node keeps the arena from rewinding
+  std::shared_ptr<TestNode> last = nodes.back();
+  nodes.clear();
+  EXPECT_EQ(100, arena.live());
+  arena.Reset();
+  EXPECT_EQ(98, last->pre->value);
+
+  last.reset();
+  EXPECT_EQ(0, arena.live());
+  arena.Reset();
+  for (int i = 0; i < 100; ++i) {
+    nodes.push_back(MakeArenaShared<TestNode>(&arena, i));
+  }
+  EXPECT_EQ(capacity, arena.capacity());
+}
+
+}  // namespace planning
+}  // namespace apollo
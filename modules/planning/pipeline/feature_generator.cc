@@ -21,7 +21,7 @@
 
 #include "absl/strings/str_cat.h"
 #include "cyber/common/file.h"
-#include "cyber/record/record_reader.h"
+#include "cyber/record/mapped_record_reader.h"
 #include "modules/common/adapters/adapter_gflags.h"
 
 DEFINE_string(planning_data_dir, "/apollo/modules/planning/data/",
@@ -49,8 +49,8 @@ namespace apollo {
 namespace planning {
 
 using apollo::canbus::Chassis;
-using apollo::cyber::record::RecordMessage;
-using apollo::cyber::record::RecordReader;
+using apollo::cyber::record::MappedRecordReader;
+using apollo::cyber::record::RecordMessageView;
 using apollo::localization::LocalizationEstimate;
 
 void FeatureGenerator::Init() { instance_ = instances_.add_instances(); }
@@ -149,22 +149,24 @@ void FeatureGenerator::OnChassis(const apollo::canbus::Chassis& chassis) {
 }
 
 void FeatureGenerator::ProcessOfflineData(const std::string& record_filename) {
-  RecordReader reader(record_filename);
+  MappedRecordReader reader(record_filename);
   if (!reader.IsValid()) {
     AERROR << "Fail to open " << record_filename;
     return;
   }
 
-  RecordMessage message;
+  RecordMessageView message;
   while (reader.ReadMessage(&message)) {
     if (message.channel_name == FLAGS_localization_topic) {
       LocalizationEstimate localization;
-      if (localization.ParseFromString(message.content)) {
+      if (localization.ParseFromArray(message.content.data(),
+                                      message.content.size())) {
         OnLocalization(localization);
       }
     } else if (message.channel_name == FLAGS_chassis_topic) {
       Chassis chassis;
-      if (chassis.ParseFromString(message.content)) {
+      if (chassis.ParseFromArray(message.content.data(),
+                                 message.content.size())) {
         OnChassis(chassis);
       }
     }
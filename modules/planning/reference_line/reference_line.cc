@@ -667,31 +667,35 @@ bool ReferenceLine::GetSLBoundary(const common::math::Box2d& box,
   std::vector<common::math::Vec2d> corners;
   box.GetAllCorners(&corners);
 
-  // The order must be counter-clockwise
-  std::vector<SLPoint> sl_corners;
-  for (const auto& point : corners) {
-    SLPoint sl_point;
-    if (!XYToSL(point, &sl_point)) {
-      AERROR << "Failed to get projection for point: " << point.DebugString()
-             << " on reference line.";
-      return false;
-    }
-    sl_corners.push_back(std::move(sl_point));
+  // The order must be counter-clockwise. Each corner is followed by the
+  // middle of the edge to the next one, and all of them are projected
+  // together.
+  std::vector<Vec2d> points;
+  points.reserve(2 * corners.size());
+  for (size_t i = 0; i < corners.size(); ++i) {
+    points.push_back(corners[i]);
+    points.push_back((corners[i] + corners[(i + 1) % corners.size()]) * 0.5);
+  }
+  std::vector<double> s;
+  std::vector<double> l;
+  if (!map_path_.GetProjections(points, &s, &l)) {
+    AERROR << "Failed to get projection for box: " << box.DebugString()
+           << " on reference line.";
+    return false;
+  }
+  std::vector<SLPoint> sl_corners(corners.size());
+  for (size_t i = 0; i < corners.size(); ++i) {
+    sl_corners[i].set_s(s[2 * i]);
+    sl_corners[i].set_l(l[2 * i]);
   }
 
   for (size_t i = 0; i < corners.size(); ++i) {
     auto index0 = i;
     auto index1 = (i + 1) % corners.size();
-    const auto& p0 = corners[index0];
-    const auto& p1 = corners[index1];
 
-    const auto p_mid = (p0 + p1) * 0.5;
     SLPoint sl_point_mid;
-    if (!XYToSL(p_mid, &sl_point_mid)) {
-      AERROR << "Failed to get projection for point: " << p_mid.DebugString()
-             << " on reference line.";
-      return false;
-    }
+    sl_point_mid.set_s(s[2 * i + 1]);
+    sl_point_mid.set_l(l[2 * i + 1]);
 
     Vec2d v0(sl_corners[index1].s() - sl_corners[index0].s(),
              sl_corners[index1].l() - sl_corners[index0].l());
@@ -20,9 +20,12 @@
 
 #include "modules/planning/scenarios/lane_follow/lane_follow_stage.h"
 
+#include <algorithm>
+#include <future>
 #include <utility>
 
 #include "cyber/common/log.h"
+#include "cyber/task/task.h"
 #include "modules/common/math/math_utils.h"
 #include "modules/common/time/time.h"
 #include "modules/common/util/point_factory.h"
@@ -32,6 +35,7 @@
 #include "modules/map/hdmap/hdmap_common.h"
 #include "modules/planning/common/ego_info.h"
 #include "modules/planning/common/frame.h"
+#include "modules/planning/common/planning_context.h"
 #include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/constraint_checker/constraint_checker.h"
 #include "modules/planning/tasks/deciders/lane_change_decider/lane_change_decider.h"
@@ -109,6 +113,11 @@ void LaneFollowStage::RecordDebugInfo(ReferenceLineInfo* reference_line_info,
 
 Stage::StageStatus LaneFollowStage::Process(
     const TrajectoryPoint& planning_start_point, Frame* frame) {
+  if (FLAGS_enable_parallel_reference_line_planning &&
+      frame->reference_line_info().size() > 1) {
+    return ProcessInParallel(planning_start_point, frame);
+  }
+
   bool has_drivable_reference_line = false;
 
   ADEBUG << "Number of reference lines:\t"
@@ -132,40 +141,144 @@ Stage::StageStatus LaneFollowStage::Process(
     auto cur_status =
         PlanOnReferenceLine(planning_start_point, frame, &reference_line_info);
 
-    if (cur_status.ok()) {
-      if (reference_line_info.IsChangeLanePath()) {
-        ADEBUG << "reference line is lane change ref.";
-        ADEBUG << "FLAGS_enable_smarter_lane_change: "
-               << FLAGS_enable_smarter_lane_change;
-        if (reference_line_info.Cost() < kStraightForwardLineCost &&
-            (LaneChangeDecider::IsClearToChangeLane(&reference_line_info) ||
-             FLAGS_enable_smarter_lane_change)) {
-          // If the path and speed optimization succeed on target lane while
-          // under smart lane-change or IsClearToChangeLane under older version
-          has_drivable_reference_line = true;
-          reference_line_info.SetDrivable(true);
-          LaneChangeDecider::UpdatePreparationDistance(true, frame,
-                                                       &reference_line_info);
-          ADEBUG << "\tclear for lane change";
-        } else {
-          LaneChangeDecider::UpdatePreparationDistance(false, frame,
-                                                       &reference_line_info);
-          reference_line_info.SetDrivable(false);
-          ADEBUG << "\tlane change failed";
-        }
-      } else {
-        ADEBUG << "reference line is NOT lane change ref.";
-        has_drivable_reference_line = true;
+    has_drivable_reference_line =
+        AcceptReferenceLine(cur_status, frame, &reference_line_info);
+  }
+
+  return has_drivable_reference_line ? StageStatus::RUNNING
+                                     : StageStatus::ERROR;
+}
+
+Stage::StageStatus LaneFollowStage::ProcessInParallel(
+    const TrajectoryPoint& planning_start_point, Frame* frame) {
+  // the list may be reordered by the tasks, the pointers stay valid
+  std::vector<ReferenceLineInfo*> reference_line_infos;
+  for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
+    reference_line_infos.push_back(&reference_line_info);
+  }
+  const size_t num_lines = reference_line_infos.size();
+  ADEBUG << "Plan " << num_lines << " reference lines in parallel.";
+
+  // every line plans on its own copy of the planning status
+  std::vector<PlanningStatus> planning_status(
+      num_lines, PlanningContext::Instance()->planning_status());
+  std::vector<const std::vector<Task*>*> task_lists(num_lines);
+  std::vector<Status> line_status(num_lines, Status::OK());
+  for (size_t i = 0; i < num_lines; ++i) {
+    task_lists[i] = &TaskListForReferenceLine(i);
+    if (!reference_line_infos[i]->IsChangeLanePath()) {
+      reference_line_infos[i]->AddCost(kStraightForwardLineCost);
+    }
+  }
+
+  // runs the tasks [begin, end) on the i-th line until one fails
+  auto run_tasks = [&](const size_t i, const size_t begin, const size_t end) {
+    PlanningContext::ThreadStatusScope status_scope(&planning_status[i]);
+    for (size_t k = begin; k < end && line_status[i].ok(); ++k) {
+      line_status[i] =
+          RunTask((*task_lists[i])[k], frame, reference_line_infos[i]);
+    }
+  };
+
+  // runs of reference line local tasks go in parallel, the other tasks
+  // see all lines and run on one line after the other
+  size_t begin = 0;
+  while (begin < task_list_.size()) {
+    if (!task_list_[begin]->IsReferenceLineLocal()) {
+      for (size_t i = 0; i < num_lines; ++i) {
+        run_tasks(i, begin, begin + 1);
       }
-    } else {
+      ++begin;
+      continue;
+    }
+    size_t end = begin + 1;
+    while (end < task_list_.size() && task_list_[end]->IsReferenceLineLocal()) {
+      ++end;
+    }
+    std::vector<std::future<void>> results;
+    for (size_t i = 1; i < num_lines; ++i) {
+      results.emplace_back(cyber::Async(run_tasks, i, begin, end));
+    }
+    run_tasks(0, begin, end);
+    for (auto& result : results) {
+      result.get();
+    }
+    begin = end;
+  }
+
+  for (size_t i = 0; i < num_lines; ++i) {
+    PlanningContext::ThreadStatusScope status_scope(&planning_status[i]);
+    line_status[i] = FinishPlanOnReferenceLine(
+        planning_start_point, frame, line_status[i], reference_line_infos[i]);
+  }
+
+  // choose as the sequential planning does, the first acceptable line in the
+  // final order; the planning status of the chosen line (or of the last line
+  // if none is acceptable) becomes the planning status of the cycle
+  std::vector<size_t> evaluated;
+  bool has_drivable_reference_line = false;
+  for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
+    if (has_drivable_reference_line) {
       reference_line_info.SetDrivable(false);
+      continue;
     }
+    const size_t i =
+        std::find(reference_line_infos.begin(), reference_line_infos.end(),
+                  &reference_line_info) -
+        reference_line_infos.begin();
+    evaluated.push_back(i);
+    has_drivable_reference_line =
+        line_status[i].ok() &&
+        (!reference_line_info.IsChangeLanePath() ||
+         IsChangeLaneAcceptable(&reference_line_info));
+  }
+  PlanningContext::Instance()->mutable_planning_status()->Swap(
+      &planning_status[evaluated.back()]);
+  for (const size_t i : evaluated) {
+    AcceptReferenceLine(line_status[i], frame, reference_line_infos[i]);
   }
 
   return has_drivable_reference_line ? StageStatus::RUNNING
                                      : StageStatus::ERROR;
 }
 
+bool LaneFollowStage::IsChangeLaneAcceptable(
+    ReferenceLineInfo* reference_line_info) const {
+  // If the path and speed optimization succeed on target lane while
+  // under smart lane-change or IsClearToChangeLane under older version
+  return reference_line_info->Cost() < kStraightForwardLineCost &&
+         (LaneChangeDecider::IsClearToChangeLane(reference_line_info) ||
+          FLAGS_enable_smarter_lane_change);
+}
+
+bool LaneFollowStage::AcceptReferenceLine(
+    const Status& plan_status, Frame* frame,
+    ReferenceLineInfo* reference_line_info) {
+  if (!plan_status.ok()) {
+    reference_line_info->SetDrivable(false);
+    return false;
+  }
+  if (!reference_line_info->IsChangeLanePath()) {
+    ADEBUG << "reference line is NOT lane change ref.";
+    return true;
+  }
+  ADEBUG << "reference line is lane change ref.";
+  ADEBUG << "FLAGS_enable_smarter_lane_change: "
+         << FLAGS_enable_smarter_lane_change;
+  if (IsChangeLaneAcceptable(reference_line_info)) {
+    reference_line_info->SetDrivable(true);
+    LaneChangeDecider::UpdatePreparationDistance(true, frame,
+                                                 reference_line_info);
+    ADEBUG << "\tclear for lane change";
+    return true;
+  }
+  LaneChangeDecider::UpdatePreparationDistance(false, frame,
+                                               reference_line_info);
+  reference_line_info->SetDrivable(false);
+  ADEBUG << "\tlane change failed";
+  return false;
+}
+
 Status LaneFollowStage::PlanOnReferenceLine(
     const TrajectoryPoint& planning_start_point, Frame* frame,
     ReferenceLineInfo* reference_line_info) {
@@ -178,21 +291,10 @@ Status LaneFollowStage::PlanOnReferenceLine(
 
   auto ret = Status::OK();
   for (auto* optimizer : task_list_) {
-    const double start_timestamp = Clock::NowInSeconds();
-    ret = optimizer->Execute(frame, reference_line_info);
+    ret = RunTask(optimizer, frame, reference_line_info);
     if (!ret.ok()) {
-      AERROR << "Failed to run tasks[" << optimizer->Name()
-             << "], Error message: " << ret.error_message();
       break;
     }
-    const double end_timestamp = Clock::NowInSeconds();
-    const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
-
-    ADEBUG << "after optimizer " << optimizer->Name() << ":"
-           << reference_line_info->PathSpeedDebugString();
-    ADEBUG << optimizer->Name() << " time spend: " << time_diff_ms << " ms.";
-
-    RecordDebugInfo(reference_line_info, optimizer->Name(), time_diff_ms);
 
     // TODO(SHU): disable reference line order changes for now
     // updated reference_line_info, because it is changed in
@@ -202,6 +304,33 @@ Status LaneFollowStage::PlanOnReferenceLine(
     //        << reference_line_info->IsChangeLanePath();
   }
 
+  return FinishPlanOnReferenceLine(planning_start_point, frame, ret,
+                                   reference_line_info);
+}
+
+Status LaneFollowStage::RunTask(Task* optimizer, Frame* frame,
+                                ReferenceLineInfo* reference_line_info) {
+  const double start_timestamp = Clock::NowInSeconds();
+  auto ret = optimizer->Execute(frame, reference_line_info);
+  if (!ret.ok()) {
+    AERROR << "Failed to run tasks[" << optimizer->Name()
+           << "], Error message: " << ret.error_message();
+    return ret;
+  }
+  const double end_timestamp = Clock::NowInSeconds();
+  const double time_diff_ms = (end_timestamp - start_timestamp) * 1000;
+
+  ADEBUG << "after optimizer " << optimizer->Name() << ":"
+         << reference_line_info->PathSpeedDebugString();
+  ADEBUG << optimizer->Name() << " time spend: " << time_diff_ms << " ms.";
+
+  RecordDebugInfo(reference_line_info, optimizer->Name(), time_diff_ms);
+  return ret;
+}
+
+Status LaneFollowStage::FinishPlanOnReferenceLine(
+    const TrajectoryPoint& planning_start_point, Frame* frame,
+    const Status& ret, ReferenceLineInfo* reference_line_info) {
   RecordObstacleDebugInfo(reference_line_info);
 
   // check path and speed results for path or speed fallback
@@ -53,6 +53,16 @@ class LaneFollowStage : public Stage {
       const common::TrajectoryPoint& planning_start_point, Frame* frame,
       ReferenceLineInfo* reference_line_info);
 
+  /**
+   * @brief Plans all reference lines concurrently, see
+   * FLAGS_enable_parallel_reference_line_planning, and picks the same line
+   * Process() would pick. Each line runs on its own task instances and its
+   * own copy of the planning status; the tasks that are not reference line
+   * local run on one line after the other.
+   */
+  StageStatus ProcessInParallel(
+      const common::TrajectoryPoint& planning_init_point, Frame* frame);
+
   void PlanFallbackTrajectory(
       const common::TrajectoryPoint& planning_start_point, Frame* frame,
       ReferenceLineInfo* reference_line_info);
@@ -73,6 +83,20 @@ class LaneFollowStage : public Stage {
                        const std::string& name, const double time_diff_ms);
 
  private:
+  common::Status RunTask(Task* optimizer, Frame* frame,
+                         ReferenceLineInfo* reference_line_info);
+
+  // fallback, trajectory and costs after the tasks of a reference line ran
+  common::Status FinishPlanOnReferenceLine(
+      const common::TrajectoryPoint& planning_start_point, Frame* frame,
+      const common::Status& ret, ReferenceLineInfo* reference_line_info);
+
+  bool IsChangeLaneAcceptable(ReferenceLineInfo* reference_line_info) const;
+
+  // marks the planned line drivable or not, returns whether it is chosen
+  bool AcceptReferenceLine(const common::Status& plan_status, Frame* frame,
+                           ReferenceLineInfo* reference_line_info);
+
   ScenarioConfig config_;
   std::unique_ptr<Stage> stage_;
 };
@@ -0,0 +1,223 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/scenarios/lane_follow/lane_follow_stage.h"
+
+#include <cmath>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/planning/common/planning_context.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+namespace scenario {
+namespace lane_follow {
+
+using apollo::common::Status;
+
+namespace {
+
+constexpr double kLaneWidth = 3.5;
+constexpr double kLineLength = 100.0;
+
+int LaneOf(const ReferenceLineInfo& reference_line_info) {
+  return static_cast<int>(std::lround(
+      reference_line_info.reference_line().reference_points().front().y() /
+      kLaneWidth));
+}
+
+// Plans a straight path at constant speed along the reference line, adds the
+// cost given for its lane and writes the lane to the planning status.
+class FakeLaneTask : public Task {
+ public:
+  FakeLaneTask(const TaskConfig& config, const std::map<int, double>& costs)
+      : Task(config), costs_(costs) {}
+
+  bool IsReferenceLineLocal() const override { return true; }
+
+  Status Execute(Frame* frame,
+                 ReferenceLineInfo* reference_line_info) override {
+    Task::Execute(frame, reference_line_info);
+    const int lane = LaneOf(*reference_line_info);
+
+    std::vector<common::PathPoint> path_points;
+    for (double s = 0.0; s <= kLineLength; s += 1.0) {
+      common::PathPoint point;
+      point.set_x(s);
+      point.set_y(lane * kLaneWidth);
+      point.set_theta(0.0);
+      point.set_s(s);
+      path_points.push_back(std::move(point));
+    }
+    auto* path_data = reference_line_info->mutable_path_data();
+    path_data->SetReferenceLine(&reference_line_info->reference_line());
+    path_data->SetDiscretizedPath(DiscretizedPath(std::move(path_points)));
+
+    SpeedData speed_data;
+    for (double t = 0.0; t <= 8.0; t += 0.1) {
+      speed_data.AppendSpeedPoint(5.0 * t, t, 5.0, 0.0, 0.0);
+    }
+    *reference_line_info->mutable_speed_data() = std::move(speed_data);
+
+    reference_line_info->AddCost(costs_.at(lane));
+    PlanningContext::Instance()
+        ->mutable_planning_status()
+        ->mutable_path_decider()
+        ->set_front_static_obstacle_cycle_counter(lane);
+    return Status::OK();
+  }
+
+ private:
+  std::map<int, double> costs_;
+};
+
+// A lane follow stage running only the fake task. The task factory does not
+// know it, so the instances of the other reference lines are made here too.
+class FakeLaneFollowStage : public LaneFollowStage {
+ public:
+  FakeLaneFollowStage(const ScenarioConfig::StageConfig& config,
+                      const std::map<int, double>& costs,
+                      const size_t num_lines)
+      : LaneFollowStage(config) {
+    TaskConfig task_config;
+    task_config.set_task_type(TaskConfig::PATH_DECIDER);
+    tasks_[TaskConfig::PATH_DECIDER].reset(
+        new FakeLaneTask(task_config, costs));
+    task_list_.push_back(tasks_[TaskConfig::PATH_DECIDER].get());
+    line_tasks_.resize(num_lines - 1);
+    line_task_lists_.resize(num_lines - 1);
+    for (size_t i = 0; i + 1 < num_lines; ++i) {
+      line_tasks_[i][TaskConfig::PATH_DECIDER].reset(
+          new FakeLaneTask(task_config, costs));
+      line_task_lists_[i].push_back(
+          line_tasks_[i][TaskConfig::PATH_DECIDER].get());
+    }
+  }
+};
+
+void AddReferenceLine(const int lane, const bool is_change_lane,
+                      Frame* frame) {
+  std::vector<ReferencePoint> reference_points;
+  for (double s = 0.0; s <= kLineLength; s += 1.0) {
+    reference_points.emplace_back(
+        hdmap::MapPathPoint(common::math::Vec2d(s, lane * kLaneWidth), 0.0),
+        0.0, 0.0);
+  }
+  hdmap::RouteSegments segments;
+  segments.SetIsOnSegment(!is_change_lane);
+  common::VehicleState vehicle_state;
+  frame->mutable_reference_line_info()->emplace_back(
+      vehicle_state, frame->PlanningStartPoint(),
+      ReferenceLine(reference_points), segments);
+}
+
+struct PlanResult {
+  Stage::StageStatus status;
+  std::vector<bool> drivable;
+  double cost = 0.0;
+  size_t num_trajectory_points = 0;
+  int status_lane = 0;
+};
+
+}  // namespace
+
+class LaneFollowStageTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    config_.set_stage_type(ScenarioConfig::LANE_FOLLOW_DEFAULT_STAGE);
+  }
+
+  virtual void TearDown() {
+    FLAGS_enable_parallel_reference_line_planning = false;
+    PlanningContext::Instance()->Clear();
+  }
+
+ protected:
+  // plans a change to the left lane, the own lane and a change to the right
+  // lane, in this order
+  PlanResult Plan(const bool in_parallel, const std::map<int, double>& costs) {
+    FLAGS_enable_parallel_reference_line_planning = in_parallel;
+    PlanningContext::Instance()->Clear();
+
+    Frame frame(1);
+    AddReferenceLine(1, true, &frame);
+    AddReferenceLine(0, false, &frame);
+    AddReferenceLine(-1, true, &frame);
+    FakeLaneFollowStage stage(config_, costs,
+                              frame.reference_line_info().size());
+
+    PlanResult result;
+    result.status = stage.Process(frame.PlanningStartPoint(), &frame);
+    for (const auto& reference_line_info : frame.reference_line_info()) {
+      result.drivable.push_back(reference_line_info.IsDrivable());
+      if (reference_line_info.IsDrivable()) {
+        result.cost = reference_line_info.Cost();
+        result.num_trajectory_points =
+            reference_line_info.trajectory().size();
+      }
+    }
+    result.status_lane = PlanningContext::Instance()
+                             ->planning_status()
+                             .path_decider()
+                             .front_static_obstacle_cycle_counter();
+    return result;
+  }
+
+  void ExpectSameChoice(const std::map<int, double>& costs,
+                        const std::vector<bool>& drivable,
+                        const int chosen_lane) {
+    const auto sequential = Plan(false, costs);
+    const auto parallel = Plan(true, costs);
+    EXPECT_EQ(Stage::RUNNING, sequential.status);
+    EXPECT_EQ(sequential.status, parallel.status);
+    EXPECT_EQ(drivable, sequential.drivable);
+    EXPECT_EQ(sequential.drivable, parallel.drivable);
+    EXPECT_DOUBLE_EQ(sequential.cost, parallel.cost);
+    EXPECT_GT(sequential.num_trajectory_points, 0);
+    EXPECT_EQ(sequential.num_trajectory_points,
+              parallel.num_trajectory_points);
+    // the planning status of the chosen line is kept
+    EXPECT_EQ(chosen_lane, sequential.status_lane);
+    EXPECT_EQ(chosen_lane, parallel.status_lane);
+  }
+
+  ScenarioConfig::StageConfig config_;
+};
+
+TEST_F(LaneFollowStageTest, ProcessInParallelKeepsOwnLane) {
+  // the change to the left is too expensive to be accepted
+  ExpectSameChoice({{1, 20.0}, {0, 5.0}, {-1, 0.0}}, {false, true, false},
+                   0);
+}
+
+TEST_F(LaneFollowStageTest, ProcessInParallelChangesLane) {
+  ExpectSameChoice({{1, 2.0}, {0, 5.0}, {-1, 0.0}}, {true, false, false},
+                   1);
+}
+
+}  // namespace lane_follow
+}  // namespace scenario
+}  // namespace planning
+}  // namespace apollo
@@ -82,6 +82,34 @@ Task* Stage::FindTask(TaskConfig::TaskType task_type) const {
   }
 }
 
+const std::vector<Task*>& Stage::TaskListForReferenceLine(size_t index) {
+  if (index == 0) {
+    return task_list_;
+  }
+  if (line_task_lists_.size() < index) {
+    line_tasks_.resize(index);
+    line_task_lists_.resize(index);
+  }
+  auto& task_list = line_task_lists_[index - 1];
+  if (task_list.empty()) {
+    auto& tasks = line_tasks_[index - 1];
+    for (auto* task : task_list_) {
+      if (!task->IsReferenceLineLocal()) {
+        task_list.push_back(task);
+        continue;
+      }
+      const auto task_type = task->Config().task_type();
+      auto iter = tasks.find(task_type);
+      if (iter == tasks.end()) {
+        iter = tasks.emplace(task_type, TaskFactory::CreateTask(task->Config()))
+                   .first;
+      }
+      task_list.push_back(iter->second.get());
+    }
+  }
+  return task_list;
+}
+
 bool Stage::ExecuteTaskOnReferenceLine(
     const common::TrajectoryPoint& planning_start_point, Frame* frame) {
   for (auto& reference_line_info : *frame->mutable_reference_line_info()) {
@@ -67,6 +67,14 @@ class Stage {
    */
   const std::vector<Task*>& TaskList() const { return task_list_; }
 
+  /**
+   * @brief The task list to run on the index-th of several reference lines
+   * planned concurrently. Index 0 is TaskList(); other indices get their own
+   * instances of the reference line local tasks, created on first use and
+   * kept across cycles, and share the instances of the other tasks.
+   */
+  const std::vector<Task*>& TaskListForReferenceLine(size_t index);
+
   const std::string& Name() const;
 
   template <typename T>
@@ -91,6 +99,10 @@ class Stage {
  protected:
   std::map<TaskConfig::TaskType, std::unique_ptr<Task>> tasks_;
   std::vector<Task*> task_list_;
+  // per reference line task instances, see TaskListForReferenceLine()
+  std::vector<std::map<TaskConfig::TaskType, std::unique_ptr<Task>>>
+      line_tasks_;
+  std::vector<std::vector<Task*>> line_task_lists_;
   ScenarioConfig::StageConfig config_;
   ScenarioConfig::StageType next_stage_;
   void* context_ = nullptr;
@@ -36,6 +36,9 @@ class LaneChangeDecider : public Decider {
  public:
   explicit LaneChangeDecider(const TaskConfig& config);
 
+  // reorders the reference lines of the frame
+  bool IsReferenceLineLocal() const override { return false; }
+
   /**
    * @brief A static function to check if the ChangeLanePath type of reference
    * line is safe or if current reference line is safe to deviate away and come
@@ -52,6 +52,8 @@ class PathBoundsDecider : public Decider {
   };
   explicit PathBoundsDecider(const TaskConfig& config);
 
+  bool IsReferenceLineLocal() const override { return true; }
+
  private:
   /** @brief Every time when Process function is called, it will:
    *   1. Initialize.
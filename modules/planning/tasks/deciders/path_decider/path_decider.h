@@ -32,6 +32,8 @@ class PathDecider : public Task {
  public:
   explicit PathDecider(const TaskConfig &config);
 
+  bool IsReferenceLineLocal() const override { return true; }
+
   apollo::common::Status Execute(
       Frame *frame, ReferenceLineInfo *reference_line_info) override;
 
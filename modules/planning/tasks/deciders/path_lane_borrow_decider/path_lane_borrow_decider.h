@@ -30,6 +30,9 @@ class PathLaneBorrowDecider : public Decider {
  public:
   explicit PathLaneBorrowDecider(const TaskConfig& config);
 
+  // of the other reference lines only their number is read
+  bool IsReferenceLineLocal() const override { return true; }
+
  private:
   common::Status Process(Frame* frame,
                          ReferenceLineInfo* reference_line_info) override;
@@ -27,6 +27,9 @@ class RuleBasedStopDecider : public Decider {
  public:
   explicit RuleBasedStopDecider(const TaskConfig& config);
 
+  // adds stop decisions to the other reference lines of the frame
+  bool IsReferenceLineLocal() const override { return false; }
+
  private:
   apollo::common::Status Process(
       Frame* const frame,
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/tasks/deciders/speed_bounds_decider/path_footprint_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "modules/common/math/vec2d.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::PathPoint;
+using apollo::common::VehicleParam;
+using apollo::common::math::Box2d;
+using apollo::common::math::Vec2d;
+
+PathFootprintIndex::PathFootprintIndex(const VehicleParam& vehicle_param,
+                                       const double l_buffer)
+    : vehicle_param_(vehicle_param), l_buffer_(l_buffer) {}
+
+Box2d PathFootprintIndex::AdcBoundingBox(const VehicleParam& vehicle_param,
+                                         const PathPoint& path_point,
+                                         const double l_buffer) {
+  // Convert reference point from center of rear axis to center of ADC.
+  Vec2d ego_center_map_frame((vehicle_param.front_edge_to_center() -
+                              vehicle_param.back_edge_to_center()) *
+                                 0.5,
+                             (vehicle_param.left_edge_to_center() -
+                              vehicle_param.right_edge_to_center()) *
+                                 0.5);
+  ego_center_map_frame.SelfRotate(path_point.theta());
+  ego_center_map_frame.set_x(ego_center_map_frame.x() + path_point.x());
+  ego_center_map_frame.set_y(ego_center_map_frame.y() + path_point.y());
+
+  return Box2d(ego_center_map_frame, path_point.theta(),
+               vehicle_param.length(), vehicle_param.width() + l_buffer * 2);
+}
+
+void PathFootprintIndex::Add(const double s, const PathPoint& path_point) {
+  Box2d box = AdcBoundingBox(vehicle_param_, path_point, l_buffer_);
+  const double radius = box.diagonal() * 0.5;
+  if (footprints_.size() % kBucketSize == 0) {
+    buckets_.push_back(
+        {box.min_x(), box.max_x(), box.min_y(), box.max_y()});
+  } else {
+    auto& bucket = buckets_.back();
+    bucket.min_x = std::min(bucket.min_x, box.min_x());
+    bucket.max_x = std::max(bucket.max_x, box.max_x());
+    bucket.min_y = std::min(bucket.min_y, box.min_y());
+    bucket.max_y = std::max(bucket.max_y, box.max_y());
+  }
+  footprints_.push_back({s, radius, std::move(box)});
+}
+
+int PathFootprintIndex::FirstOverlap(const Box2d& obs_box) const {
+  const double obs_radius = obs_box.diagonal() * 0.5;
+  for (size_t b = 0; b < buckets_.size(); ++b) {
+    const auto& bucket = buckets_[b];
+    if (obs_box.max_x() < bucket.min_x || obs_box.min_x() > bucket.max_x ||
+        obs_box.max_y() < bucket.min_y || obs_box.min_y() > bucket.max_y) {
+      continue;
+    }
+    const size_t end = std::min(footprints_.size(), (b + 1) * kBucketSize);
+    for (size_t i = b * kBucketSize; i < end; ++i) {
+      const auto& footprint = footprints_[i];
+      // the slack keeps touching boxes, which HasOverlap accepts
+      const double max_dist = footprint.radius + obs_radius + 1e-6;
+      const double dx = footprint.box.center_x() - obs_box.center_x();
+      const double dy = footprint.box.center_y() - obs_box.center_y();
+      if (dx * dx + dy * dy > max_dist * max_dist) {
+        continue;
+      }
+      if (obs_box.HasOverlap(footprint.box)) {
+        return static_cast<int>(i);
+      }
+    }
+  }
+  return -1;
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,96 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#pragma once
+
+#include <vector>
+
+#include "modules/common/configs/proto/vehicle_config.pb.h"
+#include "modules/common/proto/pnc_point.pb.h"
+
+#include "modules/common/math/box2d.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class PathFootprintIndex
+ * @brief The ADC bounding boxes along a path, to find where on the path the
+ * ADC first collides with an obstacle box. The boxes are built once per path
+ * instead of once per obstacle and are grouped into consecutive buckets with
+ * the axis aligned bounds of the corridor they sweep, so a query skips whole
+ * buckets, then single boxes by bounding circle, before the exact check.
+ */
+class PathFootprintIndex {
+ public:
+  PathFootprintIndex(const common::VehicleParam& vehicle_param,
+                     const double l_buffer);
+
+  /**
+   * @brief The ADC bounding box, widened by l_buffer on both sides, when the
+   * center of the rear axis is at the path point.
+   */
+  static common::math::Box2d AdcBoundingBox(
+      const common::VehicleParam& vehicle_param,
+      const common::PathPoint& path_point, const double l_buffer);
+
+  /**
+   * @brief Appends the footprint at the path point. Footprints are kept in
+   * the order they are added, which is the order queries search them in.
+   * @param s The path s the footprint is reported with.
+   */
+  void Add(const double s, const common::PathPoint& path_point);
+
+  /**
+   * @brief The index of the first footprint overlapping the box, -1 if none.
+   */
+  int FirstOverlap(const common::math::Box2d& obs_box) const;
+
+  size_t size() const { return footprints_.size(); }
+  double s(const size_t index) const { return footprints_[index].s; }
+  const common::math::Box2d& box(const size_t index) const {
+    return footprints_[index].box;
+  }
+
+ private:
+  struct Footprint {
+    double s;
+    double radius;
+    common::math::Box2d box;
+  };
+
+  struct Bucket {
+    double min_x;
+    double max_x;
+    double min_y;
+    double max_y;
+  };
+
+  // footprints per bucket, a few meters of path with the usual sampling
+  static constexpr size_t kBucketSize = 8;
+
+  const common::VehicleParam& vehicle_param_;
+  const double l_buffer_;
+  std::vector<Footprint> footprints_;
+  std::vector<Bucket> buckets_;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/tasks/deciders/speed_bounds_decider/path_footprint_index.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "modules/common/math/vec2d.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::PathPoint;
+using apollo::common::VehicleParam;
+using apollo::common::math::Box2d;
+using apollo::common::math::Vec2d;
+
+class PathFootprintIndexTest : public ::testing::Test {
+ public:
+  virtual void SetUp() {
+    vehicle_param_.set_front_edge_to_center(3.89);
+    vehicle_param_.set_back_edge_to_center(1.04);
+    vehicle_param_.set_left_edge_to_center(1.055);
+    vehicle_param_.set_right_edge_to_center(1.055);
+    vehicle_param_.set_length(4.93);
+    vehicle_param_.set_width(2.11);
+
+    // a left turn of 100 m
+    for (double s = 0.0; s < 100.0; s += 0.5) {
+      PathPoint path_point;
+      const double theta = s / 100.0;
+      path_point.set_x(100.0 * std::sin(theta));
+      path_point.set_y(100.0 * (1.0 - std::cos(theta)));
+      path_point.set_theta(theta);
+      path_point.set_s(s);
+      path_points_.push_back(path_point);
+    }
+  }
+
+ protected:
+  VehicleParam vehicle_param_;
+  std::vector<PathPoint> path_points_;
+};
+
+TEST_F(PathFootprintIndexTest, FirstOverlapMatchesScan) {
+  const double l_buffer = 0.4;
+  PathFootprintIndex index(vehicle_param_, l_buffer);
+  for (const auto& path_point : path_points_) {
+    index.Add(path_point.s(), path_point);
+  }
+  ASSERT_EQ(path_points_.size(), index.size());
+
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> x_dist(-10.0, 110.0);
+  std::uniform_real_distribution<double> y_dist(-20.0, 60.0);
+  std::uniform_real_distribution<double> heading_dist(-M_PI, M_PI);
+  std::uniform_real_distribution<double> size_dist(0.5, 12.0);
+  int num_overlaps = 0;
+  for (int i = 0; i < 2000; ++i) {
+    const Box2d obs_box(Vec2d(x_dist(gen), y_dist(gen)), heading_dist(gen),
+                        size_dist(gen), size_dist(gen));
+    int expected = -1;
+    for (size_t j = 0; j < path_points_.size(); ++j) {
+      const Box2d adc_box = PathFootprintIndex::AdcBoundingBox(
+          vehicle_param_, path_points_[j], l_buffer);
+      if (obs_box.HasOverlap(adc_box)) {
+        expected = static_cast<int>(j);
+        break;
+      }
+    }
+    ASSERT_EQ(expected, index.FirstOverlap(obs_box)) << "box " << i;
+    num_overlaps += expected >= 0;
+  }
+  // both outcomes are covered
+  EXPECT_GT(num_overlaps, 100);
+  EXPECT_LT(num_overlaps, 1900);
+}
+
+TEST_F(PathFootprintIndexTest, AdcBoundingBox) {
+  PathPoint path_point;
+  path_point.set_x(1.0);
+  path_point.set_y(2.0);
+  path_point.set_theta(M_PI_2);
+  const Box2d box =
+      PathFootprintIndex::AdcBoundingBox(vehicle_param_, path_point, 0.5);
+  // the center is ahead of the rear axis
+  EXPECT_NEAR(1.0, box.center_x(), 1e-9);
+  EXPECT_NEAR(2.0 + (3.89 - 1.04) * 0.5, box.center_y(), 1e-9);
+  EXPECT_DOUBLE_EQ(4.93, box.length());
+  EXPECT_DOUBLE_EQ(3.11, box.width());
+
+  PathFootprintIndex empty_index(vehicle_param_, 0.0);
+  EXPECT_EQ(-1, empty_index.FirstOverlap(box));
+}
+
+}  // namespace planning
+}  // namespace apollo
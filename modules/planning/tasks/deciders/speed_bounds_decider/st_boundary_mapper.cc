@@ -21,6 +21,7 @@
 #include "modules/planning/tasks/deciders/speed_bounds_decider/st_boundary_mapper.h"
 
 #include <algorithm>
+#include <future>
 #include <limits>
 #include <utility>
 
@@ -28,6 +29,7 @@
 #include "modules/planning/proto/decision.pb.h"
 
 #include "cyber/common/log.h"
+#include "cyber/task/task.h"
 #include "modules/common/configs/vehicle_config_helper.h"
 #include "modules/common/math/line_segment2d.h"
 #include "modules/common/math/vec2d.h"
@@ -45,7 +47,11 @@ using apollo::common::ErrorCode;
 using apollo::common::PathPoint;
 using apollo::common::Status;
 using apollo::common::math::Box2d;
-using apollo::common::math::Vec2d;
+
+namespace {
+// the ADC path is subsampled to about this many points for moving obstacles
+constexpr size_t kDefaultNumPoint = 50;
+}  // namespace
 
 STBoundaryMapper::STBoundaryMapper(const SpeedBoundsDeciderConfig& config,
                                    const ReferenceLine& reference_line,
@@ -70,7 +76,11 @@ Status STBoundaryMapper::ComputeSTBoundary(PathDecision* path_decision) const {
                   "Fail to get params because of too few path points");
   }
 
-  // Go through every obstacle.
+  const auto path_index = BuildPathIndex(path_data_.discretized_path());
+
+  // Go through every obstacle. The obstacles to map onto the ST-graph are
+  // independent of each other and are mapped afterwards.
+  std::vector<Obstacle*> obstacles_to_map;
   Obstacle* stop_obstacle = nullptr;
   ObjectDecisionType stop_decision;
   double min_stop_s = std::numeric_limits<double>::max();
@@ -80,7 +90,7 @@ Status STBoundaryMapper::ComputeSTBoundary(PathDecision* path_decision) const {
 
     // If no longitudinal decision has been made, then plot it onto ST-graph.
     if (!ptr_obstacle->HasLongitudinalDecision()) {
-      ComputeSTBoundary(ptr_obstacle);
+      obstacles_to_map.push_back(ptr_obstacle);
       continue;
     }
 
@@ -102,12 +112,35 @@ Status STBoundaryMapper::ComputeSTBoundary(PathDecision* path_decision) const {
                decision.has_yield()) {
       // 2. Depending on the longitudinal overtake/yield decision,
       //    fine-tune the upper/lower st-boundary of related obstacles.
-      ComputeSTBoundaryWithDecision(ptr_obstacle, decision);
+      obstacles_to_map.push_back(ptr_obstacle);
     } else if (!decision.has_ignore()) {
       // 3. Ignore those unrelated obstacles.
       AWARN << "No mapping for decision: " << decision.DebugString();
     }
   }
+
+  auto map_obstacle = [this, &path_index](Obstacle* obstacle) {
+    if (obstacle->HasLongitudinalDecision()) {
+      ComputeSTBoundaryWithDecision(*path_index, obstacle,
+                                    obstacle->LongitudinalDecision());
+    } else {
+      ComputeSTBoundary(*path_index, obstacle);
+    }
+  };
+  if (FLAGS_enable_multi_thread_in_st_boundary_mapper) {
+    std::vector<std::future<void>> results;
+    for (auto* obstacle : obstacles_to_map) {
+      results.emplace_back(cyber::Async(map_obstacle, obstacle));
+    }
+    for (auto& result : results) {
+      result.get();
+    }
+  } else {
+    for (auto* obstacle : obstacles_to_map) {
+      map_obstacle(obstacle);
+    }
+  }
+
   if (stop_obstacle) {
     bool success = MapStopDecision(stop_obstacle, stop_decision);
     if (!success) {
@@ -159,15 +192,63 @@ bool STBoundaryMapper::MapStopDecision(
   return true;
 }
 
-void STBoundaryMapper::ComputeSTBoundary(Obstacle* obstacle) const {
+std::unique_ptr<STBoundaryMapper::PathIndex> STBoundaryMapper::BuildPathIndex(
+    const std::vector<PathPoint>& path_points) const {
+  const auto* planning_status = PlanningContext::Instance()
+                                    ->mutable_planning_status()
+                                    ->mutable_change_lane();
+
+  double l_buffer =
+      planning_status->status() == ChangeLaneStatus::IN_CHANGE_LANE
+          ? FLAGS_lane_change_obstacle_nudge_l_buffer
+          : FLAGS_nonstatic_obstacle_nudge_l_buffer;
+
+  std::unique_ptr<PathIndex> path_index(
+      new PathIndex(vehicle_param_, l_buffer));
+
+  for (const auto& curr_point_on_path : path_points) {
+    if (curr_point_on_path.s() > planning_max_distance_) {
+      break;
+    }
+    path_index->static_footprints.Add(curr_point_on_path.s(),
+                                      curr_point_on_path);
+  }
+
+  // Subsample to reduce computation time.
+  auto& discretized_path = path_index->discretized_path;
+  if (path_points.size() > 2 * kDefaultNumPoint) {
+    const auto ratio = path_points.size() / kDefaultNumPoint;
+    std::vector<PathPoint> sampled_path_points;
+    for (size_t i = 0; i < path_points.size(); ++i) {
+      if (i % ratio == 0) {
+        sampled_path_points.push_back(path_points[i]);
+      }
+    }
+    discretized_path = DiscretizedPath(std::move(sampled_path_points));
+  } else {
+    discretized_path = DiscretizedPath(path_points);
+  }
+
+  const double step_length = vehicle_param_.front_edge_to_center();
+  auto path_len = std::min(FLAGS_max_trajectory_len, discretized_path.Length());
+  for (double path_s = 0.0; path_s < path_len; path_s += step_length) {
+    path_index->moving_footprints.Add(
+        path_s,
+        discretized_path.Evaluate(path_s + discretized_path.front().s()));
+  }
+  return path_index;
+}
+
+void STBoundaryMapper::ComputeSTBoundary(const PathIndex& path_index,
+                                         Obstacle* obstacle) const {
   if (FLAGS_use_st_drivable_boundary) {
     return;
   }
   std::vector<STPoint> lower_points;
   std::vector<STPoint> upper_points;
 
-  if (!GetOverlapBoundaryPoints(path_data_.discretized_path(), *obstacle,
-                                &upper_points, &lower_points)) {
+  if (!GetOverlapBoundaryPoints(path_index, *obstacle, &upper_points,
+                                &lower_points)) {
     return;
   }
 
@@ -187,26 +268,19 @@ void STBoundaryMapper::ComputeSTBoundary(Obstacle* obstacle) const {
 }
 
 bool STBoundaryMapper::GetOverlapBoundaryPoints(
-    const std::vector<PathPoint>& path_points, const Obstacle& obstacle,
+    const PathIndex& path_index, const Obstacle& obstacle,
     std::vector<STPoint>* upper_points,
     std::vector<STPoint>* lower_points) const {
   // Sanity checks.
   DCHECK(upper_points->empty());
   DCHECK(lower_points->empty());
-  DCHECK_GT(path_points.size(), 0);
-  if (path_points.empty()) {
+  const auto& discretized_path = path_index.discretized_path;
+  if (discretized_path.empty()) {
     AERROR << "No points in path_data_.discretized_path().";
     return false;
   }
 
-  const auto* planning_status = PlanningContext::Instance()
-                                    ->mutable_planning_status()
-                                    ->mutable_change_lane();
-
-  double l_buffer =
-      planning_status->status() == ChangeLaneStatus::IN_CHANGE_LANE
-          ? FLAGS_lane_change_obstacle_nudge_l_buffer
-          : FLAGS_nonstatic_obstacle_nudge_l_buffer;
+  const double l_buffer = path_index.l_buffer;
 
   // Draw the given obstacle on the ST-graph.
   const auto& trajectory = obstacle.Trajectory();
@@ -218,116 +292,93 @@ bool STBoundaryMapper::GetOverlapBoundaryPoints(
             << "] has NO prediction trajectory."
             << obstacle.Perception().ShortDebugString();
     }
-    for (const auto& curr_point_on_path : path_points) {
-      if (curr_point_on_path.s() > planning_max_distance_) {
-        break;
-      }
-
-      const Box2d& obs_box = obstacle.PerceptionBoundingBox();
-      if (CheckOverlap(curr_point_on_path, obs_box, l_buffer)) {
-        // If there is overlapping, then plot it on ST-graph.
-        const double backward_distance = -vehicle_param_.front_edge_to_center();
-        const double forward_distance = obs_box.length();
-        double low_s =
-            std::fmax(0.0, curr_point_on_path.s() + backward_distance);
-        double high_s = std::fmin(planning_max_distance_,
-                                  curr_point_on_path.s() + forward_distance);
-        // It is an unrotated rectangle appearing on the ST-graph.
-        // TODO(jiacheng): reconsider the backward_distance, it might be
-        // unnecessary, but forward_distance is indeed meaningful though.
-        lower_points->emplace_back(low_s, 0.0);
-        lower_points->emplace_back(low_s, planning_max_time_);
-        upper_points->emplace_back(high_s, 0.0);
-        upper_points->emplace_back(high_s, planning_max_time_);
-        break;
-      }
+    const Box2d& obs_box = obstacle.PerceptionBoundingBox();
+    const int overlap_index =
+        path_index.static_footprints.FirstOverlap(obs_box);
+    if (overlap_index >= 0) {
+      // If there is overlapping, then plot it on ST-graph.
+      const double curr_s = path_index.static_footprints.s(overlap_index);
+      const double backward_distance = -vehicle_param_.front_edge_to_center();
+      const double forward_distance = obs_box.length();
+      double low_s = std::fmax(0.0, curr_s + backward_distance);
+      double high_s =
+          std::fmin(planning_max_distance_, curr_s + forward_distance);
+      // It is an unrotated rectangle appearing on the ST-graph.
+      // TODO(jiacheng): reconsider the backward_distance, it might be
+      // unnecessary, but forward_distance is indeed meaningful though.
+      lower_points->emplace_back(low_s, 0.0);
+      lower_points->emplace_back(low_s, planning_max_time_);
+      upper_points->emplace_back(high_s, 0.0);
+      upper_points->emplace_back(high_s, planning_max_time_);
     }
   } else {
     // For those with predicted trajectories (moving obstacles):
-    // 1. Subsample to reduce computation time.
-    const int default_num_point = 50;
-    DiscretizedPath discretized_path;
-    if (path_points.size() > 2 * default_num_point) {
-      const auto ratio = path_points.size() / default_num_point;
-      std::vector<PathPoint> sampled_path_points;
-      for (size_t i = 0; i < path_points.size(); ++i) {
-        if (i % ratio == 0) {
-          sampled_path_points.push_back(path_points[i]);
-        }
-      }
-      discretized_path = DiscretizedPath(std::move(sampled_path_points));
-    } else {
-      discretized_path = DiscretizedPath(path_points);
-    }
-    // 2. Go through every point of the predicted obstacle trajectory.
+    // Go through every point of the predicted obstacle trajectory.
     for (int i = 0; i < trajectory.trajectory_point_size(); ++i) {
       const auto& trajectory_point = trajectory.trajectory_point(i);
-      const Box2d obs_box = obstacle.GetBoundingBox(trajectory_point);
 
       double trajectory_point_time = trajectory_point.relative_time();
       static constexpr double kNegtiveTimeThreshold = -1.0;
       if (trajectory_point_time < kNegtiveTimeThreshold) {
         continue;
       }
+      const Box2d obs_box = obstacle.GetBoundingBox(trajectory_point);
 
       const double step_length = vehicle_param_.front_edge_to_center();
-      auto path_len =
-          std::min(FLAGS_max_trajectory_len, discretized_path.Length());
-      // Go through every point of the ADC's path.
-      for (double path_s = 0.0; path_s < path_len; path_s += step_length) {
-        const auto curr_adc_path_point =
-            discretized_path.Evaluate(path_s + discretized_path.front().s());
-        if (CheckOverlap(curr_adc_path_point, obs_box, l_buffer)) {
-          // Found overlap, start searching with higher resolution
-          const double backward_distance = -step_length;
-          const double forward_distance = vehicle_param_.length() +
-                                          vehicle_param_.width() +
-                                          obs_box.length() + obs_box.width();
-          const double default_min_step = 0.1;  // in meters
-          const double fine_tuning_step_length = std::fmin(
-              default_min_step, discretized_path.Length() / default_num_point);
-
-          bool find_low = false;
-          bool find_high = false;
-          double low_s = std::fmax(0.0, path_s + backward_distance);
-          double high_s =
-              std::fmin(discretized_path.Length(), path_s + forward_distance);
-
-          // Keep shrinking by the resolution bidirectionally until finally
-          // locating the tight upper and lower bounds.
-          while (low_s < high_s) {
-            if (find_low && find_high) {
-              break;
-            }
-            if (!find_low) {
-              const auto& point_low = discretized_path.Evaluate(
-                  low_s + discretized_path.front().s());
-              if (!CheckOverlap(point_low, obs_box, l_buffer)) {
-                low_s += fine_tuning_step_length;
-              } else {
-                find_low = true;
-              }
-            }
-            if (!find_high) {
-              const auto& point_high = discretized_path.Evaluate(
-                  high_s + discretized_path.front().s());
-              if (!CheckOverlap(point_high, obs_box, l_buffer)) {
-                high_s -= fine_tuning_step_length;
-              } else {
-                find_high = true;
-              }
+      // Find the first point of the ADC's path that overlaps.
+      const int overlap_index =
+          path_index.moving_footprints.FirstOverlap(obs_box);
+      if (overlap_index >= 0) {
+        const double path_s = path_index.moving_footprints.s(overlap_index);
+        // Found overlap, start searching with higher resolution
+        const double backward_distance = -step_length;
+        const double forward_distance = vehicle_param_.length() +
+                                        vehicle_param_.width() +
+                                        obs_box.length() + obs_box.width();
+        const double default_min_step = 0.1;  // in meters
+        const double fine_tuning_step_length = std::fmin(
+            default_min_step, discretized_path.Length() / kDefaultNumPoint);
+
+        bool find_low = false;
+        bool find_high = false;
+        double low_s = std::fmax(0.0, path_s + backward_distance);
+        double high_s =
+            std::fmin(discretized_path.Length(), path_s + forward_distance);
+
+        // Keep shrinking by the resolution bidirectionally until finally
+        // locating the tight upper and lower bounds.
+        while (low_s < high_s) {
+          if (find_low && find_high) {
+            break;
+          }
+          if (!find_low) {
+            const auto& point_low = discretized_path.Evaluate(
+                low_s + discretized_path.front().s());
+            if (!CheckOverlap(point_low, obs_box, l_buffer)) {
+              low_s += fine_tuning_step_length;
+            } else {
+              find_low = true;
             }
           }
-          if (find_high && find_low) {
-            lower_points->emplace_back(
-                low_s - speed_bounds_config_.point_extension(),
-                trajectory_point_time);
-            upper_points->emplace_back(
-                high_s + speed_bounds_config_.point_extension(),
-                trajectory_point_time);
+          if (!find_high) {
+            const auto& point_high = discretized_path.Evaluate(
+                high_s + discretized_path.front().s());
+            if (!CheckOverlap(point_high, obs_box, l_buffer)) {
+              high_s -= fine_tuning_step_length;
+            } else {
+              find_high = true;
+            }
           }
-          break;
         }
+        if (find_high && find_low) {
+          lower_points->emplace_back(
+              low_s - speed_bounds_config_.point_extension(),
+              trajectory_point_time);
+          upper_points->emplace_back(
+              high_s + speed_bounds_config_.point_extension(),
+              trajectory_point_time);
+        }
+
       }
     }
   }
@@ -338,7 +389,8 @@ bool STBoundaryMapper::GetOverlapBoundaryPoints(
 }
 
 void STBoundaryMapper::ComputeSTBoundaryWithDecision(
-    Obstacle* obstacle, const ObjectDecisionType& decision) const {
+    const PathIndex& path_index, Obstacle* obstacle,
+    const ObjectDecisionType& decision) const {
   DCHECK(decision.has_follow() || decision.has_yield() ||
          decision.has_overtake())
       << "decision is " << decision.DebugString()
@@ -353,8 +405,8 @@ void STBoundaryMapper::ComputeSTBoundaryWithDecision(
     lower_points = path_st_boundary.lower_points();
     upper_points = path_st_boundary.upper_points();
   } else {
-    if (!GetOverlapBoundaryPoints(path_data_.discretized_path(), *obstacle,
-                                  &upper_points, &lower_points)) {
+    if (!GetOverlapBoundaryPoints(path_index, *obstacle, &upper_points,
+                                  &lower_points)) {
       return;
     }
   }
@@ -388,20 +440,9 @@ void STBoundaryMapper::ComputeSTBoundaryWithDecision(
 bool STBoundaryMapper::CheckOverlap(const PathPoint& path_point,
                                     const Box2d& obs_box,
                                     const double l_buffer) const {
-  // Convert reference point from center of rear axis to center of ADC.
-  Vec2d ego_center_map_frame((vehicle_param_.front_edge_to_center() -
-                              vehicle_param_.back_edge_to_center()) *
-                                 0.5,
-                             (vehicle_param_.left_edge_to_center() -
-                              vehicle_param_.right_edge_to_center()) *
-                                 0.5);
-  ego_center_map_frame.SelfRotate(path_point.theta());
-  ego_center_map_frame.set_x(ego_center_map_frame.x() + path_point.x());
-  ego_center_map_frame.set_y(ego_center_map_frame.y() + path_point.y());
-
   // Compute the ADC bounding box.
-  Box2d adc_box(ego_center_map_frame, path_point.theta(),
-                vehicle_param_.length(), vehicle_param_.width() + l_buffer * 2);
+  Box2d adc_box =
+      PathFootprintIndex::AdcBoundingBox(vehicle_param_, path_point, l_buffer);
 
   // Check whether ADC bounding box overlaps with obstacle bounding box.
   return obs_box.HasOverlap(adc_box);
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -33,6 +34,7 @@
 #include "modules/planning/common/speed/st_boundary.h"
 #include "modules/planning/common/speed_limit.h"
 #include "modules/planning/reference_line/reference_line.h"
+#include "modules/planning/tasks/deciders/speed_bounds_decider/path_footprint_index.h"
 
 namespace apollo {
 namespace planning {
@@ -51,20 +53,41 @@ class STBoundaryMapper {
  private:
   FRIEND_TEST(StBoundaryMapperTest, check_overlap_test);
 
+  /** @brief The ADC path prepared once for mapping all obstacles: the
+   * subsampled path of the moving obstacles and the ADC footprints the
+   * obstacles are checked against.
+   */
+  struct PathIndex {
+    PathIndex(const common::VehicleParam& vehicle_param, const double l_buffer)
+        : l_buffer(l_buffer),
+          static_footprints(vehicle_param, l_buffer),
+          moving_footprints(vehicle_param, l_buffer) {}
+
+    double l_buffer;
+    DiscretizedPath discretized_path;
+    // at the path points up to the planning distance
+    PathFootprintIndex static_footprints;
+    // every front_edge_to_center along discretized_path
+    PathFootprintIndex moving_footprints;
+  };
+
+  std::unique_ptr<PathIndex> BuildPathIndex(
+      const std::vector<common::PathPoint>& path_points) const;
+
   /** @brief Calls GetOverlapBoundaryPoints to get upper and lower points
    * for a given obstacle, and then formulate STBoundary based on that.
    * It also labels boundary type based on previously documented decisions.
    */
-  void ComputeSTBoundary(Obstacle* obstacle) const;
+  void ComputeSTBoundary(const PathIndex& path_index, Obstacle* obstacle) const;
 
   /** @brief Map the given obstacle onto the ST-Graph. The boundary is
    * represented as upper and lower points for every s of interests.
    * Note that upper_points.size() = lower_points.size()
    */
-  bool GetOverlapBoundaryPoints(
-      const std::vector<common::PathPoint>& path_points,
-      const Obstacle& obstacle, std::vector<STPoint>* upper_points,
-      std::vector<STPoint>* lower_points) const;
+  bool GetOverlapBoundaryPoints(const PathIndex& path_index,
+                                const Obstacle& obstacle,
+                                std::vector<STPoint>* upper_points,
+                                std::vector<STPoint>* lower_points) const;
 
   /** @brief Given a path-point and an obstacle bounding box, check if the
    *        ADC, when at that path-point, will collide with the obstacle.
@@ -87,7 +110,8 @@ class STBoundaryMapper {
    * Increase boundary on the s-dimension or set the boundary type, etc.,
    * when necessary.
    */
-  void ComputeSTBoundaryWithDecision(Obstacle* obstacle,
+  void ComputeSTBoundaryWithDecision(const PathIndex& path_index,
+                                     Obstacle* obstacle,
                                      const ObjectDecisionType& decision) const;
 
  private:
@@ -0,0 +1,190 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+// Times the ST-boundary mapping of a crowded scene: a 100 m path with
+// traffic driving along and across it, every obstacle predicted 8 s ahead.
+// BM_FirstOverlap compares the per obstacle box scan along the path the
+// mapper did before with the footprint index; BM_STBoundaryMapper times the
+// whole mapper, single threaded and with obstacles mapped in parallel.
+//
+// cd modules/planning/tasks/deciders/speed_bounds_decider
+// bazel run :st_boundary_mapper_benchmark
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "modules/common/configs/vehicle_config_helper.h"
+#include "modules/common/math/box2d.h"
+#include "modules/common/math/vec2d.h"
+#include "modules/common/util/point_factory.h"
+#include "modules/planning/common/path_decision.h"
+#include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/tasks/deciders/speed_bounds_decider/path_footprint_index.h"
+#include "modules/planning/tasks/deciders/speed_bounds_decider/st_boundary_mapper.h"
+
+namespace apollo {
+namespace planning {
+
+using apollo::common::PathPoint;
+using apollo::common::VehicleConfigHelper;
+using apollo::common::math::Box2d;
+using apollo::common::math::Vec2d;
+using apollo::common::util::PointFactory;
+
+constexpr double kPathLength = 100.0;
+constexpr double kPathResolution = 0.5;
+constexpr double kPredictionTime = 8.0;
+constexpr double kPredictionResolution = 0.1;
+
+std::vector<PathPoint> AdcPath() {
+  std::vector<PathPoint> path_points;
+  for (double s = 0.0; s < kPathLength; s += kPathResolution) {
+    path_points.push_back(PointFactory::ToPathPoint(s, 0.0, 0.0, s));
+  }
+  return path_points;
+}
+
+// Obstacles on the four lanes around the path, half of them oncoming, and
+// some crossing it.
+std::vector<Obstacle> CrowdedScene(const int num_obstacles) {
+  std::mt19937 gen(num_obstacles);
+  std::uniform_real_distribution<double> s_dist(-20.0, kPathLength);
+  std::uniform_real_distribution<double> v_dist(2.0, 15.0);
+  std::uniform_int_distribution<int> lane_dist(-2, 1);
+  std::vector<Obstacle> obstacles;
+  for (int i = 0; i < num_obstacles; ++i) {
+    const bool crossing = i % 8 == 0;
+    const double x = s_dist(gen);
+    const double y = crossing ? -30.0 : 3.5 * lane_dist(gen) + 1.75;
+    const double heading = crossing ? M_PI_2 : (i % 2 == 0 ? 0.0 : M_PI);
+    const double v = v_dist(gen);
+
+    perception::PerceptionObstacle perception_obstacle;
+    perception_obstacle.set_id(i);
+    perception_obstacle.mutable_position()->set_x(x);
+    perception_obstacle.mutable_position()->set_y(y);
+    perception_obstacle.set_theta(heading);
+    perception_obstacle.mutable_velocity()->set_x(v * std::cos(heading));
+    perception_obstacle.mutable_velocity()->set_y(v * std::sin(heading));
+    perception_obstacle.set_length(4.5);
+    perception_obstacle.set_width(1.8);
+
+    prediction::Trajectory trajectory;
+    for (double t = 0.0; t <= kPredictionTime; t += kPredictionResolution) {
+      auto* trajectory_point = trajectory.add_trajectory_point();
+      trajectory_point->mutable_path_point()->set_x(x +
+                                                    v * t * std::cos(heading));
+      trajectory_point->mutable_path_point()->set_y(y +
+                                                    v * t * std::sin(heading));
+      trajectory_point->mutable_path_point()->set_theta(heading);
+      trajectory_point->set_v(v);
+      trajectory_point->set_relative_time(t);
+    }
+    obstacles.emplace_back(std::to_string(i), perception_obstacle, trajectory,
+                           prediction::ObstaclePriority::NORMAL, false);
+  }
+  return obstacles;
+}
+
+enum OverlapMode { kScan = 0, kIndex = 1 };
+
+void BM_FirstOverlap(benchmark::State& state) {  // NOLINT
+  const auto mode = static_cast<OverlapMode>(state.range(1));
+  const auto& vehicle_param = VehicleConfigHelper::GetConfig().vehicle_param();
+  const double l_buffer = FLAGS_nonstatic_obstacle_nudge_l_buffer;
+  const std::vector<PathPoint> path_points = AdcPath();
+  std::vector<Box2d> obs_boxes;
+  for (const auto& obstacle : CrowdedScene(static_cast<int>(state.range(0)))) {
+    for (const auto& point : obstacle.Trajectory().trajectory_point()) {
+      obs_boxes.push_back(obstacle.GetBoundingBox(point));
+    }
+  }
+
+  for (auto _ : state) {
+    int num_overlaps = 0;
+    if (mode == kScan) {
+      for (const auto& obs_box : obs_boxes) {
+        for (const auto& path_point : path_points) {
+          if (obs_box.HasOverlap(PathFootprintIndex::AdcBoundingBox(
+                  vehicle_param, path_point, l_buffer))) {
+            ++num_overlaps;
+            break;
+          }
+        }
+      }
+    } else {
+      PathFootprintIndex index(vehicle_param, l_buffer);
+      for (const auto& path_point : path_points) {
+        index.Add(path_point.s(), path_point);
+      }
+      for (const auto& obs_box : obs_boxes) {
+        num_overlaps += index.FirstOverlap(obs_box) >= 0;
+      }
+    }
+    benchmark::DoNotOptimize(num_overlaps);
+  }
+}
+BENCHMARK(BM_FirstOverlap)
+    ->Args({80, kScan})
+    ->Args({80, kIndex})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_STBoundaryMapper(benchmark::State& state) {  // NOLINT
+  FLAGS_enable_multi_thread_in_st_boundary_mapper = state.range(1) != 0;
+
+  std::vector<ReferencePoint> ref_points;
+  for (double s = 0.0; s < kPathLength + 50.0; s += kPathResolution) {
+    ref_points.emplace_back(
+        hdmap::MapPathPoint(Vec2d(s - 20.0, 0.0), 0.0), 0.0, 0.0);
+  }
+  const ReferenceLine reference_line(ref_points);
+  PathData path_data;
+  path_data.SetReferenceLine(&reference_line);
+  path_data.SetDiscretizedPath(DiscretizedPath(AdcPath()));
+
+  PathDecision path_decision;
+  for (const auto& obstacle :
+       CrowdedScene(static_cast<int>(state.range(0)))) {
+    path_decision.AddObstacle(obstacle);
+  }
+
+  SpeedBoundsDeciderConfig config;
+  const STBoundaryMapper mapper(config, reference_line, path_data,
+                                kPathLength, kPredictionTime);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mapper.ComputeSTBoundary(&path_decision));
+  }
+  FLAGS_enable_multi_thread_in_st_boundary_mapper = false;
+}
+BENCHMARK(BM_STBoundaryMapper)
+    ->Args({20, 0})
+    ->Args({80, 0})
+    ->Args({80, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace planning
+}  // namespace apollo
+
+BENCHMARK_MAIN();
@@ -44,6 +44,8 @@ class STBoundsDecider : public Decider {
  public:
   explicit STBoundsDecider(const TaskConfig& config);
 
+  bool IsReferenceLineLocal() const override { return true; }
+
  private:
   common::Status Process(Frame* const frame,
                          ReferenceLineInfo* const reference_line_info) override;
@@ -31,7 +31,13 @@ namespace apollo {
 namespace planning {
 namespace {
 constexpr double kInf = std::numeric_limits<double>::infinity();
-}
+
+// resolution and offset of the accel and jerk cost lookup tables
+constexpr double kAccelCostResolution = 0.1;
+constexpr size_t kAccelCostShift = 100;
+constexpr double kJerkCostResolution = 0.1;
+constexpr size_t kJerkCostShift = 200;
+}  // namespace
 
 DpStCost::DpStCost(const DpStSpeedConfig& config, const double total_t,
                    const double total_s,
@@ -58,8 +64,16 @@ DpStCost::DpStCost(const DpStSpeedConfig& config, const double total_t,
   for (auto& vec : boundary_cost_) {
     vec.resize(dimension_t, std::make_pair(-1.0, -1.0));
   }
-  accel_cost_.fill(-1.0);
-  jerk_cost_.fill(-1.0);
+  // Filled here rather than on first use so that the cost getters do not
+  // write and the rows of a column can be evaluated concurrently.
+  for (size_t i = 0; i < accel_cost_.size(); ++i) {
+    accel_cost_[i] = ComputeAccelCost(
+        (static_cast<double>(i) - kAccelCostShift) * kAccelCostResolution);
+  }
+  for (size_t i = 0; i < jerk_cost_.size(); ++i) {
+    jerk_cost_[i] = ComputeJerkCost(
+        (static_cast<double>(i) - kJerkCostShift) * kJerkCostResolution);
+  }
 }
 
 void DpStCost::AddToKeepClearRange(
@@ -101,6 +115,42 @@ void DpStCost::SortAndMergeRange(
   keep_clear_range->resize(i + 1);
 }
 
+bool DpStCost::IsCostObstacle(const Obstacle& obstacle) {
+  // Not applying obstacle approaching cost to virtual obstacle like created
+  // stop fences
+  if (obstacle.IsVirtual()) {
+    return false;
+  }
+
+  // Stop obstacles are assumed to have a safety margin when mapping them out,
+  // so repelling force in dp st is not needed as it is designed to have adc
+  // stop right at the stop distance we design in prior mapping process
+  if (obstacle.LongitudinalDecision().has_stop()) {
+    return false;
+  }
+
+  return obstacle.path_st_boundary().min_s() <=
+         FLAGS_speed_lon_decision_horizon;
+}
+
+void DpStCost::CacheBoundarySRanges(const uint32_t index_t, const double t) {
+  for (size_t i = 0; i < obstacles_.size(); ++i) {
+    const auto& boundary = obstacles_[i]->path_st_boundary();
+    if (!IsCostObstacle(*obstacles_[i]) || t < boundary.min_t() ||
+        t > boundary.max_t()) {
+      continue;
+    }
+    const int boundary_index = boundary_map_.at(boundary.id());
+    auto& s_range = boundary_cost_[boundary_index][index_t];
+    if (s_range.first < 0.0) {
+      double s_upper = 0.0;
+      double s_lower = 0.0;
+      boundary.GetBoundarySRange(t, &s_upper, &s_lower);
+      s_range = std::make_pair(s_upper, s_lower);
+    }
+  }
+}
+
 bool DpStCost::InKeepClearRange(double s) const {
   for (const auto& p : keep_clear_range_) {
     if (p.first <= s && p.second >= s) {
@@ -131,24 +181,11 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
   }
 
   for (const auto* obstacle : obstacles_) {
-    // Not applying obstacle approaching cost to virtual obstacle like created
-    // stop fences
-    if (obstacle->IsVirtual()) {
-      continue;
-    }
-
-    // Stop obstacles are assumed to have a safety margin when mapping them out,
-    // so repelling force in dp st is not needed as it is designed to have adc
-    // stop right at the stop distance we design in prior mapping process
-    if (obstacle->LongitudinalDecision().has_stop()) {
+    if (!IsCostObstacle(*obstacle)) {
       continue;
     }
 
-    auto boundary = obstacle->path_st_boundary();
-
-    if (boundary.min_s() > FLAGS_speed_lon_decision_horizon) {
-      continue;
-    }
+    const auto& boundary = obstacle->path_st_boundary();
     if (t < boundary.min_t() || t > boundary.max_t()) {
       continue;
     }
@@ -158,7 +195,7 @@ double DpStCost::GetObstacleCost(const StGraphPoint& st_graph_point) {
     double s_upper = 0.0;
     double s_lower = 0.0;
 
-    int boundary_index = boundary_map_[boundary.id()];
+    const int boundary_index = boundary_map_.at(boundary.id());
     if (boundary_cost_[boundary_index][st_graph_point.index_t()].first < 0.0) {
       boundary.GetBoundarySRange(t, &s_upper, &s_lower);
       boundary_cost_[boundary_index][st_graph_point.index_t()] =
@@ -238,37 +275,34 @@ double DpStCost::GetSpeedCost(const STPoint& first, const STPoint& second,
   return cost;
 }
 
-double DpStCost::GetAccelCost(const double accel) {
-  double cost = 0.0;
-  static constexpr double kEpsilon = 0.1;
-  static constexpr size_t kShift = 100;
-  const size_t accel_key = static_cast<size_t>(accel / kEpsilon + 0.5 + kShift);
+double DpStCost::GetAccelCost(const double accel) const {
+  const size_t accel_key = static_cast<size_t>(
+      accel / kAccelCostResolution + 0.5 + kAccelCostShift);
   DCHECK_LT(accel_key, accel_cost_.size());
   if (accel_key >= accel_cost_.size()) {
     return kInf;
   }
+  return accel_cost_[accel_key] * unit_t_;
+}
 
-  if (accel_cost_.at(accel_key) < 0.0) {
-    const double accel_sq = accel * accel;
-    double max_acc = config_.max_acceleration();
-    double max_dec = config_.max_deceleration();
-    double accel_penalty = config_.accel_penalty();
-    double decel_penalty = config_.decel_penalty();
-
-    if (accel > 0.0) {
-      cost = accel_penalty * accel_sq;
-    } else {
-      cost = decel_penalty * accel_sq;
-    }
-    cost += accel_sq * decel_penalty * decel_penalty /
-                (1 + std::exp(1.0 * (accel - max_dec))) +
-            accel_sq * accel_penalty * accel_penalty /
-                (1 + std::exp(-1.0 * (accel - max_acc)));
-    accel_cost_.at(accel_key) = cost;
+double DpStCost::ComputeAccelCost(const double accel) const {
+  double cost = 0.0;
+  const double accel_sq = accel * accel;
+  double max_acc = config_.max_acceleration();
+  double max_dec = config_.max_deceleration();
+  double accel_penalty = config_.accel_penalty();
+  double decel_penalty = config_.decel_penalty();
+
+  if (accel > 0.0) {
+    cost = accel_penalty * accel_sq;
   } else {
-    cost = accel_cost_.at(accel_key);
+    cost = decel_penalty * accel_sq;
   }
-  return cost * unit_t_;
+  cost += accel_sq * decel_penalty * decel_penalty /
+              (1 + std::exp(1.0 * (accel - max_dec))) +
+          accel_sq * accel_penalty * accel_penalty /
+              (1 + std::exp(-1.0 * (accel - max_acc)));
+  return cost;
 }
 
 double DpStCost::GetAccelCostByThreePoints(const STPoint& first,
@@ -286,29 +320,22 @@ double DpStCost::GetAccelCostByTwoPoints(const double pre_speed,
   return GetAccelCost(accel);
 }
 
-double DpStCost::JerkCost(const double jerk) {
-  double cost = 0.0;
-  static constexpr double kEpsilon = 0.1;
-  static constexpr size_t kShift = 200;
-  const size_t jerk_key = static_cast<size_t>(jerk / kEpsilon + 0.5 + kShift);
+double DpStCost::JerkCost(const double jerk) const {
+  const size_t jerk_key =
+      static_cast<size_t>(jerk / kJerkCostResolution + 0.5 + kJerkCostShift);
   if (jerk_key >= jerk_cost_.size()) {
     return kInf;
   }
+  // TODO(All): normalize to unit_t_
+  return jerk_cost_[jerk_key];
+}
 
-  if (jerk_cost_.at(jerk_key) < 0.0) {
-    double jerk_sq = jerk * jerk;
-    if (jerk > 0) {
-      cost = config_.positive_jerk_coeff() * jerk_sq * unit_t_;
-    } else {
-      cost = config_.negative_jerk_coeff() * jerk_sq * unit_t_;
-    }
-    jerk_cost_.at(jerk_key) = cost;
-  } else {
-    cost = jerk_cost_.at(jerk_key);
+double DpStCost::ComputeJerkCost(const double jerk) const {
+  const double jerk_sq = jerk * jerk;
+  if (jerk > 0) {
+    return config_.positive_jerk_coeff() * jerk_sq * unit_t_;
   }
-
-  // TODO(All): normalize to unit_t_
-  return cost;
+  return config_.negative_jerk_coeff() * jerk_sq * unit_t_;
 }
 
 double DpStCost::GetJerkCostByFourPoints(const STPoint& first,
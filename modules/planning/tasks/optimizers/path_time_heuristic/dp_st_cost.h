@@ -44,6 +44,13 @@ class DpStCost {
            const STDrivableBoundary& st_drivable_boundary,
            const common::TrajectoryPoint& init_point);
 
+  /**
+   * @brief Computes the s-range of every obstacle boundary at column
+   * index_t, time t, ahead of GetObstacleCost, which then only reads them.
+   * This lets the rows of a column be evaluated concurrently.
+   */
+  void CacheBoundarySRanges(const uint32_t index_t, const double t);
+
   double GetObstacleCost(const StGraphPoint& point);
 
   double GetSpatialPotentialCost(const StGraphPoint& point);
@@ -72,8 +79,13 @@ class DpStCost {
                                  const STPoint& third, const STPoint& fourth);
 
  private:
-  double GetAccelCost(const double accel);
-  double JerkCost(const double jerk);
+  double GetAccelCost(const double accel) const;
+  double ComputeAccelCost(const double accel) const;
+  double JerkCost(const double jerk) const;
+  double ComputeJerkCost(const double jerk) const;
+
+  // whether the obstacle adds to the obstacle cost
+  static bool IsCostObstacle(const Obstacle& obstacle);
 
   void AddToKeepClearRange(const std::vector<const Obstacle*>& obstacles);
   static void SortAndMergeRange(
@@ -0,0 +1,128 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file dp_st_worker_pool.cc
+ **/
+
+#include "modules/planning/tasks/optimizers/path_time_heuristic/dp_st_worker_pool.h"
+
+#include <algorithm>
+
+#include "cyber/common/log.h"
+#include "cyber/scheduler/common/pin_thread.h"
+#include "modules/planning/common/planning_gflags.h"
+
+namespace apollo {
+namespace planning {
+
+DpStWorkerPool* DpStWorkerPool::Instance() {
+  static DpStWorkerPool pool(FLAGS_dp_st_graph_thread_num,
+                             FLAGS_dp_st_graph_thread_cpuset);
+  return &pool;
+}
+
+DpStWorkerPool::DpStWorkerPool(const int num_workers,
+                               const std::string& cpuset) {
+  std::vector<int> cpus;
+  if (!cpuset.empty()) {
+    cyber::scheduler::ParseCpuset(cpuset, &cpus);
+  }
+  for (int i = 0; i < num_workers; ++i) {
+    workers_.emplace_back(&DpStWorkerPool::Work, this, i);
+    cyber::scheduler::SetSchedAffinity(&workers_.back(), cpus, "1to1", i);
+  }
+  ADEBUG << "dp st worker pool: " << num_workers << " workers, cpuset: \""
+         << cpuset << "\"";
+}
+
+DpStWorkerPool::~DpStWorkerPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void DpStWorkerPool::ParallelFor(
+    const size_t begin, const size_t end, const size_t min_range_size,
+    const std::function<void(size_t, size_t)>& func) {
+  if (begin >= end) {
+    return;
+  }
+  const size_t size = end - begin;
+  const size_t num_ranges =
+      std::min(workers_.size() + 1, size / std::max<size_t>(min_range_size, 1));
+  std::unique_lock<std::mutex> caller_lock(caller_mutex_, std::try_to_lock);
+  if (num_ranges < 2 || !caller_lock.owns_lock()) {
+    func(begin, end);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    func_ = &func;
+    begin_ = begin;
+    end_ = end;
+    range_size_ = (size + num_ranges - 1) / num_ranges;
+    num_ranges_ = (size + range_size_ - 1) / range_size_;
+    num_pending_ = num_ranges_ - 1;
+    ++generation_;
+  }
+  work_cv_.notify_all();
+
+  RunRange(0);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_cv_.wait(lock, [this] { return num_pending_ == 0; });
+  func_ = nullptr;
+}
+
+void DpStWorkerPool::Work(const size_t worker_index) {
+  uint64_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      work_cv_.wait(lock,
+                    [&] { return stop_ || generation_ != generation; });
+      if (stop_) {
+        return;
+      }
+      generation = generation_;
+      // the calling thread runs range 0
+      if (worker_index + 1 >= num_ranges_) {
+        continue;
+      }
+    }
+    RunRange(worker_index + 1);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--num_pending_ == 0) {
+      done_cv_.notify_one();
+    }
+  }
+}
+
+void DpStWorkerPool::RunRange(const size_t range_index) {
+  // the job does not change until all its ranges are done
+  const size_t range_begin = begin_ + range_index * range_size_;
+  (*func_)(range_begin, std::min(range_begin + range_size_, end_));
+}
+
+}  // namespace planning
+}  // namespace apollo
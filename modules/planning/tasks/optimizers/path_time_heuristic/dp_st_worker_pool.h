@@ -0,0 +1,91 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file dp_st_worker_pool.h
+ **/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class DpStWorkerPool
+ * @brief Long-lived worker threads for the row-parallel dp st graph. Each
+ * column of the cost table is split into contiguous row ranges that the
+ * workers and the calling thread compute together, with no task or future
+ * allocated per column.
+ */
+class DpStWorkerPool {
+ public:
+  /**
+   * @brief The process wide pool, started on first use with
+   * FLAGS_dp_st_graph_thread_num workers, pinned one to one to the CPUs of
+   * FLAGS_dp_st_graph_thread_cpuset if it is set.
+   */
+  static DpStWorkerPool* Instance();
+
+  DpStWorkerPool(const int num_workers, const std::string& cpuset);
+
+  ~DpStWorkerPool();
+
+  /**
+   * @brief Calls func on disjoint ranges [range_begin, range_end) covering
+   * [begin, end), of at least min_range_size elements, and returns when all
+   * of them are done. Runs func(begin, end) on the calling thread if the
+   * pool is already used by another caller.
+   */
+  void ParallelFor(const size_t begin, const size_t end,
+                   const size_t min_range_size,
+                   const std::function<void(size_t, size_t)>& func);
+
+  size_t num_workers() const { return workers_.size(); }
+
+ private:
+  void Work(const size_t worker_index);
+
+  void RunRange(const size_t range_index);
+
+  std::vector<std::thread> workers_;
+
+  // held by the thread running ParallelFor
+  std::mutex caller_mutex_;
+
+  // guards the job below
+  std::mutex mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  uint64_t generation_ = 0;
+  bool stop_ = false;
+  const std::function<void(size_t, size_t)>* func_ = nullptr;
+  size_t begin_ = 0;
+  size_t end_ = 0;
+  size_t range_size_ = 0;
+  size_t num_ranges_ = 0;
+  size_t num_pending_ = 0;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file
+ **/
+
+#include "modules/planning/tasks/optimizers/path_time_heuristic/dp_st_worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace apollo {
+namespace planning {
+
+TEST(DpStWorkerPoolTest, ParallelFor) {
+  DpStWorkerPool pool(3, "");
+  EXPECT_EQ(3U, pool.num_workers());
+
+  std::vector<int> visits(100, 0);
+  std::atomic<int> num_ranges(0);
+  for (int round = 0; round < 50; ++round) {
+    // ranges from the whole column down to a single row
+    const size_t begin = round;
+    const size_t end = visits.size() - round;
+    num_ranges = 0;
+    pool.ParallelFor(begin, end, 8, [&](const size_t b, const size_t e) {
+      EXPECT_LE(begin, b);
+      EXPECT_LT(b, e);
+      EXPECT_LE(e, end);
+      for (size_t i = b; i < e; ++i) {
+        ++visits[i];
+      }
+      ++num_ranges;
+    });
+    EXPECT_LE(num_ranges, 4);
+    if (end - begin < 16) {
+      EXPECT_EQ(1, num_ranges);
+    }
+  }
+  for (size_t i = 0; i < visits.size(); ++i) {
+    EXPECT_EQ(static_cast<int>(std::min(i, visits.size() - 1 - i)) + 1,
+              visits[i]);
+  }
+
+  pool.ParallelFor(5, 5, 1, [](const size_t, const size_t) { FAIL(); });
+}
+
+TEST(DpStWorkerPoolTest, NestedCall) {
+  DpStWorkerPool pool(2, "");
+  std::atomic<int> sum(0);
+  pool.ParallelFor(0, 30, 1, [&](const size_t b, const size_t e) {
+    // the pool is busy, so the inner call runs on this thread
+    pool.ParallelFor(b * 10, e * 10, 1, [&](const size_t bb, const size_t ee) {
+      for (size_t i = bb; i < ee; ++i) {
+        sum += static_cast<int>(i);
+      }
+    });
+  });
+  EXPECT_EQ(299 * 300 / 2, sum);
+}
+
+}  // namespace planning
+}  // namespace apollo
@@ -24,14 +24,14 @@
 #include <limits>
 #include <string>
 
-#include "cyber/task/task.h"
-
 #include "modules/common/proto/pnc_point.pb.h"
 
 #include "cyber/common/log.h"
 #include "modules/common/math/vec2d.h"
 #include "modules/common/util/point_factory.h"
 #include "modules/planning/common/planning_gflags.h"
+#include "modules/planning/tasks/optimizers/path_time_heuristic/dp_st_worker_pool.h"
+#include "modules/planning/tasks/utils/st_gap_estimator.h"
 
 namespace apollo {
 namespace planning {
@@ -45,6 +45,9 @@ namespace {
 
 static constexpr double kDoubleEpsilon = 1.0e-6;
 
+// The fewest rows of a column given to one thread of the multi-thread dp.
+static constexpr size_t kMinRowsPerThread = 8;
+
 // Continuous-time collision check using linear interpolation as closed-loop
 // dynamics
 bool CheckOverlapOnDpStGraph(const std::vector<const STBoundary*>& boundaries,
@@ -68,14 +71,20 @@ bool CheckOverlapOnDpStGraph(const std::vector<const STBoundary*>& boundaries,
 GriddedPathTimeGraph::GriddedPathTimeGraph(
     const StGraphData& st_graph_data, const DpStSpeedConfig& dp_config,
     const std::vector<const Obstacle*>& obstacles,
-    const common::TrajectoryPoint& init_point)
+    const common::TrajectoryPoint& init_point,
+    StGraphCostTable* const cost_table)
     : st_graph_data_(st_graph_data),
       gridded_path_time_graph_config_(dp_config),
       obstacles_(obstacles),
       init_point_(init_point),
       dp_st_cost_(dp_config, st_graph_data_.total_time_by_conf(),
                   st_graph_data_.path_length(), obstacles,
-                  st_graph_data_.st_drivable_boundary(), init_point_) {
+                  st_graph_data_.st_drivable_boundary(), init_point_),
+      cost_table_(cost_table) {
+  if (cost_table_ == nullptr) {
+    own_cost_table_.reset(new StGraphCostTable());
+    cost_table_ = own_cost_table_.get();
+  }
   total_length_t_ = st_graph_data_.total_time_by_conf();
   unit_t_ = gridded_path_time_graph_config_.unit_t();
   total_length_s_ = st_graph_data_.path_length();
@@ -122,6 +131,8 @@ Status GriddedPathTimeGraph::Search(SpeedData* const speed_data) {
     return Status(ErrorCode::PLANNING_ERROR, msg);
   }
 
+  UpdateObstacleCostCache();
+
   if (!InitSpeedLimitLookUp().ok()) {
     const std::string msg = "Initialize speed limit lookup table failed.";
     AERROR << msg;
@@ -185,32 +196,68 @@ Status GriddedPathTimeGraph::InitCostTable() {
     return Status(ErrorCode::PLANNING_ERROR, msg);
   }
 
-  cost_table_ = std::vector<std::vector<StGraphPoint>>(
-      dimension_t_, std::vector<StGraphPoint>(dimension_s_, StGraphPoint()));
+  cost_table_->Reset(dimension_t_, dimension_s_);
 
   double curr_t = 0.0;
-  for (uint32_t i = 0; i < cost_table_.size(); ++i, curr_t += unit_t_) {
-    auto& cost_table_i = cost_table_[i];
+  for (uint32_t i = 0; i < dimension_t_; ++i, curr_t += unit_t_) {
     double curr_s = 0.0;
     for (uint32_t j = 0; j < dense_dimension_s_; ++j, curr_s += dense_unit_s_) {
-      cost_table_i[j].Init(i, j, STPoint(curr_s, curr_t));
+      cost_table_->at(i, j).Init(i, j, STPoint(curr_s, curr_t));
     }
     curr_s = static_cast<double>(dense_dimension_s_ - 1) * dense_unit_s_ +
              sparse_unit_s_;
-    for (uint32_t j = dense_dimension_s_; j < cost_table_i.size();
+    for (uint32_t j = dense_dimension_s_; j < dimension_s_;
          ++j, curr_s += sparse_unit_s_) {
-      cost_table_i[j].Init(i, j, STPoint(curr_s, curr_t));
+      cost_table_->at(i, j).Init(i, j, STPoint(curr_s, curr_t));
     }
   }
 
-  const auto& cost_table_0 = cost_table_[0];
-  spatial_distance_by_index_ = std::vector<double>(cost_table_0.size(), 0.0);
-  for (uint32_t i = 0; i < cost_table_0.size(); ++i) {
-    spatial_distance_by_index_[i] = cost_table_0[i].point().s();
+  spatial_distance_by_index_.resize(dimension_s_);
+  for (uint32_t i = 0; i < dimension_s_; ++i) {
+    spatial_distance_by_index_[i] = cost_table_->at(0, i).point().s();
   }
   return Status::OK();
 }
 
+void GriddedPathTimeGraph::UpdateObstacleCostCache() {
+  if (FLAGS_use_st_drivable_boundary) {
+    // the drivable boundary is rebuilt every cycle, never reuse
+    cost_table_->ClearObstacleCosts();
+    return;
+  }
+
+  // everything DpStCost::GetObstacleCost reads for a cell
+  std::vector<double> key_values = {
+      unit_t_,
+      dense_unit_s_,
+      sparse_unit_s_,
+      static_cast<double>(dense_dimension_s_),
+      static_cast<double>(dimension_s_),
+      gridded_path_time_graph_config_.obstacle_weight(),
+      gridded_path_time_graph_config_.default_obstacle_cost(),
+      gridded_path_time_graph_config_.safe_distance(),
+      FLAGS_speed_lon_decision_horizon,
+      StGapEstimator::EstimateSafeOvertakingGap()};
+  std::vector<std::string> key_ids;
+  for (const auto* obstacle : obstacles_) {
+    const auto& boundary = obstacle->path_st_boundary();
+    key_ids.push_back(boundary.id());
+    key_values.push_back(obstacle->IsVirtual());
+    key_values.push_back(obstacle->LongitudinalDecision().has_stop());
+    for (const auto& points :
+         {boundary.lower_points(), boundary.upper_points()}) {
+      key_values.push_back(static_cast<double>(points.size()));
+      for (const auto& point : points) {
+        key_values.push_back(point.s());
+        key_values.push_back(point.t());
+      }
+    }
+  }
+  if (cost_table_->UpdateObstacleCostKey(key_values, key_ids)) {
+    ADEBUG << "Reuse the obstacle costs of the last search.";
+  }
+}
+
 Status GriddedPathTimeGraph::InitSpeedLimitLookUp() {
   speed_limit_by_index_.clear();
 
@@ -219,7 +266,7 @@ Status GriddedPathTimeGraph::InitSpeedLimitLookUp() {
 
   for (uint32_t i = 0; i < dimension_s_; ++i) {
     speed_limit_by_index_[i] =
-        speed_limit.GetSpeedLimitByS(cost_table_[0][i].point().s());
+        speed_limit.GetSpeedLimitByS(cost_table_->at(0, i).point().s());
   }
   return Status::OK();
 }
@@ -231,32 +278,33 @@ Status GriddedPathTimeGraph::CalculateTotalCost() {
   size_t next_highest_row = 0;
   size_t next_lowest_row = 0;
 
-  for (size_t c = 0; c < cost_table_.size(); ++c) {
+  const auto calculate_rows = [this](const uint32_t c, const size_t begin,
+                                     const size_t end) {
+    for (size_t r = begin; r < end; ++r) {
+      CalculateCostAt(c, static_cast<uint32_t>(r));
+    }
+  };
+
+  for (uint32_t c = 0; c < dimension_t_; ++c) {
     size_t highest_row = 0;
-    size_t lowest_row = cost_table_.back().size() - 1;
-
-    int count = static_cast<int>(next_highest_row) -
-                static_cast<int>(next_lowest_row) + 1;
-    if (count > 0) {
-      std::vector<std::future<void>> results;
-      for (size_t r = next_lowest_row; r <= next_highest_row; ++r) {
-        auto msg = std::make_shared<StGraphMessage>(c, r);
-        if (FLAGS_enable_multi_thread_in_dp_st_graph) {
-          results.push_back(
-              cyber::Async(&GriddedPathTimeGraph::CalculateCostAt, this, msg));
-        } else {
-          CalculateCostAt(msg);
-        }
-      }
+    size_t lowest_row = dimension_s_ - 1;
+
+    if (next_lowest_row <= next_highest_row) {
       if (FLAGS_enable_multi_thread_in_dp_st_graph) {
-        for (auto& result : results) {
-          result.get();
-        }
+        // rows only read the previous columns and write their own point
+        dp_st_cost_.CacheBoundarySRanges(c, cost_table_->at(c, 0).point().t());
+        DpStWorkerPool::Instance()->ParallelFor(
+            next_lowest_row, next_highest_row + 1, kMinRowsPerThread,
+            [&](const size_t begin, const size_t end) {
+              calculate_rows(c, begin, end);
+            });
+      } else {
+        calculate_rows(c, next_lowest_row, next_highest_row + 1);
       }
     }
 
     for (size_t r = next_lowest_row; r <= next_highest_row; ++r) {
-      const auto& cost_cr = cost_table_[c][r];
+      const auto& cost_cr = cost_table_->at(c, static_cast<uint32_t>(r));
       if (cost_cr.total_cost() < std::numeric_limits<double>::infinity()) {
         size_t h_r = 0;
         size_t l_r = 0;
@@ -316,20 +364,22 @@ void GriddedPathTimeGraph::GetRowRange(const StGraphPoint& point,
   }
 }
 
-void GriddedPathTimeGraph::CalculateCostAt(
-    const std::shared_ptr<StGraphMessage>& msg) {
-  const uint32_t c = msg->c;
-  const uint32_t r = msg->r;
-  auto& cost_cr = cost_table_[c][r];
+void GriddedPathTimeGraph::CalculateCostAt(const uint32_t c, const uint32_t r) {
+  auto& cost_cr = cost_table_->at(c, r);
 
-  cost_cr.SetObstacleCost(dp_st_cost_.GetObstacleCost(cost_cr));
+  double obstacle_cost = cost_table_->cached_obstacle_cost(c, r);
+  if (std::isnan(obstacle_cost)) {
+    obstacle_cost = dp_st_cost_.GetObstacleCost(cost_cr);
+    cost_table_->CacheObstacleCost(c, r, obstacle_cost);
+  }
+  cost_cr.SetObstacleCost(obstacle_cost);
   if (cost_cr.obstacle_cost() > std::numeric_limits<double>::max()) {
     return;
   }
 
   cost_cr.SetSpatialPotentialCost(dp_st_cost_.GetSpatialPotentialCost(cost_cr));
 
-  const auto& cost_init = cost_table_[0][0];
+  const auto& cost_init = cost_table_->at(0, 0);
   if (c == 0) {
     DCHECK_EQ(r, 0) << "Incorrect. Row should be 0 with col = 0. row: " << r;
     cost_cr.SetTotalCost(0.0);
@@ -383,7 +433,7 @@ void GriddedPathTimeGraph::CalculateCostAt(
         std::distance(spatial_distance_by_index_.begin(), pre_lowest_itr));
   }
   const uint32_t r_pre_size = r - r_low + 1;
-  const auto& pre_col = cost_table_[c - 1];
+  const StGraphPoint* const pre_col = &cost_table_->at(c - 1, 0);
   double curr_speed_limit = speed_limit;
 
   if (c == 2) {
@@ -468,7 +518,7 @@ void GriddedPathTimeGraph::CalculateCostAt(
     }
 
     uint32_t r_prepre = pre_col[r_pre].pre_point()->index_s();
-    const StGraphPoint& prepre_graph_point = cost_table_[c - 2][r_prepre];
+    const StGraphPoint& prepre_graph_point = cost_table_->at(c - 2, r_prepre);
     if (std::isinf(prepre_graph_point.total_cost())) {
       continue;
     }
@@ -499,7 +549,8 @@ void GriddedPathTimeGraph::CalculateCostAt(
 Status GriddedPathTimeGraph::RetrieveSpeedProfile(SpeedData* const speed_data) {
   double min_cost = std::numeric_limits<double>::infinity();
   const StGraphPoint* best_end_point = nullptr;
-  for (const StGraphPoint& cur_point : cost_table_.back()) {
+  for (uint32_t r = 0; r < dimension_s_; ++r) {
+    const StGraphPoint& cur_point = cost_table_->at(dimension_t_ - 1, r);
     if (!std::isinf(cur_point.total_cost()) &&
         cur_point.total_cost() < min_cost) {
       best_end_point = &cur_point;
@@ -507,8 +558,8 @@ Status GriddedPathTimeGraph::RetrieveSpeedProfile(SpeedData* const speed_data) {
     }
   }
 
-  for (const auto& row : cost_table_) {
-    const StGraphPoint& cur_point = row.back();
+  for (uint32_t c = 0; c < dimension_t_; ++c) {
+    const StGraphPoint& cur_point = cost_table_->at(c, dimension_s_ - 1);
     if (!std::isinf(cur_point.total_cost()) &&
         cur_point.total_cost() < min_cost) {
       best_end_point = &cur_point;
@@ -566,8 +617,8 @@ double GriddedPathTimeGraph::CalculateEdgeCostForSecondCol(
     const uint32_t row, const double speed_limit, const double cruise_speed) {
   double init_speed = init_point_.v();
   double init_acc = init_point_.a();
-  const STPoint& pre_point = cost_table_[0][0].point();
-  const STPoint& curr_point = cost_table_[1][row].point();
+  const STPoint& pre_point = cost_table_->at(0, 0).point();
+  const STPoint& curr_point = cost_table_->at(1, row).point();
   return dp_st_cost_.GetSpeedCost(pre_point, curr_point, speed_limit,
                                   cruise_speed) +
          dp_st_cost_.GetAccelCostByTwoPoints(init_speed, pre_point,
@@ -580,9 +631,9 @@ double GriddedPathTimeGraph::CalculateEdgeCostForThirdCol(
     const uint32_t curr_row, const uint32_t pre_row, const double speed_limit,
     const double cruise_speed) {
   double init_speed = init_point_.v();
-  const STPoint& first = cost_table_[0][0].point();
-  const STPoint& second = cost_table_[1][pre_row].point();
-  const STPoint& third = cost_table_[2][curr_row].point();
+  const STPoint& first = cost_table_->at(0, 0).point();
+  const STPoint& second = cost_table_->at(1, pre_row).point();
+  const STPoint& third = cost_table_->at(2, curr_row).point();
   return dp_st_cost_.GetSpeedCost(second, third, speed_limit, cruise_speed) +
          dp_st_cost_.GetAccelCostByThreePoints(first, second, third) +
          dp_st_cost_.GetJerkCostByThreePoints(init_speed, first, second, third);
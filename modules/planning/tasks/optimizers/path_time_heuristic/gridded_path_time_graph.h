@@ -21,6 +21,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "modules/common/configs/proto/vehicle_config.pb.h"
@@ -36,6 +37,7 @@
 #include "modules/planning/common/speed/st_point.h"
 #include "modules/planning/common/st_graph_data.h"
 #include "modules/planning/tasks/optimizers/path_time_heuristic/dp_st_cost.h"
+#include "modules/planning/tasks/optimizers/path_time_heuristic/st_graph_cost_table.h"
 #include "modules/planning/tasks/optimizers/path_time_heuristic/st_graph_point.h"
 
 namespace apollo {
@@ -43,10 +45,16 @@ namespace planning {
 
 class GriddedPathTimeGraph {
  public:
+  /**
+   * @param cost_table The cost table to search in, kept by the caller across
+   * planning cycles to reuse its memory and obstacle costs. A table of its
+   * own is used if it is nullptr.
+   */
   GriddedPathTimeGraph(const StGraphData& st_graph_data,
                        const DpStSpeedConfig& dp_config,
                        const std::vector<const Obstacle*>& obstacles,
-                       const common::TrajectoryPoint& init_point);
+                       const common::TrajectoryPoint& init_point,
+                       StGraphCostTable* const cost_table = nullptr);
 
   common::Status Search(SpeedData* const speed_data);
 
@@ -55,17 +63,15 @@ class GriddedPathTimeGraph {
 
   common::Status InitSpeedLimitLookUp();
 
+  // Keeps the obstacle costs cached in the cost table if nothing they
+  // depend on changed since the last search.
+  void UpdateObstacleCostCache();
+
   common::Status RetrieveSpeedProfile(SpeedData* const speed_data);
 
   common::Status CalculateTotalCost();
 
-  // defined for cyber task
-  struct StGraphMessage {
-    StGraphMessage(const uint32_t c_, const int32_t r_) : c(c_), r(r_) {}
-    uint32_t c;
-    uint32_t r;
-  };
-  void CalculateCostAt(const std::shared_ptr<StGraphMessage>& msg);
+  void CalculateCostAt(const uint32_t c, const uint32_t r);
 
   double CalculateEdgeCost(const STPoint& first, const STPoint& second,
                            const STPoint& third, const STPoint& forth,
@@ -119,9 +125,10 @@ class GriddedPathTimeGraph {
   double max_acceleration_ = 0.0;
   double max_deceleration_ = 0.0;
 
-  // cost_table_[t][s]
+  // cost_table_->at(t, s)
   // row: s, col: t --- NOTICE: Please do NOT change.
-  std::vector<std::vector<StGraphPoint>> cost_table_;
+  std::unique_ptr<StGraphCostTable> own_cost_table_;
+  StGraphCostTable* cost_table_ = nullptr;
 };
 
 }  // namespace planning
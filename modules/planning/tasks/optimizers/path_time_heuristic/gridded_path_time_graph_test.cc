@@ -135,5 +135,53 @@ TEST_F(DpStGraphTest, simple) {
   EXPECT_TRUE(ret.ok());
 }
 
+TEST_F(DpStGraphTest, reuse_cost_table) {
+  Obstacle o1;
+  o1.SetId("o1");
+  obstacle_list_.push_back(o1);
+
+  std::vector<const Obstacle*> obstacles_;
+  obstacles_.emplace_back(&(obstacle_list_.back()));
+
+  std::vector<std::pair<STPoint, STPoint>> point_pairs;
+  point_pairs.emplace_back(STPoint(20.0, 2.0), STPoint(35.0, 2.0));
+  point_pairs.emplace_back(STPoint(40.0, 6.0), STPoint(55.0, 6.0));
+  obstacle_list_.back().set_path_st_boundary(STBoundary(point_pairs));
+
+  std::vector<const STBoundary*> boundaries;
+  boundaries.push_back(&(obstacles_.back()->path_st_boundary()));
+
+  init_point_.set_v(10.0);
+  init_point_.set_a(0.0);
+
+  planning_internal::STGraphDebug st_graph_debug;
+  st_graph_data_ = StGraphData();
+  st_graph_data_.LoadData(boundaries, 30.0, init_point_, speed_limit_, 5.0,
+                          120.0, 7.0, &st_graph_debug);
+
+  SpeedData expected_speed_data;
+  GriddedPathTimeGraph dp_st_graph(st_graph_data_, dp_config_, obstacles_,
+                                   init_point_);
+  ASSERT_TRUE(dp_st_graph.Search(&expected_speed_data).ok());
+
+  // the second search reuses the obstacle costs of the first, the third
+  // computes the rows of each column on several threads
+  StGraphCostTable cost_table;
+  for (const bool multi_thread : {false, false, true}) {
+    FLAGS_enable_multi_thread_in_dp_st_graph = multi_thread;
+    SpeedData speed_data;
+    GriddedPathTimeGraph reused_dp_st_graph(st_graph_data_, dp_config_,
+                                            obstacles_, init_point_,
+                                            &cost_table);
+    ASSERT_TRUE(reused_dp_st_graph.Search(&speed_data).ok());
+    ASSERT_EQ(expected_speed_data.size(), speed_data.size());
+    for (size_t i = 0; i < speed_data.size(); ++i) {
+      EXPECT_DOUBLE_EQ(expected_speed_data[i].s(), speed_data[i].s());
+      EXPECT_DOUBLE_EQ(expected_speed_data[i].t(), speed_data[i].t());
+    }
+  }
+  FLAGS_enable_multi_thread_in_dp_st_graph = false;
+}
+
 }  // namespace planning
 }  // namespace apollo
@@ -39,11 +39,11 @@ PathTimeHeuristicOptimizer::PathTimeHeuristicOptimizer(const TaskConfig& config)
   speed_heuristic_config_ = config.speed_heuristic_config();
 }
 
-bool PathTimeHeuristicOptimizer::SearchPathTimeGraph(
-    SpeedData* speed_data) const {
+bool PathTimeHeuristicOptimizer::SearchPathTimeGraph(SpeedData* speed_data) {
   GriddedPathTimeGraph st_graph(
       reference_line_info_->st_graph_data(), dp_st_speed_config_,
-      reference_line_info_->path_decision()->obstacles().Items(), init_point_);
+      reference_line_info_->path_decision()->obstacles().Items(), init_point_,
+      &cost_table_);
 
   if (!st_graph.Search(speed_data).ok()) {
     AERROR << "failed to search graph with dynamic programming.";
@@ -25,6 +25,7 @@
 #include "modules/planning/proto/dp_st_speed_config.pb.h"
 #include "modules/planning/proto/planning_internal.pb.h"
 
+#include "modules/planning/tasks/optimizers/path_time_heuristic/st_graph_cost_table.h"
 #include "modules/planning/tasks/optimizers/speed_optimizer.h"
 
 namespace apollo {
@@ -39,18 +40,24 @@ class PathTimeHeuristicOptimizer : public SpeedOptimizer {
  public:
   explicit PathTimeHeuristicOptimizer(const TaskConfig& config);
 
+  // a line finding the dp st worker pool busy computes its rows alone
+  bool IsReferenceLineLocal() const override { return true; }
+
  private:
   common::Status Process(const PathData& path_data,
                          const common::TrajectoryPoint& init_point,
                          SpeedData* const speed_data) override;
 
-  bool SearchPathTimeGraph(SpeedData* speed_data) const;
+  bool SearchPathTimeGraph(SpeedData* speed_data);
 
  private:
   common::TrajectoryPoint init_point_;
   SLBoundary adc_sl_boundary_;
   SpeedHeuristicConfig speed_heuristic_config_;
   DpStSpeedConfig dp_st_speed_config_;
+
+  // reused by the searches of all planning cycles
+  StGraphCostTable cost_table_;
 };
 
 }  // namespace planning
@@ -0,0 +1,66 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file st_graph_cost_table.cc
+ **/
+
+#include "modules/planning/tasks/optimizers/path_time_heuristic/st_graph_cost_table.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace apollo {
+namespace planning {
+
+namespace {
+constexpr double kNoCost = std::numeric_limits<double>::quiet_NaN();
+}  // namespace
+
+void StGraphCostTable::Reset(const uint32_t dimension_t,
+                             const uint32_t dimension_s) {
+  const size_t size = static_cast<size_t>(dimension_t) * dimension_s;
+  if (dimension_t != dimension_t_ || dimension_s != dimension_s_) {
+    dimension_t_ = dimension_t;
+    dimension_s_ = dimension_s;
+    ClearObstacleCosts();
+    obstacle_costs_.resize(size, kNoCost);
+  }
+  // assign keeps the capacity, so a table that does not grow is not
+  // reallocated
+  points_.assign(size, StGraphPoint());
+}
+
+bool StGraphCostTable::UpdateObstacleCostKey(
+    const std::vector<double>& key_values,
+    const std::vector<std::string>& key_ids) {
+  if (key_values == key_values_ && key_ids == key_ids_) {
+    return true;
+  }
+  ClearObstacleCosts();
+  key_values_ = key_values;
+  key_ids_ = key_ids;
+  return false;
+}
+
+void StGraphCostTable::ClearObstacleCosts() {
+  std::fill(obstacle_costs_.begin(), obstacle_costs_.end(), kNoCost);
+  key_values_.clear();
+  key_ids_.clear();
+}
+
+}  // namespace planning
+}  // namespace apollo
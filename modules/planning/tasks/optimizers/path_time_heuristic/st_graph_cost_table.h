@@ -0,0 +1,99 @@
+/******************************************************************************
+ * Copyright 2018 The Apollo Authors. All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *****************************************************************************/
+
+/**
+ * @file st_graph_cost_table.h
+ **/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "modules/planning/tasks/optimizers/path_time_heuristic/st_graph_point.h"
+
+namespace apollo {
+namespace planning {
+
+/**
+ * @class StGraphCostTable
+ * @brief The dp st cost table, kept across planning cycles by its owner.
+ *
+ * All points live in one block, column after column, which is only
+ * reallocated when the grid grows. The obstacle cost of each cell is
+ * remembered as long as the obstacle cost key, built by the caller from
+ * everything GetObstacleCost reads, stays the same.
+ */
+class StGraphCostTable {
+ public:
+  /**
+   * @brief Lays out a table of dimension_t columns of dimension_s points,
+   * all reset to their default state. Cached obstacle costs survive only if
+   * the dimensions are unchanged.
+   */
+  void Reset(const uint32_t dimension_t, const uint32_t dimension_s);
+
+  uint32_t dimension_t() const { return dimension_t_; }
+  uint32_t dimension_s() const { return dimension_s_; }
+
+  StGraphPoint& at(const uint32_t c, const uint32_t r) {
+    return points_[c * dimension_s_ + r];
+  }
+  const StGraphPoint& at(const uint32_t c, const uint32_t r) const {
+    return points_[c * dimension_s_ + r];
+  }
+
+  /**
+   * @brief Compares the key with the one of the previous search and drops
+   * the cached obstacle costs if they differ.
+   * @return true if the cached obstacle costs are still valid
+   */
+  bool UpdateObstacleCostKey(const std::vector<double>& key_values,
+                             const std::vector<std::string>& key_ids);
+
+  /**
+   * @brief Drops the cached obstacle costs and the key.
+   */
+  void ClearObstacleCosts();
+
+  /**
+   * @brief The cached obstacle cost of a cell, NaN if there is none.
+   */
+  double cached_obstacle_cost(const uint32_t c, const uint32_t r) const {
+    return obstacle_costs_[c * dimension_s_ + r];
+  }
+
+  // Different cells may be set from different threads.
+  void CacheObstacleCost(const uint32_t c, const uint32_t r,
+                         const double obstacle_cost) {
+    obstacle_costs_[c * dimension_s_ + r] = obstacle_cost;
+  }
+
+ private:
+  uint32_t dimension_t_ = 0;
+  uint32_t dimension_s_ = 0;
+
+  // points_[c * dimension_s_ + r], col: t, row: s
+  std::vector<StGraphPoint> points_;
+
+  std::vector<double> obstacle_costs_;
+  std::vector<double> key_values_;
+  std::vector<std::string> key_ids_;
+};
+
+}  // namespace planning
+}  // namespace apollo
@@ -129,10 +129,30 @@ common::Status PiecewiseJerkPathOptimizer::Process(
       ddl_bounds.emplace_back(-lat_acc_bound - kappa, lat_acc_bound - kappa);
     }
 
-    bool res_opt =
-        OptimizePath(init_frenet_state.second, end_state,
-                     path_boundary.delta_s(), path_boundary.boundary(),
-                     ddl_bounds, w, &opt_l, &opt_dl, &opt_ddl, max_iter);
+    PiecewiseJerkWorkspace* workspace = nullptr;
+    double warm_start_shift = 0.0;
+    if (FLAGS_enable_piecewise_jerk_warm_start) {
+      // lane change paths do not share a cache with the ones in the lane
+      auto& cache =
+          warm_start_caches_[reference_line_info_->IsChangeLanePath()
+                                 ? path_boundary.label() + "/change_lane"
+                                 : path_boundary.label()];
+      if (cache == nullptr) {
+        cache.reset(new WarmStartCache());
+      }
+      // start from the last path, moved forward by the distance driven
+      const common::math::Vec2d start_position(
+          planning_start_point.path_point().x(),
+          planning_start_point.path_point().y());
+      warm_start_shift = start_position.DistanceTo(cache->start_position);
+      cache->start_position = start_position;
+      workspace = &cache->workspace;
+    }
+
+    bool res_opt = OptimizePath(
+        init_frenet_state.second, end_state, path_boundary.delta_s(),
+        path_boundary.boundary(), ddl_bounds, w, &opt_l, &opt_dl, &opt_ddl,
+        max_iter, workspace, warm_start_shift);
 
     if (res_opt) {
       for (size_t i = 0; i < path_boundary.boundary().size(); i += 4) {
@@ -206,9 +226,14 @@ bool PiecewiseJerkPathOptimizer::OptimizePath(
     const std::vector<std::pair<double, double>>& lat_boundaries,
     const std::vector<std::pair<double, double>>& ddl_bounds,
     const std::array<double, 5>& w, std::vector<double>* x,
-    std::vector<double>* dx, std::vector<double>* ddx, const int max_iter) {
+    std::vector<double>* dx, std::vector<double>* ddx, const int max_iter,
+    PiecewiseJerkWorkspace* const workspace, const double warm_start_shift) {
   PiecewiseJerkPathProblem piecewise_jerk_problem(lat_boundaries.size(),
                                                   delta_s, init_state);
+  if (workspace != nullptr) {
+    piecewise_jerk_problem.set_workspace(workspace);
+    piecewise_jerk_problem.set_warm_start_shift(warm_start_shift, false);
+  }
 
   // TODO(Hongyi): update end_state settings
   piecewise_jerk_problem.set_end_state_ref({1000.0, 0.0, 0.0}, end_state);
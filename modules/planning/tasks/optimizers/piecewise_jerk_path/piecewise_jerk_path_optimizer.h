@@ -20,9 +20,14 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "modules/common/math/vec2d.h"
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_workspace.h"
 #include "modules/planning/tasks/optimizers/path_optimizer.h"
 
 namespace apollo {
@@ -32,6 +37,8 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
  public:
   explicit PiecewiseJerkPathOptimizer(const TaskConfig& config);
 
+  bool IsReferenceLineLocal() const override { return true; }
+
   virtual ~PiecewiseJerkPathOptimizer() = default;
 
  private:
@@ -54,7 +61,8 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
       const std::vector<std::pair<double, double>>& ddl_bounds,
       const std::array<double, 5>& w, std::vector<double>* ptr_x,
       std::vector<double>* ptr_dx, std::vector<double>* ptr_ddx,
-      const int max_iter);
+      const int max_iter, PiecewiseJerkWorkspace* const workspace,
+      const double warm_start_shift);
 
   FrenetFramePath ToPiecewiseJerkPath(const std::vector<double>& l,
                                       const std::vector<double>& dl,
@@ -65,6 +73,17 @@ class PiecewiseJerkPathOptimizer : public PathOptimizer {
   double EstimateJerkBoundary(const double vehicle_speed,
                               const double axis_distance,
                               const double max_steering_rate) const;
+
+  // The OSQP workspace and planning start position of the last solve of a
+  // kind of path boundary, kept across planning cycles with
+  // FLAGS_enable_piecewise_jerk_warm_start.
+  struct WarmStartCache {
+    PiecewiseJerkWorkspace workspace;
+    common::math::Vec2d start_position;
+  };
+  // by path boundary label, a small fixed set
+  std::unordered_map<std::string, std::unique_ptr<WarmStartCache>>
+      warm_start_caches_;
 };
 
 }  // namespace planning
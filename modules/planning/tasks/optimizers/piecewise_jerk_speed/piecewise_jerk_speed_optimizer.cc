@@ -26,6 +26,7 @@
 
 #include "modules/common/proto/pnc_point.pb.h"
 
+#include "modules/common/time/time.h"
 #include "modules/common/vehicle_state/vehicle_state_provider.h"
 #include "modules/planning/common/planning_gflags.h"
 #include "modules/planning/common/speed_profile_generator.h"
@@ -40,6 +41,7 @@ using apollo::common::PathPoint;
 using apollo::common::SpeedPoint;
 using apollo::common::Status;
 using apollo::common::TrajectoryPoint;
+using apollo::common::time::Clock;
 
 PiecewiseJerkSpeedOptimizer::PiecewiseJerkSpeedOptimizer(
     const TaskConfig& config)
@@ -161,6 +163,15 @@ Status PiecewiseJerkSpeedOptimizer::Process(const PathData& path_data,
   piecewise_jerk_problem.set_penalty_dx(penalty_dx);
   piecewise_jerk_problem.set_dx_bounds(std::move(s_dot_bounds));
 
+  if (FLAGS_enable_piecewise_jerk_warm_start) {
+    // start from the last profile, moved forward by the time since then
+    const double timestamp = Clock::NowInSeconds();
+    piecewise_jerk_problem.set_workspace(&workspace_);
+    piecewise_jerk_problem.set_warm_start_shift(
+        timestamp - last_solve_timestamp_, true);
+    last_solve_timestamp_ = timestamp;
+  }
+
   // Solve the problem
   if (!piecewise_jerk_problem.Optimize()) {
     std::string msg("Piecewise jerk speed optimizer failed!");
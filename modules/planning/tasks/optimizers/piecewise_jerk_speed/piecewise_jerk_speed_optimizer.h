@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "modules/planning/math/piecewise_jerk/piecewise_jerk_workspace.h"
 #include "modules/planning/tasks/optimizers/speed_optimizer.h"
 
 namespace apollo {
@@ -29,12 +30,18 @@ class PiecewiseJerkSpeedOptimizer : public SpeedOptimizer {
  public:
   explicit PiecewiseJerkSpeedOptimizer(const TaskConfig& config);
 
+  bool IsReferenceLineLocal() const override { return true; }
+
   virtual ~PiecewiseJerkSpeedOptimizer() = default;
 
  private:
   common::Status Process(const PathData& path_data,
                          const common::TrajectoryPoint& init_point,
                          SpeedData* const speed_data) override;
+
+  // kept across planning cycles with FLAGS_enable_piecewise_jerk_warm_start
+  PiecewiseJerkWorkspace workspace_;
+  double last_solve_timestamp_ = 0.0;
 };
 
 }  // namespace planning
@@ -46,6 +46,16 @@ class Task {
 
   virtual common::Status Execute(Frame* frame);
 
+  /**
+   * @brief Whether Execute(frame, reference_line_info) only touches the given
+   * reference line, the read-only parts of the frame and the planning status.
+   * Stages may run such tasks for several reference lines concurrently on
+   * separate instances. Tasks opt in once audited; the others, e.g. those
+   * reading other reference lines or keeping static state, run for one line
+   * at a time.
+   */
+  virtual bool IsReferenceLineLocal() const { return false; }
+
  protected:
   Frame* frame_ = nullptr;
   ReferenceLineInfo* reference_line_info_ = nullptr;
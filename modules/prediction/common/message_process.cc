@@ -17,7 +17,7 @@
 #include "modules/prediction/common/message_process.h"
 
 #include "cyber/common/file.h"
-#include "cyber/record/record_reader.h"
+#include "cyber/record/mapped_record_reader.h"
 
 #include "modules/common/adapters/adapter_gflags.h"
 #include "modules/prediction/common/feature_output.h"
@@ -39,8 +39,8 @@ namespace apollo {
 namespace prediction {
 
 using apollo::common::adapter::AdapterConfig;
-using apollo::cyber::record::RecordMessage;
-using apollo::cyber::record::RecordReader;
+using apollo::cyber::record::MappedRecordReader;
+using apollo::cyber::record::RecordMessageView;
 using apollo::localization::LocalizationEstimate;
 using apollo::perception::PerceptionObstacle;
 using apollo::perception::PerceptionObstacles;
@@ -283,23 +283,26 @@ void MessageProcess::OnStoryTelling(const Stories& story) {
 }
 
 void MessageProcess::ProcessOfflineData(const std::string& record_filename) {
-  RecordReader reader(record_filename);
-  RecordMessage message;
+  MappedRecordReader reader(record_filename);
+  RecordMessageView message;
   while (reader.ReadMessage(&message)) {
     if (message.channel_name == FLAGS_perception_obstacle_topic) {
       PerceptionObstacles perception_obstacles;
-      if (perception_obstacles.ParseFromString(message.content)) {
+      if (perception_obstacles.ParseFromArray(message.content.data(),
+                                              message.content.size())) {
         PredictionObstacles prediction_obstacles;
         OnPerception(perception_obstacles, &prediction_obstacles);
       }
     } else if (message.channel_name == FLAGS_localization_topic) {
       LocalizationEstimate localization;
-      if (localization.ParseFromString(message.content)) {
+      if (localization.ParseFromArray(message.content.data(),
+                                      message.content.size())) {
         OnLocalization(localization);
       }
     } else if (message.channel_name == FLAGS_planning_trajectory_topic) {
       ADCTrajectory adc_trajectory;
-      if (adc_trajectory.ParseFromString(message.content)) {
+      if (adc_trajectory.ParseFromArray(message.content.data(),
+                                        message.content.size())) {
         OnPlanning(adc_trajectory);
       }
     }